@@ -0,0 +1,208 @@
+//
+// Alloc - Arena
+//
+
+// Notes:
+// - Linear allocator for transient data. Allocations are never freed individually, the whole
+//   arena is reset at once.
+// - Running out of space chains a new block instead of failing. On reset, chained blocks are
+//   merged into a single block sized for the peak usage, so after a few frames the arena
+//   settles into one block and stops allocating.
+
+#define SC_ARENA_DEFAULT_ALIGNMENT 16
+
+typedef struct ScArenaBlock {
+    struct ScArenaBlock* prev;
+    uint64_t capacity;
+    uint64_t offset;
+    // Data follows, SC_ARENA_DEFAULT_ALIGNMENT aligned.
+} ScArenaBlock;
+
+typedef struct ScArena {
+    ScArenaBlock* block;
+    uint64_t block_count;
+    uint64_t used_byte_count;
+    uint64_t peak_byte_count;
+    // Most recent allocation, can be grown in place.
+    void* last;
+} ScArena;
+
+#define SC_ARENA_ALLOC(arena, type, count)                                             \
+    ((type*)sc_arena_alloc((arena), (uint64_t)(count) * sizeof(type), _Alignof(type)))
+
+// Offsets and capacity are relative to the block, including the header.
+#define SC_ARENA_BLOCK_HEADER_BYTE_COUNT                                                          \
+    ((sizeof(ScArenaBlock) + SC_ARENA_DEFAULT_ALIGNMENT - 1) & ~(SC_ARENA_DEFAULT_ALIGNMENT - 1))
+
+static ScArenaBlock* sc_arena_block_new(ScArenaBlock* prev, uint64_t capacity) {
+    ScArenaBlock* block = malloc(SC_ARENA_BLOCK_HEADER_BYTE_COUNT + capacity);
+    SC_ASSERT(block != NULL);
+    block->prev = prev;
+    block->capacity = SC_ARENA_BLOCK_HEADER_BYTE_COUNT + capacity;
+    block->offset = SC_ARENA_BLOCK_HEADER_BYTE_COUNT;
+    return block;
+}
+
+static void sc_arena_new(ScArena* arena, uint64_t byte_count) {
+    arena->block = sc_arena_block_new(NULL, byte_count);
+    arena->block_count = 1;
+    arena->used_byte_count = 0;
+    arena->peak_byte_count = 0;
+    arena->last = NULL;
+}
+
+static void sc_arena_free(ScArena* arena) {
+    ScArenaBlock* block = arena->block;
+    while (block != NULL) {
+        ScArenaBlock* prev = block->prev;
+        free(block);
+        block = prev;
+    }
+    SDL_zerop(arena);
+}
+
+static void* sc_arena_alloc(ScArena* arena, uint64_t byte_count, uint64_t alignment) {
+    // Align.
+    SC_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    ScArenaBlock* block = arena->block;
+    uint64_t offset = (block->offset + alignment - 1) & ~(alignment - 1);
+
+    // Chain a new block, at least twice the previous one.
+    if (offset + byte_count > block->capacity) {
+        const uint64_t capacity = SDL_max(2 * block->capacity, byte_count + alignment);
+        block = sc_arena_block_new(block, capacity);
+        arena->block = block;
+        arena->block_count++;
+        offset = (block->offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Bump.
+    void* ptr = (uint8_t*)block + offset;
+    arena->used_byte_count += offset + byte_count - block->offset;
+    arena->peak_byte_count = SDL_max(arena->peak_byte_count, arena->used_byte_count);
+    block->offset = offset + byte_count;
+    arena->last = ptr;
+    return ptr;
+}
+
+// Resizes an allocation, in place if it was the most recent one and there is room.
+static void* sc_arena_grow(
+    ScArena* arena,
+    void* ptr,
+    uint64_t old_byte_count,
+    uint64_t new_byte_count,
+    uint64_t alignment
+) {
+    ScArenaBlock* block = arena->block;
+    if (ptr != NULL && ptr == arena->last) {
+        const uint64_t offset = (uint64_t)((uint8_t*)ptr - (uint8_t*)block);
+        if (offset + new_byte_count <= block->capacity) {
+            arena->used_byte_count += new_byte_count - old_byte_count;
+            arena->peak_byte_count = SDL_max(arena->peak_byte_count, arena->used_byte_count);
+            block->offset = offset + new_byte_count;
+            return ptr;
+        }
+    }
+    void* new_ptr = sc_arena_alloc(arena, new_byte_count, alignment);
+    if (ptr != NULL) {
+        memcpy(new_ptr, ptr, old_byte_count);
+    }
+    return new_ptr;
+}
+
+static void sc_arena_reset(ScArena* arena) {
+    // Merge chained blocks into one that fits everything seen so far.
+    if (arena->block_count > 1) {
+        uint64_t capacity = arena->peak_byte_count;
+        ScArenaBlock* block = arena->block;
+        while (block != NULL) {
+            ScArenaBlock* prev = block->prev;
+            free(block);
+            block = prev;
+        }
+        arena->block = sc_arena_block_new(NULL, capacity);
+        arena->block_count = 1;
+    }
+    arena->block->offset = SC_ARENA_BLOCK_HEADER_BYTE_COUNT;
+    arena->used_byte_count = 0;
+    arena->last = NULL;
+}
+
+//
+// Alloc - Pool
+//
+
+// Notes:
+// - Fixed-size objects with a long lifetime, allocated from chained blocks and recycled
+//   through a free list, so releasing and reallocating does not touch the heap.
+
+typedef struct ScPoolBlock {
+    struct ScPoolBlock* prev;
+    // Elements follow, SC_ARENA_DEFAULT_ALIGNMENT aligned.
+} ScPoolBlock;
+
+typedef struct ScPool {
+    uint64_t element_byte_count;
+    uint32_t block_element_count;
+    ScPoolBlock* block;
+    void* free_list;
+    uint32_t live_count;
+} ScPool;
+
+static void sc_pool_new(ScPool* pool, uint64_t element_byte_count, uint32_t block_element_count) {
+    SC_ASSERT(block_element_count > 0);
+    pool->element_byte_count = (SDL_max(element_byte_count, sizeof(void*))
+                                + SC_ARENA_DEFAULT_ALIGNMENT - 1)
+                               & ~(uint64_t)(SC_ARENA_DEFAULT_ALIGNMENT - 1);
+    pool->block_element_count = block_element_count;
+    pool->block = NULL;
+    pool->free_list = NULL;
+    pool->live_count = 0;
+}
+
+static void sc_pool_free(ScPool* pool) {
+    ScPoolBlock* block = pool->block;
+    while (block != NULL) {
+        ScPoolBlock* prev = block->prev;
+        free(block);
+        block = prev;
+    }
+    SDL_zerop(pool);
+}
+
+// Returns zeroed memory.
+static void* sc_pool_alloc(ScPool* pool) {
+    // Refill.
+    if (pool->free_list == NULL) {
+        const uint64_t header_byte_count = SC_ARENA_DEFAULT_ALIGNMENT;
+        static_assert(sizeof(ScPoolBlock) <= SC_ARENA_DEFAULT_ALIGNMENT, "ScPoolBlock too large");
+        ScPoolBlock* block =
+            malloc(header_byte_count + pool->block_element_count * pool->element_byte_count);
+        SC_ASSERT(block != NULL);
+        block->prev = pool->block;
+        pool->block = block;
+        uint8_t* elements = (uint8_t*)block + header_byte_count;
+        for (uint32_t i = pool->block_element_count; i-- > 0;) {
+            void* element = elements + i * pool->element_byte_count;
+            *(void**)element = pool->free_list;
+            pool->free_list = element;
+        }
+    }
+
+    // Pop.
+    void* element = pool->free_list;
+    pool->free_list = *(void**)element;
+    pool->live_count++;
+    memset(element, 0, pool->element_byte_count);
+    return element;
+}
+
+static void sc_pool_release(ScPool* pool, void* element) {
+    if (element == NULL) {
+        return;
+    }
+    SC_ASSERT(pool->live_count > 0);
+    *(void**)element = pool->free_list;
+    pool->free_list = element;
+    pool->live_count--;
+}
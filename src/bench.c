@@ -0,0 +1,1391 @@
+//
+// Stormcloud Bench - Includes.
+//
+
+#include "common.h"
+#include "alloc.h"
+#include "job.h"
+#include "math.h"
+#include "color.h"
+#include "camera.h"
+#include "octree.h"
+
+//
+// Stormcloud Bench - Microbenchmarks and validation of the batch kernels.
+//
+
+// Usage: stormcloud_bench [element_count]
+
+#define SC_BENCH_DEFAULT_ELEMENT_COUNT (1u << 20)
+#define SC_BENCH_REPEAT_COUNT 16
+
+typedef enum ScBenchVariant {
+    SC_BENCH_VARIANT_SCALAR,
+    SC_BENCH_VARIANT_SSE2,
+    SC_BENCH_VARIANT_AVX2,
+    SC_BENCH_VARIANT_COUNT,
+} ScBenchVariant;
+
+static const char* SC_BENCH_VARIANT_NAME[] = {
+    "scalar",
+    "sse2",
+    "avx2",
+};
+
+static const bool SC_BENCH_VARIANT_ENABLED[] = {
+    true,
+#if defined(SC_SIMD_SSE2)
+    true,
+#else
+    false,
+#endif
+#if defined(SC_SIMD_AVX2)
+    true,
+#else
+    false,
+#endif
+};
+
+//
+// Random
+//
+
+typedef struct ScBenchRng {
+    uint64_t state;
+} ScBenchRng;
+
+static uint32_t sc_bench_rng_u32(ScBenchRng* rng) {
+    // xorshift64*
+    rng->state ^= rng->state >> 12;
+    rng->state ^= rng->state << 25;
+    rng->state ^= rng->state >> 27;
+    return (uint32_t)((rng->state * 0x2545f4914f6cdd1dull) >> 32);
+}
+
+static float sc_bench_rng_f32(ScBenchRng* rng, float mn, float mx) {
+    const float t = (float)(sc_bench_rng_u32(rng) >> 8) / (float)(1u << 24);
+    return mn + t * (mx - mn);
+}
+
+static void sc_bench_rng_fill(ScBenchRng* rng, float* dst, uint32_t count, float mn, float mx) {
+    for (uint32_t i = 0; i < count; i++) {
+        dst[i] = sc_bench_rng_f32(rng, mn, mx);
+    }
+}
+
+//
+// Reporting
+//
+
+typedef struct ScBenchResult {
+    uint64_t best_time_ns;
+    bool matches_reference;
+} ScBenchResult;
+
+static void
+sc_bench_report(const char* kernel, const char* variant, ScBenchResult result, uint32_t count) {
+    const double ns_per_element = (double)result.best_time_ns / (double)count;
+    const double melements_per_second = (double)count / ((double)result.best_time_ns / 1e3);
+    SC_LOG_INFO(
+        "%-28s %-8s %8.3f ns/elem %10.2f Melem/s %s",
+        kernel,
+        variant,
+        ns_per_element,
+        melements_per_second,
+        result.matches_reference ? "ok" : "MISMATCH"
+    );
+}
+
+// Runs a statement SC_BENCH_REPEAT_COUNT times and keeps the best time.
+#define SC_BENCH_TIME(best_time_ns, stmt)                            \
+    do {                                                             \
+        best_time_ns = UINT64_MAX;                                   \
+        for (uint32_t rep = 0; rep < SC_BENCH_REPEAT_COUNT; rep++) { \
+            const uint64_t begin_ns = SDL_GetTicksNS();              \
+            stmt;                                                    \
+            const uint64_t end_ns = SDL_GetTicksNS();                \
+            best_time_ns = SDL_min(best_time_ns, end_ns - begin_ns); \
+        }                                                            \
+    } while (0)
+
+//
+// Kernels
+//
+
+static bool sc_bench_transform(ScBenchRng* rng, uint32_t count) {
+    // Inputs.
+    float* x = malloc(count * sizeof(float));
+    float* y = malloc(count * sizeof(float));
+    float* z = malloc(count * sizeof(float));
+    sc_bench_rng_fill(rng, x, count, -1024.0f, 1024.0f);
+    sc_bench_rng_fill(rng, y, count, -1024.0f, 1024.0f);
+    sc_bench_rng_fill(rng, z, count, -1024.0f, 1024.0f);
+    const mat4f m = mat4f_mul(
+        mat4f_perspective(rad_from_deg(60.0f), 16.0f / 10.0f, 16.0f, 2048.0f),
+        mat4f_lookat(
+            vec3f_new(900.0f, 300.0f, 200.0f),
+            vec3f_new(0.0f, 0.0f, 0.0f),
+            vec3f_new_z(1.0f)
+        )
+    );
+
+    // Outputs.
+    float* out[SC_BENCH_VARIANT_COUNT][4];
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        for (uint32_t c = 0; c < 4; c++) {
+            out[v][c] = calloc(count, sizeof(float));
+        }
+    }
+
+    // Run.
+    bool ok = true;
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        if (!SC_BENCH_VARIANT_ENABLED[v]) {
+            continue;
+        }
+        float** o = out[v];
+        ScBenchResult result = {0};
+        switch (v) {
+            case SC_BENCH_VARIANT_SCALAR:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    mat4f_transform_batch_scalar(m, x, y, z, o[0], o[1], o[2], o[3], count)
+                );
+                break;
+#if defined(SC_SIMD_SSE2)
+            case SC_BENCH_VARIANT_SSE2:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    mat4f_transform_batch_sse2(m, x, y, z, o[0], o[1], o[2], o[3], count)
+                );
+                break;
+#endif
+#if defined(SC_SIMD_AVX2)
+            case SC_BENCH_VARIANT_AVX2:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    mat4f_transform_batch_avx2(m, x, y, z, o[0], o[1], o[2], o[3], count)
+                );
+                break;
+#endif
+            default: break;
+        }
+        result.matches_reference = true;
+        for (uint32_t c = 0; c < 4; c++) {
+            const float* reference = out[SC_BENCH_VARIANT_SCALAR][c];
+            result.matches_reference &= memcmp(o[c], reference, count * sizeof(float)) == 0;
+        }
+        ok &= result.matches_reference;
+        sc_bench_report("mat4f_transform_batch", SC_BENCH_VARIANT_NAME[v], result, count);
+    }
+
+    // Free.
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        for (uint32_t c = 0; c < 4; c++) {
+            free(out[v][c]);
+        }
+    }
+    free(x);
+    free(y);
+    free(z);
+    return ok;
+}
+
+static bool sc_bench_classify(ScBenchRng* rng, uint32_t count) {
+    // Inputs.
+    float* mn[3];
+    float* mx[3];
+    for (uint32_t c = 0; c < 3; c++) {
+        mn[c] = malloc(count * sizeof(float));
+        mx[c] = malloc(count * sizeof(float));
+        for (uint32_t i = 0; i < count; i++) {
+            const float center = sc_bench_rng_f32(rng, -1024.0f, 1024.0f);
+            const float extent = sc_bench_rng_f32(rng, 1.0f, 64.0f);
+            mn[c][i] = center - extent;
+            mx[c][i] = center + extent;
+        }
+    }
+    const box3f_batch boxes = {
+        .mn_x = mn[0],
+        .mn_y = mn[1],
+        .mn_z = mn[2],
+        .mx_x = mx[0],
+        .mx_y = mx[1],
+        .mx_z = mx[2],
+    };
+    const plane3f plane = plane3f_from_vec4f(vec4f_new(0.3f, -0.8f, 0.5f, 120.0f));
+
+    // Outputs.
+    uint8_t* out[SC_BENCH_VARIANT_COUNT];
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        out[v] = calloc(count, sizeof(uint8_t));
+    }
+
+    // Run.
+    bool ok = true;
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        if (!SC_BENCH_VARIANT_ENABLED[v]) {
+            continue;
+        }
+        ScBenchResult result = {0};
+        switch (v) {
+            case SC_BENCH_VARIANT_SCALAR:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    box3f_classify_plane_batch_scalar(boxes, plane, out[v], count)
+                );
+                break;
+#if defined(SC_SIMD_SSE2)
+            case SC_BENCH_VARIANT_SSE2:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    box3f_classify_plane_batch_sse2(boxes, plane, out[v], count)
+                );
+                break;
+#endif
+#if defined(SC_SIMD_AVX2)
+            case SC_BENCH_VARIANT_AVX2:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    box3f_classify_plane_batch_avx2(boxes, plane, out[v], count)
+                );
+                break;
+#endif
+            default: break;
+        }
+        result.matches_reference = memcmp(out[v], out[SC_BENCH_VARIANT_SCALAR], count) == 0;
+        ok &= result.matches_reference;
+        sc_bench_report("box3f_classify_plane_batch", SC_BENCH_VARIANT_NAME[v], result, count);
+    }
+
+    // Reference: classification must agree with testing all eight corners.
+    uint32_t corner_mismatch_count = 0;
+    const vec4f p = vec4f_from_plane3f(plane);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t front_count = 0;
+        for (uint32_t corner = 0; corner < 8; corner++) {
+            const vec4f c = vec4f_new(
+                corner & 1 ? mx[0][i] : mn[0][i],
+                corner & 2 ? mx[1][i] : mn[1][i],
+                corner & 4 ? mx[2][i] : mn[2][i],
+                1.0f
+            );
+            front_count += vec4f_dot(p, c) >= 0.0f ? 1 : 0;
+        }
+        const uint8_t side = front_count == 0   ? PLANE3F_SIDE_BACK
+                           : front_count == 8 ? PLANE3F_SIDE_FRONT
+                                              : PLANE3F_SIDE_STRADDLE;
+        corner_mismatch_count += side != out[SC_BENCH_VARIANT_SCALAR][i] ? 1 : 0;
+    }
+    if (corner_mismatch_count > 0) {
+        SC_LOG_ERROR("box3f_classify_plane_batch: %u corner mismatches", corner_mismatch_count);
+        ok = false;
+    }
+
+    // Free.
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        free(out[v]);
+    }
+    for (uint32_t c = 0; c < 3; c++) {
+        free(mn[c]);
+        free(mx[c]);
+    }
+    return ok;
+}
+
+static bool sc_bench_sphere_project(ScBenchRng* rng, uint32_t count) {
+    // Inputs.
+    float* o_x = malloc(count * sizeof(float));
+    float* o_y = malloc(count * sizeof(float));
+    float* o_z = malloc(count * sizeof(float));
+    float* r = malloc(count * sizeof(float));
+    sc_bench_rng_fill(rng, o_x, count, -1024.0f, 1024.0f);
+    sc_bench_rng_fill(rng, o_y, count, -1024.0f, 1024.0f);
+    sc_bench_rng_fill(rng, o_z, count, -1024.0f, 1024.0f);
+    sc_bench_rng_fill(rng, r, count, 0.5f, 8.0f);
+    const sphere3f_project_info info = {
+        .view_from_world = mat4f_lookat(
+            vec3f_new(1500.0f, 600.0f, 400.0f),
+            vec3f_new(0.0f, 0.0f, 0.0f),
+            vec3f_new_z(1.0f)
+        ),
+        .focal_length = 1.0f / tanf(rad_from_deg(60.0f) * 0.5f),
+        .screen_area = 1920.0f * 1200.0f,
+    };
+
+    // Outputs.
+    float* out[SC_BENCH_VARIANT_COUNT];
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        out[v] = calloc(count, sizeof(float));
+    }
+
+    // Run.
+    bool ok = true;
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        if (!SC_BENCH_VARIANT_ENABLED[v]) {
+            continue;
+        }
+        ScBenchResult result = {0};
+        switch (v) {
+            case SC_BENCH_VARIANT_SCALAR:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    sphere3f_project_area_batch_scalar(&info, o_x, o_y, o_z, r, out[v], count)
+                );
+                break;
+#if defined(SC_SIMD_SSE2)
+            case SC_BENCH_VARIANT_SSE2:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    sphere3f_project_area_batch_sse2(&info, o_x, o_y, o_z, r, out[v], count)
+                );
+                break;
+#endif
+#if defined(SC_SIMD_AVX2)
+            case SC_BENCH_VARIANT_AVX2:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    sphere3f_project_area_batch_avx2(&info, o_x, o_y, o_z, r, out[v], count)
+                );
+                break;
+#endif
+            default: break;
+        }
+        const size_t byte_count = count * sizeof(float);
+        result.matches_reference = memcmp(out[v], out[SC_BENCH_VARIANT_SCALAR], byte_count) == 0;
+        ok &= result.matches_reference;
+        sc_bench_report("sphere3f_project_area_batch", SC_BENCH_VARIANT_NAME[v], result, count);
+    }
+
+    // Free.
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        free(out[v]);
+    }
+    free(o_x);
+    free(o_y);
+    free(o_z);
+    free(r);
+    return ok;
+}
+
+static bool sc_bench_decode(ScBenchRng* rng, uint32_t count) {
+    // Inputs, interleaved with colors like ScOctreePoint.
+    const uint32_t stride = 2;
+    uint32_t* packed = malloc((size_t)count * stride * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count * stride; i++) {
+        packed[i] = sc_bench_rng_u32(rng);
+    }
+    const vec3f mn = vec3f_new(-512.0f, 128.0f, 64.0f);
+    const vec3f extent = vec3f_new(256.0f, 256.0f, 256.0f);
+
+    // Outputs.
+    float* out[SC_BENCH_VARIANT_COUNT][3];
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        for (uint32_t c = 0; c < 3; c++) {
+            out[v][c] = calloc(count, sizeof(float));
+        }
+    }
+
+    // Run.
+    bool ok = true;
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        if (!SC_BENCH_VARIANT_ENABLED[v]) {
+            continue;
+        }
+        float** o = out[v];
+        ScBenchResult result = {0};
+        switch (v) {
+            case SC_BENCH_VARIANT_SCALAR:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    vec3f_decode_unorm10_batch_scalar(
+                        packed,
+                        stride,
+                        mn,
+                        extent,
+                        o[0],
+                        o[1],
+                        o[2],
+                        count
+                    )
+                );
+                break;
+#if defined(SC_SIMD_SSE2)
+            case SC_BENCH_VARIANT_SSE2:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    vec3f_decode_unorm10_batch_sse2(
+                        packed,
+                        stride,
+                        mn,
+                        extent,
+                        o[0],
+                        o[1],
+                        o[2],
+                        count
+                    )
+                );
+                break;
+#endif
+#if defined(SC_SIMD_AVX2)
+            case SC_BENCH_VARIANT_AVX2:
+                SC_BENCH_TIME(
+                    result.best_time_ns,
+                    vec3f_decode_unorm10_batch_avx2(
+                        packed,
+                        stride,
+                        mn,
+                        extent,
+                        o[0],
+                        o[1],
+                        o[2],
+                        count
+                    )
+                );
+                break;
+#endif
+            default: break;
+        }
+        result.matches_reference = true;
+        for (uint32_t c = 0; c < 3; c++) {
+            const float* reference = out[SC_BENCH_VARIANT_SCALAR][c];
+            result.matches_reference &= memcmp(o[c], reference, count * sizeof(float)) == 0;
+        }
+        ok &= result.matches_reference;
+        sc_bench_report("vec3f_decode_unorm10_batch", SC_BENCH_VARIANT_NAME[v], result, count);
+    }
+
+    // Free.
+    for (uint32_t v = 0; v < SC_BENCH_VARIANT_COUNT; v++) {
+        for (uint32_t c = 0; c < 3; c++) {
+            free(out[v][c]);
+        }
+    }
+    free(packed);
+    return ok;
+}
+
+//
+// Frustum culling
+//
+
+// Notes:
+// - Every culling function is checked against an exact separating axis test, which treats the
+//   frustum as the convex hull of its corners. Culling a box that the reference keeps is an
+//   error. Keeping a box that the reference culls only costs time, and is reported as a rate.
+// - Frustum planes are extracted from the single precision clip matrix and the corners are
+//   unprojected through its inverse, so the two disagree slightly, most at the far plane. Boxes
+//   within SC_BENCH_CULL_TOLERANCE of touching the frustum, relative to its coordinates, may be
+//   culled without counting as false negatives. Near planes are kept at viewer-like distances,
+//   much closer ones lose the far plane to precision.
+// - Frusta come from sc_perspective_camera_new with random poses and lenses. Boxes are spread
+//   around the camera to beyond the far plane, so inside, outside and straddling are all common.
+
+#define SC_BENCH_FRUSTUM_COUNT 64
+#define SC_BENCH_CULL_TOLERANCE 1e-4
+
+// Baseline: every box corner against every plane, then every frustum corner against every box
+// slab.
+static bool sc_bench_cull_corners(const ScFrustum* frustum, box3f box) {
+    for (uint32_t i = 0; i < SC_FRUSTUM_PLANE_COUNT; i++) {
+        const vec4f plane = vec4f_from_plane3f(frustum->planes[i]);
+        uint32_t count = 0;
+        for (uint32_t corner = 0; corner < 8; corner++) {
+            const vec4f c = vec4f_new(
+                corner & 1 ? box.mx.x : box.mn.x,
+                corner & 2 ? box.mx.y : box.mn.y,
+                corner & 4 ? box.mx.z : box.mn.z,
+                1.0f
+            );
+            count += vec4f_dot(plane, c) < 0.0f ? 1 : 0;
+        }
+        if (count == 8) {
+            return false;
+        }
+    }
+    for (uint32_t c = 0; c < 3; c++) {
+        uint32_t above_count = 0;
+        uint32_t below_count = 0;
+        for (uint32_t corner = 0; corner < SC_FRUSTUM_CORNER_COUNT; corner++) {
+            const float v = (&frustum->corners[corner].x)[c];
+            above_count += v > (&box.mx.x)[c] ? 1 : 0;
+            below_count += v < (&box.mn.x)[c] ? 1 : 0;
+        }
+        if (above_count == SC_FRUSTUM_CORNER_COUNT || below_count == SC_FRUSTUM_CORNER_COUNT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sc_bench_cull_planes_scalar(const ScFrustum* frustum, box3f box) {
+    return !sc_frustum_test_box_scalar(frustum, box, NULL);
+}
+
+static bool sc_bench_cull_classify(const ScFrustum* frustum, box3f box) {
+    return sc_frustum_classify_box(frustum, box) != SC_FRUSTUM_SIDE_OUTSIDE;
+}
+
+typedef enum ScBenchCullVariant {
+    SC_BENCH_CULL_VARIANT_CORNERS,
+    SC_BENCH_CULL_VARIANT_PLANES_SCALAR,
+    SC_BENCH_CULL_VARIANT_PLANES,
+    SC_BENCH_CULL_VARIANT_TIGHT,
+    SC_BENCH_CULL_VARIANT_CLASSIFY,
+    SC_BENCH_CULL_VARIANT_COUNT,
+} ScBenchCullVariant;
+
+static const char* SC_BENCH_CULL_VARIANT_NAME[] = {
+    "corners",
+    "planes_scalar",
+    "planes",
+    "tight",
+    "classify",
+};
+
+typedef bool (*ScBenchCullFn)(const ScFrustum*, box3f);
+
+static const ScBenchCullFn SC_BENCH_CULL[] = {
+    sc_bench_cull_corners,
+    sc_bench_cull_planes_scalar,
+    sc_frustum_intersects_box_planes,
+    sc_frustum_intersects_box,
+    sc_bench_cull_classify,
+};
+
+static void sc_bench_cull_project(
+    const double points[8][3],
+    const double axis[3],
+    double* out_min,
+    double* out_max
+) {
+    *out_min = DBL_MAX;
+    *out_max = -DBL_MAX;
+    for (uint32_t i = 0; i < 8; i++) {
+        const double d = points[i][0] * axis[0] + points[i][1] * axis[1] + points[i][2] * axis[2];
+        *out_min = SDL_min(*out_min, d);
+        *out_max = SDL_max(*out_max, d);
+    }
+}
+
+// Reference: exact separating axis test between two convex polyhedra. Candidate axes are the
+// box normals and the cross products of all edge direction pairs, which include the frustum
+// face normals. Overlaps up to tolerance along an axis count as separated.
+static bool sc_bench_cull_reference(const ScFrustum* frustum, box3f box, double tolerance) {
+    // Vertices.
+    double frustum_points[8][3];
+    double box_points[8][3];
+    for (uint32_t i = 0; i < 8; i++) {
+        frustum_points[i][0] = (double)frustum->corners[i].x;
+        frustum_points[i][1] = (double)frustum->corners[i].y;
+        frustum_points[i][2] = (double)frustum->corners[i].z;
+        box_points[i][0] = (double)(i & 1 ? box.mx.x : box.mn.x);
+        box_points[i][1] = (double)(i & 2 ? box.mx.y : box.mn.y);
+        box_points[i][2] = (double)(i & 4 ? box.mx.z : box.mn.z);
+    }
+
+    // Edge directions: box axes, then frustum near edges and side edges.
+    double edges[9][3] = {{1.0, 0.0, 0.0}, {0.0, 1.0, 0.0}, {0.0, 0.0, 1.0}};
+    const uint32_t edge_corners[6][2] = {
+        {SC_FRUSTUM_CORNER_LBN, SC_FRUSTUM_CORNER_RBN},
+        {SC_FRUSTUM_CORNER_LBN, SC_FRUSTUM_CORNER_LTN},
+        {SC_FRUSTUM_CORNER_LBN, SC_FRUSTUM_CORNER_LBF},
+        {SC_FRUSTUM_CORNER_RBN, SC_FRUSTUM_CORNER_RBF},
+        {SC_FRUSTUM_CORNER_LTN, SC_FRUSTUM_CORNER_LTF},
+        {SC_FRUSTUM_CORNER_RTN, SC_FRUSTUM_CORNER_RTF},
+    };
+    for (uint32_t i = 0; i < 6; i++) {
+        for (uint32_t c = 0; c < 3; c++) {
+            const double a = frustum_points[edge_corners[i][0]][c];
+            const double b = frustum_points[edge_corners[i][1]][c];
+            edges[3 + i][c] = b - a;
+        }
+    }
+
+    // Axes.
+    double axes[3 + 3 * 6 + 15][3];
+    uint32_t axis_count = 0;
+    for (uint32_t i = 0; i < 3; i++) {
+        memcpy(axes[axis_count++], edges[i], sizeof(edges[i]));
+    }
+    for (uint32_t i = 0; i < 9; i++) {
+        for (uint32_t j = SDL_max(i + 1, 3); j < 9; j++) {
+            const double* a = edges[i];
+            const double* b = edges[j];
+            double* axis = axes[axis_count++];
+            axis[0] = a[1] * b[2] - a[2] * b[1];
+            axis[1] = a[2] * b[0] - a[0] * b[2];
+            axis[2] = a[0] * b[1] - a[1] * b[0];
+        }
+    }
+    SC_ASSERT(axis_count == SC_COUNTOF(axes));
+
+    // Separation.
+    for (uint32_t i = 0; i < axis_count; i++) {
+        const double* axis = axes[i];
+        if (axis[0] == 0.0 && axis[1] == 0.0 && axis[2] == 0.0) {
+            continue;
+        }
+        double frustum_min, frustum_max, box_min, box_max;
+        sc_bench_cull_project(frustum_points, axis, &frustum_min, &frustum_max);
+        sc_bench_cull_project(box_points, axis, &box_min, &box_max);
+        const double overlap_min =
+            tolerance * sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+        if (frustum_max - box_min < overlap_min || box_max - frustum_min < overlap_min) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void sc_bench_cull_run(
+    ScBenchCullFn cull,
+    const ScFrustum* frusta,
+    const box3f* boxes,
+    uint32_t box_count,
+    uint8_t* out
+) {
+    for (uint32_t f = 0; f < SC_BENCH_FRUSTUM_COUNT; f++) {
+        const ScFrustum* frustum = &frusta[f];
+        for (uint32_t b = 0; b < box_count; b++) {
+            const uint32_t i = f * box_count + b;
+            out[i] = cull(frustum, boxes[i]) ? 1 : 0;
+        }
+    }
+}
+
+static vec3f sc_bench_rng_direction(ScBenchRng* rng) {
+    vec3f direction = {0.0f, 0.0f, 0.0f};
+    while (vec3f_len(direction) < 0.01f || vec3f_len(direction) > 1.0f) {
+        direction = (vec3f) {
+            sc_bench_rng_f32(rng, -1.0f, 1.0f),
+            sc_bench_rng_f32(rng, -1.0f, 1.0f),
+            sc_bench_rng_f32(rng, -1.0f, 1.0f),
+        };
+    }
+    return vec3f_normalize(direction);
+}
+
+static bool sc_bench_cull(ScBenchRng* rng, uint32_t count) {
+    // Inputs, the boxes are split evenly over the frusta.
+    const uint32_t box_count = SDL_max(count / SC_BENCH_FRUSTUM_COUNT, 1);
+    const uint32_t total_count = SC_BENCH_FRUSTUM_COUNT * box_count;
+    ScFrustum* frusta = malloc(SC_BENCH_FRUSTUM_COUNT * sizeof(ScFrustum));
+    box3f* boxes = malloc(total_count * sizeof(box3f));
+    for (uint32_t f = 0; f < SC_BENCH_FRUSTUM_COUNT; f++) {
+        // Camera, never looking straight up or down.
+        const vec3f world_position = {
+            sc_bench_rng_f32(rng, -1024.0f, 1024.0f),
+            sc_bench_rng_f32(rng, -1024.0f, 1024.0f),
+            sc_bench_rng_f32(rng, -1024.0f, 1024.0f),
+        };
+        vec3f forward = sc_bench_rng_direction(rng);
+        while (SDL_fabsf(forward.z) > 0.95f) {
+            forward = sc_bench_rng_direction(rng);
+        }
+        const float clip_distance_near = sc_bench_rng_f32(rng, 1.0f, 16.0f);
+        const float clip_distance_far = sc_bench_rng_f32(rng, 256.0f, 4096.0f);
+        const ScPerspectiveCamera camera = sc_perspective_camera_new(
+            &(ScPerspectiveCameraCreateInfo) {
+                .screen_width = sc_bench_rng_f32(rng, 320.0f, 3840.0f),
+                .screen_height = sc_bench_rng_f32(rng, 240.0f, 2160.0f),
+                .field_of_view = rad_from_deg(sc_bench_rng_f32(rng, 20.0f, 110.0f)),
+                .clip_distance_near = clip_distance_near,
+                .clip_distance_far = clip_distance_far,
+                .world_position = world_position,
+                .world_target = vec3f_add(world_position, forward),
+                .world_up = (vec3f) {0.0f, 0.0f, 1.0f},
+            }
+        );
+        frusta[f] = camera.frustum;
+
+        // Boxes, from a quarter unit to hundreds of units across. Every other box is aimed
+        // roughly down the view direction, otherwise most would be outside.
+        for (uint32_t b = 0; b < box_count; b++) {
+            const float distance = sc_bench_rng_f32(rng, 0.0f, 1.25f * clip_distance_far);
+            const vec3f random_direction = sc_bench_rng_direction(rng);
+            const vec3f direction =
+                b % 2 == 0
+                    ? random_direction
+                    : vec3f_normalize(vec3f_add(forward, vec3f_scale(random_direction, 0.5f)));
+            const vec3f center = vec3f_add(world_position, vec3f_scale(direction, distance));
+            const vec3f extents = {
+                exp2f(sc_bench_rng_f32(rng, -2.0f, 8.0f)),
+                exp2f(sc_bench_rng_f32(rng, -2.0f, 8.0f)),
+                exp2f(sc_bench_rng_f32(rng, -2.0f, 8.0f)),
+            };
+            boxes[f * box_count + b] = (box3f) {
+                .mn = vec3f_sub(center, extents),
+                .mx = vec3f_add(center, extents),
+            };
+        }
+    }
+
+    // Reference, exact and with tolerance.
+    uint8_t* reference = malloc(total_count);
+    uint8_t* reference_tolerant = malloc(total_count);
+    uint32_t reference_culled_count = 0;
+    for (uint32_t f = 0; f < SC_BENCH_FRUSTUM_COUNT; f++) {
+        float coordinate_max = 0.0f;
+        for (uint32_t c = 0; c < SC_FRUSTUM_CORNER_COUNT; c++) {
+            const vec3f corner = frusta[f].corners[c];
+            coordinate_max = SDL_max(coordinate_max, SDL_fabsf(corner.x));
+            coordinate_max = SDL_max(coordinate_max, SDL_fabsf(corner.y));
+            coordinate_max = SDL_max(coordinate_max, SDL_fabsf(corner.z));
+        }
+        const double tolerance = SC_BENCH_CULL_TOLERANCE * (double)coordinate_max;
+        for (uint32_t b = 0; b < box_count; b++) {
+            const uint32_t i = f * box_count + b;
+            reference[i] = sc_bench_cull_reference(&frusta[f], boxes[i], 0.0) ? 1 : 0;
+            reference_tolerant[i] =
+                sc_bench_cull_reference(&frusta[f], boxes[i], tolerance) ? 1 : 0;
+            reference_culled_count += reference[i] ? 0 : 1;
+        }
+    }
+    SC_LOG_INFO(
+        "frustum_intersects_box: %u frusta, %.1f%% of boxes outside",
+        SC_BENCH_FRUSTUM_COUNT,
+        100.0 * (double)reference_culled_count / (double)total_count
+    );
+
+    // Run.
+    bool ok = true;
+    uint8_t* out = malloc(total_count);
+    for (uint32_t v = 0; v < SC_BENCH_CULL_VARIANT_COUNT; v++) {
+        ScBenchResult result = {0};
+        SC_BENCH_TIME(
+            result.best_time_ns,
+            sc_bench_cull_run(SC_BENCH_CULL[v], frusta, boxes, box_count, out)
+        );
+
+        // No false negatives, false positives are measured.
+        uint32_t false_negative_count = 0;
+        uint32_t false_positive_count = 0;
+        for (uint32_t i = 0; i < total_count; i++) {
+            false_negative_count += reference_tolerant[i] && !out[i] ? 1 : 0;
+            false_positive_count += !reference[i] && out[i] ? 1 : 0;
+        }
+        result.matches_reference = false_negative_count == 0;
+        ok &= result.matches_reference;
+        const char* name = SC_BENCH_CULL_VARIANT_NAME[v];
+        sc_bench_report("frustum_intersects_box", name, result, total_count);
+        SC_LOG_INFO(
+            "frustum_intersects_box: %s false negatives %u, false positives %.2f%% of outside",
+            name,
+            false_negative_count,
+            reference_culled_count > 0
+                ? 100.0 * (double)false_positive_count / (double)reference_culled_count
+                : 0.0
+        );
+    }
+
+    // Free.
+    free(frusta);
+    free(boxes);
+    free(reference);
+    free(reference_tolerant);
+    free(out);
+    return ok;
+}
+
+//
+// Space-filling curves
+//
+
+typedef enum ScBenchKeyVariant {
+    SC_BENCH_KEY_VARIANT_LUT,
+    SC_BENCH_KEY_VARIANT_BMI2,
+    SC_BENCH_KEY_VARIANT_AVX2,
+    SC_BENCH_KEY_VARIANT_COUNT,
+} ScBenchKeyVariant;
+
+static const char* SC_BENCH_KEY_VARIANT_NAME[] = {
+    "lut",
+    "bmi2",
+    "avx2",
+};
+
+typedef void (*ScBenchEncode30Fn)(
+    const uint32_t*,
+    const uint32_t*,
+    const uint32_t*,
+    uint32_t*,
+    uint32_t
+);
+typedef void (*ScBenchEncode63Fn)(
+    const uint32_t*,
+    const uint32_t*,
+    const uint32_t*,
+    uint64_t*,
+    uint32_t
+);
+typedef void (*ScBenchDecode30Fn)(const uint32_t*, uint32_t*, uint32_t*, uint32_t*, uint32_t);
+typedef void (*ScBenchDecode63Fn)(const uint64_t*, uint32_t*, uint32_t*, uint32_t*, uint32_t);
+
+// Null when the variant is not enabled at compile time.
+#if defined(SC_SIMD_BMI2)
+    #define SC_BENCH_KEY_BMI2(fn) fn##_bmi2
+#else
+    #define SC_BENCH_KEY_BMI2(fn) NULL
+#endif
+#if defined(SC_SIMD_AVX2)
+    #define SC_BENCH_KEY_AVX2(fn) fn##_avx2
+#else
+    #define SC_BENCH_KEY_AVX2(fn) NULL
+#endif
+
+static const ScBenchEncode30Fn SC_BENCH_MORTON3_ENCODE30[] = {
+    morton3_encode30_batch_lut,
+    SC_BENCH_KEY_BMI2(morton3_encode30_batch),
+    SC_BENCH_KEY_AVX2(morton3_encode30_batch),
+};
+
+static const ScBenchEncode63Fn SC_BENCH_MORTON3_ENCODE63[] = {
+    morton3_encode63_batch_lut,
+    SC_BENCH_KEY_BMI2(morton3_encode63_batch),
+    SC_BENCH_KEY_AVX2(morton3_encode63_batch),
+};
+
+static const ScBenchDecode30Fn SC_BENCH_MORTON3_DECODE30[] = {
+    morton3_decode30_batch_lut,
+    SC_BENCH_KEY_BMI2(morton3_decode30_batch),
+    SC_BENCH_KEY_AVX2(morton3_decode30_batch),
+};
+
+static const ScBenchDecode63Fn SC_BENCH_MORTON3_DECODE63[] = {
+    morton3_decode63_batch_lut,
+    SC_BENCH_KEY_BMI2(morton3_decode63_batch),
+    SC_BENCH_KEY_AVX2(morton3_decode63_batch),
+};
+
+// Reference: one bit at a time.
+static uint64_t sc_bench_morton3_reference(uint32_t x, uint32_t y, uint32_t z, uint32_t bit_count) {
+    uint64_t mc = 0;
+    for (uint32_t bit = 0; bit < bit_count; bit++) {
+        mc |= (uint64_t)((x >> bit) & 1) << (3 * bit + 0);
+        mc |= (uint64_t)((y >> bit) & 1) << (3 * bit + 1);
+        mc |= (uint64_t)((z >> bit) & 1) << (3 * bit + 2);
+    }
+    return mc;
+}
+
+static bool sc_bench_axes_match(
+    const uint32_t* const axes[3],
+    const uint32_t* const out[3],
+    uint32_t mask,
+    uint32_t count
+) {
+    for (uint32_t c = 0; c < 3; c++) {
+        for (uint32_t i = 0; i < count; i++) {
+            if ((axes[c][i] & mask) != out[c][i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool sc_bench_morton(ScBenchRng* rng, uint32_t count) {
+    // Inputs, including bits above the per-axis width which must be ignored.
+    uint32_t* axes[3];
+    for (uint32_t c = 0; c < 3; c++) {
+        axes[c] = malloc(count * sizeof(uint32_t));
+        for (uint32_t i = 0; i < count; i++) {
+            axes[c][i] = sc_bench_rng_u32(rng);
+        }
+    }
+    uint32_t* reference30 = malloc(count * sizeof(uint32_t));
+    uint64_t* reference63 = malloc(count * sizeof(uint64_t));
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t x = axes[0][i];
+        const uint32_t y = axes[1][i];
+        const uint32_t z = axes[2][i];
+        reference30[i] = (uint32_t)sc_bench_morton3_reference(x, y, z, 10);
+        reference63[i] = sc_bench_morton3_reference(x, y, z, 21);
+    }
+
+    // Outputs.
+    uint32_t* out30 = calloc(count, sizeof(uint32_t));
+    uint64_t* out63 = calloc(count, sizeof(uint64_t));
+    uint32_t* out_axes[3];
+    for (uint32_t c = 0; c < 3; c++) {
+        out_axes[c] = calloc(count, sizeof(uint32_t));
+    }
+
+    // Run.
+    bool ok = true;
+    const uint32_t* const* in = (const uint32_t* const*)axes;
+    uint32_t* const* o = out_axes;
+    for (uint32_t v = 0; v < SC_BENCH_KEY_VARIANT_COUNT; v++) {
+        if (SC_BENCH_MORTON3_ENCODE30[v] == NULL) {
+            continue;
+        }
+        const char* name = SC_BENCH_KEY_VARIANT_NAME[v];
+        ScBenchResult result = {0};
+
+        // Encode 30.
+        SC_BENCH_TIME(
+            result.best_time_ns,
+            SC_BENCH_MORTON3_ENCODE30[v](in[0], in[1], in[2], out30, count)
+        );
+        result.matches_reference = memcmp(out30, reference30, count * sizeof(uint32_t)) == 0;
+        ok &= result.matches_reference;
+        sc_bench_report("morton3_encode30_batch", name, result, count);
+
+        // Decode 30.
+        SC_BENCH_TIME(
+            result.best_time_ns,
+            SC_BENCH_MORTON3_DECODE30[v](reference30, o[0], o[1], o[2], count)
+        );
+        result.matches_reference =
+            sc_bench_axes_match(in, (const uint32_t* const*)o, 0x3ff, count);
+        ok &= result.matches_reference;
+        sc_bench_report("morton3_decode30_batch", name, result, count);
+
+        // Encode 63.
+        SC_BENCH_TIME(
+            result.best_time_ns,
+            SC_BENCH_MORTON3_ENCODE63[v](in[0], in[1], in[2], out63, count)
+        );
+        result.matches_reference = memcmp(out63, reference63, count * sizeof(uint64_t)) == 0;
+        ok &= result.matches_reference;
+        sc_bench_report("morton3_encode63_batch", name, result, count);
+
+        // Decode 63.
+        SC_BENCH_TIME(
+            result.best_time_ns,
+            SC_BENCH_MORTON3_DECODE63[v](reference63, o[0], o[1], o[2], count)
+        );
+        result.matches_reference =
+            sc_bench_axes_match(in, (const uint32_t* const*)o, 0x1fffff, count);
+        ok &= result.matches_reference;
+        sc_bench_report("morton3_decode63_batch", name, result, count);
+    }
+
+    // Free.
+    for (uint32_t c = 0; c < 3; c++) {
+        free(axes[c]);
+        free(out_axes[c]);
+    }
+    free(reference30);
+    free(reference63);
+    free(out30);
+    free(out63);
+    return ok;
+}
+
+// Consecutive codes must decode to face-adjacent cells.
+static bool sc_bench_hilbert_adjacent(const uint32_t* const axes[3], uint32_t count) {
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t distance = 0;
+        for (uint32_t c = 0; c < 3; c++) {
+            const uint32_t a = axes[c][i - 1];
+            const uint32_t b = axes[c][i];
+            distance += a > b ? a - b : b - a;
+        }
+        if (distance != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sc_bench_hilbert(ScBenchRng* rng, uint32_t count) {
+    // Inputs.
+    uint32_t* axes[3];
+    for (uint32_t c = 0; c < 3; c++) {
+        axes[c] = malloc(count * sizeof(uint32_t));
+        for (uint32_t i = 0; i < count; i++) {
+            axes[c][i] = sc_bench_rng_u32(rng) & 0x3ff;
+        }
+    }
+
+    // Consecutive codes starting from a random offset.
+    uint32_t* walk30 = malloc(count * sizeof(uint32_t));
+    uint64_t* walk63 = malloc(count * sizeof(uint64_t));
+    const uint32_t base30 = sc_bench_rng_u32(rng) & 0x1fffffff;
+    const uint64_t base63 = ((uint64_t)sc_bench_rng_u32(rng) << 30) | sc_bench_rng_u32(rng);
+    for (uint32_t i = 0; i < count; i++) {
+        walk30[i] = (base30 + i) & 0x3fffffff;
+        walk63[i] = base63 + i;
+    }
+
+    // Outputs.
+    uint32_t* out30 = calloc(count, sizeof(uint32_t));
+    uint64_t* out63 = calloc(count, sizeof(uint64_t));
+    uint32_t* out_axes[3];
+    for (uint32_t c = 0; c < 3; c++) {
+        out_axes[c] = calloc(count, sizeof(uint32_t));
+    }
+
+    // Run.
+#if defined(SC_SIMD_BMI2)
+    const char* name = SC_BENCH_KEY_VARIANT_NAME[SC_BENCH_KEY_VARIANT_BMI2];
+#else
+    const char* name = SC_BENCH_KEY_VARIANT_NAME[SC_BENCH_KEY_VARIANT_LUT];
+#endif
+    bool ok = true;
+    const uint32_t* const* in = (const uint32_t* const*)axes;
+    const uint32_t* const* out = (const uint32_t* const*)out_axes;
+    uint32_t* const* o = out_axes;
+    ScBenchResult result = {0};
+
+    // Encode 30, checked by round trip.
+    SC_BENCH_TIME(result.best_time_ns, hilbert3_encode30_batch(in[0], in[1], in[2], out30, count));
+    hilbert3_decode30_batch(out30, o[0], o[1], o[2], count);
+    result.matches_reference = sc_bench_axes_match(in, out, 0x3ff, count);
+    ok &= result.matches_reference;
+    sc_bench_report("hilbert3_encode30_batch", name, result, count);
+
+    // Decode 30, checked by adjacency.
+    SC_BENCH_TIME(result.best_time_ns, hilbert3_decode30_batch(walk30, o[0], o[1], o[2], count));
+    result.matches_reference = sc_bench_hilbert_adjacent(out, count);
+    ok &= result.matches_reference;
+    sc_bench_report("hilbert3_decode30_batch", name, result, count);
+
+    // Encode 63, checked by round trip.
+    SC_BENCH_TIME(result.best_time_ns, hilbert3_encode63_batch(in[0], in[1], in[2], out63, count));
+    hilbert3_decode63_batch(out63, o[0], o[1], o[2], count);
+    result.matches_reference = sc_bench_axes_match(in, out, 0x1fffff, count);
+    ok &= result.matches_reference;
+    sc_bench_report("hilbert3_encode63_batch", name, result, count);
+
+    // Decode 63, checked by adjacency.
+    SC_BENCH_TIME(result.best_time_ns, hilbert3_decode63_batch(walk63, o[0], o[1], o[2], count));
+    result.matches_reference = sc_bench_hilbert_adjacent(out, count);
+    ok &= result.matches_reference;
+    sc_bench_report("hilbert3_decode63_batch", name, result, count);
+
+    // Free.
+    for (uint32_t c = 0; c < 3; c++) {
+        free(axes[c]);
+        free(out_axes[c]);
+    }
+    free(walk30);
+    free(walk63);
+    free(out30);
+    free(out63);
+    return ok;
+}
+
+#define SC_BENCH_INSERT_BATCH_COUNT 65536
+
+// Rebuilds a live octree from scratch, inserting in batches like a streaming source would.
+static uint64_t sc_bench_insert_run(
+    ScOctree* octree,
+    const vec3f* positions,
+    const uint32_t* colors,
+    uint32_t count
+) {
+    sc_octree_free(octree);
+    sc_octree_live_new(octree, (box3f) {.mn = {-1.0f, -1.0f, -1.0f}, .mx = {1.0f, 1.0f, 1.0f}});
+    uint64_t inserted_count = 0;
+    for (uint32_t begin = 0; begin < count; begin += SC_BENCH_INSERT_BATCH_COUNT) {
+        const uint32_t batch_count = SDL_min(count - begin, SC_BENCH_INSERT_BATCH_COUNT);
+        inserted_count += sc_octree_insert(octree, positions + begin, colors + begin, batch_count);
+        sc_octree_live_dirty_clear(octree);
+    }
+    return inserted_count;
+}
+
+static bool sc_bench_insert(ScBenchRng* rng, uint32_t count) {
+    // Inputs, points on a sphere like a scanned surface.
+    vec3f* positions = malloc(count * sizeof(vec3f));
+    uint32_t* colors = malloc(count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        vec3f direction = {0.0f, 0.0f, 0.0f};
+        while (vec3f_len(direction) < 0.01f) {
+            direction = (vec3f) {
+                sc_bench_rng_f32(rng, -1.0f, 1.0f),
+                sc_bench_rng_f32(rng, -1.0f, 1.0f),
+                sc_bench_rng_f32(rng, -1.0f, 1.0f),
+            };
+        }
+        positions[i] = vec3f_scale(vec3f_normalize(direction), 0.9f);
+        colors[i] = sc_bench_rng_u32(rng);
+    }
+
+    // Run.
+    ScOctree octree = {0};
+    uint64_t inserted_count = 0;
+    ScBenchResult result = {0};
+    SC_BENCH_TIME(
+        result.best_time_ns,
+        inserted_count = sc_bench_insert_run(&octree, positions, colors, count)
+    );
+
+    // Every inserted point is in exactly one leaf, interior nodes hold copies.
+    uint64_t leaf_point_count = 0;
+    for (uint64_t node_idx = 0; node_idx < octree.node_count; node_idx++) {
+        const ScOctreeNode* node = &octree.nodes[node_idx];
+        leaf_point_count += node->level == 0 ? node->point_count : 0;
+    }
+    result.matches_reference = inserted_count == count && leaf_point_count == count;
+    sc_bench_report("octree_insert", SC_BENCH_VARIANT_NAME[SC_BENCH_VARIANT_SCALAR], result, count);
+    SC_LOG_INFO(
+        "octree_insert: %" PRIu64 " nodes, %" PRIu64 " points with subsamples",
+        octree.node_count,
+        octree.point_count
+    );
+
+    // Free.
+    sc_octree_free(&octree);
+    free(positions);
+    free(colors);
+    return result.matches_reference;
+}
+
+//
+// Multi-view traversal
+//
+
+// Notes:
+// - One traversal shared by several views is compared with separate traversals, one per view,
+//   on the live octree of the insertion benchmark.
+// - The shared cut must cover every node of the separate cuts which really intersects its view,
+//   by the reference of the culling benchmark: either the node itself or some of its descendants
+//   are drawn. Nodes kept by the looser single-view culling alone are not required.
+
+#define SC_BENCH_VIEW_LOD_BIAS 64.0f
+
+typedef enum ScBenchViewLayout {
+    SC_BENCH_VIEW_LAYOUT_SINGLE,
+    SC_BENCH_VIEW_LAYOUT_STEREO,
+    SC_BENCH_VIEW_LAYOUT_QUAD,
+    SC_BENCH_VIEW_LAYOUT_COUNT,
+} ScBenchViewLayout;
+
+static const char* SC_BENCH_VIEW_LAYOUT_NAME[] = {
+    "single",
+    "stereo",
+    "quad",
+};
+
+static const uint32_t SC_BENCH_VIEW_LAYOUT_VIEW_COUNT[] = {1, 2, 4};
+
+static ScPerspectiveCamera
+sc_bench_view_camera(vec3f world_position, vec3f world_target, float screen_width) {
+    return sc_perspective_camera_new(&(ScPerspectiveCameraCreateInfo) {
+        .screen_width = screen_width,
+        .screen_height = 1200.0f,
+        .field_of_view = rad_from_deg(60.0f),
+        .clip_distance_near = 0.01f,
+        .clip_distance_far = 8.0f,
+        .world_position = world_position,
+        .world_target = world_target,
+        .world_up = (vec3f) {0.0f, 0.0f, 1.0f},
+    });
+}
+
+static void sc_bench_view_cameras(ScBenchViewLayout layout, ScPerspectiveCamera* cameras) {
+    const vec3f position = {1.6f, 0.4f, 0.3f};
+    const vec3f target = {0.0f, 0.0f, 0.0f};
+    switch (layout) {
+        case SC_BENCH_VIEW_LAYOUT_SINGLE:
+            cameras[0] = sc_bench_view_camera(position, target, 1920.0f);
+            break;
+        case SC_BENCH_VIEW_LAYOUT_STEREO: {
+            const ScPerspectiveCamera center = sc_bench_view_camera(position, target, 960.0f);
+            for (uint32_t i = 0; i < 2; i++) {
+                const vec3f offset = vec3f_scale(center.world_right, i == 0 ? -0.01f : 0.01f);
+                cameras[i] = sc_bench_view_camera(
+                    vec3f_add(position, offset),
+                    vec3f_add(vec3f_add(position, offset), center.world_forward),
+                    960.0f
+                );
+            }
+            break;
+        }
+        case SC_BENCH_VIEW_LAYOUT_QUAD: {
+            // Quarter turns around the center.
+            vec3f quad_position = position;
+            for (uint32_t i = 0; i < 4; i++) {
+                cameras[i] = sc_bench_view_camera(quad_position, target, 960.0f);
+                quad_position = (vec3f) {-quad_position.y, quad_position.x, quad_position.z};
+            }
+            break;
+        }
+        default: break;
+    }
+}
+
+static void sc_bench_view_traverse(
+    const ScOctree* octree,
+    const ScPerspectiveCamera* cameras,
+    uint32_t camera_count,
+    ScOctreeTraversal* traversal
+) {
+    free(traversal->node_traverse);
+    sc_octree_traverse(
+        octree,
+        &(ScOctreeTraverseInfo) {
+            .arena = NULL,
+            .cameras = cameras,
+            .camera_count = camera_count,
+            .lod_bias = SC_BENCH_VIEW_LOD_BIAS,
+        },
+        traversal
+    );
+}
+
+// Whether the node or some of its descendants are marked.
+static bool sc_bench_view_covered(const ScOctree* octree, const uint8_t* marks, uint32_t node_idx) {
+    if (marks[node_idx]) {
+        return true;
+    }
+    const ScOctreeNode* node = &octree->nodes[node_idx];
+    for (uint32_t i = 0; i < 8; i++) {
+        if (node->octants[i] != ~0u && sc_bench_view_covered(octree, marks, node->octants[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool sc_bench_views(ScBenchRng* rng, uint32_t count) {
+    // Octree, points on a sphere like the insertion benchmark.
+    vec3f* positions = malloc(count * sizeof(vec3f));
+    uint32_t* colors = malloc(count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        positions[i] = vec3f_scale(sc_bench_rng_direction(rng), 0.9f);
+        colors[i] = sc_bench_rng_u32(rng);
+    }
+    ScOctree octree = {0};
+    sc_bench_insert_run(&octree, positions, colors, count);
+    uint8_t* marks = calloc(octree.node_count, 1);
+
+    // Run.
+    bool ok = true;
+    for (uint32_t l = 0; l < SC_BENCH_VIEW_LAYOUT_COUNT; l++) {
+        // Unpack.
+        const char* name = SC_BENCH_VIEW_LAYOUT_NAME[l];
+        const uint32_t view_count = SC_BENCH_VIEW_LAYOUT_VIEW_COUNT[l];
+        ScPerspectiveCamera cameras[4];
+        sc_bench_view_cameras((ScBenchViewLayout)l, cameras);
+
+        // Shared.
+        ScOctreeTraversal shared = {0};
+        ScBenchResult result = {0};
+        SC_BENCH_TIME(
+            result.best_time_ns,
+            sc_bench_view_traverse(&octree, cameras, view_count, &shared)
+        );
+
+        // Separate.
+        ScOctreeTraversal separate[4] = {0};
+        uint64_t separate_time_ns = 0;
+        for (uint32_t v = 0; v < view_count; v++) {
+            uint64_t best_time_ns = 0;
+            SC_BENCH_TIME(
+                best_time_ns,
+                sc_bench_view_traverse(&octree, &cameras[v], 1, &separate[v])
+            );
+            separate_time_ns += best_time_ns;
+        }
+
+        // Coverage.
+        memset(marks, 0, octree.node_count);
+        for (uint32_t i = 0; i < shared.node_traverse_count; i++) {
+            marks[shared.node_traverse[i]] = 1;
+        }
+        uint32_t uncovered_count = 0;
+        uint32_t separate_node_count = 0;
+        for (uint32_t v = 0; v < view_count; v++) {
+            const ScFrustum* frustum = &cameras[v].frustum;
+            float coordinate_max = 0.0f;
+            for (uint32_t c = 0; c < SC_FRUSTUM_CORNER_COUNT; c++) {
+                const vec3f corner = frustum->corners[c];
+                coordinate_max = SDL_max(coordinate_max, SDL_fabsf(corner.x));
+                coordinate_max = SDL_max(coordinate_max, SDL_fabsf(corner.y));
+                coordinate_max = SDL_max(coordinate_max, SDL_fabsf(corner.z));
+            }
+            const double tolerance = SC_BENCH_CULL_TOLERANCE * (double)coordinate_max;
+            for (uint32_t i = 0; i < separate[v].node_traverse_count; i++) {
+                const uint32_t node_idx = separate[v].node_traverse[i];
+                const box3f bounds = sc_octree_node_bounds(&octree, node_idx);
+                if (sc_bench_cull_reference(frustum, bounds, tolerance)
+                    && !sc_bench_view_covered(&octree, marks, node_idx)) {
+                    uncovered_count++;
+                }
+            }
+            separate_node_count += separate[v].node_traverse_count;
+        }
+        result.matches_reference = uncovered_count == 0;
+        ok &= result.matches_reference;
+        sc_bench_report("octree_traverse_views", name, result, view_count);
+        SC_LOG_INFO(
+            "octree_traverse_views: %s %u views, shared %.3f ms %u nodes, separate %.3f ms %u "
+            "nodes, %u uncovered",
+            name,
+            view_count,
+            (double)result.best_time_ns / 1e6,
+            shared.node_traverse_count,
+            (double)separate_time_ns / 1e6,
+            separate_node_count,
+            uncovered_count
+        );
+
+        // Free.
+        free(shared.node_traverse);
+        for (uint32_t v = 0; v < view_count; v++) {
+            free(separate[v].node_traverse);
+        }
+    }
+
+    // Free.
+    sc_octree_free(&octree);
+    free(positions);
+    free(colors);
+    free(marks);
+    return ok;
+}
+
+//
+// Stormcloud Bench - Main.
+//
+
+SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
+    // Arguments.
+    SC_UNUSED(appstate);
+    const uint32_t count = argc > 1 ? (uint32_t)atoi(argv[1]) : SC_BENCH_DEFAULT_ELEMENT_COUNT;
+    if (count == 0) {
+        SC_LOG_ERROR("Usage: %s [element_count]", argv[0]);
+        return SDL_APP_FAILURE;
+    }
+    SC_LOG_INFO("Elements: %u, repeats: %u", count, SC_BENCH_REPEAT_COUNT);
+
+    // Kernels.
+    ScBenchRng rng = {.state = 0x9e3779b97f4a7c15ull};
+    bool ok = true;
+    ok &= sc_bench_transform(&rng, count);
+    ok &= sc_bench_classify(&rng, count);
+    ok &= sc_bench_sphere_project(&rng, count);
+    ok &= sc_bench_decode(&rng, count);
+    ok &= sc_bench_cull(&rng, count);
+    ok &= sc_bench_morton(&rng, count);
+    ok &= sc_bench_hilbert(&rng, count);
+    ok &= sc_bench_insert(&rng, count);
+    ok &= sc_bench_views(&rng, count);
+
+    if (!ok) {
+        SC_LOG_ERROR("Validation failed");
+        return SDL_APP_FAILURE;
+    }
+    return SDL_APP_SUCCESS;
+}
+
+SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(event);
+    return SDL_APP_CONTINUE;
+}
+
+SDL_AppResult SDL_AppIterate(void* appstate) {
+    SC_UNUSED(appstate);
+    return SDL_APP_SUCCESS;
+}
+
+void SDL_AppQuit(void* appstate, SDL_AppResult result) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(result);
+}
@@ -7,6 +7,9 @@
 // - https://donw.io/post/frustum-point-extraction/
 // - https://iquilezles.org/articles/frustumcorrect/
 // - https://iquilezles.org/articles/sphereproj/
+// - Boxes are tested against each plane at their p-vertex, the corner furthest along the
+//   normal, and n-vertex, the corner furthest against it. Which corners those are only depends
+//   on the normal signs, so they are precomputed per frustum.
 
 typedef enum ScFrustumPlane {
     SC_FRUSTUM_PLANE_L, // -x
@@ -30,201 +33,215 @@ typedef enum ScFrustumCorner {
     SC_FRUSTUM_CORNER_COUNT,
 } ScFrustumCorner;
 
+typedef enum ScFrustumSide {
+    SC_FRUSTUM_SIDE_OUTSIDE,
+    SC_FRUSTUM_SIDE_INTERSECT,
+    SC_FRUSTUM_SIDE_INSIDE,
+    SC_FRUSTUM_SIDE_COUNT,
+} ScFrustumSide;
+
 typedef struct ScFrustum {
     plane3f planes[SC_FRUSTUM_PLANE_COUNT];
     vec3f corners[SC_FRUSTUM_CORNER_COUNT];
-} ScFrustum;
 
-static bool sc_frustum_intersects_box(const ScFrustum* frustum, box3f box) {
-    // Unpack.
-    const plane3f* frustum_planes = frustum->planes;
-    const vec3f* frustum_corners = frustum->corners;
-
-    // Box corners.
-    const vec4f box_corners[8] = {
-        (vec4f) {box.mn.x, box.mn.y, box.mn.z, 1.0f},
-        (vec4f) {box.mx.x, box.mn.y, box.mn.z, 1.0f},
-        (vec4f) {box.mn.x, box.mx.y, box.mn.z, 1.0f},
-        (vec4f) {box.mx.x, box.mx.y, box.mn.z, 1.0f},
-        (vec4f) {box.mn.x, box.mn.y, box.mx.z, 1.0f},
-        (vec4f) {box.mx.x, box.mn.y, box.mx.z, 1.0f},
-        (vec4f) {box.mn.x, box.mx.y, box.mx.z, 1.0f},
-        (vec4f) {box.mx.x, box.mx.y, box.mx.z, 1.0f},
-    };
+    // Derived by sc_frustum_precompute.
+    // Per plane, bit i set if normal component i is non-negative.
+    uint32_t plane_signs[SC_FRUSTUM_PLANE_COUNT];
+    box3f bounds;
 
-    // Init.
-    uint32_t count;
-
-    // Box outside/inside frustum - 0
-    count = 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[0]), box_corners[0]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[0]), box_corners[1]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[0]), box_corners[2]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[0]), box_corners[3]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[0]), box_corners[4]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[0]), box_corners[5]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[0]), box_corners[6]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[0]), box_corners[7]) < 0.0f) ? 1 : 0;
-    if (count == 8) {
-        return false;
-    }
+    // Planes transposed for the SIMD paths, padded with zero planes which no box is behind.
+    float plane_n_x[8];
+    float plane_n_y[8];
+    float plane_n_z[8];
+    float plane_d[8];
+} ScFrustum;
 
-    // Box outside/inside frustum - 1
-    count = 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[1]), box_corners[0]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[1]), box_corners[1]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[1]), box_corners[2]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[1]), box_corners[3]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[1]), box_corners[4]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[1]), box_corners[5]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[1]), box_corners[6]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[1]), box_corners[7]) < 0.0f) ? 1 : 0;
-    if (count == 8) {
-        return false;
+// Fills the fields derived from the planes.
+static void sc_frustum_precompute_planes(ScFrustum* frustum) {
+    for (uint32_t i = 0; i < SC_FRUSTUM_PLANE_COUNT; i++) {
+        const vec3f n = frustum->planes[i].n;
+        frustum->plane_signs[i] =
+            (n.x >= 0.0f ? 1u : 0u) | (n.y >= 0.0f ? 2u : 0u) | (n.z >= 0.0f ? 4u : 0u);
     }
-
-    // Box outside/inside frustum - 2
-    count = 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[2]), box_corners[0]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[2]), box_corners[1]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[2]), box_corners[2]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[2]), box_corners[3]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[2]), box_corners[4]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[2]), box_corners[5]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[2]), box_corners[6]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[2]), box_corners[7]) < 0.0f) ? 1 : 0;
-    if (count == 8) {
-        return false;
+    for (uint32_t i = 0; i < 8; i++) {
+        const plane3f plane =
+            i < SC_FRUSTUM_PLANE_COUNT ? frustum->planes[i] : (plane3f) {.n = {0.0f}, .d = 0.0f};
+        frustum->plane_n_x[i] = plane.n.x;
+        frustum->plane_n_y[i] = plane.n.y;
+        frustum->plane_n_z[i] = plane.n.z;
+        frustum->plane_d[i] = plane.d;
     }
+}
 
-    // Box outside/inside frustum - 3
-    count = 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[3]), box_corners[0]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[3]), box_corners[1]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[3]), box_corners[2]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[3]), box_corners[3]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[3]), box_corners[4]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[3]), box_corners[5]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[3]), box_corners[6]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[3]), box_corners[7]) < 0.0f) ? 1 : 0;
-    if (count == 8) {
-        return false;
+// Fills the derived fields, after the planes and corners are set.
+static void sc_frustum_precompute(ScFrustum* frustum) {
+    sc_frustum_precompute_planes(frustum);
+    frustum->bounds = (box3f) {.mn = frustum->corners[0], .mx = frustum->corners[0]};
+    for (uint32_t i = 1; i < SC_FRUSTUM_CORNER_COUNT; i++) {
+        frustum->bounds.mn = vec3f_min(frustum->bounds.mn, frustum->corners[i]);
+        frustum->bounds.mx = vec3f_max(frustum->bounds.mx, frustum->corners[i]);
     }
+}
 
-    // Box outside/inside frustum - 4
-    count = 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[4]), box_corners[0]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[4]), box_corners[1]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[4]), box_corners[2]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[4]), box_corners[3]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[4]), box_corners[4]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[4]), box_corners[5]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[4]), box_corners[6]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[4]), box_corners[7]) < 0.0f) ? 1 : 0;
-    if (count == 8) {
-        return false;
-    }
+// Box corner furthest along a plane normal. Selected by indexing the box as six floats, mn then
+// mx, since branching on the signs is slower.
+static SC_INLINE vec3f sc_frustum_p_vertex(uint32_t signs, const float box[6]) {
+    return (vec3f) {
+        box[0 + 3 * (signs & 1u)],
+        box[1 + 3 * ((signs >> 1) & 1u)],
+        box[2 + 3 * ((signs >> 2) & 1u)],
+    };
+}
 
-    // Box outside/inside frustum - 5
-    count = 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[5]), box_corners[0]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[5]), box_corners[1]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[5]), box_corners[2]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[5]), box_corners[3]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[5]), box_corners[4]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[5]), box_corners[5]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[5]), box_corners[6]) < 0.0f) ? 1 : 0;
-    count += (vec4f_dot(vec4f_from_plane3f(frustum_planes[5]), box_corners[7]) < 0.0f) ? 1 : 0;
-    if (count == 8) {
-        return false;
-    }
+// Box corner furthest against a plane normal.
+static SC_INLINE vec3f sc_frustum_n_vertex(uint32_t signs, const float box[6]) {
+    return sc_frustum_p_vertex(~signs, box);
+}
 
-    // Frustum outside/inside box - 0
-    count = 0;
-    count += (frustum_corners[0].x > box.mx.x) ? 1 : 0;
-    count += (frustum_corners[1].x > box.mx.x) ? 1 : 0;
-    count += (frustum_corners[2].x > box.mx.x) ? 1 : 0;
-    count += (frustum_corners[3].x > box.mx.x) ? 1 : 0;
-    count += (frustum_corners[4].x > box.mx.x) ? 1 : 0;
-    count += (frustum_corners[5].x > box.mx.x) ? 1 : 0;
-    count += (frustum_corners[6].x > box.mx.x) ? 1 : 0;
-    count += (frustum_corners[7].x > box.mx.x) ? 1 : 0;
-    if (count == 8) {
-        return false;
+// Tests the p-vertex of each plane, and the n-vertex too when out_inside is given. Returns whether
+// the box is entirely behind one of the planes. Branchless, since whether a node is culled is
+// close to random from the branch predictor's point of view.
+static SC_INLINE bool
+sc_frustum_test_box_scalar(const ScFrustum* frustum, box3f box, bool* out_inside) {
+    float box_floats[6];
+    memcpy(box_floats, &box, sizeof(box_floats));
+    bool outside = false;
+    bool inside = true;
+    for (uint32_t i = 0; i < SC_FRUSTUM_PLANE_COUNT; i++) {
+        const plane3f plane = frustum->planes[i];
+        const uint32_t signs = frustum->plane_signs[i];
+        const vec3f p = sc_frustum_p_vertex(signs, box_floats);
+        outside |= vec3f_dot(plane.n, p) + plane.d < 0.0f;
+        if (out_inside != NULL) {
+            const vec3f n = sc_frustum_n_vertex(signs, box_floats);
+            inside &= vec3f_dot(plane.n, n) + plane.d >= 0.0f;
+        }
     }
-
-    // Frustum outside/inside box - 1
-    count = 0;
-    count += (frustum_corners[0].x < box.mn.x) ? 1 : 0;
-    count += (frustum_corners[1].x < box.mn.x) ? 1 : 0;
-    count += (frustum_corners[2].x < box.mn.x) ? 1 : 0;
-    count += (frustum_corners[3].x < box.mn.x) ? 1 : 0;
-    count += (frustum_corners[4].x < box.mn.x) ? 1 : 0;
-    count += (frustum_corners[5].x < box.mn.x) ? 1 : 0;
-    count += (frustum_corners[6].x < box.mn.x) ? 1 : 0;
-    count += (frustum_corners[7].x < box.mn.x) ? 1 : 0;
-    if (count == 8) {
-        return false;
+    if (out_inside != NULL) {
+        *out_inside = inside;
     }
+    return outside;
+}
 
-    // Frustum outside/inside box - 2
-    count = 0;
-    count += (frustum_corners[0].y > box.mx.y) ? 1 : 0;
-    count += (frustum_corners[1].y > box.mx.y) ? 1 : 0;
-    count += (frustum_corners[2].y > box.mx.y) ? 1 : 0;
-    count += (frustum_corners[3].y > box.mx.y) ? 1 : 0;
-    count += (frustum_corners[4].y > box.mx.y) ? 1 : 0;
-    count += (frustum_corners[5].y > box.mx.y) ? 1 : 0;
-    count += (frustum_corners[6].y > box.mx.y) ? 1 : 0;
-    count += (frustum_corners[7].y > box.mx.y) ? 1 : 0;
-    if (count == 8) {
-        return false;
+#if defined(SC_SIMD_SSE2)
+// All planes at once, in two halves of four.
+static SC_INLINE bool
+sc_frustum_test_box_sse2(const ScFrustum* frustum, box3f box, bool* out_inside) {
+    const __m128 zero = _mm_setzero_ps();
+    int32_t outside = 0;
+    int32_t outside_n = 0;
+    for (uint32_t i = 0; i < 8; i += 4) {
+        const __m128 nx = _mm_loadu_ps(frustum->plane_n_x + i);
+        const __m128 ny = _mm_loadu_ps(frustum->plane_n_y + i);
+        const __m128 nz = _mm_loadu_ps(frustum->plane_n_z + i);
+        const __m128 d = _mm_loadu_ps(frustum->plane_d + i);
+
+        // The p-vertex takes the minimum where the normal is negative.
+        const __m128 neg_x = _mm_cmplt_ps(nx, zero);
+        const __m128 neg_y = _mm_cmplt_ps(ny, zero);
+        const __m128 neg_z = _mm_cmplt_ps(nz, zero);
+        const __m128 mn_x = _mm_set1_ps(box.mn.x);
+        const __m128 mn_y = _mm_set1_ps(box.mn.y);
+        const __m128 mn_z = _mm_set1_ps(box.mn.z);
+        const __m128 mx_x = _mm_set1_ps(box.mx.x);
+        const __m128 mx_y = _mm_set1_ps(box.mx.y);
+        const __m128 mx_z = _mm_set1_ps(box.mx.z);
+        const __m128 px = _mm_or_ps(_mm_and_ps(neg_x, mn_x), _mm_andnot_ps(neg_x, mx_x));
+        const __m128 py = _mm_or_ps(_mm_and_ps(neg_y, mn_y), _mm_andnot_ps(neg_y, mx_y));
+        const __m128 pz = _mm_or_ps(_mm_and_ps(neg_z, mn_z), _mm_andnot_ps(neg_z, mx_z));
+        // clang-format off
+        const __m128 dp = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, px), _mm_mul_ps(ny, py)), _mm_mul_ps(nz, pz)), d);
+        // clang-format on
+        outside |= _mm_movemask_ps(_mm_cmplt_ps(dp, zero));
+
+        if (out_inside != NULL) {
+            const __m128 qx = _mm_or_ps(_mm_and_ps(neg_x, mx_x), _mm_andnot_ps(neg_x, mn_x));
+            const __m128 qy = _mm_or_ps(_mm_and_ps(neg_y, mx_y), _mm_andnot_ps(neg_y, mn_y));
+            const __m128 qz = _mm_or_ps(_mm_and_ps(neg_z, mx_z), _mm_andnot_ps(neg_z, mn_z));
+            // clang-format off
+            const __m128 dn = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, qx), _mm_mul_ps(ny, qy)), _mm_mul_ps(nz, qz)), d);
+            // clang-format on
+            outside_n |= _mm_movemask_ps(_mm_cmplt_ps(dn, zero));
+        }
     }
-
-    // Frustum outside/inside box - 3
-    count = 0;
-    count += (frustum_corners[0].y < box.mn.y) ? 1 : 0;
-    count += (frustum_corners[1].y < box.mn.y) ? 1 : 0;
-    count += (frustum_corners[2].y < box.mn.y) ? 1 : 0;
-    count += (frustum_corners[3].y < box.mn.y) ? 1 : 0;
-    count += (frustum_corners[4].y < box.mn.y) ? 1 : 0;
-    count += (frustum_corners[5].y < box.mn.y) ? 1 : 0;
-    count += (frustum_corners[6].y < box.mn.y) ? 1 : 0;
-    count += (frustum_corners[7].y < box.mn.y) ? 1 : 0;
-    if (count == 8) {
-        return false;
+    if (out_inside != NULL) {
+        *out_inside = outside_n == 0;
     }
-
-    // Frustum outside/inside box - 4
-    count = 0;
-    count += (frustum_corners[0].z > box.mx.z) ? 1 : 0;
-    count += (frustum_corners[1].z > box.mx.z) ? 1 : 0;
-    count += (frustum_corners[2].z > box.mx.z) ? 1 : 0;
-    count += (frustum_corners[3].z > box.mx.z) ? 1 : 0;
-    count += (frustum_corners[4].z > box.mx.z) ? 1 : 0;
-    count += (frustum_corners[5].z > box.mx.z) ? 1 : 0;
-    count += (frustum_corners[6].z > box.mx.z) ? 1 : 0;
-    count += (frustum_corners[7].z > box.mx.z) ? 1 : 0;
-    if (count == 8) {
-        return false;
+    return outside != 0;
+}
+#endif
+
+#if defined(SC_SIMD_AVX2)
+// All planes at once, one per lane.
+static SC_INLINE bool
+sc_frustum_test_box_avx2(const ScFrustum* frustum, box3f box, bool* out_inside) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 nx = _mm256_loadu_ps(frustum->plane_n_x);
+    const __m256 ny = _mm256_loadu_ps(frustum->plane_n_y);
+    const __m256 nz = _mm256_loadu_ps(frustum->plane_n_z);
+    const __m256 d = _mm256_loadu_ps(frustum->plane_d);
+
+    // The p-vertex takes the minimum where the normal is negative.
+    const __m256 neg_x = _mm256_cmp_ps(nx, zero, _CMP_LT_OQ);
+    const __m256 neg_y = _mm256_cmp_ps(ny, zero, _CMP_LT_OQ);
+    const __m256 neg_z = _mm256_cmp_ps(nz, zero, _CMP_LT_OQ);
+    const __m256 mn_x = _mm256_set1_ps(box.mn.x);
+    const __m256 mn_y = _mm256_set1_ps(box.mn.y);
+    const __m256 mn_z = _mm256_set1_ps(box.mn.z);
+    const __m256 mx_x = _mm256_set1_ps(box.mx.x);
+    const __m256 mx_y = _mm256_set1_ps(box.mx.y);
+    const __m256 mx_z = _mm256_set1_ps(box.mx.z);
+    const __m256 px = _mm256_blendv_ps(mx_x, mn_x, neg_x);
+    const __m256 py = _mm256_blendv_ps(mx_y, mn_y, neg_y);
+    const __m256 pz = _mm256_blendv_ps(mx_z, mn_z, neg_z);
+    // clang-format off
+    const __m256 dp = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, px), _mm256_mul_ps(ny, py)), _mm256_mul_ps(nz, pz)), d);
+    // clang-format on
+
+    if (out_inside != NULL) {
+        const __m256 qx = _mm256_blendv_ps(mn_x, mx_x, neg_x);
+        const __m256 qy = _mm256_blendv_ps(mn_y, mx_y, neg_y);
+        const __m256 qz = _mm256_blendv_ps(mn_z, mx_z, neg_z);
+        // clang-format off
+        const __m256 dn = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, qx), _mm256_mul_ps(ny, qy)), _mm256_mul_ps(nz, qz)), d);
+        // clang-format on
+        *out_inside = _mm256_movemask_ps(_mm256_cmp_ps(dn, zero, _CMP_LT_OQ)) == 0;
     }
+    return _mm256_movemask_ps(_mm256_cmp_ps(dp, zero, _CMP_LT_OQ)) != 0;
+}
+#endif
+
+static SC_INLINE bool sc_frustum_test_box(const ScFrustum* frustum, box3f box, bool* out_inside) {
+#if defined(SC_SIMD_AVX2)
+    return sc_frustum_test_box_avx2(frustum, box, out_inside);
+#elif defined(SC_SIMD_SSE2)
+    return sc_frustum_test_box_sse2(frustum, box, out_inside);
+#else
+    return sc_frustum_test_box_scalar(frustum, box, out_inside);
+#endif
+}
 
-    // Frustum outside/inside box - 5
-    count = 0;
-    count += (frustum_corners[0].z < box.mn.z) ? 1 : 0;
-    count += (frustum_corners[1].z < box.mn.z) ? 1 : 0;
-    count += (frustum_corners[2].z < box.mn.z) ? 1 : 0;
-    count += (frustum_corners[3].z < box.mn.z) ? 1 : 0;
-    count += (frustum_corners[4].z < box.mn.z) ? 1 : 0;
-    count += (frustum_corners[5].z < box.mn.z) ? 1 : 0;
-    count += (frustum_corners[6].z < box.mn.z) ? 1 : 0;
-    count += (frustum_corners[7].z < box.mn.z) ? 1 : 0;
-    if (count == 8) {
-        return false;
-    }
+// Rejects boxes entirely behind one of the planes. Keeps some boxes near the frustum edges which no
+// single plane separates.
+static bool sc_frustum_intersects_box_planes(const ScFrustum* frustum, box3f box) {
+    return !sc_frustum_test_box(frustum, box, NULL);
+}
 
-    // Inside or intersects.
-    return true;
+// Planes, tightened by testing the frustum corners against the box, which is the same as testing
+// the box against the bounds of the corners.
+static bool sc_frustum_intersects_box(const ScFrustum* frustum, box3f box) {
+    return sc_frustum_intersects_box_planes(frustum, box) & box3f_intersects(frustum->bounds, box);
+}
+
+// Same culling as sc_frustum_intersects_box, but also tells boxes entirely inside apart, by testing
+// the n-vertex of each plane too. Nothing inside such a box needs testing again.
+static ScFrustumSide sc_frustum_classify_box(const ScFrustum* frustum, box3f box) {
+    bool inside;
+    bool outside = sc_frustum_test_box(frustum, box, &inside);
+    outside |= !box3f_intersects(frustum->bounds, box);
+    return outside  ? SC_FRUSTUM_SIDE_OUTSIDE
+           : inside ? SC_FRUSTUM_SIDE_INSIDE
+                    : SC_FRUSTUM_SIDE_INTERSECT;
 }
 
 //
@@ -342,23 +359,33 @@ sc_perspective_camera_new(const ScPerspectiveCameraCreateInfo* create_info) {
         frustum.planes[SC_FRUSTUM_PLANE_F] = plane3f_from_vec4f(vec4f_add(r3, r2));
     }
     {
-        const vec4f lbn = mat4f_mul_vec4f(world_from_clip, vec4f_new(-1.0f, -1.0f, 0.0f, 1.0f));
-        const vec4f rbn = mat4f_mul_vec4f(world_from_clip, vec4f_new(+1.0f, -1.0f, 0.0f, 1.0f));
-        const vec4f ltn = mat4f_mul_vec4f(world_from_clip, vec4f_new(-1.0f, +1.0f, 0.0f, 1.0f));
-        const vec4f rtn = mat4f_mul_vec4f(world_from_clip, vec4f_new(+1.0f, +1.0f, 0.0f, 1.0f));
-        const vec4f lbf = mat4f_mul_vec4f(world_from_clip, vec4f_new(-1.0f, -1.0f, 1.0f, 1.0f));
-        const vec4f rbf = mat4f_mul_vec4f(world_from_clip, vec4f_new(+1.0f, -1.0f, 1.0f, 1.0f));
-        const vec4f ltf = mat4f_mul_vec4f(world_from_clip, vec4f_new(-1.0f, +1.0f, 1.0f, 1.0f));
-        const vec4f rtf = mat4f_mul_vec4f(world_from_clip, vec4f_new(+1.0f, +1.0f, 1.0f, 1.0f));
-        frustum.corners[SC_FRUSTUM_CORNER_LBN] = vec3f_scale(vec3f_from_vec4f(lbn), 1.0f / lbn.w);
-        frustum.corners[SC_FRUSTUM_CORNER_RBN] = vec3f_scale(vec3f_from_vec4f(rbn), 1.0f / rbn.w);
-        frustum.corners[SC_FRUSTUM_CORNER_LTN] = vec3f_scale(vec3f_from_vec4f(ltn), 1.0f / ltn.w);
-        frustum.corners[SC_FRUSTUM_CORNER_RTN] = vec3f_scale(vec3f_from_vec4f(rtn), 1.0f / rtn.w);
-        frustum.corners[SC_FRUSTUM_CORNER_LBF] = vec3f_scale(vec3f_from_vec4f(lbf), 1.0f / lbf.w);
-        frustum.corners[SC_FRUSTUM_CORNER_RBF] = vec3f_scale(vec3f_from_vec4f(rbf), 1.0f / rbf.w);
-        frustum.corners[SC_FRUSTUM_CORNER_LTF] = vec3f_scale(vec3f_from_vec4f(ltf), 1.0f / ltf.w);
-        frustum.corners[SC_FRUSTUM_CORNER_RTF] = vec3f_scale(vec3f_from_vec4f(rtf), 1.0f / rtf.w);
+        // Clip space corners, in ScFrustumCorner order.
+        // clang-format off
+        const float clip_x[SC_FRUSTUM_CORNER_COUNT] = {-1.0f, +1.0f, -1.0f, +1.0f, -1.0f, +1.0f, -1.0f, +1.0f};
+        const float clip_y[SC_FRUSTUM_CORNER_COUNT] = {-1.0f, -1.0f, +1.0f, +1.0f, -1.0f, -1.0f, +1.0f, +1.0f};
+        const float clip_z[SC_FRUSTUM_CORNER_COUNT] = {0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f};
+        // clang-format on
+        float world_x[SC_FRUSTUM_CORNER_COUNT];
+        float world_y[SC_FRUSTUM_CORNER_COUNT];
+        float world_z[SC_FRUSTUM_CORNER_COUNT];
+        float world_w[SC_FRUSTUM_CORNER_COUNT];
+        mat4f_transform_batch(
+            world_from_clip,
+            clip_x,
+            clip_y,
+            clip_z,
+            world_x,
+            world_y,
+            world_z,
+            world_w,
+            SC_FRUSTUM_CORNER_COUNT
+        );
+        for (uint32_t i = 0; i < SC_FRUSTUM_CORNER_COUNT; i++) {
+            const vec3f corner = vec3f_new(world_x[i], world_y[i], world_z[i]);
+            frustum.corners[i] = vec3f_scale(corner, 1.0f / world_w[i]);
+        }
     }
+    sc_frustum_precompute(&frustum);
 
     return (ScPerspectiveCamera) {
         .screen_width = screen_width,
@@ -397,6 +424,55 @@ static float sc_screen_projected_sphere_area(const ScPerspectiveCamera* camera,
     return result;
 }
 
+// Union frusta keep every corner at least this far in front of each plane, relative to the
+// largest corner coordinate. Planes and corners are derived separately in single precision, so
+// they disagree slightly, most at the far plane.
+#define SC_FRUSTUM_UNION_SLACK 1e-4f
+
+// Frustum containing the frusta of all cameras: the planes of the first camera, each pushed out
+// past the corners of all of them. Tight for cameras which only differ by position, like stereo
+// pairs, loose for diverging ones. Only its planes and bounds are set.
+static ScFrustum
+sc_perspective_camera_union_frustum(const ScPerspectiveCamera* cameras, uint32_t camera_count) {
+    // Special: a single frustum is its own union.
+    SC_ASSERT(camera_count > 0);
+    if (camera_count == 1) {
+        return cameras[0].frustum;
+    }
+
+    // Slack.
+    float corner_scale = 0.0f;
+    for (uint32_t i = 0; i < camera_count; i++) {
+        for (uint32_t j = 0; j < SC_FRUSTUM_CORNER_COUNT; j++) {
+            const vec3f corner = cameras[i].frustum.corners[j];
+            corner_scale = SDL_max(corner_scale, fabsf(corner.x));
+            corner_scale = SDL_max(corner_scale, fabsf(corner.y));
+            corner_scale = SDL_max(corner_scale, fabsf(corner.z));
+        }
+    }
+    const float slack = SC_FRUSTUM_UNION_SLACK * corner_scale;
+
+    // Planes and bounds.
+    ScFrustum frustum = {0};
+    for (uint32_t i = 0; i < SC_FRUSTUM_PLANE_COUNT; i++) {
+        plane3f plane = cameras[0].frustum.planes[i];
+        for (uint32_t j = 0; j < camera_count; j++) {
+            for (uint32_t k = 0; k < SC_FRUSTUM_CORNER_COUNT; k++) {
+                const vec3f corner = cameras[j].frustum.corners[k];
+                plane.d = SDL_max(plane.d, slack - vec3f_dot(plane.n, corner));
+            }
+        }
+        frustum.planes[i] = plane;
+    }
+    frustum.bounds = cameras[0].frustum.bounds;
+    for (uint32_t i = 1; i < camera_count; i++) {
+        frustum.bounds.mn = vec3f_min(frustum.bounds.mn, cameras[i].frustum.bounds.mn);
+        frustum.bounds.mx = vec3f_max(frustum.bounds.mx, cameras[i].frustum.bounds.mx);
+    }
+    sc_frustum_precompute_planes(&frustum);
+    return frustum;
+}
+
 //
 // Camera control - common
 //
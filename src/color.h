@@ -26,3 +26,10 @@ static SC_INLINE uint32_t sc_color_from_hsv(float hue, float saturation, float v
     color |= 0xff000000;
     return color;
 }
+
+static SC_INLINE float sc_srgb_from_linear(float linear) {
+    if (linear <= 0.0031308f) {
+        return 12.92f * linear;
+    }
+    return 1.055f * powf(linear, 1.0f / 2.4f) - 0.055f;
+}
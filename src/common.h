@@ -6,6 +6,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <zstd.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
 #define SDL_MAIN_USE_CALLBACKS 1
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_main.h>
@@ -18,7 +22,15 @@
         abort();        \
     }
 #define SC_COUNTOF(arr) (sizeof(arr) / sizeof(arr[0]))
-#define SC_INLINE __forceinline
+#if defined(_MSC_VER)
+    #define SC_INLINE __forceinline
+    #define SC_ALIGNAS(n) __declspec(align(n))
+    #define SC_THREAD_LOCAL __declspec(thread)
+#else
+    #define SC_INLINE inline __attribute__((always_inline))
+    #define SC_ALIGNAS(n) __attribute__((aligned(n)))
+    #define SC_THREAD_LOCAL _Thread_local
+#endif
 #define SC_LOG_INFO(fmt, ...) SDL_Log(fmt, ##__VA_ARGS__)
 #define SC_LOG_ERROR(fmt, ...) SDL_LogError(SDL_LOG_CATEGORY_ERROR, fmt, ##__VA_ARGS__)
 #define SC_SDL_ASSERT(expr)                            \
@@ -28,3 +40,51 @@
     }
 
 #define SC_INFLIGHT_FRAME_COUNT 2
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define SC_SIMD_SSE2 1
+#endif
+#if defined(__AVX2__)
+    #define SC_SIMD_AVX2 1
+#endif
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define SC_SIMD_BMI2 1
+#endif
+
+static SC_INLINE void sc_atomic_min_u64(volatile uint64_t* dst, uint64_t value) {
+    uint64_t current = *dst;
+    while (value < current) {
+#if defined(_MSC_VER)
+        const uint64_t previous = (uint64_t)_InterlockedCompareExchange64(
+            (volatile int64_t*)dst,
+            (int64_t)value,
+            (int64_t)current
+        );
+#else
+        const uint64_t previous = __sync_val_compare_and_swap(dst, current, value);
+#endif
+        if (previous == current) {
+            break;
+        }
+        current = previous;
+    }
+}
+
+// Fast non-cryptographic hash, for change detection and cache keys. Several ranges can be hashed
+// as one by passing the previous result as hash, starting from SC_HASH_SEED.
+#define SC_HASH_SEED 0xcbf29ce484222325ull
+
+static uint64_t sc_hash_bytes(uint64_t hash, const void* data, size_t byte_count) {
+    const uint8_t* bytes = data;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= byte_count; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof(uint64_t));
+        hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+        hash ^= hash >> 29;
+    }
+    for (; i < byte_count; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
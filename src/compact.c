@@ -0,0 +1,138 @@
+//
+// Stormcloud Compact - Includes.
+//
+
+#include "common.h"
+#include "alloc.h"
+#include "job.h"
+#include "math.h"
+#include "color.h"
+#include "camera.h"
+#include "octree.h"
+
+//
+// Stormcloud Compact - Convert an octree to the compact point format.
+//
+
+// Usage: stormcloud_compact <input.oct> <output.oct>
+
+SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
+    // Arguments.
+    SC_UNUSED(appstate);
+    if (argc < 3) {
+        SC_LOG_ERROR("Usage: %s <input.oct> <output.oct>", argv[0]);
+        return SDL_APP_FAILURE;
+    }
+    const char* input_path = argv[1];
+    const char* output_path = argv[2];
+    if (SDL_strcmp(input_path, output_path) == 0) {
+        SC_LOG_ERROR("Input and output must be different files");
+        return SDL_APP_FAILURE;
+    }
+
+    // Input, checked before loading.
+    if (!sc_octree_probe(input_path)) {
+        return SDL_APP_FAILURE;
+    }
+
+    // Octree.
+    ScOctree octree;
+    sc_octree_new(&octree, input_path);
+    if (octree.point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+        SC_LOG_ERROR("%s is already compact", input_path);
+        sc_octree_free(&octree);
+        return SDL_APP_FAILURE;
+    }
+    const uint64_t point_count = octree.point_count;
+    ScOctreePoint* original_points = malloc(point_count * sizeof(ScOctreePoint));
+    memcpy(original_points, octree.points, point_count * sizeof(ScOctreePoint));
+
+    // Convert.
+    const uint64_t begin_time_ns = SDL_GetTicksNS();
+    sc_octree_compact(&octree);
+    const uint64_t end_time_ns = SDL_GetTicksNS();
+    SC_LOG_INFO(
+        "Converted %" PRIu64 " points in %.3f ms",
+        point_count,
+        (double)(end_time_ns - begin_time_ns) / 1e6
+    );
+
+    // Quality.
+    uint64_t position_mismatch_count = 0;
+    uint64_t error_sum[3] = {0};
+    uint64_t error_squared_sum[3] = {0};
+    uint32_t error_max[3] = {0};
+    for (uint64_t i = 0; i < point_count; i++) {
+        const ScOctreePoint original = original_points[i];
+        const ScOctreePoint expanded = sc_octree_point_expand(octree.compact_points[i]);
+        position_mismatch_count += original.position != expanded.position;
+        for (uint32_t c = 0; c < 3; c++) {
+            const int32_t a = (int32_t)((original.color >> (8 * c)) & 0xff);
+            const int32_t b = (int32_t)((expanded.color >> (8 * c)) & 0xff);
+            const uint32_t error = (uint32_t)SDL_abs(a - b);
+            error_sum[c] += error;
+            error_squared_sum[c] += error * error;
+            error_max[c] = SDL_max(error_max[c], error);
+        }
+    }
+    const char* channel_names[] = {"r", "g", "b"};
+    uint64_t error_squared_total = 0;
+    for (uint32_t c = 0; c < 3; c++) {
+        SC_LOG_INFO(
+            "Color %s: mean abs error %.3f, max abs error %u",
+            channel_names[c],
+            point_count > 0 ? (double)error_sum[c] / (double)point_count : 0.0,
+            error_max[c]
+        );
+        error_squared_total += error_squared_sum[c];
+    }
+    const double mse = point_count > 0 ? (double)error_squared_total / (3.0 * point_count) : 0.0;
+    if (mse > 0.0) {
+        SC_LOG_INFO("Color PSNR: %.2f dB", 10.0 * SDL_log10(255.0 * 255.0 / mse));
+    } else {
+        SC_LOG_INFO("Color PSNR: inf");
+    }
+    SC_LOG_INFO("Position mismatches: %" PRIu64, position_mismatch_count);
+
+    // Size.
+    const uint64_t byte_count_before = point_count * sizeof(ScOctreePoint);
+    const uint64_t byte_count_after = point_count * sizeof(ScOctreePointCompact);
+    SC_LOG_INFO(
+        "Point bytes: %" PRIu64 " -> %" PRIu64 " (%.1f%% smaller)",
+        byte_count_before,
+        byte_count_after,
+        byte_count_before > 0
+            ? 100.0 * (double)(byte_count_before - byte_count_after) / (double)byte_count_before
+            : 0.0
+    );
+
+    // Write.
+    const bool written = position_mismatch_count == 0 && sc_octree_write(&octree, output_path);
+    if (written) {
+        SC_LOG_INFO("Wrote %s", output_path);
+    } else {
+        SC_LOG_ERROR("Failed to write %s", output_path);
+    }
+
+    // Free.
+    free(original_points);
+    sc_octree_free(&octree);
+
+    return written ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
+
+SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(event);
+    return SDL_APP_CONTINUE;
+}
+
+SDL_AppResult SDL_AppIterate(void* appstate) {
+    SC_UNUSED(appstate);
+    return SDL_APP_SUCCESS;
+}
+
+void SDL_AppQuit(void* appstate, SDL_AppResult result) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(result);
+}
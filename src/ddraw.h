@@ -1,15 +1,62 @@
+//
+// Debug draw
+//
+
+// Notes:
+// - Lines are expanded on the CPU and re-uploaded every frame, which is fine for a handful of
+//   them. Boxes, frusta and axes are instanced instead: every primitive is a single transform
+//   and color record, and the shape vertices live on the device.
+// - The instance transform maps the unit shape into world space and may be projective, which is
+//   how a frustum is drawn as a unit box transformed by world_from_clip.
+// - Persistent instances are uploaded once and drawn every frame until they are freed, for
+//   large sets that rarely change, like the bounds of every node in the octree. They are staged
+//   with the next sc_ddraw_upload through the frame uploader, so creating them costs no submit
+//   of its own, and one freed before that is never copied.
+
 typedef struct ScDebugDrawVertex {
     vec3f position;
     uint32_t color;
 } ScDebugDrawVertex;
 
+typedef enum ScDebugDrawShape {
+    SC_DDRAW_SHAPE_BOX,
+    SC_DDRAW_SHAPE_AXIS,
+    SC_DDRAW_SHAPE_COUNT,
+} ScDebugDrawShape;
+
+// Vertex ranges in the shape buffer.
+static const uint32_t SC_DDRAW_SHAPE_FIRST_VERTEX[] = {0, 24};
+static const uint32_t SC_DDRAW_SHAPE_VERTEX_COUNT[] = {24, 6};
+
+typedef struct ScDebugDrawInstance {
+    mat4f world_from_local;
+    uint32_t color;
+} ScDebugDrawInstance;
+
+// Instances uploaded once, drawn every frame until freed.
+typedef struct ScDebugDrawPersistent {
+    struct ScDebugDrawPersistent* prev;
+    struct ScDebugDrawPersistent* next;
+    ScDebugDrawShape shape;
+    uint32_t instance_count;
+    SDL_GPUBuffer* instance_buffer;
+    // Waiting for the next upload, NULL once staged.
+    ScDebugDrawInstance* pending_instances;
+    bool visible;
+} ScDebugDrawPersistent;
+
 typedef struct ScDebugDrawCreateInfo {
     SDL_GPUTextureFormat color_format;
     SDL_GPUTextureFormat depth_stencil_format;
 } ScDebugDrawCreateInfo;
 
-typedef struct ScDebugRenderInfo {
+typedef struct ScDebugUploadInfo {
     SDL_GPUDevice* device;
+    ScGpuFrameUploader* uploader;
+    uint32_t frame_index;
+} ScDebugUploadInfo;
+
+typedef struct ScDebugRenderInfo {
     SDL_GPUCommandBuffer* command_buffer;
     SDL_GPURenderPass* render_pass;
     SDL_GPUViewport viewport;
@@ -18,46 +65,172 @@ typedef struct ScDebugRenderInfo {
 } ScDebugRenderInfo;
 
 typedef struct ScDebugDraw {
+    // Lines and instances live in the frame arena until they are rendered.
+    ScArena* arena;
     uint32_t line_count;
     uint32_t line_capacity;
-    uint32_t line_byte_count;
     ScDebugDrawVertex* lines;
+    uint32_t instance_counts[SC_DDRAW_SHAPE_COUNT];
+    uint32_t instance_capacities[SC_DDRAW_SHAPE_COUNT];
+    ScDebugDrawInstance* instances[SC_DDRAW_SHAPE_COUNT];
 
-    SDL_GPUTransferBuffer* line_transfer_buffers[SC_INFLIGHT_FRAME_COUNT];
+    // Device buffers grow on demand, separately for every frame in flight. They are filled
+    // through the frame uploader.
     SDL_GPUBuffer* line_buffers[SC_INFLIGHT_FRAME_COUNT];
+    uint32_t line_buffer_capacities[SC_INFLIGHT_FRAME_COUNT];
+    SDL_GPUBuffer* instance_buffers[SC_INFLIGHT_FRAME_COUNT];
+    uint32_t instance_buffer_capacities[SC_INFLIGHT_FRAME_COUNT];
+
+    // Shape vertices, uploaded once.
+    SDL_GPUBuffer* shape_buffer;
+
+    // Persistent instances.
+    ScPool persistent_pool;
+    ScDebugDrawPersistent* persistent_list;
 
     SDL_GPUGraphicsPipeline* line_pipeline;
+    SDL_GPUGraphicsPipeline* instance_pipeline;
 } ScDebugDraw;
 
-static void
-sc_ddraw_new(ScDebugDraw* ddraw, SDL_GPUDevice* device, const ScDebugDrawCreateInfo* create_info) {
-    // Buffers.
-    ddraw->line_count = 0;
-    ddraw->line_capacity = 1024;
-    ddraw->line_byte_count = ddraw->line_capacity * sizeof(ScDebugDrawVertex);
-    ddraw->lines = malloc(ddraw->line_byte_count);
-    for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
-        ddraw->line_transfer_buffers[i] = SDL_CreateGPUTransferBuffer(
-            device,
-            &(SDL_GPUTransferBufferCreateInfo) {
-                .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-                .size = ddraw->line_byte_count,
-            }
-        );
-        ddraw->line_buffers[i] = SDL_CreateGPUBuffer(
-            device,
-            &(SDL_GPUBufferCreateInfo) {
-                .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
-                .size = ddraw->line_byte_count,
-            }
-        );
+//
+// Debug draw - Instances
+//
+
+static ScDebugDrawInstance sc_ddraw_instance_box(box3f box, uint32_t color) {
+    const vec3f extents = box3f_extents(box);
+    mat4f world_from_local = mat4f_identity();
+    world_from_local.m00 = extents.x;
+    world_from_local.m11 = extents.y;
+    world_from_local.m22 = extents.z;
+    world_from_local.m30 = box.mn.x;
+    world_from_local.m31 = box.mn.y;
+    world_from_local.m32 = box.mn.z;
+    return (ScDebugDrawInstance) {.world_from_local = world_from_local, .color = color};
+}
+
+// The frustum of clip_from_world, with world_from_clip being its inverse.
+static ScDebugDrawInstance sc_ddraw_instance_frustum(mat4f world_from_clip, uint32_t color) {
+    // Unit box to clip space, x and y in [-1, 1], z in [0, 1].
+    mat4f clip_from_local = mat4f_identity();
+    clip_from_local.m00 = 2.0f;
+    clip_from_local.m11 = 2.0f;
+    clip_from_local.m30 = -1.0f;
+    clip_from_local.m31 = -1.0f;
+    return (ScDebugDrawInstance) {
+        .world_from_local = mat4f_mul(world_from_clip, clip_from_local),
+        .color = color,
+    };
+}
+
+// Right, up and forward are drawn red, green and blue, scaled by length.
+static ScDebugDrawInstance
+sc_ddraw_instance_axis(vec3f position, vec3f right, vec3f up, vec3f forward, float length) {
+    const vec3f x = vec3f_scale(right, length);
+    const vec3f y = vec3f_scale(up, length);
+    const vec3f z = vec3f_scale(forward, length);
+    return (ScDebugDrawInstance) {
+        .world_from_local =
+            (mat4f) {
+                // clang-format off
+                x.x, x.y, x.z, 0.0f,
+                y.x, y.y, y.z, 0.0f,
+                z.x, z.y, z.z, 0.0f,
+                position.x, position.y, position.z, 1.0f,
+                // clang-format on
+            },
+        .color = 0xffffffff,
+    };
+}
+
+//
+// Debug draw - Device
+//
+
+static void sc_ddraw_buffer_reserve(
+    SDL_GPUDevice* device,
+    SDL_GPUBuffer** buffer,
+    uint32_t* capacity,
+    uint32_t count,
+    uint32_t stride
+) {
+    // Early out.
+    if (count <= *capacity) {
+        return;
+    }
+
+    // Grow, the previous buffer is released once the device is done with it.
+    uint32_t new_capacity = SDL_max(*capacity, 1);
+    while (new_capacity < count) {
+        new_capacity *= 2;
     }
+    const uint32_t byte_count = new_capacity * stride;
+    SDL_ReleaseGPUBuffer(device, *buffer);
+    *buffer = SDL_CreateGPUBuffer(
+        device,
+        &(SDL_GPUBufferCreateInfo) {
+            .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+            .size = byte_count,
+        }
+    );
+    *capacity = new_capacity;
+}
 
+// Creates a vertex buffer with its contents, for data uploaded once outside of a frame.
+static SDL_GPUBuffer*
+sc_ddraw_buffer_new(SDL_GPUDevice* device, const void* data, uint32_t byte_count) {
+    SDL_GPUBuffer* buffer = SDL_CreateGPUBuffer(
+        device,
+        &(SDL_GPUBufferCreateInfo) {
+            .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+            .size = byte_count,
+        }
+    );
+    SDL_GPUTransferBuffer* transfer_buffer = SDL_CreateGPUTransferBuffer(
+        device,
+        &(SDL_GPUTransferBufferCreateInfo) {
+            .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+            .size = byte_count,
+        }
+    );
+    void* dst = SDL_MapGPUTransferBuffer(device, transfer_buffer, false);
+    memcpy(dst, data, byte_count);
+    SDL_UnmapGPUTransferBuffer(device, transfer_buffer);
+    SDL_GPUCommandBuffer* upload_cmd = SDL_AcquireGPUCommandBuffer(device);
+    SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(upload_cmd);
+    SDL_UploadToGPUBuffer(
+        copy_pass,
+        &(SDL_GPUTransferBufferLocation) {
+            .transfer_buffer = transfer_buffer,
+            .offset = 0,
+        },
+        &(SDL_GPUBufferRegion) {
+            .buffer = buffer,
+            .offset = 0,
+            .size = byte_count,
+        },
+        false
+    );
+    SDL_EndGPUCopyPass(copy_pass);
+    SDL_SubmitGPUCommandBuffer(upload_cmd);
+    SDL_ReleaseGPUTransferBuffer(device, transfer_buffer);
+    return buffer;
+}
+
+static SDL_GPUGraphicsPipeline* sc_ddraw_pipeline_new(
+    SDL_GPUDevice* device,
+    const ScDebugDrawCreateInfo* create_info,
+    const char* shader_name,
+    SDL_GPUVertexInputState vertex_input_state
+) {
     // Shaders.
+    char vertex_file_name[64];
+    char fragment_file_name[64];
+    snprintf(vertex_file_name, sizeof(vertex_file_name), "%s.vert", shader_name);
+    snprintf(fragment_file_name, sizeof(fragment_file_name), "%s.frag", shader_name);
     SDL_GPUShader* vertex_shader = sc_gpu_shader_new(
         device,
         &(ScGpuShaderCreateInfo) {
-            .file_path = "src/shaders/dxil/ddraw.vert",
+            .file_name = vertex_file_name,
             .entry_point = "vs_main",
             .shader_stage = SDL_GPU_SHADERSTAGE_VERTEX,
             .sampler_count = 0,
@@ -67,7 +240,7 @@ sc_ddraw_new(ScDebugDraw* ddraw, SDL_GPUDevice* device, const ScDebugDrawCreateI
     SDL_GPUShader* fragment_shader = sc_gpu_shader_new(
         device,
         &(ScGpuShaderCreateInfo) {
-            .file_path = "src/shaders/dxil/ddraw.frag",
+            .file_name = fragment_file_name,
             .entry_point = "fs_main",
             .shader_stage = SDL_GPU_SHADERSTAGE_FRAGMENT,
             .sampler_count = 0,
@@ -76,39 +249,12 @@ sc_ddraw_new(ScDebugDraw* ddraw, SDL_GPUDevice* device, const ScDebugDrawCreateI
     );
 
     // Pipeline.
-    ddraw->line_pipeline = SDL_CreateGPUGraphicsPipeline(
+    SDL_GPUGraphicsPipeline* pipeline = SDL_CreateGPUGraphicsPipeline(
         device,
         &(SDL_GPUGraphicsPipelineCreateInfo) {
             .vertex_shader = vertex_shader,
             .fragment_shader = fragment_shader,
-            .vertex_input_state =
-                (SDL_GPUVertexInputState) {
-                    .vertex_buffer_descriptions =
-                        &(SDL_GPUVertexBufferDescription) {
-                            .slot = 0,
-                            .pitch = sizeof(ScDebugDrawVertex),
-                            .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
-                            .instance_step_rate = 0,
-
-                        },
-                    .num_vertex_buffers = 1,
-                    .vertex_attributes =
-                        (SDL_GPUVertexAttribute[]) {
-                            {
-                                .location = 0,
-                                .buffer_slot = 0,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-                                .offset = 0,
-                            },
-                            {
-                                .location = 1,
-                                .buffer_slot = 0,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
-                                .offset = sizeof(vec3f),
-                            },
-                        },
-                    .num_vertex_attributes = 2,
-                },
+            .vertex_input_state = vertex_input_state,
             .primitive_type = SDL_GPU_PRIMITIVETYPE_LINELIST,
             .rasterizer_state =
                 (SDL_GPURasterizerState) {
@@ -150,132 +296,451 @@ sc_ddraw_new(ScDebugDraw* ddraw, SDL_GPUDevice* device, const ScDebugDrawCreateI
                 },
         }
     );
+    SC_SDL_ASSERT(pipeline != NULL);
 
     // Release shaders.
     SDL_ReleaseGPUShader(device, vertex_shader);
     SDL_ReleaseGPUShader(device, fragment_shader);
+    return pipeline;
+}
+
+//
+// Debug draw - Lifetime
+//
+
+static void
+sc_ddraw_new(ScDebugDraw* ddraw, SDL_GPUDevice* device, const ScDebugDrawCreateInfo* create_info) {
+    // Host data.
+    ddraw->arena = NULL;
+    ddraw->line_count = 0;
+    ddraw->line_capacity = 0;
+    ddraw->lines = NULL;
+    for (uint32_t i = 0; i < SC_DDRAW_SHAPE_COUNT; i++) {
+        ddraw->instance_counts[i] = 0;
+        ddraw->instance_capacities[i] = 0;
+        ddraw->instances[i] = NULL;
+    }
+
+    // Buffers.
+    for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
+        ddraw->line_buffers[i] = NULL;
+        ddraw->line_buffer_capacities[i] = 0;
+        sc_ddraw_buffer_reserve(
+            device,
+            &ddraw->line_buffers[i],
+            &ddraw->line_buffer_capacities[i],
+            1024,
+            sizeof(ScDebugDrawVertex)
+        );
+        ddraw->instance_buffers[i] = NULL;
+        ddraw->instance_buffer_capacities[i] = 0;
+        sc_ddraw_buffer_reserve(
+            device,
+            &ddraw->instance_buffers[i],
+            &ddraw->instance_buffer_capacities[i],
+            256,
+            sizeof(ScDebugDrawInstance)
+        );
+    }
+
+    // Shapes.
+    {
+        const uint32_t w = 0xffffffff;
+        // clang-format off
+        const ScDebugDrawVertex vertices[] = {
+            // Box, unit cube.
+            {{0.0f, 0.0f, 0.0f}, w}, {{1.0f, 0.0f, 0.0f}, w},
+            {{1.0f, 0.0f, 0.0f}, w}, {{1.0f, 1.0f, 0.0f}, w},
+            {{1.0f, 1.0f, 0.0f}, w}, {{0.0f, 1.0f, 0.0f}, w},
+            {{0.0f, 1.0f, 0.0f}, w}, {{0.0f, 0.0f, 0.0f}, w},
+            {{0.0f, 0.0f, 1.0f}, w}, {{1.0f, 0.0f, 1.0f}, w},
+            {{1.0f, 0.0f, 1.0f}, w}, {{1.0f, 1.0f, 1.0f}, w},
+            {{1.0f, 1.0f, 1.0f}, w}, {{0.0f, 1.0f, 1.0f}, w},
+            {{0.0f, 1.0f, 1.0f}, w}, {{0.0f, 0.0f, 1.0f}, w},
+            {{0.0f, 0.0f, 0.0f}, w}, {{0.0f, 0.0f, 1.0f}, w},
+            {{1.0f, 0.0f, 0.0f}, w}, {{1.0f, 0.0f, 1.0f}, w},
+            {{1.0f, 1.0f, 0.0f}, w}, {{1.0f, 1.0f, 1.0f}, w},
+            {{0.0f, 1.0f, 0.0f}, w}, {{0.0f, 1.0f, 1.0f}, w},
+            // Axis.
+            {{0.0f, 0.0f, 0.0f}, 0xff0000ff}, {{1.0f, 0.0f, 0.0f}, 0xff0000ff},
+            {{0.0f, 0.0f, 0.0f}, 0xff00ff00}, {{0.0f, 1.0f, 0.0f}, 0xff00ff00},
+            {{0.0f, 0.0f, 0.0f}, 0xffff0000}, {{0.0f, 0.0f, 1.0f}, 0xffff0000},
+        };
+        // clang-format on
+        static_assert(SC_COUNTOF(vertices) == 30, "Shape vertex count mismatch");
+        ddraw->shape_buffer = sc_ddraw_buffer_new(device, vertices, sizeof(vertices));
+    }
+
+    // Persistent instances.
+    sc_pool_new(&ddraw->persistent_pool, sizeof(ScDebugDrawPersistent), 64);
+    ddraw->persistent_list = NULL;
+
+    // Pipelines.
+    ddraw->line_pipeline = sc_ddraw_pipeline_new(
+        device,
+        create_info,
+        "ddraw",
+        (SDL_GPUVertexInputState) {
+            .vertex_buffer_descriptions =
+                &(SDL_GPUVertexBufferDescription) {
+                    .slot = 0,
+                    .pitch = sizeof(ScDebugDrawVertex),
+                    .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+                    .instance_step_rate = 0,
+
+                },
+            .num_vertex_buffers = 1,
+            .vertex_attributes =
+                (SDL_GPUVertexAttribute[]) {
+                    {
+                        .location = 0,
+                        .buffer_slot = 0,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                        .offset = 0,
+                    },
+                    {
+                        .location = 1,
+                        .buffer_slot = 0,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+                        .offset = sizeof(vec3f),
+                    },
+                },
+            .num_vertex_attributes = 2,
+        }
+    );
+    ddraw->instance_pipeline = sc_ddraw_pipeline_new(
+        device,
+        create_info,
+        "ddraw_instance",
+        (SDL_GPUVertexInputState) {
+            .vertex_buffer_descriptions =
+                (SDL_GPUVertexBufferDescription[]) {
+                    {
+                        .slot = 0,
+                        .pitch = sizeof(ScDebugDrawVertex),
+                        .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+                        .instance_step_rate = 0,
+                    },
+                    {
+                        .slot = 1,
+                        .pitch = sizeof(ScDebugDrawInstance),
+                        .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+                        .instance_step_rate = 1,
+                    },
+                },
+            .num_vertex_buffers = 2,
+            .vertex_attributes =
+                (SDL_GPUVertexAttribute[]) {
+                    {
+                        .location = 0,
+                        .buffer_slot = 0,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                        .offset = 0,
+                    },
+                    {
+                        .location = 1,
+                        .buffer_slot = 0,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+                        .offset = sizeof(vec3f),
+                    },
+                    {
+                        .location = 2,
+                        .buffer_slot = 1,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+                        .offset = 0 * sizeof(vec4f),
+                    },
+                    {
+                        .location = 3,
+                        .buffer_slot = 1,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+                        .offset = 1 * sizeof(vec4f),
+                    },
+                    {
+                        .location = 4,
+                        .buffer_slot = 1,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+                        .offset = 2 * sizeof(vec4f),
+                    },
+                    {
+                        .location = 5,
+                        .buffer_slot = 1,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+                        .offset = 3 * sizeof(vec4f),
+                    },
+                    {
+                        .location = 6,
+                        .buffer_slot = 1,
+                        .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+                        .offset = sizeof(mat4f),
+                    },
+                },
+            .num_vertex_attributes = 7,
+        }
+    );
+}
+
+static void sc_ddraw_persistent_free(
+    ScDebugDraw* ddraw,
+    SDL_GPUDevice* device,
+    ScDebugDrawPersistent* persistent
+) {
+    // Unlink.
+    if (persistent->prev != NULL) {
+        persistent->prev->next = persistent->next;
+    } else {
+        ddraw->persistent_list = persistent->next;
+    }
+    if (persistent->next != NULL) {
+        persistent->next->prev = persistent->prev;
+    }
+
+    // Release.
+    SDL_ReleaseGPUBuffer(device, persistent->instance_buffer);
+    free(persistent->pending_instances);
+    sc_pool_release(&ddraw->persistent_pool, persistent);
 }
 
 static void sc_ddraw_free(ScDebugDraw* ddraw, SDL_GPUDevice* device) {
     SDL_ReleaseGPUGraphicsPipeline(device, ddraw->line_pipeline);
+    SDL_ReleaseGPUGraphicsPipeline(device, ddraw->instance_pipeline);
     for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
         SDL_ReleaseGPUBuffer(device, ddraw->line_buffers[i]);
-        SDL_ReleaseGPUTransferBuffer(device, ddraw->line_transfer_buffers[i]);
+        SDL_ReleaseGPUBuffer(device, ddraw->instance_buffers[i]);
     }
-    free(ddraw->lines);
+    SDL_ReleaseGPUBuffer(device, ddraw->shape_buffer);
+    while (ddraw->persistent_list != NULL) {
+        sc_ddraw_persistent_free(ddraw, device, ddraw->persistent_list);
+    }
+    sc_pool_free(&ddraw->persistent_pool);
 }
 
-static void sc_ddraw_line(ScDebugDraw* ddraw, vec3f a, vec3f b, uint32_t color) {
+// Copies the instances for the next upload, they are drawn every frame while visible.
+static ScDebugDrawPersistent* sc_ddraw_persistent_new(
+    ScDebugDraw* ddraw,
+    SDL_GPUDevice* device,
+    ScDebugDrawShape shape,
+    const ScDebugDrawInstance* instances,
+    uint32_t instance_count
+) {
     // Validation.
-    SC_ASSERT(ddraw->line_count + 2 <= ddraw->line_capacity);
+    SC_ASSERT(shape < SC_DDRAW_SHAPE_COUNT);
+    SC_ASSERT(instance_count > 0);
+
+    // Create.
+    ScDebugDrawPersistent* persistent = sc_pool_alloc(&ddraw->persistent_pool);
+    persistent->shape = shape;
+    persistent->instance_count = instance_count;
+    const uint32_t byte_count = instance_count * sizeof(ScDebugDrawInstance);
+    persistent->instance_buffer = SDL_CreateGPUBuffer(
+        device,
+        &(SDL_GPUBufferCreateInfo) {
+            .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+            .size = byte_count,
+        }
+    );
+    persistent->pending_instances = malloc(byte_count);
+    SC_ASSERT(persistent->pending_instances != NULL);
+    memcpy(persistent->pending_instances, instances, byte_count);
+    persistent->visible = true;
+
+    // Link.
+    persistent->next = ddraw->persistent_list;
+    if (ddraw->persistent_list != NULL) {
+        ddraw->persistent_list->prev = persistent;
+    }
+    ddraw->persistent_list = persistent;
+    return persistent;
+}
 
-    // Write.
-    ScDebugDrawVertex* vertices = &ddraw->lines[ddraw->line_count];
+//
+// Debug draw - Recording
+//
+
+// Lines and instances recorded until the next render are allocated from arena.
+static void sc_ddraw_frame_begin(ScDebugDraw* ddraw, ScArena* arena) {
+    ddraw->arena = arena;
+    ddraw->line_count = 0;
+    ddraw->line_capacity = 0;
+    ddraw->lines = NULL;
+    for (uint32_t i = 0; i < SC_DDRAW_SHAPE_COUNT; i++) {
+        ddraw->instance_counts[i] = 0;
+        ddraw->instance_capacities[i] = 0;
+        ddraw->instances[i] = NULL;
+    }
+}
+
+// Reserves count elements at the end of an arena array, growing it as needed.
+static void* sc_ddraw_reserve(
+    ScArena* arena,
+    void** data,
+    uint32_t* count,
+    uint32_t* capacity,
+    uint32_t reserve_count,
+    uint32_t stride
+) {
+    // Grow.
+    SC_ASSERT(arena != NULL);
+    if (*count + reserve_count > *capacity) {
+        const uint32_t new_capacity = SDL_max(2 * *capacity, SDL_max(*count + reserve_count, 256));
+        *data = sc_arena_grow(
+            arena,
+            *data,
+            *capacity * stride,
+            new_capacity * stride,
+            SC_ARENA_DEFAULT_ALIGNMENT
+        );
+        *capacity = new_capacity;
+    }
+
+    // Reserve.
+    void* reserved = (uint8_t*)*data + *count * stride;
+    *count += reserve_count;
+    return reserved;
+}
+
+static void sc_ddraw_line(ScDebugDraw* ddraw, vec3f a, vec3f b, uint32_t color) {
+    ScDebugDrawVertex* vertices = sc_ddraw_reserve(
+        ddraw->arena,
+        (void**)&ddraw->lines,
+        &ddraw->line_count,
+        &ddraw->line_capacity,
+        2,
+        sizeof(ScDebugDrawVertex)
+    );
     vertices[0] = (ScDebugDrawVertex) {.position = a, .color = color};
     vertices[1] = (ScDebugDrawVertex) {.position = b, .color = color};
-    ddraw->line_count += 2;
+}
+
+static void
+sc_ddraw_instance(ScDebugDraw* ddraw, ScDebugDrawShape shape, ScDebugDrawInstance instance) {
+    ScDebugDrawInstance* dst = sc_ddraw_reserve(
+        ddraw->arena,
+        (void**)&ddraw->instances[shape],
+        &ddraw->instance_counts[shape],
+        &ddraw->instance_capacities[shape],
+        1,
+        sizeof(ScDebugDrawInstance)
+    );
+    *dst = instance;
 }
 
 static void sc_ddraw_box(ScDebugDraw* ddraw, box3f box, uint32_t color) {
-    // Validation.
-    SC_ASSERT(ddraw->line_count + 24 <= ddraw->line_capacity);
-
-    // Corners.
-    const vec3f c[8] = {
-        {box.mn.x, box.mn.y, box.mn.z},
-        {box.mx.x, box.mn.y, box.mn.z},
-        {box.mn.x, box.mx.y, box.mn.z},
-        {box.mx.x, box.mx.y, box.mn.z},
-        {box.mn.x, box.mn.y, box.mx.z},
-        {box.mx.x, box.mn.y, box.mx.z},
-        {box.mn.x, box.mx.y, box.mx.z},
-        {box.mx.x, box.mx.y, box.mx.z},
-    };
+    sc_ddraw_instance(ddraw, SC_DDRAW_SHAPE_BOX, sc_ddraw_instance_box(box, color));
+}
+
+static void sc_ddraw_frustum(ScDebugDraw* ddraw, mat4f world_from_clip, uint32_t color) {
+    sc_ddraw_instance(ddraw, SC_DDRAW_SHAPE_BOX, sc_ddraw_instance_frustum(world_from_clip, color));
+}
+
+static void sc_ddraw_axis(
+    ScDebugDraw* ddraw,
+    vec3f position,
+    vec3f right,
+    vec3f up,
+    vec3f forward,
+    float length
+) {
+    sc_ddraw_instance(
+        ddraw,
+        SC_DDRAW_SHAPE_AXIS,
+        sc_ddraw_instance_axis(position, right, up, forward, length)
+    );
+}
 
-    // Write.
-    ScDebugDrawVertex* vertices = &ddraw->lines[ddraw->line_count];
-    vertices[0] = (ScDebugDrawVertex) {.position = c[0], .color = color};
-    vertices[1] = (ScDebugDrawVertex) {.position = c[1], .color = color};
-    vertices[2] = (ScDebugDrawVertex) {.position = c[1], .color = color};
-    vertices[3] = (ScDebugDrawVertex) {.position = c[3], .color = color};
-    vertices[4] = (ScDebugDrawVertex) {.position = c[3], .color = color};
-    vertices[5] = (ScDebugDrawVertex) {.position = c[2], .color = color};
-    vertices[6] = (ScDebugDrawVertex) {.position = c[2], .color = color};
-    vertices[7] = (ScDebugDrawVertex) {.position = c[0], .color = color};
-
-    vertices[8] = (ScDebugDrawVertex) {.position = c[4], .color = color};
-    vertices[9] = (ScDebugDrawVertex) {.position = c[5], .color = color};
-    vertices[10] = (ScDebugDrawVertex) {.position = c[5], .color = color};
-    vertices[11] = (ScDebugDrawVertex) {.position = c[7], .color = color};
-    vertices[12] = (ScDebugDrawVertex) {.position = c[7], .color = color};
-    vertices[13] = (ScDebugDrawVertex) {.position = c[6], .color = color};
-    vertices[14] = (ScDebugDrawVertex) {.position = c[6], .color = color};
-    vertices[15] = (ScDebugDrawVertex) {.position = c[4], .color = color};
-
-    vertices[16] = (ScDebugDrawVertex) {.position = c[0], .color = color};
-    vertices[17] = (ScDebugDrawVertex) {.position = c[4], .color = color};
-    vertices[18] = (ScDebugDrawVertex) {.position = c[1], .color = color};
-    vertices[19] = (ScDebugDrawVertex) {.position = c[5], .color = color};
-    vertices[20] = (ScDebugDrawVertex) {.position = c[2], .color = color};
-    vertices[21] = (ScDebugDrawVertex) {.position = c[6], .color = color};
-    vertices[22] = (ScDebugDrawVertex) {.position = c[3], .color = color};
-    vertices[23] = (ScDebugDrawVertex) {.position = c[7], .color = color};
-    ddraw->line_count += 24;
+//
+// Debug draw - Render
+//
+
+static uint32_t sc_ddraw_instance_count(const ScDebugDraw* ddraw) {
+    uint32_t instance_count = 0;
+    for (uint32_t i = 0; i < SC_DDRAW_SHAPE_COUNT; i++) {
+        instance_count += ddraw->instance_counts[i];
+    }
+    return instance_count;
+}
+
+// Stages the lines and instances recorded this frame and any new persistent instances, before
+// the render pass.
+static void sc_ddraw_upload(ScDebugDraw* ddraw, const ScDebugUploadInfo* upload_info) {
+    // Unpack.
+    SDL_GPUDevice* device = upload_info->device;
+    ScGpuFrameUploader* uploader = upload_info->uploader;
+    const uint32_t frame_index = upload_info->frame_index;
+    const uint32_t line_count = ddraw->line_count;
+    const uint32_t instance_count = sc_ddraw_instance_count(ddraw);
+
+    // Lines.
+    if (line_count > 0) {
+        sc_ddraw_buffer_reserve(
+            device,
+            &ddraw->line_buffers[frame_index],
+            &ddraw->line_buffer_capacities[frame_index],
+            line_count,
+            sizeof(ScDebugDrawVertex)
+        );
+        const uint32_t line_byte_count = line_count * sizeof(ScDebugDrawVertex);
+        void* dst = sc_gpu_frame_uploader_alloc(
+            uploader,
+            ddraw->line_buffers[frame_index],
+            0,
+            line_byte_count
+        );
+        memcpy(dst, ddraw->lines, line_byte_count);
+    }
+
+    // Instances, grouped by shape.
+    if (instance_count > 0) {
+        sc_ddraw_buffer_reserve(
+            device,
+            &ddraw->instance_buffers[frame_index],
+            &ddraw->instance_buffer_capacities[frame_index],
+            instance_count,
+            sizeof(ScDebugDrawInstance)
+        );
+        ScDebugDrawInstance* dst = sc_gpu_frame_uploader_alloc(
+            uploader,
+            ddraw->instance_buffers[frame_index],
+            0,
+            instance_count * sizeof(ScDebugDrawInstance)
+        );
+        for (uint32_t i = 0; i < SC_DDRAW_SHAPE_COUNT; i++) {
+            memcpy(dst, ddraw->instances[i], ddraw->instance_counts[i] * sizeof(*dst));
+            dst += ddraw->instance_counts[i];
+        }
+    }
+
+    // Persistent instances.
+    for (ScDebugDrawPersistent* it = ddraw->persistent_list; it != NULL; it = it->next) {
+        if (it->pending_instances == NULL) {
+            continue;
+        }
+        const uint32_t byte_count = it->instance_count * sizeof(ScDebugDrawInstance);
+        void* dst = sc_gpu_frame_uploader_alloc(uploader, it->instance_buffer, 0, byte_count);
+        memcpy(dst, it->pending_instances, byte_count);
+        free(it->pending_instances);
+        it->pending_instances = NULL;
+    }
 }
 
 static void sc_ddraw_render(ScDebugDraw* ddraw, ScDebugRenderInfo* render_info) {
+    // Counts.
+    const uint32_t line_count = ddraw->line_count;
+    const uint32_t instance_count = sc_ddraw_instance_count(ddraw);
+
     // Early out.
-    if (ddraw->line_count == 0) {
+    if (line_count == 0 && instance_count == 0 && ddraw->persistent_list == NULL) {
         return;
     }
 
     // Unpack.
-    SDL_GPUDevice* device = render_info->device;
     SDL_GPUCommandBuffer* command_buffer = render_info->command_buffer;
     SDL_GPURenderPass* render_pass = render_info->render_pass;
     SDL_GPUViewport viewport = render_info->viewport;
     const uint32_t frame_index = render_info->frame_index;
-    SDL_GPUTransferBuffer* line_transfer_buffer = ddraw->line_transfer_buffers[frame_index];
     SDL_GPUBuffer* line_buffer = ddraw->line_buffers[frame_index];
+    SDL_GPUBuffer* instance_buffer = ddraw->instance_buffers[frame_index];
 
-    // Copy to device.
-    const uint32_t line_byte_count = ddraw->line_count * sizeof(ScDebugDrawVertex);
-    ScDebugDrawVertex* dst = SDL_MapGPUTransferBuffer(device, line_transfer_buffer, false);
-    memcpy(dst, ddraw->lines, line_byte_count);
-    SDL_UnmapGPUTransferBuffer(device, line_transfer_buffer);
-
-    // Device commands.
-    SDL_GPUCommandBuffer* upload_buffer = SDL_AcquireGPUCommandBuffer(device);
-    SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(upload_buffer);
-    SDL_UploadToGPUBuffer(
-        copy_pass,
-        &(SDL_GPUTransferBufferLocation) {
-            .transfer_buffer = line_transfer_buffer,
-            .offset = 0,
-        },
-        &(SDL_GPUBufferRegion) {
-            .buffer = line_buffer,
-            .offset = 0,
-            .size = line_byte_count,
-        },
-        false
-    );
-    SDL_EndGPUCopyPass(copy_pass);
-    SDL_SubmitGPUCommandBuffer(upload_buffer);
-
-    // Render.
-    SDL_BindGPUGraphicsPipeline(render_pass, ddraw->line_pipeline);
-    SDL_BindGPUVertexBuffers(
-        render_pass,
-        0,
-        (SDL_GPUBufferBinding[]) {
-            {
-                .buffer = line_buffer,
-                .offset = 0,
-            },
-        },
-        1
-    );
+    // Render - shared state.
     SDL_SetGPUViewport(render_pass, &viewport);
     SDL_PushGPUVertexUniformData(
         command_buffer,
@@ -283,8 +748,86 @@ static void sc_ddraw_render(ScDebugDraw* ddraw, ScDebugRenderInfo* render_info)
         &render_info->clip_from_world,
         sizeof(render_info->clip_from_world)
     );
-    SDL_DrawGPUPrimitives(render_pass, ddraw->line_count, 1, 0, 0);
+
+    // Render - lines.
+    if (line_count > 0) {
+        SDL_BindGPUGraphicsPipeline(render_pass, ddraw->line_pipeline);
+        SDL_BindGPUVertexBuffers(
+            render_pass,
+            0,
+            (SDL_GPUBufferBinding[]) {
+                {
+                    .buffer = line_buffer,
+                    .offset = 0,
+                },
+            },
+            1
+        );
+        SDL_DrawGPUPrimitives(render_pass, line_count, 1, 0, 0);
+    }
+
+    // Render - instances, one draw per shape.
+    SDL_BindGPUGraphicsPipeline(render_pass, ddraw->instance_pipeline);
+    if (instance_count > 0) {
+        SDL_BindGPUVertexBuffers(
+            render_pass,
+            0,
+            (SDL_GPUBufferBinding[]) {
+                {
+                    .buffer = ddraw->shape_buffer,
+                    .offset = 0,
+                },
+                {
+                    .buffer = instance_buffer,
+                    .offset = 0,
+                },
+            },
+            2
+        );
+        uint32_t first_instance = 0;
+        for (uint32_t i = 0; i < SC_DDRAW_SHAPE_COUNT; i++) {
+            if (ddraw->instance_counts[i] > 0) {
+                SDL_DrawGPUPrimitives(
+                    render_pass,
+                    SC_DDRAW_SHAPE_VERTEX_COUNT[i],
+                    ddraw->instance_counts[i],
+                    SC_DDRAW_SHAPE_FIRST_VERTEX[i],
+                    first_instance
+                );
+            }
+            first_instance += ddraw->instance_counts[i];
+        }
+    }
+
+    // Render - persistent instances.
+    for (ScDebugDrawPersistent* it = ddraw->persistent_list; it != NULL; it = it->next) {
+        if (!it->visible) {
+            continue;
+        }
+        SDL_BindGPUVertexBuffers(
+            render_pass,
+            0,
+            (SDL_GPUBufferBinding[]) {
+                {
+                    .buffer = ddraw->shape_buffer,
+                    .offset = 0,
+                },
+                {
+                    .buffer = it->instance_buffer,
+                    .offset = 0,
+                },
+            },
+            2
+        );
+        SDL_DrawGPUPrimitives(
+            render_pass,
+            SC_DDRAW_SHAPE_VERTEX_COUNT[it->shape],
+            it->instance_count,
+            SC_DDRAW_SHAPE_FIRST_VERTEX[it->shape],
+            0
+        );
+    }
 
     // Reset.
-    ddraw->line_count = 0;
+    sc_ddraw_frame_begin(ddraw, ddraw->arena);
 }
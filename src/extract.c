@@ -0,0 +1,767 @@
+//
+// Stormcloud Extract - Includes.
+//
+
+#include "common.h"
+#include "alloc.h"
+#include "job.h"
+#include "math.h"
+#include "color.h"
+#include "camera.h"
+#include "octree.h"
+
+//
+// Stormcloud Extract - Copy the part of an octree inside a region to a new octree.
+//
+
+// Usage:
+//   stormcloud_extract <input.oct> <output.oct> box <x0> <y0> <z0> <x1> <y1> <z1>
+//   stormcloud_extract <input.oct> <output.oct> polygon <x0> <y0> <x1> <y1> <x2> <y2> ...
+
+// Notes:
+// - Coordinates are in world units. Polygons are in the xy plane and extend along z, which is up.
+// - Only the header, nodes and tables of the source are loaded. Nodes are classified against the
+//   region, and points are read from disk for kept nodes only, so the cost follows the size of
+//   the region rather than the size of the source.
+// - Nodes crossing the boundary of the region have their points filtered one by one. Interior
+//   nodes are filtered like leaves, so coarse levels show nothing outside the region either.
+// - The output is re-rooted at the smallest node holding everything kept, which is the first node
+//   with kept points of its own or more than one kept child. Node bounds keep their unit
+//   coordinates, so points are copied as they are, without quantizing again.
+// - Levels are recounted from the leaves of the output. An interior node whose children all fall
+//   outside the region becomes a leaf, and its subsampled points are the finest data left there.
+// - The output is written front to back. Offsets are known before any point is written, only
+//   the point bounds in the header are patched at the end.
+
+typedef enum ScExtractRegionKind {
+    SC_EXTRACT_REGION_KIND_BOX,
+    SC_EXTRACT_REGION_KIND_POLYGON,
+    SC_EXTRACT_REGION_KIND_COUNT,
+} ScExtractRegionKind;
+
+static const char* SC_EXTRACT_REGION_KIND_NAME[] = {
+    "box",
+    "polygon",
+};
+
+typedef enum ScExtractSide {
+    SC_EXTRACT_SIDE_OUTSIDE,
+    SC_EXTRACT_SIDE_INTERSECT,
+    SC_EXTRACT_SIDE_INSIDE,
+    SC_EXTRACT_SIDE_COUNT,
+} ScExtractSide;
+
+typedef struct ScExtractRegion {
+    ScExtractRegionKind kind;
+    // The box, or the polygon bounds with an unbounded z range.
+    box3f bounds;
+    vec2f* vertices;
+    uint32_t vertex_count;
+} ScExtractRegion;
+
+typedef struct ScExtract {
+    const ScOctree* source;
+    const ScExtractRegion* region;
+
+    // Per source node.
+    ScExtractSide* sides;
+    // Indices of the kept points within the node, only for nodes crossing the boundary.
+    uint32_t** kept_points;
+    uint32_t* kept_counts;
+    bool* kept_nodes;
+    uint32_t* kept_child_counts;
+
+    // Nodes intersecting the region, depth first, and those of them crossing the boundary.
+    uint32_t* visited_nodes;
+    uint32_t visited_node_count;
+    uint32_t* filter_nodes;
+    uint32_t filter_node_count;
+
+    // Output.
+    uint32_t root;
+    uint32_t* output_nodes;
+    uint32_t output_node_count;
+    uint64_t output_point_count;
+    uint64_t read_byte_count;
+} ScExtract;
+
+//
+// Region
+//
+
+// Even-odd rule.
+static bool sc_extract_polygon_contains(const ScExtractRegion* region, float x, float y) {
+    bool inside = false;
+    for (uint32_t i = 0, j = region->vertex_count - 1; i < region->vertex_count; j = i++) {
+        const vec2f a = region->vertices[i];
+        const vec2f b = region->vertices[j];
+        if ((a.y > y) != (b.y > y) && x < a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+// Clips the segment against the rectangle, Liang-Barsky.
+static bool sc_extract_segment_intersects_rect(vec2f a, vec2f b, vec2f mn, vec2f mx) {
+    const float origin[2] = {a.x, a.y};
+    const float direction[2] = {b.x - a.x, b.y - a.y};
+    const float lo[2] = {mn.x, mn.y};
+    const float hi[2] = {mx.x, mx.y};
+    float t_min = 0.0f;
+    float t_max = 1.0f;
+    for (uint32_t c = 0; c < 2; c++) {
+        if (direction[c] == 0.0f) {
+            if (origin[c] < lo[c] || origin[c] > hi[c]) {
+                return false;
+            }
+            continue;
+        }
+        const float t_lo = (lo[c] - origin[c]) / direction[c];
+        const float t_hi = (hi[c] - origin[c]) / direction[c];
+        t_min = SDL_max(t_min, SDL_min(t_lo, t_hi));
+        t_max = SDL_min(t_max, SDL_max(t_lo, t_hi));
+        if (t_min > t_max) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sc_extract_region_contains(const ScExtractRegion* region, vec3f point) {
+    if (!box3f_contains(region->bounds, point)) {
+        return false;
+    }
+    return region->kind == SC_EXTRACT_REGION_KIND_BOX
+           || sc_extract_polygon_contains(region, point.x, point.y);
+}
+
+static ScExtractSide sc_extract_region_classify(const ScExtractRegion* region, box3f box) {
+    // Bounds.
+    if (!box3f_intersects(region->bounds, box)) {
+        return SC_EXTRACT_SIDE_OUTSIDE;
+    }
+    if (region->kind == SC_EXTRACT_REGION_KIND_BOX) {
+        return box3f_contains(region->bounds, box.mn) && box3f_contains(region->bounds, box.mx)
+                   ? SC_EXTRACT_SIDE_INSIDE
+                   : SC_EXTRACT_SIDE_INTERSECT;
+    }
+
+    // Polygon, crossed by an edge or contained in the rectangle.
+    const vec2f mn = {box.mn.x, box.mn.y};
+    const vec2f mx = {box.mx.x, box.mx.y};
+    for (uint32_t i = 0, j = region->vertex_count - 1; i < region->vertex_count; j = i++) {
+        if (sc_extract_segment_intersects_rect(region->vertices[j], region->vertices[i], mn, mx)) {
+            return SC_EXTRACT_SIDE_INTERSECT;
+        }
+    }
+
+    // Otherwise the rectangle is entirely on one side.
+    return sc_extract_polygon_contains(region, mn.x, mn.y) ? SC_EXTRACT_SIDE_INSIDE
+                                                           : SC_EXTRACT_SIDE_OUTSIDE;
+}
+
+// Parses the region from the arguments after the output path.
+static bool sc_extract_region_parse(ScExtractRegion* region, int argc, char** argv) {
+    // Kind.
+    SDL_zerop(region);
+    region->kind = SC_EXTRACT_REGION_KIND_COUNT;
+    for (uint32_t i = 0; i < SC_EXTRACT_REGION_KIND_COUNT; i++) {
+        if (SDL_strcmp(argv[0], SC_EXTRACT_REGION_KIND_NAME[i]) == 0) {
+            region->kind = (ScExtractRegionKind)i;
+        }
+    }
+
+    // Coordinates.
+    const int32_t value_count = argc - 1;
+    float* values = malloc((size_t)SDL_max(value_count, 1) * sizeof(float));
+    for (int32_t i = 0; i < value_count; i++) {
+        values[i] = (float)atof(argv[i + 1]);
+    }
+    bool ok = true;
+    switch (region->kind) {
+        case SC_EXTRACT_REGION_KIND_BOX: {
+            if (value_count != 6) {
+                SC_LOG_ERROR("A box takes 6 coordinates, got %d", value_count);
+                ok = false;
+                break;
+            }
+            region->bounds = (box3f) {
+                .mn = {SDL_min(values[0], values[3]),
+                       SDL_min(values[1], values[4]),
+                       SDL_min(values[2], values[5])},
+                .mx = {SDL_max(values[0], values[3]),
+                       SDL_max(values[1], values[4]),
+                       SDL_max(values[2], values[5])},
+            };
+            break;
+        }
+        case SC_EXTRACT_REGION_KIND_POLYGON: {
+            if (value_count < 6 || value_count % 2 != 0) {
+                SC_LOG_ERROR("A polygon takes at least 3 xy pairs, got %d values", value_count);
+                ok = false;
+                break;
+            }
+            region->vertex_count = (uint32_t)value_count / 2;
+            region->vertices = malloc(region->vertex_count * sizeof(vec2f));
+            region->bounds = (box3f) {
+                .mn = {FLT_MAX, FLT_MAX, -FLT_MAX},
+                .mx = {-FLT_MAX, -FLT_MAX, FLT_MAX},
+            };
+            for (uint32_t i = 0; i < region->vertex_count; i++) {
+                const vec2f vertex = {values[2 * i + 0], values[2 * i + 1]};
+                region->vertices[i] = vertex;
+                region->bounds.mn.x = SDL_min(region->bounds.mn.x, vertex.x);
+                region->bounds.mn.y = SDL_min(region->bounds.mn.y, vertex.y);
+                region->bounds.mx.x = SDL_max(region->bounds.mx.x, vertex.x);
+                region->bounds.mx.y = SDL_max(region->bounds.mx.y, vertex.y);
+            }
+            break;
+        }
+        default:
+            SC_LOG_ERROR("Unknown region %s, expected box or polygon", argv[0]);
+            ok = false;
+            break;
+    }
+    free(values);
+    return ok;
+}
+
+static void sc_extract_region_free(ScExtractRegion* region) {
+    free(region->vertices);
+}
+
+//
+// Points
+//
+
+static SC_INLINE ScOctreePoint
+sc_extract_point(const ScOctree* source, const uint8_t* data, uint32_t point_idx) {
+    if (source->point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+        return sc_octree_point_expand(((const ScOctreePointCompact*)data)[point_idx]);
+    }
+    return ((const ScOctreePoint*)data)[point_idx];
+}
+
+// Decodes as min + q / 1023 * extent, in world units.
+static SC_INLINE vec3f
+sc_extract_point_position(const ScOctree* source, const ScOctreeNode* node, ScOctreePoint point) {
+    const float scale = source->node_world_scale;
+    const float qx = (float)(point.position & 1023) / 1023.0f;
+    const float qy = (float)((point.position >> 10) & 1023) / 1023.0f;
+    const float qz = (float)((point.position >> 20) & 1023) / 1023.0f;
+    return (vec3f) {
+        scale * ((float)node->min_x + qx * (float)(node->max_x - node->min_x)),
+        scale * ((float)node->min_y + qy * (float)(node->max_y - node->min_y)),
+        scale * ((float)node->min_z + qz * (float)(node->max_z - node->min_z)),
+    };
+}
+
+// Filters the points of nodes crossing the boundary, each worker with its own handle.
+static void sc_extract_filter(void* user_data, uint32_t begin, uint32_t end) {
+    ScExtract* extract = user_data;
+    const ScOctree* source = extract->source;
+    const uint64_t point_file_offset = sc_octree_point_file_offset(source);
+    const uint32_t point_stride = sc_octree_point_stride(source->point_format);
+    SDL_IOStream* io = SDL_IOFromFile(source->file_path, "rb");
+    SC_SDL_ASSERT(io != NULL);
+    uint8_t* data = NULL;
+    uint64_t capacity = 0;
+    for (uint32_t i = begin; i < end; i++) {
+        const uint32_t node_idx = extract->filter_nodes[i];
+        const ScOctreeNode* node = &source->nodes[node_idx];
+        sc_octree_stream_read(
+            io,
+            point_file_offset,
+            point_stride,
+            node->point_offset,
+            node->point_count,
+            &data,
+            &capacity
+        );
+        uint32_t* kept = malloc(SDL_max(node->point_count, 1) * sizeof(uint32_t));
+        uint32_t kept_count = 0;
+        for (uint32_t j = 0; j < node->point_count; j++) {
+            const ScOctreePoint point = sc_extract_point(source, data, j);
+            const vec3f position = sc_extract_point_position(source, node, point);
+            if (sc_extract_region_contains(extract->region, position)) {
+                kept[kept_count++] = j;
+            }
+        }
+        extract->kept_points[node_idx] = kept;
+        extract->kept_counts[node_idx] = kept_count;
+    }
+    free(data);
+    SDL_CloseIO(io);
+}
+
+// Copies the kept elements of a node, returns the count.
+static uint32_t sc_extract_gather(
+    const ScExtract* extract,
+    uint32_t node_idx,
+    uint32_t stride,
+    const uint8_t* src,
+    uint8_t* dst
+) {
+    const uint32_t count = extract->kept_counts[node_idx];
+    const uint32_t* kept = extract->kept_points[node_idx];
+    if (kept == NULL) {
+        memcpy(dst, src, (uint64_t)count * stride);
+        return count;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(dst + (uint64_t)i * stride, src + (uint64_t)kept[i] * stride, stride);
+    }
+    return count;
+}
+
+//
+// Extract
+//
+
+// Classifies, filters and prunes the source nodes. Returns false if nothing is inside.
+static bool
+sc_extract_new(ScExtract* extract, const ScOctree* source, const ScExtractRegion* region) {
+    // Allocate.
+    const uint64_t node_count = source->node_count;
+    *extract = (ScExtract) {
+        .source = source,
+        .region = region,
+        .sides = calloc(node_count, sizeof(ScExtractSide)),
+        .kept_points = calloc(node_count, sizeof(uint32_t*)),
+        .kept_counts = calloc(node_count, sizeof(uint32_t)),
+        .kept_nodes = calloc(node_count, sizeof(bool)),
+        .kept_child_counts = calloc(node_count, sizeof(uint32_t)),
+        .visited_nodes = malloc(node_count * sizeof(uint32_t)),
+        .filter_nodes = malloc(node_count * sizeof(uint32_t)),
+        .output_nodes = malloc(node_count * sizeof(uint32_t)),
+    };
+    if (node_count == 0) {
+        return false;
+    }
+
+    // Classify, depth first. Descendants of nodes inside the region are inside too.
+    uint32_t* stack = malloc(node_count * sizeof(uint32_t));
+    uint32_t stack_count = 0;
+    extract->sides[0] = sc_extract_region_classify(region, sc_octree_node_bounds(source, 0));
+    if (extract->sides[0] != SC_EXTRACT_SIDE_OUTSIDE) {
+        stack[stack_count++] = 0;
+    }
+    while (stack_count > 0) {
+        const uint32_t node_idx = stack[--stack_count];
+        const ScOctreeNode* node = &source->nodes[node_idx];
+        const bool inside = extract->sides[node_idx] == SC_EXTRACT_SIDE_INSIDE;
+        extract->visited_nodes[extract->visited_node_count++] = node_idx;
+        if (inside) {
+            extract->kept_counts[node_idx] = node->point_count;
+        } else {
+            extract->filter_nodes[extract->filter_node_count++] = node_idx;
+        }
+        for (uint32_t octant = 8; octant-- > 0;) {
+            const uint32_t child = node->octants[octant];
+            if (child == ~0u) {
+                continue;
+            }
+            extract->sides[child] =
+                inside ? SC_EXTRACT_SIDE_INSIDE
+                       : sc_extract_region_classify(region, sc_octree_node_bounds(source, child));
+            if (extract->sides[child] != SC_EXTRACT_SIDE_OUTSIDE) {
+                stack[stack_count++] = child;
+            }
+        }
+    }
+    free(stack);
+
+    // Filter the nodes crossing the boundary.
+    sc_job_parallel_for(sc_extract_filter, extract, extract->filter_node_count, 1);
+
+    // Prune nodes left without points or children, children before parents.
+    for (uint32_t i = extract->visited_node_count; i-- > 0;) {
+        const uint32_t node_idx = extract->visited_nodes[i];
+        const ScOctreeNode* node = &source->nodes[node_idx];
+        for (uint32_t octant = 0; octant < 8; octant++) {
+            const uint32_t child = node->octants[octant];
+            extract->kept_child_counts[node_idx] += child != ~0u && extract->kept_nodes[child];
+        }
+        extract->kept_nodes[node_idx] =
+            extract->kept_counts[node_idx] > 0 || extract->kept_child_counts[node_idx] > 0;
+    }
+    if (!extract->kept_nodes[0]) {
+        return false;
+    }
+
+    // Re-root, down to the first node which keeps points or does not have a single kept child.
+    uint32_t root = 0;
+    while (extract->kept_counts[root] == 0 && extract->kept_child_counts[root] == 1) {
+        const ScOctreeNode* node = &source->nodes[root];
+        for (uint32_t octant = 0; octant < 8; octant++) {
+            const uint32_t child = node->octants[octant];
+            if (child != ~0u && extract->kept_nodes[child]) {
+                root = child;
+                break;
+            }
+        }
+    }
+    extract->root = root;
+
+    // Output order, depth first from the new root.
+    stack = malloc(node_count * sizeof(uint32_t));
+    stack_count = 0;
+    stack[stack_count++] = root;
+    while (stack_count > 0) {
+        const uint32_t node_idx = stack[--stack_count];
+        extract->output_nodes[extract->output_node_count++] = node_idx;
+        extract->output_point_count += extract->kept_counts[node_idx];
+        for (uint32_t octant = 8; octant-- > 0;) {
+            const uint32_t child = source->nodes[node_idx].octants[octant];
+            if (child != ~0u && extract->kept_nodes[child]) {
+                stack[stack_count++] = child;
+            }
+        }
+    }
+    free(stack);
+    return true;
+}
+
+static void sc_extract_free(ScExtract* extract) {
+    for (uint32_t i = 0; i < extract->filter_node_count; i++) {
+        free(extract->kept_points[extract->filter_nodes[i]]);
+    }
+    free(extract->sides);
+    free(extract->kept_points);
+    free(extract->kept_counts);
+    free(extract->kept_nodes);
+    free(extract->kept_child_counts);
+    free(extract->visited_nodes);
+    free(extract->filter_nodes);
+    free(extract->output_nodes);
+}
+
+// Output nodes, re-indexed with the new root first.
+static ScOctreeNode* sc_extract_nodes(const ScExtract* extract) {
+    // Indices.
+    const ScOctree* source = extract->source;
+    const uint32_t node_count = extract->output_node_count;
+    uint32_t* output_indices = malloc(source->node_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < node_count; i++) {
+        output_indices[extract->output_nodes[i]] = i;
+    }
+
+    // Nodes.
+    ScOctreeNode* nodes = malloc(node_count * sizeof(ScOctreeNode));
+    uint64_t point_offset = 0;
+    for (uint32_t i = 0; i < node_count; i++) {
+        const uint32_t node_idx = extract->output_nodes[i];
+        ScOctreeNode* node = &nodes[i];
+        *node = source->nodes[node_idx];
+        node->octant_mask = 0;
+        for (uint32_t octant = 0; octant < 8; octant++) {
+            const uint32_t child = node->octants[octant];
+            if (child != ~0u && extract->kept_nodes[child]) {
+                node->octants[octant] = output_indices[child];
+                node->octant_mask |= (uint16_t)(1u << octant);
+            } else {
+                node->octants[octant] = ~0u;
+            }
+        }
+        node->point_count = extract->kept_counts[node_idx];
+        node->point_offset = point_offset;
+        point_offset += node->point_count;
+    }
+    free(output_indices);
+
+    // Levels count up from the leaves again, pruning may have shortened subtrees. Children come
+    // after their parents.
+    for (uint32_t i = node_count; i-- > 0;) {
+        ScOctreeNode* node = &nodes[i];
+        uint32_t level = 0;
+        for (uint32_t octant = 0; octant < 8; octant++) {
+            if (node->octants[octant] != ~0u) {
+                level = SDL_max(level, (uint32_t)nodes[node->octants[octant]].level + 1);
+            }
+        }
+        node->level = (uint16_t)level;
+    }
+    return nodes;
+}
+
+// Streams the output front to back. Node geometry is copied for nodes inside the region if the
+// source has it, and measured otherwise.
+static bool
+sc_extract_write(ScExtract* extract, bool source_geometry_loaded, const char* file_path) {
+    // Unpack.
+    const ScOctree* source = extract->source;
+    const uint32_t node_count = extract->output_node_count;
+    const uint64_t point_count = extract->output_point_count;
+    const uint32_t point_stride = sc_octree_point_stride(source->point_format);
+    const uint64_t point_file_offset = sc_octree_point_file_offset(source);
+    ScOctreeNode* nodes = sc_extract_nodes(extract);
+    SDL_IOStream* io = SDL_IOFromFile(file_path, "wb");
+    if (io == NULL) {
+        SC_LOG_ERROR("Failed to open %s: %s", file_path, SDL_GetError());
+        free(nodes);
+        return false;
+    }
+
+    // Header, the point bounds are patched once the points have been seen.
+    bool ok = true;
+    const uint64_t node_count_u64 = node_count;
+    box3f point_bounds = {
+        .mn = {FLT_MAX, FLT_MAX, FLT_MAX},
+        .mx = {-FLT_MAX, -FLT_MAX, -FLT_MAX},
+    };
+    ok &= SDL_WriteIO(io, SC_OCTREE_POINT_FORMAT_MAGIC[source->point_format], 8) == 8;
+    ok &= SDL_WriteIO(io, &node_count_u64, sizeof(uint64_t)) == sizeof(uint64_t);
+    ok &= SDL_WriteIO(io, &point_count, sizeof(uint64_t)) == sizeof(uint64_t);
+    ok &= SDL_WriteIO(io, &point_bounds, sizeof(box3f)) == sizeof(box3f);
+    ok &= SDL_WriteIO(io, &source->unit_world_scale, sizeof(float)) == sizeof(float);
+    ok &= SDL_WriteIO(io, &source->node_unit_count, sizeof(float)) == sizeof(float);
+    ok &= SDL_WriteIO(io, &source->node_world_scale, sizeof(float)) == sizeof(float);
+
+    // Nodes.
+    const uint64_t node_byte_count = node_count * sizeof(ScOctreeNode);
+    ok &= SDL_WriteIO(io, nodes, node_byte_count) == node_byte_count;
+    extract->read_byte_count = source->node_count * sizeof(ScOctreeNode);
+
+    // Points, node by node.
+    SDL_IOStream* source_io = SDL_IOFromFile(source->file_path, "rb");
+    SC_SDL_ASSERT(source_io != NULL);
+    ScOctreeNodeGeometry* node_geometry = malloc(node_count * sizeof(ScOctreeNodeGeometry));
+    uint8_t* src = NULL;
+    uint64_t src_capacity = 0;
+    uint8_t* dst = NULL;
+    uint64_t dst_capacity = 0;
+    for (uint32_t i = 0; i < node_count && ok; i++) {
+        // Read.
+        const uint32_t node_idx = extract->output_nodes[i];
+        const ScOctreeNode* source_node = &source->nodes[node_idx];
+        const ScOctreeNode* node = &nodes[i];
+        sc_octree_stream_read(
+            source_io,
+            point_file_offset,
+            point_stride,
+            source_node->point_offset,
+            source_node->point_count,
+            &src,
+            &src_capacity
+        );
+        extract->read_byte_count += (uint64_t)source_node->point_count * point_stride;
+
+        // Filter and write.
+        const uint64_t byte_count = (uint64_t)node->point_count * point_stride;
+        sc_octree_reserve(&dst, &dst_capacity, byte_count);
+        sc_extract_gather(extract, node_idx, point_stride, src, dst);
+        ok &= SDL_WriteIO(io, dst, byte_count) == byte_count;
+
+        // Bounds.
+        for (uint32_t j = 0; j < node->point_count; j++) {
+            const ScOctreePoint point = sc_extract_point(source, dst, j);
+            const vec3f position = sc_extract_point_position(source, node, point);
+            point_bounds.mn = vec3f_min(point_bounds.mn, position);
+            point_bounds.mx = vec3f_max(point_bounds.mx, position);
+        }
+
+        // Geometry, measured on a view of this node alone.
+        if (source_geometry_loaded && extract->kept_points[node_idx] == NULL) {
+            node_geometry[i] = source->node_geometry[node_idx];
+            continue;
+        }
+        ScOctreeNode view_node = *node;
+        view_node.point_offset = 0;
+        ScOctree view = {
+            .node_unit_count = source->node_unit_count,
+            .node_world_scale = source->node_world_scale,
+            .nodes = &view_node,
+            .node_geometry = &node_geometry[i],
+            .node_count = 1,
+            .point_format = source->point_format,
+        };
+        if (source->point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+            view.compact_points = (ScOctreePointCompact*)dst;
+        } else {
+            view.points = (ScOctreePoint*)dst;
+        }
+        sc_octree_node_geometry_measure(&view, 0, 1);
+    }
+
+    // Attributes, one stream at a time.
+    if (ok && source->attribute_mask != 0) {
+        ok &= SDL_WriteIO(io, "TOKYOATR", 8) == 8;
+        ok &= SDL_WriteIO(io, &source->attribute_mask, sizeof(uint32_t)) == sizeof(uint32_t);
+    }
+    for (uint32_t a = 0; a < SC_OCTREE_ATTRIBUTE_COUNT && ok; a++) {
+        if (!sc_octree_attribute_available(source, (ScOctreeAttribute)a)) {
+            continue;
+        }
+        const uint32_t stride = SC_OCTREE_ATTRIBUTE_STRIDE[a];
+        for (uint32_t i = 0; i < node_count && ok; i++) {
+            const uint32_t node_idx = extract->output_nodes[i];
+            const ScOctreeNode* source_node = &source->nodes[node_idx];
+            sc_octree_stream_read(
+                source_io,
+                source->attribute_file_offsets[a],
+                stride,
+                source_node->point_offset,
+                source_node->point_count,
+                &src,
+                &src_capacity
+            );
+            extract->read_byte_count += (uint64_t)source_node->point_count * stride;
+            const uint64_t byte_count = (uint64_t)nodes[i].point_count * stride;
+            sc_octree_reserve(&dst, &dst_capacity, byte_count);
+            sc_extract_gather(extract, node_idx, stride, src, dst);
+            ok &= SDL_WriteIO(io, dst, byte_count) == byte_count;
+        }
+    }
+    SDL_CloseIO(source_io);
+
+    // Node geometry, then the point bounds.
+    if (ok) {
+        const uint64_t geometry_byte_count = node_count * sizeof(ScOctreeNodeGeometry);
+        ok &= SDL_WriteIO(io, "TOKYOGEO", 8) == 8;
+        ok &= SDL_WriteIO(io, node_geometry, geometry_byte_count) == geometry_byte_count;
+        const Sint64 bounds_offset = (Sint64)(8 + 2 * sizeof(uint64_t));
+        ok &= SDL_SeekIO(io, bounds_offset, SDL_IO_SEEK_SET) == bounds_offset;
+        ok &= SDL_WriteIO(io, &point_bounds, sizeof(box3f)) == sizeof(box3f);
+    }
+    ok &= SDL_CloseIO(io);
+    if (!ok) {
+        SC_LOG_ERROR("Failed to write %s: %s", file_path, SDL_GetError());
+    }
+
+    // Free.
+    free(src);
+    free(dst);
+    free(node_geometry);
+    free(nodes);
+    return ok;
+}
+
+//
+// Main
+//
+
+SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
+    // Arguments.
+    SC_UNUSED(appstate);
+    if (argc < 4) {
+        SC_LOG_ERROR(
+            "Usage: %s <input.oct> <output.oct> box <x0> <y0> <z0> <x1> <y1> <z1>",
+            argv[0]
+        );
+        SC_LOG_ERROR(
+            "       %s <input.oct> <output.oct> polygon <x0> <y0> <x1> <y1> ...",
+            argv[0]
+        );
+        return SDL_APP_FAILURE;
+    }
+    const char* input_path = argv[1];
+    const char* output_path = argv[2];
+    if (SDL_strcmp(input_path, output_path) == 0) {
+        SC_LOG_ERROR("Input and output must be different files");
+        return SDL_APP_FAILURE;
+    }
+    ScExtractRegion region;
+    if (!sc_extract_region_parse(&region, argc - 3, argv + 3)) {
+        sc_extract_region_free(&region);
+        return SDL_APP_FAILURE;
+    }
+
+    // Input, checked before loading.
+    SDL_PathInfo source_info;
+    if (!sc_octree_probe(input_path)) {
+        sc_extract_region_free(&region);
+        return SDL_APP_FAILURE;
+    }
+    if (!SDL_GetPathInfo(input_path, &source_info)) {
+        SC_LOG_ERROR("Failed to stat %s: %s", input_path, SDL_GetError());
+        sc_extract_region_free(&region);
+        return SDL_APP_FAILURE;
+    }
+
+    // Jobs, on all cores.
+    sc_job_system_new(&(ScJobSystemCreateInfo) {
+        .worker_count = 0,
+        .pin_workers = false,
+    });
+    const uint64_t begin_time_ns = SDL_GetTicksNS();
+
+    // Source, without points.
+    ScOctree source = {0};
+    sc_octree_header_load(&source, input_path);
+    const bool source_geometry_loaded = sc_octree_tables_load(&source);
+    source.node_instances = malloc(source.node_count * sizeof(ScOctreeNodeInstance));
+    sc_job_parallel_for(
+        sc_octree_node_instances_convert,
+        &source,
+        (uint32_t)source.node_count,
+        SC_OCTREE_NODE_INSTANCE_GRAIN
+    );
+
+    // Extract.
+    ScExtract extract;
+    const bool found = sc_extract_new(&extract, &source, &region);
+    const bool written = found && sc_extract_write(&extract, source_geometry_loaded, output_path);
+    const uint64_t end_time_ns = SDL_GetTicksNS();
+
+    // Report.
+    if (!found) {
+        SC_LOG_ERROR("No points of %s are inside the region", input_path);
+    }
+    uint32_t side_counts[SC_EXTRACT_SIDE_COUNT] = {0};
+    uint32_t coarse_leaf_count = 0;
+    for (uint32_t i = 0; i < extract.output_node_count; i++) {
+        const uint32_t node_idx = extract.output_nodes[i];
+        side_counts[extract.sides[node_idx]]++;
+        coarse_leaf_count +=
+            source.nodes[node_idx].level > 0 && extract.kept_child_counts[node_idx] == 0;
+    }
+    SC_LOG_INFO(
+        "Region: %s, new root is node %u at level %u",
+        SC_EXTRACT_REGION_KIND_NAME[region.kind],
+        extract.root,
+        found ? source.nodes[extract.root].level : 0
+    );
+    SC_LOG_INFO(
+        "Nodes: %u of %" PRIu64 ", %u inside, %u filtered, %u interior now leaves",
+        extract.output_node_count,
+        source.node_count,
+        side_counts[SC_EXTRACT_SIDE_INSIDE],
+        side_counts[SC_EXTRACT_SIDE_INTERSECT],
+        coarse_leaf_count
+    );
+    SC_LOG_INFO("Points: %" PRIu64 " of %" PRIu64, extract.output_point_count, source.point_count);
+    SC_LOG_INFO(
+        "Read %.1f MB of %.1f MB in %.3f ms",
+        (double)extract.read_byte_count / (1024.0 * 1024.0),
+        (double)source_info.size / (1024.0 * 1024.0),
+        (double)(end_time_ns - begin_time_ns) / 1e6
+    );
+    if (written) {
+        SC_LOG_INFO("Wrote %s", output_path);
+    }
+
+    // Free.
+    sc_extract_free(&extract);
+    sc_octree_free(&source);
+    sc_job_system_free();
+    sc_extract_region_free(&region);
+
+    return written ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
+
+SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(event);
+    return SDL_APP_CONTINUE;
+}
+
+SDL_AppResult SDL_AppIterate(void* appstate) {
+    SC_UNUSED(appstate);
+    return SDL_APP_SUCCESS;
+}
+
+void SDL_AppQuit(void* appstate, SDL_AppResult result) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(result);
+}
@@ -1,15 +1,34 @@
 typedef struct ScGpuShaderCreateInfo {
-    const char* file_path;
+    const char* file_name;
     const char* entry_point;
     SDL_GPUShaderStage shader_stage;
     uint32_t sampler_count;
+    uint32_t storage_buffer_count;
     uint32_t uniform_buffer_count;
 } ScGpuShaderCreateInfo;
 
 static SDL_GPUShader*
 sc_gpu_shader_new(SDL_GPUDevice* device, const ScGpuShaderCreateInfo* create_info) {
+    // Format.
+    const SDL_GPUShaderFormat device_formats = SDL_GetGPUShaderFormats(device);
+    SDL_GPUShaderFormat format;
+    const char* format_dir;
+    if (device_formats & SDL_GPU_SHADERFORMAT_DXIL) {
+        format = SDL_GPU_SHADERFORMAT_DXIL;
+        format_dir = "dxil";
+    } else if (device_formats & SDL_GPU_SHADERFORMAT_SPIRV) {
+        format = SDL_GPU_SHADERFORMAT_SPIRV;
+        format_dir = "spirv";
+    } else {
+        SC_LOG_ERROR("Unsupported shader formats: 0x%x", device_formats);
+        abort();
+    }
+
+    // Load.
+    char file_path[256];
+    snprintf(file_path, sizeof(file_path), "src/shaders/%s/%s", format_dir, create_info->file_name);
     size_t code_size;
-    void* code = SDL_LoadFile(create_info->file_path, &code_size);
+    void* code = SDL_LoadFile(file_path, &code_size);
     SC_ASSERT(code != NULL && code_size > 0);
     SDL_GPUShader* shader = SDL_CreateGPUShader(
         device,
@@ -17,11 +36,11 @@ sc_gpu_shader_new(SDL_GPUDevice* device, const ScGpuShaderCreateInfo* create_inf
             .code = code,
             .code_size = code_size,
             .entrypoint = create_info->entry_point,
-            .format = SDL_GPU_SHADERFORMAT_DXIL,
+            .format = format,
             .stage = create_info->shader_stage,
             .num_samplers = create_info->sampler_count,
             .num_storage_textures = 0,
-            .num_storage_buffers = 0,
+            .num_storage_buffers = create_info->storage_buffer_count,
             .num_uniform_buffers = create_info->uniform_buffer_count,
         }
     );
@@ -29,3 +48,320 @@ sc_gpu_shader_new(SDL_GPUDevice* device, const ScGpuShaderCreateInfo* create_inf
     SDL_free(code);
     return shader;
 }
+
+//
+// Upload
+//
+
+// Streams data to GPU buffers through a small ring of transfer buffers, so the host never
+// holds more than SC_GPU_UPLOAD_RING_SIZE chunks of staging memory at once. Each chunk is
+// submitted on its own command buffer with a fence, and a slot is reused only after its
+// fence has signaled.
+#define SC_GPU_UPLOAD_RING_SIZE 4
+#define SC_GPU_UPLOAD_CHUNK_BYTE_COUNT (16 * 1024 * 1024)
+
+typedef struct ScGpuUploader {
+    SDL_GPUDevice* device;
+    SDL_GPUTransferBuffer* transfer_buffers[SC_GPU_UPLOAD_RING_SIZE];
+    SDL_GPUFence* fences[SC_GPU_UPLOAD_RING_SIZE];
+    uint32_t ring_index;
+    uint64_t upload_byte_count;
+    uint32_t upload_chunk_count;
+} ScGpuUploader;
+
+static void sc_gpu_uploader_new(ScGpuUploader* uploader, SDL_GPUDevice* device) {
+    SDL_zerop(uploader);
+    uploader->device = device;
+    for (uint32_t i = 0; i < SC_GPU_UPLOAD_RING_SIZE; i++) {
+        uploader->transfer_buffers[i] = SDL_CreateGPUTransferBuffer(
+            device,
+            &(SDL_GPUTransferBufferCreateInfo) {
+                .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+                .size = SC_GPU_UPLOAD_CHUNK_BYTE_COUNT,
+            }
+        );
+        SC_SDL_ASSERT(uploader->transfer_buffers[i] != NULL);
+    }
+}
+
+static void sc_gpu_uploader_wait(ScGpuUploader* uploader, uint32_t ring_index) {
+    SDL_GPUFence* fence = uploader->fences[ring_index];
+    if (fence == NULL) {
+        return;
+    }
+    SC_SDL_ASSERT(SDL_WaitForGPUFences(uploader->device, true, &fence, 1));
+    SDL_ReleaseGPUFence(uploader->device, fence);
+    uploader->fences[ring_index] = NULL;
+}
+
+// Uploads byte_count bytes from data to buffer at buffer_offset.
+static void sc_gpu_uploader_upload(
+    ScGpuUploader* uploader,
+    SDL_GPUBuffer* buffer,
+    uint32_t buffer_offset,
+    const void* data,
+    uint64_t byte_count
+) {
+    const uint8_t* bytes = data;
+    uint64_t offset = 0;
+    while (offset < byte_count) {
+        // Acquire slot.
+        const uint32_t ring_index = uploader->ring_index;
+        uploader->ring_index = (ring_index + 1) % SC_GPU_UPLOAD_RING_SIZE;
+        sc_gpu_uploader_wait(uploader, ring_index);
+        SDL_GPUTransferBuffer* transfer_buffer = uploader->transfer_buffers[ring_index];
+
+        // Stage.
+        const uint32_t chunk_byte_count =
+            (uint32_t)SDL_min(byte_count - offset, (uint64_t)SC_GPU_UPLOAD_CHUNK_BYTE_COUNT);
+        void* staging = SDL_MapGPUTransferBuffer(uploader->device, transfer_buffer, false);
+        memcpy(staging, bytes + offset, chunk_byte_count);
+        SDL_UnmapGPUTransferBuffer(uploader->device, transfer_buffer);
+
+        // Copy.
+        SDL_GPUCommandBuffer* upload_cmd = SDL_AcquireGPUCommandBuffer(uploader->device);
+        SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(upload_cmd);
+        SDL_UploadToGPUBuffer(
+            copy_pass,
+            &(SDL_GPUTransferBufferLocation) {
+                .transfer_buffer = transfer_buffer,
+                .offset = 0,
+            },
+            &(SDL_GPUBufferRegion) {
+                .buffer = buffer,
+                .offset = buffer_offset + (uint32_t)offset,
+                .size = chunk_byte_count,
+            },
+            false
+        );
+        SDL_EndGPUCopyPass(copy_pass);
+        uploader->fences[ring_index] = SDL_SubmitGPUCommandBufferAndAcquireFence(upload_cmd);
+        SC_SDL_ASSERT(uploader->fences[ring_index] != NULL);
+
+        // Statistics.
+        offset += chunk_byte_count;
+        uploader->upload_byte_count += chunk_byte_count;
+        uploader->upload_chunk_count++;
+    }
+}
+
+// Waits for all pending uploads before releasing the ring.
+static void sc_gpu_uploader_free(ScGpuUploader* uploader) {
+    for (uint32_t i = 0; i < SC_GPU_UPLOAD_RING_SIZE; i++) {
+        sc_gpu_uploader_wait(uploader, i);
+        SDL_ReleaseGPUTransferBuffer(uploader->device, uploader->transfer_buffers[i]);
+    }
+    SDL_zerop(uploader);
+}
+
+//
+// Frame upload
+//
+
+// Collects the uploads of one frame into shared staging memory, one chain of transfer buffers
+// per frame in flight, and records all of them in a single copy pass on the frame's command
+// buffer before the render pass. Subsystems write directly into the suballocations they are
+// handed. Overflow chains another transfer buffer; at the start of the next frame with the
+// same index the chain is merged into one buffer that fits the peak usage.
+#define SC_GPU_FRAME_UPLOAD_INITIAL_BYTE_COUNT (1024 * 1024)
+#define SC_GPU_FRAME_UPLOAD_ALIGNMENT 16
+#define SC_GPU_FRAME_UPLOAD_CHAIN_MAX 16
+
+typedef struct ScGpuFrameUploadStaging {
+    SDL_GPUTransferBuffer* transfer_buffer;
+    uint32_t capacity;
+    uint32_t offset;
+    uint8_t* mapped;
+} ScGpuFrameUploadStaging;
+
+typedef struct ScGpuFrameUploadCopy {
+    SDL_GPUTransferBuffer* transfer_buffer;
+    uint32_t transfer_offset;
+    SDL_GPUBuffer* buffer;
+    uint32_t buffer_offset;
+    uint32_t byte_count;
+} ScGpuFrameUploadCopy;
+
+typedef struct ScGpuFrameUploader {
+    SDL_GPUDevice* device;
+
+    // Staging.
+    ScGpuFrameUploadStaging stagings[SC_INFLIGHT_FRAME_COUNT][SC_GPU_FRAME_UPLOAD_CHAIN_MAX];
+    uint32_t staging_counts[SC_INFLIGHT_FRAME_COUNT];
+    uint32_t frame_index;
+
+    // Copies recorded this frame, allocated from the frame arena.
+    ScArena* arena;
+    ScGpuFrameUploadCopy* copies;
+    uint32_t copy_count;
+    uint32_t copy_capacity;
+
+    // Statistics, this frame.
+    uint64_t upload_byte_count;
+} ScGpuFrameUploader;
+
+static void sc_gpu_frame_upload_staging_new(
+    ScGpuFrameUploadStaging* staging,
+    SDL_GPUDevice* device,
+    uint32_t capacity
+) {
+    staging->transfer_buffer = SDL_CreateGPUTransferBuffer(
+        device,
+        &(SDL_GPUTransferBufferCreateInfo) {
+            .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+            .size = capacity,
+        }
+    );
+    SC_SDL_ASSERT(staging->transfer_buffer != NULL);
+    staging->capacity = capacity;
+    staging->offset = 0;
+    staging->mapped = NULL;
+}
+
+static void sc_gpu_frame_uploader_new(ScGpuFrameUploader* uploader, SDL_GPUDevice* device) {
+    SDL_zerop(uploader);
+    uploader->device = device;
+    for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
+        sc_gpu_frame_upload_staging_new(
+            &uploader->stagings[i][0],
+            device,
+            SC_GPU_FRAME_UPLOAD_INITIAL_BYTE_COUNT
+        );
+        uploader->staging_counts[i] = 1;
+    }
+}
+
+static void sc_gpu_frame_uploader_unmap(ScGpuFrameUploader* uploader, uint32_t frame_index) {
+    for (uint32_t i = 0; i < uploader->staging_counts[frame_index]; i++) {
+        ScGpuFrameUploadStaging* staging = &uploader->stagings[frame_index][i];
+        if (staging->mapped != NULL) {
+            SDL_UnmapGPUTransferBuffer(uploader->device, staging->transfer_buffer);
+            staging->mapped = NULL;
+        }
+    }
+}
+
+static void sc_gpu_frame_uploader_free(ScGpuFrameUploader* uploader) {
+    for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
+        sc_gpu_frame_uploader_unmap(uploader, i);
+        for (uint32_t j = 0; j < uploader->staging_counts[i]; j++) {
+            ScGpuFrameUploadStaging* staging = &uploader->stagings[i][j];
+            SDL_ReleaseGPUTransferBuffer(uploader->device, staging->transfer_buffer);
+        }
+    }
+    SDL_zerop(uploader);
+}
+
+// Starts recording the uploads of a frame, copies are recorded in arena.
+static void
+sc_gpu_frame_uploader_begin(ScGpuFrameUploader* uploader, ScArena* arena, uint32_t frame_index) {
+    // Discard anything left over from a frame that was never flushed.
+    sc_gpu_frame_uploader_unmap(uploader, frame_index);
+
+    // Merge the chain.
+    ScGpuFrameUploadStaging* stagings = uploader->stagings[frame_index];
+    const uint32_t staging_count = uploader->staging_counts[frame_index];
+    if (staging_count > 1) {
+        uint32_t capacity = 0;
+        for (uint32_t i = 0; i < staging_count; i++) {
+            capacity += stagings[i].capacity;
+            SDL_ReleaseGPUTransferBuffer(uploader->device, stagings[i].transfer_buffer);
+        }
+        sc_gpu_frame_upload_staging_new(&stagings[0], uploader->device, capacity);
+        uploader->staging_counts[frame_index] = 1;
+    }
+    stagings[0].offset = 0;
+
+    // Reset.
+    uploader->frame_index = frame_index;
+    uploader->arena = arena;
+    uploader->copies = NULL;
+    uploader->copy_count = 0;
+    uploader->copy_capacity = 0;
+    uploader->upload_byte_count = 0;
+}
+
+// Returns byte_count bytes of mapped staging memory, copied to buffer at buffer_offset on flush.
+static void* sc_gpu_frame_uploader_alloc(
+    ScGpuFrameUploader* uploader,
+    SDL_GPUBuffer* buffer,
+    uint32_t buffer_offset,
+    uint32_t byte_count
+) {
+    // Validation.
+    SC_ASSERT(uploader->arena != NULL);
+    SC_ASSERT(byte_count > 0);
+
+    // Suballocate, chain a new staging buffer if the current one is full.
+    const uint32_t frame_index = uploader->frame_index;
+    ScGpuFrameUploadStaging* staging =
+        &uploader->stagings[frame_index][uploader->staging_counts[frame_index] - 1];
+    uint32_t offset = (staging->offset + SC_GPU_FRAME_UPLOAD_ALIGNMENT - 1)
+                      & ~(uint32_t)(SC_GPU_FRAME_UPLOAD_ALIGNMENT - 1);
+    if (offset + byte_count > staging->capacity) {
+        SC_ASSERT(uploader->staging_counts[frame_index] < SC_GPU_FRAME_UPLOAD_CHAIN_MAX);
+        const uint32_t capacity = SDL_max(2 * staging->capacity, byte_count);
+        staging = &uploader->stagings[frame_index][uploader->staging_counts[frame_index]++];
+        sc_gpu_frame_upload_staging_new(staging, uploader->device, capacity);
+        offset = 0;
+    }
+    if (staging->mapped == NULL) {
+        staging->mapped =
+            SDL_MapGPUTransferBuffer(uploader->device, staging->transfer_buffer, false);
+        SC_SDL_ASSERT(staging->mapped != NULL);
+    }
+    staging->offset = offset + byte_count;
+
+    // Record copy.
+    if (uploader->copy_count == uploader->copy_capacity) {
+        const uint32_t capacity = SDL_max(2 * uploader->copy_capacity, 16);
+        uploader->copies = sc_arena_grow(
+            uploader->arena,
+            uploader->copies,
+            uploader->copy_capacity * sizeof(ScGpuFrameUploadCopy),
+            capacity * sizeof(ScGpuFrameUploadCopy),
+            _Alignof(ScGpuFrameUploadCopy)
+        );
+        uploader->copy_capacity = capacity;
+    }
+    uploader->copies[uploader->copy_count++] = (ScGpuFrameUploadCopy) {
+        .transfer_buffer = staging->transfer_buffer,
+        .transfer_offset = offset,
+        .buffer = buffer,
+        .buffer_offset = buffer_offset,
+        .byte_count = byte_count,
+    };
+    uploader->upload_byte_count += byte_count;
+    return staging->mapped + offset;
+}
+
+// Records every copy of the frame in one copy pass, must be called outside of a render pass.
+static void sc_gpu_frame_uploader_flush(ScGpuFrameUploader* uploader, SDL_GPUCommandBuffer* cmd) {
+    // Unmap.
+    sc_gpu_frame_uploader_unmap(uploader, uploader->frame_index);
+
+    // Early out.
+    if (uploader->copy_count == 0) {
+        return;
+    }
+
+    // Copy.
+    SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(cmd);
+    for (uint32_t i = 0; i < uploader->copy_count; i++) {
+        const ScGpuFrameUploadCopy* copy = &uploader->copies[i];
+        SDL_UploadToGPUBuffer(
+            copy_pass,
+            &(SDL_GPUTransferBufferLocation) {
+                .transfer_buffer = copy->transfer_buffer,
+                .offset = copy->transfer_offset,
+            },
+            &(SDL_GPUBufferRegion) {
+                .buffer = copy->buffer,
+                .offset = copy->buffer_offset,
+                .size = copy->byte_count,
+            },
+            false
+        );
+    }
+    SDL_EndGPUCopyPass(copy_pass);
+}
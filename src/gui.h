@@ -24,11 +24,14 @@ typedef struct ScGuiCreateInfo {
     SDL_GPUTextureFormat depth_stencil_format;
 } ScGuiCreateInfo;
 
-typedef struct ScGuiRenderInfo {
+typedef struct ScGuiUploadInfo {
     SDL_GPUDevice* device;
+    ScGpuFrameUploader* uploader;
+} ScGuiUploadInfo;
+
+typedef struct ScGuiRenderInfo {
     SDL_GPUCommandBuffer* command_buffer;
     SDL_GPURenderPass* render_pass;
-    uint32_t frame_index;
 } ScGuiRenderInfo;
 
 typedef struct ScGui {
@@ -37,13 +40,15 @@ typedef struct ScGui {
     char* clipboard_text;
     uint64_t performance_frequency;
     uint64_t performance_counter;
-    SDL_GPUTransferBuffer* transfer_buffers[SC_INFLIGHT_FRAME_COUNT];
+    // Draw data is uploaded only when its hash changes, into the buffers after the ones the
+    // previous upload went to, so buffers still read by frames in flight are never written.
     SDL_GPUBuffer* vertex_buffers[SC_INFLIGHT_FRAME_COUNT];
     SDL_GPUBuffer* index_buffers[SC_INFLIGHT_FRAME_COUNT];
-    uint32_t vertex_buffer_capacity;
-    uint32_t index_buffer_capacity;
-    ScGuiVertex* vertex_data;
-    ScGuiIndex* index_data;
+    uint32_t vertex_buffer_capacities[SC_INFLIGHT_FRAME_COUNT];
+    uint32_t index_buffer_capacities[SC_INFLIGHT_FRAME_COUNT];
+    uint32_t buffer_index;
+    uint64_t draw_data_hash;
+    bool draw_data_uploaded;
     SDL_GPUTexture* font_texture;
     SDL_GPUSampler* font_sampler;
     SDL_GPUGraphicsPipeline* pipeline;
@@ -105,6 +110,51 @@ static void sc_gui_imgui_set_clipboard_text_callback(ImGuiContext* context, cons
     SDL_SetClipboardText(text);
 }
 
+static void sc_gui_buffers_reserve(
+    ScGui* gui,
+    SDL_GPUDevice* device,
+    uint32_t frame_index,
+    uint32_t vertex_count,
+    uint32_t index_count
+) {
+    // Early out.
+    uint32_t vertex_capacity = gui->vertex_buffer_capacities[frame_index];
+    uint32_t index_capacity = gui->index_buffer_capacities[frame_index];
+    if (vertex_count <= vertex_capacity && index_count <= index_capacity) {
+        return;
+    }
+
+    // Grow, the previous buffers are released once the device is done with them.
+    vertex_capacity = SDL_max(vertex_capacity, 1);
+    index_capacity = SDL_max(index_capacity, 1);
+    while (vertex_capacity < vertex_count) {
+        vertex_capacity *= 2;
+    }
+    while (index_capacity < index_count) {
+        index_capacity *= 2;
+    }
+    const uint32_t vertex_byte_count = vertex_capacity * sizeof(ScGuiVertex);
+    const uint32_t index_byte_count = index_capacity * sizeof(ScGuiIndex);
+    SDL_ReleaseGPUBuffer(device, gui->vertex_buffers[frame_index]);
+    SDL_ReleaseGPUBuffer(device, gui->index_buffers[frame_index]);
+    gui->vertex_buffers[frame_index] = SDL_CreateGPUBuffer(
+        device,
+        &(SDL_GPUBufferCreateInfo) {
+            .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+            .size = vertex_byte_count,
+        }
+    );
+    gui->index_buffers[frame_index] = SDL_CreateGPUBuffer(
+        device,
+        &(SDL_GPUBufferCreateInfo) {
+            .usage = SDL_GPU_BUFFERUSAGE_INDEX,
+            .size = index_byte_count,
+        }
+    );
+    gui->vertex_buffer_capacities[frame_index] = vertex_capacity;
+    gui->index_buffer_capacities[frame_index] = index_capacity;
+}
+
 static void sc_gui_new(ScGui* gui, const ScGuiCreateInfo* create_info) {
     // Unpack.
     SDL_Window* window = create_info->window;
@@ -130,36 +180,14 @@ static void sc_gui_new(ScGui* gui, const ScGuiCreateInfo* create_info) {
     gui->performance_counter = SDL_GetPerformanceCounter();
 
     // Buffers.
-    gui->vertex_buffer_capacity = 1 << 12;
-    gui->index_buffer_capacity = 1 << 12;
-    const uint32_t vertex_byte_count = gui->vertex_buffer_capacity * sizeof(ScGuiVertex);
-    const uint32_t index_byte_count = gui->index_buffer_capacity * sizeof(ScGuiIndex);
-    const uint32_t total_byte_count = vertex_byte_count + index_byte_count;
-    gui->vertex_data = malloc(vertex_byte_count);
-    gui->index_data = malloc(index_byte_count);
     for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
-        gui->vertex_buffers[i] = SDL_CreateGPUBuffer(
-            device,
-            &(SDL_GPUBufferCreateInfo) {
-                .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
-                .size = vertex_byte_count,
-            }
-        );
-        gui->index_buffers[i] = SDL_CreateGPUBuffer(
-            device,
-            &(SDL_GPUBufferCreateInfo) {
-                .usage = SDL_GPU_BUFFERUSAGE_INDEX,
-                .size = index_byte_count,
-            }
-        );
-        gui->transfer_buffers[i] = SDL_CreateGPUTransferBuffer(
-            device,
-            &(SDL_GPUTransferBufferCreateInfo) {
-                .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-                .size = total_byte_count,
-            }
-        );
+        gui->vertex_buffer_capacities[i] = 0;
+        gui->index_buffer_capacities[i] = 0;
+        sc_gui_buffers_reserve(gui, device, i, 1 << 12, 1 << 12);
     }
+    gui->buffer_index = 0;
+    gui->draw_data_hash = 0;
+    gui->draw_data_uploaded = false;
 
     // Font texture.
     {
@@ -244,7 +272,7 @@ static void sc_gui_new(ScGui* gui, const ScGuiCreateInfo* create_info) {
     SDL_GPUShader* vertex_shader = sc_gpu_shader_new(
         device,
         &(ScGpuShaderCreateInfo) {
-            .file_path = "src/shaders/dxil/gui.vert",
+            .file_name = "gui.vert",
             .entry_point = "vs_main",
             .shader_stage = SDL_GPU_SHADERSTAGE_VERTEX,
             .sampler_count = 0,
@@ -254,7 +282,7 @@ static void sc_gui_new(ScGui* gui, const ScGuiCreateInfo* create_info) {
     SDL_GPUShader* fragment_shader = sc_gpu_shader_new(
         device,
         &(ScGpuShaderCreateInfo) {
-            .file_path = "src/shaders/dxil/gui.frag",
+            .file_name = "gui.frag",
             .entry_point = "fs_main",
             .shader_stage = SDL_GPU_SHADERSTAGE_FRAGMENT,
             .sampler_count = 1,
@@ -368,10 +396,7 @@ static void sc_gui_free(ScGui* gui, SDL_GPUDevice* device) {
     for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
         SDL_ReleaseGPUBuffer(device, gui->vertex_buffers[i]);
         SDL_ReleaseGPUBuffer(device, gui->index_buffers[i]);
-        SDL_ReleaseGPUTransferBuffer(device, gui->transfer_buffers[i]);
     }
-    free(gui->vertex_data);
-    free(gui->index_data);
 
     // ImGui.
     if (gui->clipboard_text != NULL) {
@@ -601,40 +626,66 @@ static void sc_gui_frame_begin(ScGui* gui) {
     ImGui_NewFrame();
 }
 
-static void sc_gui_frame_end(ScGui* gui, const ScGuiRenderInfo* render_info) {
+// Ends the frame and stages its draw data if it changed, before the render pass.
+static void sc_gui_frame_end(ScGui* gui, const ScGuiUploadInfo* upload_info) {
     // Generate draw data.
     ImGui_Render();
 
     // Get draw data.
     ImDrawData* draw_data = ImGui_GetDrawData();
 
-    // Validation.
+    // Counts.
     const uint32_t vertex_count = (uint32_t)draw_data->TotalVtxCount;
     const uint32_t index_count = (uint32_t)draw_data->TotalIdxCount;
-    SC_ASSERT(vertex_count <= gui->vertex_buffer_capacity);
-    SC_ASSERT(index_count <= gui->index_buffer_capacity);
 
     // Early out.
     if (vertex_count == 0 || index_count == 0) {
         return;
     }
 
+    // Change detection.
+    uint64_t hash = SC_HASH_SEED;
+    hash = sc_hash_bytes(hash, &vertex_count, sizeof(vertex_count));
+    hash = sc_hash_bytes(hash, &index_count, sizeof(index_count));
+    for (int32_t cmd_list_idx = 0; cmd_list_idx < draw_data->CmdListsCount; cmd_list_idx++) {
+        ImDrawList* cmd_list = draw_data->CmdLists.Data[cmd_list_idx];
+        hash = sc_hash_bytes(
+            hash,
+            cmd_list->VtxBuffer.Data,
+            cmd_list->VtxBuffer.Size * sizeof(ImDrawVert)
+        );
+        hash = sc_hash_bytes(
+            hash,
+            cmd_list->IdxBuffer.Data,
+            cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx)
+        );
+    }
+    if (gui->draw_data_uploaded && hash == gui->draw_data_hash) {
+        return;
+    }
+    gui->draw_data_hash = hash;
+    gui->draw_data_uploaded = true;
+
     // Unpack.
-    SDL_GPUDevice* device = render_info->device;
-    SDL_GPUCommandBuffer* command_buffer = render_info->command_buffer;
-    SDL_GPURenderPass* render_pass = render_info->render_pass;
-    const uint32_t frame_index = render_info->frame_index;
+    SDL_GPUDevice* device = upload_info->device;
+    ScGpuFrameUploader* uploader = upload_info->uploader;
 
     // Select buffers.
-    SDL_GPUBuffer* vertex_buffer = gui->vertex_buffers[frame_index];
-    SDL_GPUBuffer* index_buffer = gui->index_buffers[frame_index];
-    SDL_GPUTransferBuffer* transfer_buffer = gui->transfer_buffers[frame_index];
+    const uint32_t buffer_index = (gui->buffer_index + 1) % SC_INFLIGHT_FRAME_COUNT;
+    gui->buffer_index = buffer_index;
+    sc_gui_buffers_reserve(gui, device, buffer_index, vertex_count, index_count);
+    SDL_GPUBuffer* vertex_buffer = gui->vertex_buffers[buffer_index];
+    SDL_GPUBuffer* index_buffer = gui->index_buffers[buffer_index];
 
-    // Copy to device.
+    // Copy draw lists straight into staging memory.
     const uint32_t vertex_byte_count = vertex_count * sizeof(ScGuiVertex);
     const uint32_t index_byte_count = index_count * sizeof(ScGuiIndex);
-    ScGuiVertex* vertex_data_dst = gui->vertex_data;
-    ScGuiIndex* index_data_dst = gui->index_data;
+    ScGuiVertex* vertex_data =
+        sc_gpu_frame_uploader_alloc(uploader, vertex_buffer, 0, vertex_byte_count);
+    ScGuiIndex* index_data =
+        sc_gpu_frame_uploader_alloc(uploader, index_buffer, 0, index_byte_count);
+    ScGuiVertex* vertex_data_dst = vertex_data;
+    ScGuiIndex* index_data_dst = index_data;
     for (int32_t cmd_list_idx = 0; cmd_list_idx < draw_data->CmdListsCount; cmd_list_idx++) {
         ImDrawList* cmd_list = draw_data->CmdLists.Data[cmd_list_idx];
         memcpy(
@@ -650,42 +701,24 @@ static void sc_gui_frame_end(ScGui* gui, const ScGuiRenderInfo* render_info) {
         vertex_data_dst += cmd_list->VtxBuffer.Size;
         index_data_dst += cmd_list->IdxBuffer.Size;
     }
-    SC_ASSERT(vertex_data_dst == gui->vertex_data + vertex_count);
-    SC_ASSERT(index_data_dst == gui->index_data + index_count);
-    uint8_t* dst = SDL_MapGPUTransferBuffer(device, transfer_buffer, false);
-    memcpy(dst, gui->vertex_data, vertex_byte_count);
-    memcpy(dst + vertex_byte_count, gui->index_data, index_byte_count);
-    SDL_UnmapGPUTransferBuffer(device, transfer_buffer);
-    SDL_GPUCommandBuffer* upload_buffer = SDL_AcquireGPUCommandBuffer(device);
-    SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(upload_buffer);
-    SDL_UploadToGPUBuffer(
-        copy_pass,
-        &(SDL_GPUTransferBufferLocation) {
-            .transfer_buffer = transfer_buffer,
-            .offset = 0,
-        },
-        &(SDL_GPUBufferRegion) {
-            .buffer = vertex_buffer,
-            .offset = 0,
-            .size = vertex_byte_count,
-        },
-        false
-    );
-    SDL_UploadToGPUBuffer(
-        copy_pass,
-        &(SDL_GPUTransferBufferLocation) {
-            .transfer_buffer = transfer_buffer,
-            .offset = vertex_byte_count,
-        },
-        &(SDL_GPUBufferRegion) {
-            .buffer = index_buffer,
-            .offset = 0,
-            .size = index_byte_count,
-        },
-        false
-    );
-    SDL_EndGPUCopyPass(copy_pass);
-    SDL_SubmitGPUCommandBuffer(upload_buffer);
+    SC_ASSERT(vertex_data_dst == vertex_data + vertex_count);
+    SC_ASSERT(index_data_dst == index_data + index_count);
+}
+
+static void sc_gui_render(ScGui* gui, const ScGuiRenderInfo* render_info) {
+    // Get draw data.
+    ImDrawData* draw_data = ImGui_GetDrawData();
+
+    // Early out.
+    if (draw_data == NULL || draw_data->TotalVtxCount == 0 || draw_data->TotalIdxCount == 0) {
+        return;
+    }
+
+    // Unpack.
+    SDL_GPUCommandBuffer* command_buffer = render_info->command_buffer;
+    SDL_GPURenderPass* render_pass = render_info->render_pass;
+    SDL_GPUBuffer* vertex_buffer = gui->vertex_buffers[gui->buffer_index];
+    SDL_GPUBuffer* index_buffer = gui->index_buffers[gui->buffer_index];
 
     // Render.
     SDL_BindGPUGraphicsPipeline(render_pass, gui->pipeline);
@@ -0,0 +1,418 @@
+//
+// Job - Work-stealing job system
+//
+
+// Notes:
+// - A fixed pool of workers, each owning a deque of jobs. The owner pushes and pops at the
+//   bottom, other threads steal from the top, so nested work stays on the thread that spawned
+//   it and idle workers balance the load. The deque is the Chase-Lev algorithm on SDL atomics,
+//   which are sequentially consistent.
+// - Threads that are not workers, like the main thread or the pipeline worker, submit into a
+//   shared injection queue and only steal.
+// - Fork/join through counters. Submitting adds the job count to the counter and every job
+//   decrements it when done. Waiting runs other jobs until the counter reaches zero, so a
+//   waiting thread never idles and jobs can wait on jobs of their own.
+// - Waiters only take jobs of their own counter from the injection queue, and threads that are
+//   not workers don't steal. Otherwise a frame waiting on its traversal could pick up a long job
+//   of an unrelated submitter, like the file reads of a dataset load.
+// - Jobs are owned by the submitter and must outlive the wait on their counter.
+// - Until sc_job_system_new is called, or with zero workers, everything runs inline on the
+//   calling thread.
+
+#if defined(SDL_PLATFORM_WINDOWS)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#elif defined(SDL_PLATFORM_LINUX)
+    // Needs _GNU_SOURCE, set by the build.
+    #include <sched.h>
+#endif
+
+#define SC_JOB_WORKER_MAX_COUNT 64
+#define SC_JOB_DEQUE_CAPACITY 1024
+#define SC_JOB_INJECT_CAPACITY 1024
+#define SC_JOB_PARALLEL_FOR_MAX_CHUNK_COUNT 256
+// Chunks per thread in parallel-for, so stealing can even out chunks of uneven cost.
+#define SC_JOB_PARALLEL_FOR_CHUNKS_PER_THREAD 4
+// Failed attempts to find a job before a worker goes to sleep.
+#define SC_JOB_SPIN_COUNT 256
+
+static_assert((SC_JOB_DEQUE_CAPACITY & (SC_JOB_DEQUE_CAPACITY - 1)) == 0, "Not a power of two");
+
+// Processes elements [begin, end).
+typedef void (*ScJobFn)(void* user_data, uint32_t begin, uint32_t end);
+
+typedef struct ScJobCounter {
+    SDL_AtomicInt count;
+} ScJobCounter;
+
+typedef struct ScJob {
+    ScJobFn fn;
+    void* user_data;
+    uint32_t begin;
+    uint32_t end;
+    ScJobCounter* counter;
+} ScJob;
+
+typedef struct ScJobDeque {
+    // Indices only grow, differences stay valid when they wrap around.
+    SC_ALIGNAS(64) SDL_AtomicInt top;
+    SC_ALIGNAS(64) SDL_AtomicInt bottom;
+    SC_ALIGNAS(64) void* jobs[SC_JOB_DEQUE_CAPACITY];
+} ScJobDeque;
+
+typedef struct ScJobWorker {
+    uint32_t index;
+    SDL_Thread* thread;
+    ScJobDeque deque;
+} ScJobWorker;
+
+typedef struct ScJobSystemCreateInfo {
+    // Zero means one worker per logical core, minus one for the main thread.
+    uint32_t worker_count;
+    // Pins worker i to logical core i + 1, leaving core 0 to the main thread.
+    bool pin_workers;
+} ScJobSystemCreateInfo;
+
+typedef struct ScJobSystem {
+    // Workers.
+    ScJobWorker* workers;
+    uint32_t worker_count;
+    bool pin_workers;
+
+    // Injection queue, for threads without a deque.
+    SDL_SpinLock inject_lock;
+    ScJob* inject_jobs[SC_JOB_INJECT_CAPACITY];
+    uint32_t inject_begin;
+    uint32_t inject_count;
+
+    // Sleeping.
+    SDL_Semaphore* wake;
+    SDL_AtomicInt sleeping_count;
+    SDL_AtomicInt quit;
+} ScJobSystem;
+
+static ScJobSystem sc_job_system;
+static SC_THREAD_LOCAL ScJobWorker* sc_job_worker_current;
+
+//
+// Job - Deque
+//
+
+// Owner only. Returns false if full.
+static bool sc_job_deque_push(ScJobDeque* deque, ScJob* job) {
+    const uint32_t bottom = (uint32_t)SDL_GetAtomicInt(&deque->bottom);
+    const uint32_t top = (uint32_t)SDL_GetAtomicInt(&deque->top);
+    if (bottom - top >= SC_JOB_DEQUE_CAPACITY) {
+        return false;
+    }
+    SDL_SetAtomicPointer(&deque->jobs[bottom & (SC_JOB_DEQUE_CAPACITY - 1)], job);
+    SDL_SetAtomicInt(&deque->bottom, (int)(bottom + 1));
+    return true;
+}
+
+// Owner only, newest job first.
+static ScJob* sc_job_deque_pop(ScJobDeque* deque) {
+    // Reserve the bottom job, then check whether a thief got there first.
+    const uint32_t bottom = (uint32_t)SDL_GetAtomicInt(&deque->bottom) - 1;
+    SDL_SetAtomicInt(&deque->bottom, (int)bottom);
+    const uint32_t top = (uint32_t)SDL_GetAtomicInt(&deque->top);
+    if ((int32_t)(bottom - top) < 0) {
+        SDL_SetAtomicInt(&deque->bottom, (int)(bottom + 1));
+        return NULL;
+    }
+    ScJob* job = SDL_GetAtomicPointer(&deque->jobs[bottom & (SC_JOB_DEQUE_CAPACITY - 1)]);
+    if (bottom != top) {
+        return job;
+    }
+
+    // Last job, race the thieves for it.
+    if (!SDL_CompareAndSwapAtomicInt(&deque->top, (int)top, (int)(top + 1))) {
+        job = NULL;
+    }
+    SDL_SetAtomicInt(&deque->bottom, (int)(bottom + 1));
+    return job;
+}
+
+// Any thread, oldest job first. Returns NULL if empty or another thread won the race.
+static ScJob* sc_job_deque_steal(ScJobDeque* deque) {
+    const uint32_t top = (uint32_t)SDL_GetAtomicInt(&deque->top);
+    const uint32_t bottom = (uint32_t)SDL_GetAtomicInt(&deque->bottom);
+    if ((int32_t)(bottom - top) <= 0) {
+        return NULL;
+    }
+    ScJob* job = SDL_GetAtomicPointer(&deque->jobs[top & (SC_JOB_DEQUE_CAPACITY - 1)]);
+    if (!SDL_CompareAndSwapAtomicInt(&deque->top, (int)top, (int)(top + 1))) {
+        return NULL;
+    }
+    return job;
+}
+
+//
+// Job - Scheduling
+//
+
+static bool sc_job_inject_push(ScJobSystem* system, ScJob* job) {
+    SDL_LockSpinlock(&system->inject_lock);
+    const bool pushed = system->inject_count < SC_JOB_INJECT_CAPACITY;
+    if (pushed) {
+        const uint32_t end = system->inject_begin + system->inject_count;
+        system->inject_jobs[end % SC_JOB_INJECT_CAPACITY] = job;
+        system->inject_count++;
+    }
+    SDL_UnlockSpinlock(&system->inject_lock);
+    return pushed;
+}
+
+// Oldest job first, only of the given counter if there is one. Taking a job from the middle
+// shifts the ones after it.
+static ScJob* sc_job_inject_pop(ScJobSystem* system, const ScJobCounter* counter) {
+    ScJob* job = NULL;
+    SDL_LockSpinlock(&system->inject_lock);
+    for (uint32_t i = 0; i < system->inject_count && job == NULL; i++) {
+        const uint32_t index = (system->inject_begin + i) % SC_JOB_INJECT_CAPACITY;
+        if (counter != NULL && system->inject_jobs[index]->counter != counter) {
+            continue;
+        }
+        job = system->inject_jobs[index];
+        for (uint32_t j = i; j > 0; j--) {
+            const uint32_t dst = (system->inject_begin + j) % SC_JOB_INJECT_CAPACITY;
+            const uint32_t src = (system->inject_begin + j - 1) % SC_JOB_INJECT_CAPACITY;
+            system->inject_jobs[dst] = system->inject_jobs[src];
+        }
+        system->inject_begin = (system->inject_begin + 1) % SC_JOB_INJECT_CAPACITY;
+        system->inject_count--;
+    }
+    SDL_UnlockSpinlock(&system->inject_lock);
+    return job;
+}
+
+// Own deque first, then the injection queue, then the other workers starting after our own. A
+// waiter passes its counter, see the notes.
+static ScJob* sc_job_find(ScJobSystem* system, const ScJobCounter* counter) {
+    ScJobWorker* worker = sc_job_worker_current;
+    ScJob* job = NULL;
+    if (worker != NULL) {
+        job = sc_job_deque_pop(&worker->deque);
+    }
+    if (job == NULL) {
+        job = sc_job_inject_pop(system, counter);
+    }
+    if (worker == NULL && counter != NULL) {
+        return job;
+    }
+    const uint32_t first = worker != NULL ? worker->index + 1 : 0;
+    for (uint32_t i = 0; i < system->worker_count && job == NULL; i++) {
+        job = sc_job_deque_steal(&system->workers[(first + i) % system->worker_count].deque);
+    }
+    return job;
+}
+
+// The job may be gone once its counter is decremented.
+static void sc_job_execute(ScJob* job) {
+    ScJobCounter* counter = job->counter;
+    job->fn(job->user_data, job->begin, job->end);
+    SDL_AddAtomicInt(&counter->count, -1);
+}
+
+// More workers than cores wrap around and share them.
+static void sc_job_pin_current_thread(uint32_t core_index) {
+    core_index %= (uint32_t)SDL_max(SDL_GetNumLogicalCPUCores(), 1);
+#if defined(SDL_PLATFORM_WINDOWS)
+    const DWORD_PTR mask = (DWORD_PTR)1 << (core_index % (8 * sizeof(DWORD_PTR)));
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        SC_LOG_ERROR("Failed to pin job worker to core %u", core_index);
+    }
+#elif defined(SDL_PLATFORM_LINUX)
+    // Thread id zero is the calling thread.
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core_index % CPU_SETSIZE, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        SC_LOG_ERROR("Failed to pin job worker to core %u", core_index);
+    }
+#else
+    SC_UNUSED(core_index);
+#endif
+}
+
+static int sc_job_worker_main(void* data) {
+    ScJobWorker* worker = data;
+    ScJobSystem* system = &sc_job_system;
+    sc_job_worker_current = worker;
+    if (system->pin_workers) {
+        sc_job_pin_current_thread(worker->index + 1);
+    }
+
+    uint32_t spin_count = 0;
+    while (SDL_GetAtomicInt(&system->quit) == 0) {
+        // Work.
+        ScJob* job = sc_job_find(system, NULL);
+        if (job != NULL) {
+            sc_job_execute(job);
+            spin_count = 0;
+            continue;
+        }
+
+        // Spin a little, new work usually follows soon within a frame.
+        if (++spin_count < SC_JOB_SPIN_COUNT) {
+            SDL_CPUPauseInstruction();
+            continue;
+        }
+
+        // Sleep. Work submitted after the last look is either found here, or its submitter
+        // sees this worker sleeping and wakes it.
+        SDL_AddAtomicInt(&system->sleeping_count, 1);
+        job = sc_job_find(system, NULL);
+        if (job == NULL && SDL_GetAtomicInt(&system->quit) == 0) {
+            SDL_WaitSemaphore(system->wake);
+        }
+        SDL_AddAtomicInt(&system->sleeping_count, -1);
+        if (job != NULL) {
+            sc_job_execute(job);
+        }
+        spin_count = 0;
+    }
+    return 0;
+}
+
+static void sc_job_system_new(const ScJobSystemCreateInfo* create_info) {
+    // Workers.
+    ScJobSystem* system = &sc_job_system;
+    uint32_t worker_count = create_info->worker_count;
+    if (worker_count == 0) {
+        worker_count = (uint32_t)SDL_max(SDL_GetNumLogicalCPUCores() - 1, 0);
+    }
+    worker_count = SDL_min(worker_count, SC_JOB_WORKER_MAX_COUNT);
+
+    // System.
+    SDL_zerop(system);
+    system->worker_count = worker_count;
+    system->pin_workers = create_info->pin_workers;
+#if !defined(SDL_PLATFORM_WINDOWS) && !defined(SDL_PLATFORM_LINUX)
+    if (system->pin_workers) {
+        SC_LOG_INFO("Job worker pinning is not supported on this platform");
+        system->pin_workers = false;
+    }
+#endif
+    system->wake = SDL_CreateSemaphore(0);
+    SC_SDL_ASSERT(system->wake != NULL);
+    if (worker_count == 0) {
+        return;
+    }
+    system->workers = SDL_aligned_alloc(64, worker_count * sizeof(ScJobWorker));
+    SC_ASSERT(system->workers != NULL);
+    memset(system->workers, 0, worker_count * sizeof(ScJobWorker));
+    for (uint32_t i = 0; i < worker_count; i++) {
+        ScJobWorker* worker = &system->workers[i];
+        worker->index = i;
+        worker->thread = SDL_CreateThread(sc_job_worker_main, "sc_job_worker", worker);
+        SC_SDL_ASSERT(worker->thread != NULL);
+    }
+    SC_LOG_INFO(
+        "Job system: %u workers%s",
+        worker_count,
+        system->pin_workers ? ", pinned" : ""
+    );
+}
+
+static void sc_job_system_free(void) {
+    ScJobSystem* system = &sc_job_system;
+    SDL_SetAtomicInt(&system->quit, 1);
+    for (uint32_t i = 0; i < system->worker_count; i++) {
+        SDL_SignalSemaphore(system->wake);
+    }
+    for (uint32_t i = 0; i < system->worker_count; i++) {
+        SDL_WaitThread(system->workers[i].thread, NULL);
+    }
+    SDL_DestroySemaphore(system->wake);
+    SDL_aligned_free(system->workers);
+    SDL_zerop(system);
+}
+
+static uint32_t sc_job_thread_count(void) {
+    return sc_job_system.worker_count + 1;
+}
+
+//
+// Job - Fork/join
+//
+
+// Queues the jobs, or runs them inline without workers.
+static void sc_job_submit(ScJob* jobs, uint32_t job_count, ScJobCounter* counter) {
+    // Inline.
+    ScJobSystem* system = &sc_job_system;
+    SDL_AddAtomicInt(&counter->count, (int)job_count);
+    for (uint32_t i = 0; i < job_count; i++) {
+        jobs[i].counter = counter;
+    }
+    if (system->worker_count == 0) {
+        for (uint32_t i = 0; i < job_count; i++) {
+            sc_job_execute(&jobs[i]);
+        }
+        return;
+    }
+
+    // Queue, running whatever does not fit.
+    ScJobWorker* worker = sc_job_worker_current;
+    for (uint32_t i = 0; i < job_count; i++) {
+        const bool pushed = worker != NULL ? sc_job_deque_push(&worker->deque, &jobs[i])
+                                           : sc_job_inject_push(system, &jobs[i]);
+        if (!pushed) {
+            sc_job_execute(&jobs[i]);
+        }
+    }
+
+    // Wake.
+    const uint32_t sleeping_count = (uint32_t)SDL_GetAtomicInt(&system->sleeping_count);
+    for (uint32_t i = 0; i < SDL_min(sleeping_count, job_count); i++) {
+        SDL_SignalSemaphore(system->wake);
+    }
+}
+
+// Runs queued jobs until the counter reaches zero.
+static void sc_job_wait(ScJobCounter* counter) {
+    ScJobSystem* system = &sc_job_system;
+    while (SDL_GetAtomicInt(&counter->count) > 0) {
+        ScJob* job = sc_job_find(system, counter);
+        if (job != NULL) {
+            sc_job_execute(job);
+        } else {
+            SDL_CPUPauseInstruction();
+        }
+    }
+}
+
+// Splits [0, count) into chunks of at least grain elements and waits for all of them.
+static void sc_job_parallel_for(ScJobFn fn, void* user_data, uint32_t count, uint32_t grain) {
+    // Chunks.
+    const uint32_t max_chunk_count = SDL_min(
+        sc_job_thread_count() * SC_JOB_PARALLEL_FOR_CHUNKS_PER_THREAD,
+        SC_JOB_PARALLEL_FOR_MAX_CHUNK_COUNT
+    );
+    const uint32_t chunk_count = SDL_min((count + grain - 1) / SDL_max(grain, 1), max_chunk_count);
+
+    // Early out.
+    if (chunk_count <= 1 || sc_job_system.worker_count == 0) {
+        if (count > 0) {
+            fn(user_data, 0, count);
+        }
+        return;
+    }
+
+    // Fork, chunk sizes differ by at most one element.
+    ScJob jobs[SC_JOB_PARALLEL_FOR_MAX_CHUNK_COUNT];
+    for (uint32_t i = 0; i < chunk_count; i++) {
+        jobs[i] = (ScJob) {
+            .fn = fn,
+            .user_data = user_data,
+            .begin = (uint32_t)((uint64_t)count * i / chunk_count),
+            .end = (uint32_t)((uint64_t)count * (i + 1) / chunk_count),
+        };
+    }
+    ScJobCounter counter = {0};
+    sc_job_submit(jobs, chunk_count, &counter);
+
+    // Join.
+    sc_job_wait(&counter);
+}
@@ -0,0 +1,161 @@
+//
+// Lod - Adaptive LOD controller
+//
+
+// Notes:
+// - Steers lod_bias so frames fit a frame-time budget. A larger bias stops the traversal at
+//   coarser nodes and draws fewer points.
+// - Under vsync the presented frame time is clamped to the refresh interval, so a target below
+//   it would always look over budget. Both directions are decided on the busy time instead,
+//   which is the frame time minus the time spent blocked on the swapchain.
+// - Hysteresis: coarsening starts above the upper threshold, refining below the lower threshold
+//   and only once a cooldown since the last coarsening has passed. In between the bias holds.
+// - Refining is also capped by a point budget, the target divided by the measured cost per
+//   point, so the bias converges instead of overshooting into the next coarsening.
+// - Only changes of action are logged. Busy time and point budget are recorded every frame in
+//   the stats, so a steady state stays visible there and in its exports.
+
+#define SC_LOD_SMOOTHING 0.1f
+#define SC_LOD_COARSEN_RATE 1.06f
+#define SC_LOD_REFINE_RATE 1.02f
+#define SC_LOD_COOLDOWN_FRAME_COUNT 30
+
+typedef enum ScLodAction {
+    SC_LOD_ACTION_HOLD,
+    SC_LOD_ACTION_COARSEN,
+    SC_LOD_ACTION_REFINE,
+    SC_LOD_ACTION_COUNT,
+} ScLodAction;
+
+static const char* SC_LOD_ACTION_NAME[] = {
+    "hold",
+    "coarsen",
+    "refine",
+};
+
+typedef struct ScLodControllerUpdateInfo {
+    // Previous frame.
+    float frame_ms;
+    float busy_ms;
+    uint64_t visible_point_count;
+} ScLodControllerUpdateInfo;
+
+typedef struct ScLodController {
+    // Parameters.
+    bool enabled;
+    float target_ms;
+    float upper_ratio;
+    float lower_ratio;
+    float bias_min;
+    float bias_max;
+
+    // Smoothed measurements.
+    float frame_ms;
+    float busy_ms;
+    float ms_per_mpoint;
+    uint64_t point_budget;
+
+    // Decision.
+    ScLodAction action;
+    uint32_t cooldown_frame_count;
+} ScLodController;
+
+static void sc_lod_controller_new(ScLodController* controller) {
+    SDL_zerop(controller);
+    controller->enabled = false;
+    controller->target_ms = 16.6f;
+    controller->upper_ratio = 1.05f;
+    controller->lower_ratio = 0.85f;
+    controller->bias_min = 1.0f / 1024.0f;
+    controller->bias_max = 1.0f;
+    controller->frame_ms = controller->target_ms;
+    controller->busy_ms = controller->target_ms;
+    controller->point_budget = UINT64_MAX;
+    controller->action = SC_LOD_ACTION_HOLD;
+}
+
+// Returns the lod_bias for the next traversal.
+static float sc_lod_controller_update(
+    ScLodController* controller,
+    float lod_bias,
+    const ScLodControllerUpdateInfo* update_info
+) {
+    // Unpack.
+    const float target_ms = controller->target_ms;
+    const float frame_ms = update_info->frame_ms;
+    const float busy_ms = SDL_max(update_info->busy_ms, 0.0f);
+    const uint64_t visible_point_count = update_info->visible_point_count;
+
+    // Smooth.
+    controller->frame_ms = lerpf(controller->frame_ms, frame_ms, SC_LOD_SMOOTHING);
+    controller->busy_ms = lerpf(controller->busy_ms, busy_ms, SC_LOD_SMOOTHING);
+    if (visible_point_count > 0) {
+        const float ms_per_mpoint = busy_ms / ((float)visible_point_count / 1e6f);
+        const float smoothed =
+            lerpf(controller->ms_per_mpoint, ms_per_mpoint, SC_LOD_SMOOTHING);
+        controller->ms_per_mpoint = controller->ms_per_mpoint > 0.0f ? smoothed : ms_per_mpoint;
+    }
+    controller->point_budget =
+        controller->ms_per_mpoint > 0.0f
+            ? (uint64_t)(1e6f * controller->lower_ratio * target_ms / controller->ms_per_mpoint)
+            : UINT64_MAX;
+
+    // Decide.
+    ScLodAction action = SC_LOD_ACTION_HOLD;
+    if (controller->busy_ms > controller->upper_ratio * target_ms) {
+        action = SC_LOD_ACTION_COARSEN;
+    } else if (
+        controller->busy_ms < controller->lower_ratio * target_ms
+        && controller->cooldown_frame_count == 0 && visible_point_count < controller->point_budget
+    ) {
+        action = SC_LOD_ACTION_REFINE;
+    }
+
+    // Apply.
+    float new_lod_bias = lod_bias;
+    switch (action) {
+        case SC_LOD_ACTION_COARSEN:
+            new_lod_bias = lod_bias * SC_LOD_COARSEN_RATE;
+            controller->cooldown_frame_count = SC_LOD_COOLDOWN_FRAME_COUNT;
+            break;
+        case SC_LOD_ACTION_REFINE: new_lod_bias = lod_bias / SC_LOD_REFINE_RATE; break;
+        default:
+            controller->cooldown_frame_count = controller->cooldown_frame_count > 0
+                                                   ? controller->cooldown_frame_count - 1
+                                                   : 0;
+            break;
+    }
+    new_lod_bias = SDL_clamp(new_lod_bias, controller->bias_min, controller->bias_max);
+
+    // Log, on every change of action.
+    if (action != controller->action) {
+        controller->action = action;
+        SC_LOG_INFO(
+            "lod: %s bias %.5f -> %.5f, frame %.2f ms, busy %.2f ms, points %" PRIu64
+            ", budget %" PRIu64,
+            SC_LOD_ACTION_NAME[action],
+            (double)lod_bias,
+            (double)new_lod_bias,
+            (double)controller->frame_ms,
+            (double)controller->busy_ms,
+            visible_point_count,
+            controller->point_budget
+        );
+    }
+
+    return new_lod_bias;
+}
+
+// Widgets for the app panel.
+static void sc_lod_controller_gui(ScLodController* controller) {
+    ImGui_Checkbox("auto_lod", &controller->enabled);
+    if (controller->enabled) {
+        ImGui_SliderFloat("target_ms", &controller->target_ms, 4.0f, 50.0f);
+        ImGui_Text(
+            "lod: %s, busy %.2f ms, budget %.2fM",
+            SC_LOD_ACTION_NAME[controller->action],
+            (double)controller->busy_ms,
+            controller->point_budget == UINT64_MAX ? 0.0 : (double)controller->point_budget / 1e6
+        );
+    }
+}
@@ -3,13 +3,19 @@
 //
 
 #include "common.h"
+#include "alloc.h"
+#include "profile.h"
+#include "job.h"
 #include "math.h"
 #include "color.h"
 #include "camera.h"
 #include "octree.h"
+#include "raster.h"
 #include "gpu.h"
 #include "ddraw.h"
 #include "gui.h"
+#include "stats.h"
+#include "lod.h"
 
 //
 // Stormcloud - App Camera.
@@ -18,12 +24,58 @@
 typedef enum ScAppViewMode {
     VIEW_MODE_FULLSCREEN,
     VIEW_MODE_SPLIT,
+    VIEW_MODE_QUAD,
+    VIEW_MODE_STEREO,
     VIEW_MODE_COUNT,
 } ScAppViewMode;
 
 static const char* SC_APP_VIEW_MODE_NAME[] = {
     "Fullscreen",
     "Split",
+    "Quad",
+    "Stereo",
+};
+
+// Notes:
+// - Views tile the window in a grid of equal viewports, row-major. The main camera is the first
+//   view, the others are derived from it: the aerial view in split mode, the main camera turned
+//   around the scene center in quad mode, and the two eyes in stereo mode.
+// - Views which drive the traversal come first and share one cut of the octree. The aerial view
+//   only draws that cut.
+
+#define SC_APP_VIEW_MAX_COUNT 4
+// Aerial view in split mode.
+#define SC_APP_VIEW_AERIAL 1
+
+typedef struct ScAppViewLayout {
+    uint32_t view_count;
+    uint32_t traverse_view_count;
+    uint32_t column_count;
+    uint32_t row_count;
+} ScAppViewLayout;
+
+static const ScAppViewLayout SC_APP_VIEW_LAYOUT[] = {
+    {.view_count = 1, .traverse_view_count = 1, .column_count = 1, .row_count = 1},
+    {.view_count = 2, .traverse_view_count = 1, .column_count = 2, .row_count = 1},
+    {.view_count = 4, .traverse_view_count = 4, .column_count = 2, .row_count = 2},
+    {.view_count = 2, .traverse_view_count = 2, .column_count = 2, .row_count = 1},
+};
+
+typedef enum ScAppColorMode {
+    COLOR_MODE_RGB,
+    COLOR_MODE_INTENSITY,
+    COLOR_MODE_CLASSIFICATION,
+    COLOR_MODE_RETURN_NUMBER,
+    COLOR_MODE_GPS_TIME,
+    COLOR_MODE_COUNT,
+} ScAppColorMode;
+
+static const char* SC_APP_COLOR_MODE_NAME[] = {
+    "RGB",
+    "Intensity",
+    "Classification",
+    "Return number",
+    "GPS time",
 };
 
 typedef enum ScAppMainCameraControlType {
@@ -37,12 +89,6 @@ static const char* SC_APP_MAIN_CAMERA_CONTROL_TYPE_NAME[] = {
     "Autoplay",
 };
 
-typedef enum ScAppCameraType {
-    CAMERA_TYPE_MAIN,
-    CAMERA_TYPE_AERIAL,
-    CAMERA_TYPE_COUNT,
-} ScAppCameraType;
-
 typedef struct ScAppCameraCreateInfo {
     SDL_GPUDevice* device;
     SDL_GPUTextureFormat color_format;
@@ -88,17 +134,138 @@ static void sc_app_camera_free(ScAppCamera* camera, SDL_GPUDevice* device) {
 #define SC_SWAPCHAIN_COLOR_FORMAT SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM_SRGB
 #define SC_SWAPCHAIN_DEPTH_STENCIL_FORMAT SDL_GPU_TEXTUREFORMAT_D32_FLOAT
 
+// Can be overridden at runtime with SDL_GPU_DRIVER, e.g. SDL_GPU_DRIVER=vulkan.
+#if defined(SDL_PLATFORM_WINDOWS)
+    #define SC_GPU_DEFAULT_DRIVER "direct3d12"
+#else
+    #define SC_GPU_DEFAULT_DRIVER NULL
+#endif
+
+// Initial size of the per-frame arenas, they grow to fit the peak usage.
+#define SC_FRAME_ARENA_BYTE_COUNT (1024 * 1024)
+
+// Points are split at node boundaries into GPU buffers of at most this size, which stays under
+// the per-buffer and storage buffer range limits of all backends.
+#define SC_POINT_BUFFER_MAX_BYTE_COUNT (256 * 1024 * 1024)
+
+// Live datasets grow their node buffer from this many nodes.
+#define SC_APP_LIVE_MIN_NODE_CAPACITY 64
+
 typedef struct ScAppParameters {
     float lod_bias;
+    bool show_all_nodes;
     ScAppViewMode view_mode;
+    float stereo_separation;
+    ScAppColorMode color_mode;
     ScAppMainCameraControlType main_camera_control_type;
 } ScAppParameters;
 
+// Contiguous range of points in one GPU buffer, with a matching color stream buffer.
+typedef struct ScAppPointSegment {
+    uint64_t point_offset;
+    uint64_t point_count;
+    SDL_GPUBuffer* point_buffer;
+    SDL_GPUBuffer* point_color_buffer;
+} ScAppPointSegment;
+
+// Everything loaded from one file, replaced as a whole when another dataset is opened.
+typedef struct ScAppDataset {
+    ScOctree octree;
+    ScAppPointSegment* point_segments;
+    uint32_t point_segment_count;
+    uint32_t* node_point_segments;
+    SDL_GPUBuffer* node_buffer;
+
+    // Live datasets only, node buffer capacity in nodes.
+    uint32_t node_capacity;
+} ScAppDataset;
+
+// Notes:
+// - Opening a dataset loads the octree and uploads its GPU buffers on a loader thread. The
+//   uploader waits for its fences, so the dataset is complete once the thread is done.
+// - The swap happens on the main thread between frames, after the pipeline worker is idle. The
+//   previous dataset is retired and freed once the frames in flight that drew it are done.
+
+typedef struct ScAppDatasetLoader {
+    SDL_GPUDevice* device;
+    char* file_path;
+    SDL_Thread* thread;
+    SDL_AtomicInt done;
+    bool loaded;
+    ScAppDataset dataset;
+} ScAppDatasetLoader;
+
+// Notes:
+// - Live replay streams the leaf points of the current dataset into an empty live dataset at a
+//   fixed rate, standing in for a scanner feeding points into a running viewer.
+// - Insertion runs between frames after the pipeline worker is idle. Node indices are stable,
+//   so a frame prepared ahead stays valid, only the touched ranges are uploaded.
+
+typedef struct ScAppLiveReplay {
+    // Source points, NULL when not replaying.
+    vec3f* positions;
+    uint32_t* colors;
+    uint64_t point_count;
+    uint64_t point_offset;
+
+    // Rate in millions of points per second, fractional points carry over.
+    float mpoint_rate;
+    double point_carry;
+
+    // Last frame.
+    uint64_t insert_point_count;
+    uint64_t insert_ns;
+} ScAppLiveReplay;
+
+// Notes:
+// - Preparing a frame means updating the cameras and traversing the octree. By default a frame
+//   is prepared inline with no latency. In pipelined mode a worker prepares frame N+1 while the
+//   main thread records and submits frame N, so frame N+1 is drawn with inputs sampled during
+//   frame N, a fixed latency of exactly one frame.
+// - Frame slots are double-buffered, the worker only writes the slot the main thread is not
+//   reading. Each slot has its own arena, since arenas are not thread-safe.
+// - The camera controls are also written by event handling, so events wait for the worker.
+
+#define SC_APP_FRAME_SLOT_COUNT 2
+
+// Inputs of frame preparation, sampled on the main thread.
+typedef struct ScAppPrepareInfo {
+    ScCameraControlCommonUpdateInfo common;
+    ScAppViewMode view_mode;
+    float stereo_separation;
+    ScAppMainCameraControlType main_camera_control_type;
+    float lod_bias;
+} ScAppPrepareInfo;
+
+typedef struct ScAppFrameSlot {
+    ScArena arena;
+    ScAppPrepareInfo prepare_info;
+    ScPerspectiveCamera cameras[SC_APP_VIEW_MAX_COUNT];
+    ScOctreeTraversal traversal;
+    uint64_t traverse_ns;
+} ScAppFrameSlot;
+
+typedef struct ScAppPipeline {
+    bool enabled;
+
+    // Slots, the current frame reads slot_index.
+    ScAppFrameSlot slots[SC_APP_FRAME_SLOT_COUNT];
+    uint32_t slot_index;
+
+    // Worker, work_slot is non-NULL from kick until the prepared slot is picked up.
+    SDL_Thread* worker;
+    SDL_Semaphore* work_begin;
+    SDL_Semaphore* work_end;
+    ScAppFrameSlot* work_slot;
+    bool work_pending;
+    bool work_quit;
+} ScAppPipeline;
+
 typedef struct ScApp {
     // App.
     ScAppParameters parameters;
-    ScOctree octree;
-    ScAppCamera cameras[CAMERA_TYPE_COUNT];
+    ScAppDataset dataset;
+    ScAppCamera cameras[SC_APP_VIEW_MAX_COUNT];
     ScCameraControlOrbit orbit_control;
     ScCameraControlAutoplay autoplay_control;
     ScCameraControlAerial aerial_control;
@@ -107,22 +274,891 @@ typedef struct ScApp {
     SDL_Window* window;
     SDL_GPUDevice* device;
     SDL_GPUTexture* depth_stencil_texture;
-    SDL_GPUBuffer* point_buffer;
-    SDL_GPUBuffer* node_buffer;
-    SDL_GPUBuffer* bounds_buffer;
-    uint32_t bounds_vertex_count;
+    ScAppColorMode point_color_mode;
     SDL_GPUGraphicsPipeline* point_pipeline;
-    SDL_GPUGraphicsPipeline* bounds_pipeline;
+    SDL_GPUGraphicsPipeline* point_color_pipeline;
+    SDL_GPUGraphicsPipeline* point_compact_pipeline;
+    ScDebugDrawPersistent* all_node_bounds;
+
+    // Dataset loading, at most one load in progress and one dataset waiting to be freed.
+    ScAppDatasetLoader* dataset_loader;
+    ScAppDataset retired_dataset;
+    uint32_t retired_dataset_frame_count;
+    char dataset_file_path[256];
+    ScAppLiveReplay live_replay;
 
     // User interface.
     ScGui gui;
 
+    // Transient allocations, one arena per frame in flight.
+    ScArena frame_arenas[SC_INFLIGHT_FRAME_COUNT];
+
+    // Per-frame uploads of all subsystems.
+    ScGpuFrameUploader frame_uploader;
+
+    // Frame preparation, inline or pipelined.
+    ScAppPipeline pipeline;
+
     // Frame statistics.
     uint32_t frame_index;
     uint64_t frame_time_ns;
     uint64_t frame_time_frequency;
+    uint64_t swapchain_wait_ns;
+    uint64_t visible_point_count;
+    ScStats stats;
+    ScLodController lod_controller;
 } ScApp;
 
+static void sc_app_point_color_update(ScApp* app) {
+    // Unpack.
+    const ScAppColorMode color_mode = app->parameters.color_mode;
+    if (color_mode == app->point_color_mode) {
+        return;
+    }
+
+    // Release previous stream.
+    for (uint32_t i = 0; i < app->dataset.point_segment_count; i++) {
+        ScAppPointSegment* segment = &app->dataset.point_segments[i];
+        SDL_ReleaseGPUBuffer(app->device, segment->point_color_buffer);
+        segment->point_color_buffer = NULL;
+    }
+    app->point_color_mode = COLOR_MODE_RGB;
+    if (color_mode == COLOR_MODE_RGB) {
+        return;
+    }
+
+    // Load attribute, only kept on the CPU until it has been mapped to colors.
+    const ScOctreeAttribute attribute = (ScOctreeAttribute)(color_mode - COLOR_MODE_INTENSITY);
+    if (sc_octree_attribute_load(&app->dataset.octree, attribute) == NULL) {
+        SC_LOG_ERROR("Attribute not available: %s", SC_OCTREE_ATTRIBUTE_NAME[attribute]);
+        app->parameters.color_mode = COLOR_MODE_RGB;
+        return;
+    }
+    uint32_t* colors = malloc(app->dataset.octree.point_count * sizeof(uint32_t));
+    sc_octree_attribute_colors(&app->dataset.octree, attribute, colors);
+    sc_octree_attribute_unload(&app->dataset.octree, attribute);
+
+    // Upload colors, one buffer per point segment.
+    ScGpuUploader uploader;
+    sc_gpu_uploader_new(&uploader, app->device);
+    for (uint32_t i = 0; i < app->dataset.point_segment_count; i++) {
+        ScAppPointSegment* segment = &app->dataset.point_segments[i];
+        const uint64_t byte_count = segment->point_count * sizeof(uint32_t);
+        segment->point_color_buffer = SDL_CreateGPUBuffer(
+            app->device,
+            &(SDL_GPUBufferCreateInfo) {
+                .usage = SDL_GPU_BUFFERUSAGE_VERTEX | SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+                .size = (uint32_t)byte_count,
+            }
+        );
+        sc_gpu_uploader_upload(
+            &uploader,
+            segment->point_color_buffer,
+            0,
+            colors + segment->point_offset,
+            byte_count
+        );
+    }
+    sc_gpu_uploader_free(&uploader);
+    free(colors);
+    app->point_color_mode = color_mode;
+}
+
+typedef struct ScAppNodePointRange {
+    uint64_t point_offset;
+    uint32_t node_idx;
+} ScAppNodePointRange;
+
+static int sc_app_node_point_range_compare(const void* lhs, const void* rhs) {
+    const uint64_t a = ((const ScAppNodePointRange*)lhs)->point_offset;
+    const uint64_t b = ((const ScAppNodePointRange*)rhs)->point_offset;
+    return (a > b) - (a < b);
+}
+
+// Greedily packs nodes in point order into segments of at most SC_POINT_BUFFER_MAX_BYTE_COUNT,
+// so that every node can be drawn from a single buffer.
+static void sc_app_point_segments_new(ScAppDataset* dataset) {
+    // Unpack.
+    const ScOctree* octree = &dataset->octree;
+    const uint64_t point_stride = sc_octree_point_stride(octree->point_format);
+    // Leave room for the compact format padding.
+    const uint64_t max_point_count = (SC_POINT_BUFFER_MAX_BYTE_COUNT - 8) / point_stride;
+
+    // Sort nodes by point offset.
+    ScAppNodePointRange* ranges = malloc(octree->node_count * sizeof(ScAppNodePointRange));
+    for (uint32_t node_idx = 0; node_idx < octree->node_count; node_idx++) {
+        ranges[node_idx] = (ScAppNodePointRange) {
+            .point_offset = octree->nodes[node_idx].point_offset,
+            .node_idx = node_idx,
+        };
+    }
+    qsort(ranges, octree->node_count, sizeof(ScAppNodePointRange), sc_app_node_point_range_compare);
+
+    // Pack.
+    dataset->point_segments = NULL;
+    dataset->point_segment_count = 0;
+    dataset->node_point_segments = calloc(octree->node_count, sizeof(uint32_t));
+    for (uint64_t i = 0; i < octree->node_count; i++) {
+        const ScOctreeNode* node = &octree->nodes[ranges[i].node_idx];
+        if (node->point_count == 0) {
+            continue;
+        }
+        SC_ASSERT(node->point_count <= max_point_count);
+        const uint64_t point_end = node->point_offset + node->point_count;
+        ScAppPointSegment* segment =
+            dataset->point_segment_count > 0
+                ? &dataset->point_segments[dataset->point_segment_count - 1]
+                : NULL;
+        if (segment == NULL || point_end - segment->point_offset > max_point_count) {
+            dataset->point_segments = realloc(
+                dataset->point_segments,
+                (dataset->point_segment_count + 1) * sizeof(ScAppPointSegment)
+            );
+            segment = &dataset->point_segments[dataset->point_segment_count++];
+            *segment = (ScAppPointSegment) {.point_offset = node->point_offset};
+        }
+        segment->point_count = point_end - segment->point_offset;
+        dataset->node_point_segments[ranges[i].node_idx] = dataset->point_segment_count - 1;
+    }
+    free(ranges);
+}
+
+// Loads the octree and uploads its points and nodes, returns once the uploads are complete.
+static void
+sc_app_dataset_new(ScAppDataset* dataset, SDL_GPUDevice* device, const char* file_path) {
+    // Octree.
+    SDL_zerop(dataset);
+    sc_octree_new(&dataset->octree, file_path);
+    ScGpuUploader uploader;
+    sc_gpu_uploader_new(&uploader, device);
+
+    // Vertex buffer - points.
+    // Points are streamed through the upload ring into one buffer per segment. Compact points
+    // are read from storage buffers instead, padded for the 8-byte loads in point_compact.hlsl.
+    {
+        sc_app_point_segments_new(dataset);
+        const bool compact = dataset->octree.point_format == SC_OCTREE_POINT_FORMAT_COMPACT;
+        const uint64_t point_stride = sc_octree_point_stride(dataset->octree.point_format);
+        const uint8_t* point_data = sc_octree_point_data(&dataset->octree);
+        for (uint32_t i = 0; i < dataset->point_segment_count; i++) {
+            ScAppPointSegment* segment = &dataset->point_segments[i];
+            const uint64_t byte_count = segment->point_count * point_stride;
+            segment->point_buffer = SDL_CreateGPUBuffer(
+                device,
+                &(SDL_GPUBufferCreateInfo) {
+                    .usage = compact ? SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ
+                                     : SDL_GPU_BUFFERUSAGE_VERTEX,
+                    .size = compact ? (uint32_t)((byte_count + 8) & ~3ull) : (uint32_t)byte_count,
+                }
+            );
+            sc_gpu_uploader_upload(
+                &uploader,
+                segment->point_buffer,
+                0,
+                point_data + segment->point_offset * point_stride,
+                byte_count
+            );
+        }
+    }
+
+    // Vertex buffer - nodes.
+    {
+        const uint32_t node_byte_count =
+            (uint32_t)dataset->octree.node_count * sizeof(ScOctreeNodeInstance);
+        dataset->node_buffer = SDL_CreateGPUBuffer(
+            device,
+            &(SDL_GPUBufferCreateInfo) {
+                .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+                .size = node_byte_count,
+            }
+        );
+        sc_gpu_uploader_upload(
+            &uploader,
+            dataset->node_buffer,
+            0,
+            dataset->octree.node_instances,
+            node_byte_count
+        );
+    }
+
+    // Wait.
+    SC_LOG_INFO(
+        "Uploaded %" PRIu64 " MB of points and nodes to %u buffers in %u chunks",
+        uploader.upload_byte_count / (1024 * 1024),
+        dataset->point_segment_count + 1,
+        uploader.upload_chunk_count
+    );
+    sc_gpu_uploader_free(&uploader);
+}
+
+static void sc_app_dataset_free(ScAppDataset* dataset, SDL_GPUDevice* device) {
+    for (uint32_t i = 0; i < dataset->point_segment_count; i++) {
+        SDL_ReleaseGPUBuffer(device, dataset->point_segments[i].point_buffer);
+        SDL_ReleaseGPUBuffer(device, dataset->point_segments[i].point_color_buffer);
+    }
+    SDL_ReleaseGPUBuffer(device, dataset->node_buffer);
+    free(dataset->point_segments);
+    free(dataset->node_point_segments);
+    sc_octree_free(&dataset->octree);
+    SDL_zerop(dataset);
+}
+
+static int sc_app_dataset_loader_main(void* data) {
+    ScAppDatasetLoader* loader = data;
+    sc_profile_thread_name("sc_app_dataset_loader");
+    loader->loaded = sc_octree_probe(loader->file_path);
+    if (loader->loaded) {
+        sc_app_dataset_new(&loader->dataset, loader->device, loader->file_path);
+    } else {
+        SC_LOG_ERROR("Failed to open dataset: %s", loader->file_path);
+    }
+    sc_profile_thread_release();
+    SDL_SetAtomicInt(&loader->done, 1);
+    return 0;
+}
+
+// Starts loading a dataset in the background, ignored while another load is in progress.
+static void sc_app_dataset_open(ScApp* app, const char* file_path) {
+    // Early out.
+    if (app->dataset_loader != NULL) {
+        SC_LOG_ERROR("Dataset load in progress, ignoring %s", file_path);
+        return;
+    }
+
+    // Load.
+    SC_LOG_INFO("Loading dataset %s", file_path);
+    ScAppDatasetLoader* loader = calloc(1, sizeof(ScAppDatasetLoader));
+    loader->device = app->device;
+    loader->file_path = SDL_strdup(file_path);
+    loader->thread = SDL_CreateThread(sc_app_dataset_loader_main, "sc_app_dataset_loader", loader);
+    SC_SDL_ASSERT(loader->thread != NULL);
+    app->dataset_loader = loader;
+}
+
+// Waits for the loader thread, and frees a loaded dataset that was not swapped in.
+static void sc_app_dataset_loader_free(ScAppDatasetLoader* loader, SDL_GPUDevice* device) {
+    SDL_WaitThread(loader->thread, NULL);
+    if (loader->loaded) {
+        sc_app_dataset_free(&loader->dataset, device);
+    }
+    SDL_free(loader->file_path);
+    free(loader);
+}
+
+// Creates an empty live dataset, its GPU buffers are created as nodes are inserted.
+static void sc_app_dataset_live_new(ScAppDataset* dataset, box3f world_bounds) {
+    SDL_zerop(dataset);
+    sc_octree_live_new(&dataset->octree, world_bounds);
+}
+
+// Records the ranges inserted into a live dataset since the last call, after growing its GPU
+// buffers to fit new nodes and slots.
+static void sc_app_dataset_live_upload(
+    ScAppDataset* dataset,
+    SDL_GPUDevice* device,
+    ScGpuFrameUploader* uploader
+) {
+    // Unpack.
+    ScOctree* octree = &dataset->octree;
+    ScOctreeLive* live = octree->live;
+    const uint32_t node_count = (uint32_t)octree->node_count;
+    const uint64_t segment_point_count = SC_OCTREE_LIVE_BLOCK_POINT_COUNT;
+
+    // Node buffer, recreated with every instance dirty.
+    if (node_count > dataset->node_capacity) {
+        while (dataset->node_capacity < node_count) {
+            dataset->node_capacity =
+                SDL_max(2 * dataset->node_capacity, SC_APP_LIVE_MIN_NODE_CAPACITY);
+        }
+        SDL_ReleaseGPUBuffer(device, dataset->node_buffer);
+        dataset->node_buffer = SDL_CreateGPUBuffer(
+            device,
+            &(SDL_GPUBufferCreateInfo) {
+                .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+                .size = dataset->node_capacity * (uint32_t)sizeof(ScOctreeNodeInstance),
+            }
+        );
+        dataset->node_point_segments =
+            realloc(dataset->node_point_segments, dataset->node_capacity * sizeof(uint32_t));
+        live->dirty_instance_begin = 0;
+    }
+
+    // Point buffers, one per block of point slots. Slots never straddle blocks.
+    const uint32_t segment_count =
+        (uint32_t)((live->point_end + segment_point_count - 1) / segment_point_count);
+    if (segment_count > dataset->point_segment_count) {
+        dataset->point_segments =
+            realloc(dataset->point_segments, segment_count * sizeof(ScAppPointSegment));
+        for (uint32_t i = dataset->point_segment_count; i < segment_count; i++) {
+            dataset->point_segments[i] = (ScAppPointSegment) {
+                .point_offset = i * segment_point_count,
+                .point_count = segment_point_count,
+                .point_buffer = SDL_CreateGPUBuffer(
+                    device,
+                    &(SDL_GPUBufferCreateInfo) {
+                        .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
+                        .size = (uint32_t)(segment_point_count * sizeof(ScOctreePoint)),
+                    }
+                ),
+            };
+        }
+        dataset->point_segment_count = segment_count;
+    }
+
+    // Nodes.
+    if (live->dirty_instance_begin < node_count) {
+        const uint32_t node_begin = live->dirty_instance_begin;
+        for (uint32_t node_idx = node_begin; node_idx < node_count; node_idx++) {
+            dataset->node_point_segments[node_idx] =
+                (uint32_t)(octree->nodes[node_idx].point_offset / segment_point_count);
+        }
+        const uint32_t byte_count = (node_count - node_begin) * sizeof(ScOctreeNodeInstance);
+        void* dst = sc_gpu_frame_uploader_alloc(
+            uploader,
+            dataset->node_buffer,
+            node_begin * (uint32_t)sizeof(ScOctreeNodeInstance),
+            byte_count
+        );
+        memcpy(dst, &octree->node_instances[node_begin], byte_count);
+    }
+
+    // Points, the tail of every node touched since the last upload. Nodes that moved to a
+    // larger slot are dirty from their first point.
+    for (uint32_t i = 0; i < live->dirty_node_count; i++) {
+        const uint32_t node_idx = live->dirty_nodes[i];
+        const ScOctreeNode* node = &octree->nodes[node_idx];
+        const uint32_t point_begin = live->nodes[node_idx].dirty_point_begin;
+        dataset->node_point_segments[node_idx] =
+            (uint32_t)(node->point_offset / segment_point_count);
+        if (point_begin >= node->point_count) {
+            continue;
+        }
+        const ScAppPointSegment* segment =
+            &dataset->point_segments[dataset->node_point_segments[node_idx]];
+        const uint64_t point_offset = node->point_offset + point_begin;
+        const uint32_t byte_count = (node->point_count - point_begin) * sizeof(ScOctreePoint);
+        void* dst = sc_gpu_frame_uploader_alloc(
+            uploader,
+            segment->point_buffer,
+            (uint32_t)((point_offset - segment->point_offset) * sizeof(ScOctreePoint)),
+            byte_count
+        );
+        memcpy(dst, &octree->points[point_offset], byte_count);
+    }
+    sc_octree_live_dirty_clear(octree);
+}
+
+static void sc_app_point_bind(
+    const ScApp* app,
+    SDL_GPURenderPass* render_pass,
+    const ScAppPointSegment* segment
+) {
+    // Compact points, colors come from the points unless there is a color stream.
+    if (app->dataset.octree.point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+        SDL_BindGPUGraphicsPipeline(render_pass, app->point_compact_pipeline);
+        SDL_BindGPUVertexBuffers(
+            render_pass,
+            0,
+            &(SDL_GPUBufferBinding) {
+                .buffer = app->dataset.node_buffer,
+                .offset = 0,
+            },
+            1
+        );
+        SDL_BindGPUVertexStorageBuffers(
+            render_pass,
+            0,
+            (SDL_GPUBuffer*[]) {
+                segment->point_buffer,
+                app->point_color_mode == COLOR_MODE_RGB ? segment->point_buffer
+                                                        : segment->point_color_buffer,
+            },
+            2
+        );
+        return;
+    }
+
+    // Default points.
+    if (app->point_color_mode == COLOR_MODE_RGB) {
+        SDL_BindGPUGraphicsPipeline(render_pass, app->point_pipeline);
+    } else {
+        SDL_BindGPUGraphicsPipeline(render_pass, app->point_color_pipeline);
+    }
+    SDL_BindGPUVertexBuffers(
+        render_pass,
+        0,
+        (SDL_GPUBufferBinding[]) {
+            {
+                .buffer = segment->point_buffer,
+                .offset = 0,
+            },
+            {
+                .buffer = app->dataset.node_buffer,
+                .offset = 0,
+            },
+            {
+                .buffer = segment->point_color_buffer,
+                .offset = 0,
+            },
+        },
+        app->point_color_mode == COLOR_MODE_RGB ? 2 : 3
+    );
+}
+
+// One draw per non-empty node of the cut, resolved once and replayed in every view.
+typedef struct ScAppPointDraw {
+    uint32_t segment_idx;
+    uint32_t vertex_count;
+    uint32_t vertex_offset;
+    uint32_t node_idx;
+} ScAppPointDraw;
+
+static ScAppPointDraw* sc_app_point_draws_new(
+    const ScApp* app,
+    const ScOctreeTraversal* traversal,
+    ScArena* arena,
+    uint32_t* out_draw_count
+) {
+    ScAppPointDraw* draws = SC_ARENA_ALLOC(arena, ScAppPointDraw, traversal->node_traverse_count);
+    uint32_t draw_count = 0;
+    for (uint32_t i = 0; i < traversal->node_traverse_count; i++) {
+        const uint32_t node_idx = traversal->node_traverse[i];
+        const ScOctreeNode* node = &app->dataset.octree.nodes[node_idx];
+        if (node->point_count == 0) {
+            continue;
+        }
+        const uint32_t segment_idx = app->dataset.node_point_segments[node_idx];
+        const ScAppPointSegment* segment = &app->dataset.point_segments[segment_idx];
+        draws[draw_count++] = (ScAppPointDraw) {
+            .segment_idx = segment_idx,
+            .vertex_count = node->point_count,
+            .vertex_offset = (uint32_t)(node->point_offset - segment->point_offset),
+            .node_idx = node_idx,
+        };
+    }
+    *out_draw_count = draw_count;
+    return draws;
+}
+
+static void sc_app_point_draw(
+    const ScApp* app,
+    const ScAppPointDraw* draws,
+    uint32_t draw_count,
+    SDL_GPURenderPass* render_pass
+) {
+    // Rebind whenever the next node lives in a different segment.
+    uint32_t bound_segment_idx = UINT32_MAX;
+    for (uint32_t i = 0; i < draw_count; i++) {
+        const ScAppPointDraw* draw = &draws[i];
+        if (draw->segment_idx != bound_segment_idx) {
+            sc_app_point_bind(app, render_pass, &app->dataset.point_segments[draw->segment_idx]);
+            bound_segment_idx = draw->segment_idx;
+        }
+        SDL_DrawGPUPrimitives(
+            render_pass,
+            draw->vertex_count,
+            1,
+            draw->vertex_offset,
+            draw->node_idx
+        );
+    }
+}
+
+static ScAppPrepareInfo sc_app_prepare_info(const ScApp* app, float delta_time) {
+    // Screen, one viewport.
+    const ScAppViewLayout* layout = &SC_APP_VIEW_LAYOUT[app->parameters.view_mode];
+    const float screen_width = (float)SC_WINDOW_WIDTH / (float)layout->column_count;
+    const float screen_height = (float)SC_WINDOW_HEIGHT / (float)layout->row_count;
+
+    return (ScAppPrepareInfo) {
+        .common =
+            {
+                .screen_width = screen_width,
+                .screen_height = screen_height,
+                .field_of_view = rad_from_deg(60.0f),
+                .clip_distance_near = 16.0f,
+                .clip_distance_far = 2048.0f,
+                .delta_time = delta_time,
+                .input_captured = ImGui_GetIO()->WantCaptureMouse,
+            },
+        .view_mode = app->parameters.view_mode,
+        .stereo_separation = app->parameters.stereo_separation,
+        .main_camera_control_type = app->parameters.main_camera_control_type,
+        .lod_bias = app->parameters.lod_bias,
+    };
+}
+
+// Camera with the lens of camera, placed elsewhere.
+static ScPerspectiveCamera sc_app_camera_derive(
+    const ScPerspectiveCamera* camera,
+    vec3f world_position,
+    vec3f world_forward,
+    vec3f world_up
+) {
+    return sc_perspective_camera_new(&(ScPerspectiveCameraCreateInfo) {
+        .screen_width = camera->screen_width,
+        .screen_height = camera->screen_height,
+        .field_of_view = camera->field_of_view,
+        .clip_distance_near = camera->clip_distance_near,
+        .clip_distance_far = camera->clip_distance_far,
+        .world_position = world_position,
+        .world_target = vec3f_add(world_position, world_forward),
+        .world_up = world_up,
+    });
+}
+
+// Quarter turn around the world up axis.
+static vec3f sc_app_quarter_turn(vec3f v) {
+    return (vec3f) {-v.y, v.x, v.z};
+}
+
+// Updates the cameras and traverses the octree into the slot. Runs on the main thread or the
+// pipeline worker, never on both at once.
+static void sc_app_frame_prepare(ScApp* app, ScAppFrameSlot* slot) {
+    // Unpack.
+    const ScAppPrepareInfo* prepare_info = &slot->prepare_info;
+    const ScAppViewLayout* layout = &SC_APP_VIEW_LAYOUT[prepare_info->view_mode];
+    ScPerspectiveCamera* main_camera = &slot->cameras[0];
+    const vec3f scene_center = box3f_center(app->dataset.octree.point_bounds);
+    sc_arena_reset(&slot->arena);
+
+    // Camera controls.
+    SC_PROFILE_BEGIN("camera_update");
+    switch (prepare_info->main_camera_control_type) {
+        case MAIN_CAMERA_CONTROL_TYPE_ORBIT:
+            sc_camera_control_orbit_update(
+                &app->orbit_control,
+                &(ScCameraControlOrbitUpdateInfo) {
+                    .common = prepare_info->common,
+                },
+                main_camera
+            );
+            break;
+        case MAIN_CAMERA_CONTROL_TYPE_AUTOPLAY:
+            sc_camera_control_autoplay_update(
+                &app->autoplay_control,
+                &(ScCameraControlAutoplayUpdateInfo) {
+                    .common = prepare_info->common,
+                },
+                main_camera
+            );
+            break;
+        default: break;
+    }
+
+    // Derived views.
+    switch (prepare_info->view_mode) {
+        case VIEW_MODE_SPLIT:
+            sc_camera_control_aerial_update(
+                &app->aerial_control,
+                &(ScCameraControlAerialUpdateInfo) {
+                    .common = prepare_info->common,
+                    .world_target = scene_center,
+                },
+                &slot->cameras[SC_APP_VIEW_AERIAL]
+            );
+            break;
+        case VIEW_MODE_QUAD: {
+            vec3f offset = vec3f_sub(main_camera->world_position, scene_center);
+            vec3f forward = main_camera->world_forward;
+            vec3f up = main_camera->world_up;
+            for (uint32_t i = 1; i < layout->view_count; i++) {
+                offset = sc_app_quarter_turn(offset);
+                forward = sc_app_quarter_turn(forward);
+                up = sc_app_quarter_turn(up);
+                slot->cameras[i] = sc_app_camera_derive(
+                    main_camera,
+                    vec3f_add(scene_center, offset),
+                    forward,
+                    up
+                );
+            }
+            break;
+        }
+        case VIEW_MODE_STEREO: {
+            // Parallel eyes, offset sideways from the main camera.
+            const ScPerspectiveCamera center = *main_camera;
+            const vec3f offset =
+                vec3f_scale(center.world_right, 0.5f * prepare_info->stereo_separation);
+            slot->cameras[0] = sc_app_camera_derive(
+                &center,
+                vec3f_sub(center.world_position, offset),
+                center.world_forward,
+                center.world_up
+            );
+            slot->cameras[1] = sc_app_camera_derive(
+                &center,
+                vec3f_add(center.world_position, offset),
+                center.world_forward,
+                center.world_up
+            );
+            break;
+        }
+        default: break;
+    }
+    SC_PROFILE_END();
+
+    // Octree - traversal.
+    SC_PROFILE_BEGIN("traverse");
+    const uint64_t traverse_begin_ns = SDL_GetTicksNS();
+    sc_octree_traverse(
+        &app->dataset.octree,
+        &(ScOctreeTraverseInfo) {
+            .arena = &slot->arena,
+            .cameras = slot->cameras,
+            .camera_count = layout->traverse_view_count,
+            .lod_bias = prepare_info->lod_bias,
+        },
+        &slot->traversal
+    );
+    slot->traverse_ns = SDL_GetTicksNS() - traverse_begin_ns;
+    SC_PROFILE_END();
+}
+
+static int sc_app_pipeline_worker_main(void* data) {
+    ScApp* app = data;
+    ScAppPipeline* pipeline = &app->pipeline;
+    sc_profile_thread_name("sc_app_pipeline_worker");
+    for (;;) {
+        SDL_WaitSemaphore(pipeline->work_begin);
+        if (pipeline->work_quit) {
+            break;
+        }
+        sc_app_frame_prepare(app, pipeline->work_slot);
+        SDL_SignalSemaphore(pipeline->work_end);
+    }
+    sc_profile_thread_release();
+    return 0;
+}
+
+static void sc_app_pipeline_new(ScApp* app) {
+    ScAppPipeline* pipeline = &app->pipeline;
+    SDL_zerop(pipeline);
+    for (uint32_t i = 0; i < SC_APP_FRAME_SLOT_COUNT; i++) {
+        sc_arena_new(&pipeline->slots[i].arena, app->dataset.octree.node_count * sizeof(uint32_t));
+    }
+    pipeline->work_begin = SDL_CreateSemaphore(0);
+    pipeline->work_end = SDL_CreateSemaphore(0);
+    pipeline->worker =
+        SDL_CreateThread(sc_app_pipeline_worker_main, "sc_app_pipeline_worker", app);
+    SC_SDL_ASSERT(pipeline->worker != NULL);
+}
+
+// Blocks until the worker is idle, a prepared slot stays available.
+static void sc_app_pipeline_wait(ScAppPipeline* pipeline) {
+    if (pipeline->work_pending) {
+        SDL_WaitSemaphore(pipeline->work_end);
+        pipeline->work_pending = false;
+    }
+}
+
+static void sc_app_pipeline_free(ScAppPipeline* pipeline) {
+    sc_app_pipeline_wait(pipeline);
+    pipeline->work_quit = true;
+    SDL_SignalSemaphore(pipeline->work_begin);
+    SDL_WaitThread(pipeline->worker, NULL);
+    SDL_DestroySemaphore(pipeline->work_begin);
+    SDL_DestroySemaphore(pipeline->work_end);
+    for (uint32_t i = 0; i < SC_APP_FRAME_SLOT_COUNT; i++) {
+        sc_arena_free(&pipeline->slots[i].arena);
+    }
+}
+
+// Starts preparing the next frame into the slot the current frame is not reading.
+static void sc_app_pipeline_kick(ScAppPipeline* pipeline, const ScAppPrepareInfo* prepare_info) {
+    SC_ASSERT(pipeline->work_slot == NULL);
+    const uint32_t slot_index = (pipeline->slot_index + 1) % SC_APP_FRAME_SLOT_COUNT;
+    pipeline->work_slot = &pipeline->slots[slot_index];
+    pipeline->work_slot->prepare_info = *prepare_info;
+    pipeline->work_pending = true;
+    SDL_SignalSemaphore(pipeline->work_begin);
+}
+
+// Returns the slot of the current frame: the one prepared ahead by the worker, or a slot
+// prepared inline now.
+static ScAppFrameSlot* sc_app_pipeline_acquire(ScApp* app, float delta_time) {
+    ScAppPipeline* pipeline = &app->pipeline;
+    sc_app_pipeline_wait(pipeline);
+    if (pipeline->work_slot != NULL) {
+        pipeline->slot_index = (uint32_t)(pipeline->work_slot - pipeline->slots);
+        pipeline->work_slot = NULL;
+        return &pipeline->slots[pipeline->slot_index];
+    }
+    ScAppFrameSlot* slot = &pipeline->slots[pipeline->slot_index];
+    slot->prepare_info = sc_app_prepare_info(app, delta_time);
+    sc_app_frame_prepare(app, slot);
+    return slot;
+}
+
+static void sc_app_all_node_bounds_free(ScApp* app) {
+    if (app->all_node_bounds != NULL) {
+        ScDebugDraw* aerial_ddraw = &app->cameras[SC_APP_VIEW_AERIAL].ddraw;
+        sc_ddraw_persistent_free(aerial_ddraw, app->device, app->all_node_bounds);
+        app->all_node_bounds = NULL;
+    }
+}
+
+// Takes ownership of the dataset. The previous one is retired until the frames in flight that
+// drew it are done.
+static void sc_app_dataset_swap(ScApp* app, ScAppDataset* dataset) {
+    // Still retiring from a previous swap, only happens when swapping every frame.
+    if (app->retired_dataset_frame_count > 0) {
+        SC_SDL_ASSERT(SDL_WaitForGPUIdle(app->device));
+        sc_app_dataset_free(&app->retired_dataset, app->device);
+    }
+
+    // Swap. The pipeline worker reads the octree, and a frame it prepared ahead refers to the
+    // nodes of the previous dataset.
+    sc_app_pipeline_wait(&app->pipeline);
+    app->pipeline.work_slot = NULL;
+    app->retired_dataset = app->dataset;
+    app->retired_dataset_frame_count = SC_INFLIGHT_FRAME_COUNT + 1;
+    app->dataset = *dataset;
+    SDL_zerop(dataset);
+
+    // Dependent state, rebuilt for the new dataset on demand.
+    app->point_color_mode = COLOR_MODE_RGB;
+    sc_app_all_node_bounds_free(app);
+}
+
+static void sc_app_live_replay_end(ScAppLiveReplay* replay) {
+    free(replay->positions);
+    free(replay->colors);
+    replay->positions = NULL;
+    replay->colors = NULL;
+}
+
+// Decodes the leaf points of the current dataset, and swaps in an empty live dataset with the
+// same bounds to replay them into.
+static void sc_app_live_replay_begin(ScApp* app) {
+    // Unpack.
+    ScAppLiveReplay* replay = &app->live_replay;
+    const ScOctree* octree = &app->dataset.octree;
+    const bool compact = octree->point_format == SC_OCTREE_POINT_FORMAT_COMPACT;
+
+    // Count.
+    uint64_t point_count = 0;
+    for (uint32_t node_idx = 0; node_idx < octree->node_count; node_idx++) {
+        const ScOctreeNode* node = &octree->nodes[node_idx];
+        point_count += node->level == 0 ? node->point_count : 0;
+    }
+    if (point_count == 0) {
+        SC_LOG_ERROR("Dataset has no points to replay");
+        return;
+    }
+
+    // Decode.
+    sc_app_live_replay_end(replay);
+    replay->positions = malloc(point_count * sizeof(vec3f));
+    replay->colors = malloc(point_count * sizeof(uint32_t));
+    replay->point_count = 0;
+    for (uint32_t node_idx = 0; node_idx < octree->node_count; node_idx++) {
+        const ScOctreeNode* node = &octree->nodes[node_idx];
+        if (node->level != 0) {
+            continue;
+        }
+        const box3f bounds = sc_octree_node_bounds(octree, node_idx);
+        const vec3f extent = box3f_extents(bounds);
+        for (uint64_t i = node->point_offset; i < node->point_offset + node->point_count; i++) {
+            const ScOctreePoint point = compact ? sc_octree_point_expand(octree->compact_points[i])
+                                                : octree->points[i];
+            replay->positions[replay->point_count] = (vec3f) {
+                bounds.mn.x + ((float)(point.position & 0x3ff) / 1023.0f) * extent.x,
+                bounds.mn.y + ((float)((point.position >> 10) & 0x3ff) / 1023.0f) * extent.y,
+                bounds.mn.z + ((float)((point.position >> 20) & 0x3ff) / 1023.0f) * extent.z,
+            };
+            replay->colors[replay->point_count] = point.color;
+            replay->point_count++;
+        }
+    }
+    replay->point_offset = 0;
+    replay->point_carry = 0.0;
+
+    // Swap.
+    ScAppDataset dataset;
+    sc_app_dataset_live_new(&dataset, octree->point_bounds);
+    sc_app_dataset_swap(app, &dataset);
+    SC_LOG_INFO("Replaying %" PRIu64 " points into a live dataset", replay->point_count);
+}
+
+// Inserts the points due this frame.
+static void sc_app_live_replay_update(ScApp* app, float delta_time) {
+    // Early out.
+    ScAppLiveReplay* replay = &app->live_replay;
+    replay->insert_point_count = 0;
+    if (replay->positions == NULL) {
+        return;
+    }
+
+    // Budget, a long frame does not turn into an even longer insertion.
+    const double budget =
+        1e6 * (double)replay->mpoint_rate * (double)SDL_min(delta_time, 0.1f) + replay->point_carry;
+    const uint64_t point_count =
+        SDL_min((uint64_t)budget, replay->point_count - replay->point_offset);
+    replay->point_carry = budget - (double)(uint64_t)budget;
+
+    // Insert, not while the pipeline worker traverses the octree.
+    sc_app_pipeline_wait(&app->pipeline);
+    SC_PROFILE_BEGIN("live_insert");
+    const uint64_t insert_begin_ns = SDL_GetTicksNS();
+    const uint32_t node_count = (uint32_t)app->dataset.octree.node_count;
+    sc_octree_insert(
+        &app->dataset.octree,
+        replay->positions + replay->point_offset,
+        replay->colors + replay->point_offset,
+        point_count
+    );
+    replay->insert_ns = SDL_GetTicksNS() - insert_begin_ns;
+    replay->insert_point_count = point_count;
+    replay->point_offset += point_count;
+    SC_PROFILE_END();
+
+    // New nodes.
+    if (app->dataset.octree.node_count != node_count) {
+        sc_app_all_node_bounds_free(app);
+    }
+
+    // Done, the live dataset stays.
+    if (replay->point_offset == replay->point_count) {
+        const ScOctreeLive* live = app->dataset.octree.live;
+        SC_LOG_INFO(
+            "Replay done: %" PRIu64 " points inserted, %" PRIu64 " dropped, %" PRIu64 " nodes",
+            live->inserted_point_count,
+            live->dropped_point_count,
+            app->dataset.octree.node_count
+        );
+        sc_app_live_replay_end(replay);
+    }
+}
+
+// Called between frames. Frees the retired dataset once its frames are done, and swaps in a
+// finished load.
+static void sc_app_dataset_update(ScApp* app) {
+    // Retire.
+    if (app->retired_dataset_frame_count > 0 && --app->retired_dataset_frame_count == 0) {
+        sc_app_dataset_free(&app->retired_dataset, app->device);
+    }
+
+    // Early out.
+    ScAppDatasetLoader* loader = app->dataset_loader;
+    if (loader == NULL || SDL_GetAtomicInt(&loader->done) == 0) {
+        return;
+    }
+    app->dataset_loader = NULL;
+    if (!loader->loaded) {
+        sc_app_dataset_loader_free(loader, app->device);
+        return;
+    }
+
+    // Swap, a replay into the previous dataset ends with it.
+    sc_app_dataset_swap(app, &loader->dataset);
+    loader->loaded = false;
+    sc_app_live_replay_end(&app->live_replay);
+    SDL_strlcpy(app->dataset_file_path, loader->file_path, sizeof(app->dataset_file_path));
+    SC_LOG_INFO("Swapped to dataset %s", loader->file_path);
+    sc_app_dataset_loader_free(loader, app->device);
+}
+
 SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
     // Arguments.
     SC_ASSERT(argc == 2);
@@ -131,14 +1167,24 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
     ScApp* app = calloc(1, sizeof(ScApp));
     *appstate = app;
 
+    // Profile.
+    sc_profile_new();
+    sc_profile_thread_name("main");
+
+    // Jobs, pinning is opt-in since it fights other processes for the same cores.
+    sc_job_system_new(&(ScJobSystemCreateInfo) {
+        .worker_count = 0,
+        .pin_workers = SDL_getenv("SC_JOB_PIN_WORKERS") != NULL,
+    });
+
     // Parameters.
     app->parameters.lod_bias = 1.0f / 8.0f;
+    app->parameters.show_all_nodes = false;
     app->parameters.view_mode = VIEW_MODE_SPLIT;
+    app->parameters.stereo_separation = 4.0f;
+    app->parameters.color_mode = COLOR_MODE_RGB;
     app->parameters.main_camera_control_type = MAIN_CAMERA_CONTROL_TYPE_ORBIT;
 
-    // Octree.
-    sc_octree_new(&app->octree, argv[1]);
-
     // SDL.
     SDL_SetAppMetadata("stormcloud", "1.0.0", "com.phoekz.stormcloud");
     if (!SDL_Init(SDL_INIT_VIDEO)) {
@@ -152,11 +1198,16 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
         SC_LOG_ERROR("SDL_CreateWindow failed: %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
-    app->device = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_DXIL, false, "direct3d12");
+    app->device = SDL_CreateGPUDevice(
+        SDL_GPU_SHADERFORMAT_DXIL | SDL_GPU_SHADERFORMAT_SPIRV,
+        false,
+        SC_GPU_DEFAULT_DRIVER
+    );
     if (app->device == NULL) {
         SC_LOG_ERROR("SDL_CreateGPUDevice failed: %s", SDL_GetError());
         return SDL_APP_FAILURE;
     }
+    SC_LOG_INFO("GPU driver: %s", SDL_GetGPUDeviceDriver(app->device));
     if (!SDL_ClaimWindowForGPUDevice(app->device, app->window)) {
         SC_LOG_ERROR("SDL_ClaimWindowForGPUDevice failed: %s", SDL_GetError());
         return SDL_APP_FAILURE;
@@ -204,166 +1255,15 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
         );
     }
 
-    // Vertex buffer - points.
-    {
-        const uint32_t vertex_count = (uint32_t)app->octree.point_count;
-        const uint32_t vertex_byte_count = vertex_count * sizeof(ScOctreePoint);
-        app->point_buffer = SDL_CreateGPUBuffer(
-            app->device,
-            &(SDL_GPUBufferCreateInfo) {
-                .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
-                .size = vertex_byte_count,
-            }
-        );
-        SDL_GPUTransferBuffer* transfer_buffer = SDL_CreateGPUTransferBuffer(
-            app->device,
-            &(SDL_GPUTransferBufferCreateInfo) {
-                .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-                .size = vertex_byte_count,
-            }
-        );
-        ScOctreePoint* data = SDL_MapGPUTransferBuffer(app->device, transfer_buffer, false);
-        memcpy(data, app->octree.points, vertex_byte_count);
-        SDL_UnmapGPUTransferBuffer(app->device, transfer_buffer);
-        SDL_GPUCommandBuffer* upload_cmd = SDL_AcquireGPUCommandBuffer(app->device);
-        SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(upload_cmd);
-        SDL_UploadToGPUBuffer(
-            copy_pass,
-            &(SDL_GPUTransferBufferLocation) {
-                .transfer_buffer = transfer_buffer,
-                .offset = 0,
-            },
-            &(SDL_GPUBufferRegion) {
-                .buffer = app->point_buffer,
-                .offset = 0,
-                .size = vertex_byte_count,
-            },
-            false
-        );
-        SDL_EndGPUCopyPass(copy_pass);
-        SDL_SubmitGPUCommandBuffer(upload_cmd);
-        SDL_ReleaseGPUTransferBuffer(app->device, transfer_buffer);
-    }
-
-    // Vertex buffer - nodes.
-    {
-        const uint32_t node_count = (uint32_t)app->octree.node_count;
-        const uint32_t node_byte_count = node_count * sizeof(ScOctreeNodeInstance);
-        app->node_buffer = SDL_CreateGPUBuffer(
-            app->device,
-            &(SDL_GPUBufferCreateInfo) {
-                .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
-                .size = node_byte_count,
-            }
-        );
-        SDL_GPUTransferBuffer* transfer_buffer = SDL_CreateGPUTransferBuffer(
-            app->device,
-            &(SDL_GPUTransferBufferCreateInfo) {
-                .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-                .size = node_byte_count,
-            }
-        );
-        ScOctreeNodeInstance* data = SDL_MapGPUTransferBuffer(app->device, transfer_buffer, false);
-        memcpy(data, app->octree.node_instances, node_byte_count);
-        SDL_UnmapGPUTransferBuffer(app->device, transfer_buffer);
-        SDL_GPUCommandBuffer* upload_cmd = SDL_AcquireGPUCommandBuffer(app->device);
-        SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(upload_cmd);
-        SDL_UploadToGPUBuffer(
-            copy_pass,
-            &(SDL_GPUTransferBufferLocation) {
-                .transfer_buffer = transfer_buffer,
-                .offset = 0,
-            },
-            &(SDL_GPUBufferRegion) {
-                .buffer = app->node_buffer,
-                .offset = 0,
-                .size = node_byte_count,
-            },
-            false
-        );
-        SDL_EndGPUCopyPass(copy_pass);
-        SDL_SubmitGPUCommandBuffer(upload_cmd);
-        SDL_ReleaseGPUTransferBuffer(app->device, transfer_buffer);
-    }
-
-    // Vertex buffer - lines.
-    typedef struct ScVertex {
-        vec3f position;
-        uint32_t color;
-    } ScVertex;
-    {
-        const uint32_t vertex_count = 2 * 12;
-        const uint32_t vertex_byte_count = vertex_count * sizeof(ScVertex);
-        app->bounds_vertex_count = vertex_count;
-        app->bounds_buffer = SDL_CreateGPUBuffer(
-            app->device,
-            &(SDL_GPUBufferCreateInfo) {
-                .usage = SDL_GPU_BUFFERUSAGE_VERTEX,
-                .size = vertex_byte_count,
-            }
-        );
-        SDL_GPUTransferBuffer* transfer_buffer = SDL_CreateGPUTransferBuffer(
-            app->device,
-            &(SDL_GPUTransferBufferCreateInfo) {
-                .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-                .size = vertex_byte_count,
-            }
-        );
-        ScVertex* data = SDL_MapGPUTransferBuffer(app->device, transfer_buffer, false);
-        const vec3f mn = {0.0f, 0.0f, 0.0f};
-        const vec3f mx = {1.0f, 1.0f, 1.0f};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mn.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mn.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mn.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mx.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mx.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mx.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mx.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mn.y, mn.z}, .color = 0xffffffff};
-
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mn.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mn.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mn.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mx.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mx.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mx.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mx.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mn.y, mx.z}, .color = 0xffffffff};
-
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mn.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mn.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mn.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mn.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mx.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mx.x, mx.y, mx.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mx.y, mn.z}, .color = 0xffffffff};
-        *data++ = (ScVertex) {.position = (vec3f) {mn.x, mx.y, mx.z}, .color = 0xffffffff};
-        SDL_UnmapGPUTransferBuffer(app->device, transfer_buffer);
-        SDL_GPUCommandBuffer* upload_cmd = SDL_AcquireGPUCommandBuffer(app->device);
-        SDL_GPUCopyPass* copy_pass = SDL_BeginGPUCopyPass(upload_cmd);
-        SDL_UploadToGPUBuffer(
-            copy_pass,
-            &(SDL_GPUTransferBufferLocation) {
-                .transfer_buffer = transfer_buffer,
-                .offset = 0,
-            },
-            &(SDL_GPUBufferRegion) {
-                .buffer = app->bounds_buffer,
-                .offset = 0,
-                .size = vertex_byte_count,
-            },
-            false
-        );
-        SDL_EndGPUCopyPass(copy_pass);
-        SDL_SubmitGPUCommandBuffer(upload_cmd);
-        SDL_ReleaseGPUTransferBuffer(app->device, transfer_buffer);
-    }
+    // Dataset.
+    sc_app_dataset_new(&app->dataset, app->device, argv[1]);
+    SDL_strlcpy(app->dataset_file_path, argv[1], sizeof(app->dataset_file_path));
 
     // Shaders.
     SDL_GPUShader* point_vertex_shader = sc_gpu_shader_new(
         app->device,
         &(ScGpuShaderCreateInfo) {
-            .file_path = "src/shaders/dxil/point.vert",
+            .file_name = "point.vert",
             .entry_point = "vs_main",
             .shader_stage = SDL_GPU_SHADERSTAGE_VERTEX,
             .sampler_count = 0,
@@ -373,27 +1273,28 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
     SDL_GPUShader* point_fragment_shader = sc_gpu_shader_new(
         app->device,
         &(ScGpuShaderCreateInfo) {
-            .file_path = "src/shaders/dxil/point.frag",
+            .file_name = "point.frag",
             .entry_point = "fs_main",
             .shader_stage = SDL_GPU_SHADERSTAGE_FRAGMENT,
             .sampler_count = 0,
             .uniform_buffer_count = 1,
         }
     );
-    SDL_GPUShader* bounds_vertex_shader = sc_gpu_shader_new(
+    SDL_GPUShader* point_compact_vertex_shader = sc_gpu_shader_new(
         app->device,
         &(ScGpuShaderCreateInfo) {
-            .file_path = "src/shaders/dxil/bounds.vert",
+            .file_name = "point_compact.vert",
             .entry_point = "vs_main",
             .shader_stage = SDL_GPU_SHADERSTAGE_VERTEX,
             .sampler_count = 0,
+            .storage_buffer_count = 2,
             .uniform_buffer_count = 1,
         }
     );
-    SDL_GPUShader* bounds_fragment_shader = sc_gpu_shader_new(
+    SDL_GPUShader* point_compact_fragment_shader = sc_gpu_shader_new(
         app->device,
         &(ScGpuShaderCreateInfo) {
-            .file_path = "src/shaders/dxil/bounds.frag",
+            .file_name = "point_compact.frag",
             .entry_point = "fs_main",
             .shader_stage = SDL_GPU_SHADERSTAGE_FRAGMENT,
             .sampler_count = 0,
@@ -402,203 +1303,200 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
     );
 
     // Pipeline.
-    app->point_pipeline = SDL_CreateGPUGraphicsPipeline(
-        app->device,
-        &(SDL_GPUGraphicsPipelineCreateInfo) {
-            .vertex_shader = point_vertex_shader,
-            .fragment_shader = point_fragment_shader,
-            .vertex_input_state =
-                (SDL_GPUVertexInputState) {
-                    .vertex_buffer_descriptions =
-                        (SDL_GPUVertexBufferDescription[]) {
-                            {
-                                .slot = 0,
-                                .pitch = sizeof(ScOctreePoint),
-                                .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
-                                .instance_step_rate = 0,
-                            },
-                            {
-                                .slot = 1,
-                                .pitch = sizeof(ScOctreeNodeInstance),
-                                .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
-                                .instance_step_rate = 1,
-                            },
+    SDL_GPUGraphicsPipelineCreateInfo point_pipeline_create_info = {
+        .vertex_shader = point_vertex_shader,
+        .fragment_shader = point_fragment_shader,
+        .vertex_input_state =
+            (SDL_GPUVertexInputState) {
+                .vertex_buffer_descriptions =
+                    (SDL_GPUVertexBufferDescription[]) {
+                        {
+                            .slot = 0,
+                            .pitch = sizeof(ScOctreePoint),
+                            .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+                            .instance_step_rate = 0,
                         },
-                    .num_vertex_buffers = 2,
-                    .vertex_attributes =
-                        (SDL_GPUVertexAttribute[]) {
-                            {
-                                .location = 0,
-                                .buffer_slot = 0,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_UINT,
-                                .offset = 0,
-                            },
-                            {
-                                .location = 1,
-                                .buffer_slot = 0,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
-                                .offset = sizeof(uint32_t),
-                            },
-                            {
-                                .location = 2,
-                                .buffer_slot = 1,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-                                .offset = 0,
-                            },
-                            {
-                                .location = 3,
-                                .buffer_slot = 1,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-                                .offset = 3 * sizeof(float),
-                            },
+                        {
+                            .slot = 1,
+                            .pitch = sizeof(ScOctreeNodeInstance),
+                            .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+                            .instance_step_rate = 1,
                         },
-                    .num_vertex_attributes = 4,
+                    },
+                .num_vertex_buffers = 2,
+                .vertex_attributes =
+                    (SDL_GPUVertexAttribute[]) {
+                        {
+                            .location = 0,
+                            .buffer_slot = 0,
+                            .format = SDL_GPU_VERTEXELEMENTFORMAT_UINT,
+                            .offset = 0,
+                        },
+                        {
+                            .location = 1,
+                            .buffer_slot = 0,
+                            .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+                            .offset = sizeof(uint32_t),
+                        },
+                        {
+                            .location = 2,
+                            .buffer_slot = 1,
+                            .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                            .offset = 0,
+                        },
+                        {
+                            .location = 3,
+                            .buffer_slot = 1,
+                            .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                            .offset = 3 * sizeof(float),
+                        },
+                    },
+                .num_vertex_attributes = 4,
+            },
+        .primitive_type = SDL_GPU_PRIMITIVETYPE_POINTLIST,
+        .rasterizer_state =
+            (SDL_GPURasterizerState) {
+                .fill_mode = SDL_GPU_FILLMODE_FILL,
+                .cull_mode = SDL_GPU_CULLMODE_NONE,
+                .front_face = SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,
+                .depth_bias_constant_factor = 0.0f,
+                .depth_bias_clamp = 0.0f,
+                .depth_bias_slope_factor = 0.0f,
+                .enable_depth_bias = false,
+                .enable_depth_clip = false,
+            },
+        .multisample_state =
+            (SDL_GPUMultisampleState) {
+                .sample_count = 1,
+                .sample_mask = 0,
+                .enable_mask = 0,
+            },
+        .depth_stencil_state =
+            (SDL_GPUDepthStencilState) {
+                .compare_op = SDL_GPU_COMPAREOP_LESS_OR_EQUAL,
+                .back_stencil_state = (SDL_GPUStencilOpState) {0},
+                .front_stencil_state = (SDL_GPUStencilOpState) {0},
+                .compare_mask = 0,
+                .write_mask = 0,
+                .enable_depth_test = true,
+                .enable_depth_write = true,
+                .enable_stencil_test = false,
+            },
+        .target_info =
+            (SDL_GPUGraphicsPipelineTargetInfo) {
+                .color_target_descriptions = (SDL_GPUColorTargetDescription[]) {{
+                    .format = SC_SWAPCHAIN_COLOR_FORMAT,
+                    .blend_state = (SDL_GPUColorTargetBlendState) {0},
+                }},
+                .num_color_targets = 1,
+                .depth_stencil_format = SC_SWAPCHAIN_DEPTH_STENCIL_FORMAT,
+                .has_depth_stencil_target = true,
+            },
+    };
+    app->point_pipeline = SDL_CreateGPUGraphicsPipeline(app->device, &point_pipeline_create_info);
+
+    // Pipeline - same as points, but color comes from a separate per-point stream in slot 2.
+    point_pipeline_create_info.vertex_input_state = (SDL_GPUVertexInputState) {
+        .vertex_buffer_descriptions =
+            (SDL_GPUVertexBufferDescription[]) {
+                {
+                    .slot = 0,
+                    .pitch = sizeof(ScOctreePoint),
+                    .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+                    .instance_step_rate = 0,
                 },
-            .primitive_type = SDL_GPU_PRIMITIVETYPE_POINTLIST,
-            .rasterizer_state =
-                (SDL_GPURasterizerState) {
-                    .fill_mode = SDL_GPU_FILLMODE_FILL,
-                    .cull_mode = SDL_GPU_CULLMODE_NONE,
-                    .front_face = SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,
-                    .depth_bias_constant_factor = 0.0f,
-                    .depth_bias_clamp = 0.0f,
-                    .depth_bias_slope_factor = 0.0f,
-                    .enable_depth_bias = false,
-                    .enable_depth_clip = false,
+                {
+                    .slot = 1,
+                    .pitch = sizeof(ScOctreeNodeInstance),
+                    .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+                    .instance_step_rate = 1,
                 },
-            .multisample_state =
-                (SDL_GPUMultisampleState) {
-                    .sample_count = 1,
-                    .sample_mask = 0,
-                    .enable_mask = 0,
+                {
+                    .slot = 2,
+                    .pitch = sizeof(uint32_t),
+                    .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
+                    .instance_step_rate = 0,
                 },
-            .depth_stencil_state =
-                (SDL_GPUDepthStencilState) {
-                    .compare_op = SDL_GPU_COMPAREOP_LESS_OR_EQUAL,
-                    .back_stencil_state = (SDL_GPUStencilOpState) {0},
-                    .front_stencil_state = (SDL_GPUStencilOpState) {0},
-                    .compare_mask = 0,
-                    .write_mask = 0,
-                    .enable_depth_test = true,
-                    .enable_depth_write = true,
-                    .enable_stencil_test = false,
+            },
+        .num_vertex_buffers = 3,
+        .vertex_attributes =
+            (SDL_GPUVertexAttribute[]) {
+                {
+                    .location = 0,
+                    .buffer_slot = 0,
+                    .format = SDL_GPU_VERTEXELEMENTFORMAT_UINT,
+                    .offset = 0,
                 },
-            .target_info =
-                (SDL_GPUGraphicsPipelineTargetInfo) {
-                    .color_target_descriptions = (SDL_GPUColorTargetDescription[]) {{
-                        .format = SC_SWAPCHAIN_COLOR_FORMAT,
-                        .blend_state = (SDL_GPUColorTargetBlendState) {0},
-                    }},
-                    .num_color_targets = 1,
-                    .depth_stencil_format = SC_SWAPCHAIN_DEPTH_STENCIL_FORMAT,
-                    .has_depth_stencil_target = true,
+                {
+                    .location = 1,
+                    .buffer_slot = 2,
+                    .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+                    .offset = 0,
                 },
-        }
-    );
-    app->bounds_pipeline = SDL_CreateGPUGraphicsPipeline(
-        app->device,
-        &(SDL_GPUGraphicsPipelineCreateInfo) {
-            .vertex_shader = bounds_vertex_shader,
-            .fragment_shader = bounds_fragment_shader,
-            .vertex_input_state =
-                (SDL_GPUVertexInputState) {
-                    .vertex_buffer_descriptions =
-                        (SDL_GPUVertexBufferDescription[]) {
-                            {
-                                .slot = 0,
-                                .pitch = sizeof(ScVertex),
-                                .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX,
-                                .instance_step_rate = 0,
-                            },
-                            {
-                                .slot = 1,
-                                .pitch = sizeof(ScOctreeNodeInstance),
-                                .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
-                                .instance_step_rate = 1,
-                            },
-                        },
-                    .num_vertex_buffers = 2,
-                    .vertex_attributes =
-                        (SDL_GPUVertexAttribute[]) {
-                            {
-                                .location = 0,
-                                .buffer_slot = 0,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-                                .offset = 0,
-                            },
-                            {
-                                .location = 1,
-                                .buffer_slot = 0,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
-                                .offset = sizeof(vec3f),
-                            },
-                            {
-                                .location = 2,
-                                .buffer_slot = 1,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-                                .offset = 0,
-                            },
-                            {
-                                .location = 3,
-                                .buffer_slot = 1,
-                                .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-                                .offset = 3 * sizeof(float),
-                            },
-                        },
-                    .num_vertex_attributes = 4,
+                {
+                    .location = 2,
+                    .buffer_slot = 1,
+                    .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                    .offset = 0,
                 },
-            .primitive_type = SDL_GPU_PRIMITIVETYPE_LINELIST,
-            .rasterizer_state =
-                (SDL_GPURasterizerState) {
-                    .fill_mode = SDL_GPU_FILLMODE_FILL,
-                    .cull_mode = SDL_GPU_CULLMODE_NONE,
-                    .front_face = SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,
-                    .depth_bias_constant_factor = 0.0f,
-                    .depth_bias_clamp = 0.0f,
-                    .depth_bias_slope_factor = 0.0f,
-                    .enable_depth_bias = false,
-                    .enable_depth_clip = false,
+                {
+                    .location = 3,
+                    .buffer_slot = 1,
+                    .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                    .offset = 3 * sizeof(float),
                 },
-            .multisample_state =
-                (SDL_GPUMultisampleState) {
-                    .sample_count = 1,
-                    .sample_mask = 0,
-                    .enable_mask = 0,
+            },
+        .num_vertex_attributes = 4,
+    };
+    app->point_color_pipeline =
+        SDL_CreateGPUGraphicsPipeline(app->device, &point_pipeline_create_info);
+
+    // Pipeline - compact points, fetched from storage buffers, only node instances are vertex
+    // input.
+    point_pipeline_create_info.vertex_shader = point_compact_vertex_shader;
+    point_pipeline_create_info.fragment_shader = point_compact_fragment_shader;
+    point_pipeline_create_info.vertex_input_state = (SDL_GPUVertexInputState) {
+        .vertex_buffer_descriptions =
+            (SDL_GPUVertexBufferDescription[]) {
+                {
+                    .slot = 0,
+                    .pitch = sizeof(ScOctreeNodeInstance),
+                    .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE,
+                    .instance_step_rate = 1,
                 },
-            .depth_stencil_state =
-                (SDL_GPUDepthStencilState) {
-                    .compare_op = SDL_GPU_COMPAREOP_LESS_OR_EQUAL,
-                    .back_stencil_state = (SDL_GPUStencilOpState) {0},
-                    .front_stencil_state = (SDL_GPUStencilOpState) {0},
-                    .compare_mask = 0,
-                    .write_mask = 0,
-                    .enable_depth_test = true,
-                    .enable_depth_write = true,
-                    .enable_stencil_test = false,
+            },
+        .num_vertex_buffers = 1,
+        .vertex_attributes =
+            (SDL_GPUVertexAttribute[]) {
+                {
+                    .location = 0,
+                    .buffer_slot = 0,
+                    .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                    .offset = 0,
                 },
-            .target_info =
-                (SDL_GPUGraphicsPipelineTargetInfo) {
-                    .color_target_descriptions = (SDL_GPUColorTargetDescription[]) {{
-                        .format = SC_SWAPCHAIN_COLOR_FORMAT,
-                        .blend_state = (SDL_GPUColorTargetBlendState) {0},
-                    }},
-                    .num_color_targets = 1,
-                    .depth_stencil_format = SC_SWAPCHAIN_DEPTH_STENCIL_FORMAT,
-                    .has_depth_stencil_target = true,
+                {
+                    .location = 1,
+                    .buffer_slot = 0,
+                    .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                    .offset = 3 * sizeof(float),
                 },
-        }
-    );
+            },
+        .num_vertex_attributes = 2,
+    };
+    app->point_compact_pipeline =
+        SDL_CreateGPUGraphicsPipeline(app->device, &point_pipeline_create_info);
     SC_SDL_ASSERT(app->point_pipeline != NULL);
-    SC_SDL_ASSERT(app->bounds_pipeline != NULL);
+    SC_SDL_ASSERT(app->point_color_pipeline != NULL);
+    SC_SDL_ASSERT(app->point_compact_pipeline != NULL);
 
     // Release.
     SDL_ReleaseGPUShader(app->device, point_vertex_shader);
     SDL_ReleaseGPUShader(app->device, point_fragment_shader);
-    SDL_ReleaseGPUShader(app->device, bounds_vertex_shader);
-    SDL_ReleaseGPUShader(app->device, bounds_fragment_shader);
+    SDL_ReleaseGPUShader(app->device, point_compact_vertex_shader);
+    SDL_ReleaseGPUShader(app->device, point_compact_fragment_shader);
 
     // Cameras.
-    for (uint32_t i = 0; i < CAMERA_TYPE_COUNT; i++) {
+    for (uint32_t i = 0; i < SC_APP_VIEW_MAX_COUNT; i++) {
         sc_app_camera_new(
             &app->cameras[i],
             &(ScAppCameraCreateInfo) {
@@ -612,7 +1510,7 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
     // Camera controllers.
     {
         const ScCameraControlCommonCreateInfo common_create_info = {
-            .scene_bounds = app->octree.point_bounds,
+            .scene_bounds = app->dataset.octree.point_bounds,
         };
         app->orbit_control = sc_camera_control_orbit_new(&(ScCameraControlOrbitCreateInfo) {
             .common = common_create_info,
@@ -637,10 +1535,26 @@ SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
         }
     );
 
+    // Frame arenas.
+    for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
+        sc_arena_new(&app->frame_arenas[i], SC_FRAME_ARENA_BYTE_COUNT);
+    }
+
+    // Frame uploader.
+    sc_gpu_frame_uploader_new(&app->frame_uploader, app->device);
+
+    // Frame pipeline.
+    sc_app_pipeline_new(app);
+
+    // Live replay.
+    app->live_replay.mpoint_rate = 2.0f;
+
     // Frame index.
     app->frame_index = 0;
     app->frame_time_ns = SDL_GetPerformanceCounter();
     app->frame_time_frequency = SDL_GetPerformanceFrequency();
+    sc_stats_new(&app->stats);
+    sc_lod_controller_new(&app->lod_controller);
 
     return SDL_APP_CONTINUE;
 }
@@ -659,7 +1573,13 @@ SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
         }
     }
 
-    // Camera controllers.
+    // Dataset - open dropped files.
+    if (event->type == SDL_EVENT_DROP_FILE) {
+        sc_app_dataset_open(app, event->drop.data);
+    }
+
+    // Camera controllers, not while the pipeline worker updates them.
+    sc_app_pipeline_wait(&app->pipeline);
     switch (app->parameters.main_camera_control_type) {
         case MAIN_CAMERA_CONTROL_TYPE_ORBIT:
             sc_camera_control_orbit_event(&app->orbit_control, event);
@@ -679,8 +1599,19 @@ SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
 SDL_AppResult SDL_AppIterate(void* appstate) {
     // Unpack.
     ScApp* app = (ScApp*)appstate;
-    ScAppCamera* main_camera = &app->cameras[CAMERA_TYPE_MAIN];
-    ScAppCamera* aerial_camera = &app->cameras[CAMERA_TYPE_AERIAL];
+    ScAppCamera* main_camera = &app->cameras[0];
+    ScAppCamera* aerial_camera = &app->cameras[SC_APP_VIEW_AERIAL];
+
+    // Profile.
+    sc_profile_frame_begin();
+
+    // Frame arena.
+    ScArena* frame_arena = &app->frame_arenas[app->frame_index];
+    sc_arena_reset(frame_arena);
+    sc_gpu_frame_uploader_begin(&app->frame_uploader, frame_arena, app->frame_index);
+    for (uint32_t i = 0; i < SC_APP_VIEW_MAX_COUNT; i++) {
+        sc_ddraw_frame_begin(&app->cameras[i].ddraw, frame_arena);
+    }
 
     // Timing.
     const uint64_t frame_time_ns = SDL_GetPerformanceCounter();
@@ -688,131 +1619,228 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
     app->frame_time_ns = frame_time_ns;
     const float delta_time =
         (float)((double)frame_time_elapsed_ns / (double)app->frame_time_frequency);
+    // Previous frame, minus the time blocked on the swapchain.
+    const float busy_ms = 1e3f * delta_time - (float)app->swapchain_wait_ns / 1e6f;
+
+    // Dataset - swap in a finished load.
+    sc_app_dataset_update(app);
+
+    // Dataset - live insertion.
+    sc_app_live_replay_update(app, delta_time);
+
+    // Octree - attribute colors.
+    SC_PROFILE_BEGIN("color_update");
+    sc_app_point_color_update(app);
+    SC_PROFILE_END();
+
+    // Octree - adaptive LOD, from the measurements of the previous frame.
+    if (app->lod_controller.enabled) {
+        app->parameters.lod_bias = sc_lod_controller_update(
+            &app->lod_controller,
+            app->parameters.lod_bias,
+            &(ScLodControllerUpdateInfo) {
+                .frame_ms = 1e3f * delta_time,
+                .busy_ms = busy_ms,
+                .visible_point_count = app->visible_point_count,
+            }
+        );
+    }
+
+    // Frame - prepare, or pick up the frame prepared by the pipeline worker.
+    ScAppFrameSlot* frame_slot = sc_app_pipeline_acquire(app, delta_time);
+    const ScOctreeTraversal* traversal = &frame_slot->traversal;
+    const ScAppViewMode view_mode = frame_slot->prepare_info.view_mode;
+    const ScAppViewLayout* layout = &SC_APP_VIEW_LAYOUT[view_mode];
 
-    // Camera - pre-traversal update.
+    // Camera - post-traversal update.
     {
-        // Common.
-        float screen_width = 0.0f;
-        float screen_height = 0.0f;
-        switch (app->parameters.view_mode) {
-            case VIEW_MODE_FULLSCREEN:
-                screen_width = (float)SC_WINDOW_WIDTH;
-                screen_height = (float)SC_WINDOW_HEIGHT;
-                break;
-            case VIEW_MODE_SPLIT:
-                screen_width = 0.5f * (float)SC_WINDOW_WIDTH;
-                screen_height = (float)SC_WINDOW_HEIGHT;
-                break;
-        }
+        // Unpack.
+        const float screen_width = frame_slot->prepare_info.common.screen_width;
+        const float screen_height = frame_slot->prepare_info.common.screen_height;
+
+        for (uint32_t i = 0; i < layout->view_count; i++) {
+            ScAppCamera* camera = &app->cameras[i];
+            camera->camera = frame_slot->cameras[i];
+
+            // Viewport.
+            camera->viewport = (SDL_GPUViewport) {
+                .x = (float)(i % layout->column_count) * screen_width,
+                .y = (float)(i / layout->column_count) * screen_height,
+                .w = screen_width,
+                .h = screen_height,
+                .min_depth = 0.0f,
+                .max_depth = 1.0f,
+            };
+
+            // Uniforms.
+            camera->uniforms = (ScOctreeUniforms) {
+                .clip_from_world = camera->camera.clip_from_world,
+                .node_world_scale = app->dataset.octree.node_world_scale,
+                .point_color_stream = app->point_color_mode != COLOR_MODE_RGB,
+            };
 
-        // Camera controls.
-        const ScCameraControlCommonUpdateInfo common_update_info = {
-            .screen_width = screen_width,
-            .screen_height = screen_height,
-            .field_of_view = rad_from_deg(60.0f),
-            .clip_distance_near = 16.0f,
-            .clip_distance_far = 2048.0f,
-            .delta_time = delta_time,
-            .input_captured = ImGui_GetIO()->WantCaptureMouse,
-        };
-        switch (app->parameters.main_camera_control_type) {
-            case MAIN_CAMERA_CONTROL_TYPE_ORBIT:
-                sc_camera_control_orbit_update(
-                    &app->orbit_control,
-                    &(ScCameraControlOrbitUpdateInfo) {
-                        .common = common_update_info,
-                    },
-                    &main_camera->camera
-                );
-                break;
-            case MAIN_CAMERA_CONTROL_TYPE_AUTOPLAY:
-                sc_camera_control_autoplay_update(
-                    &app->autoplay_control,
-                    &(ScCameraControlAutoplayUpdateInfo) {
-                        .common = common_update_info,
-                    },
-                    &main_camera->camera
-                );
-                break;
-            default: break;
+            // Debug.
+            if (i < layout->traverse_view_count) {
+                sc_ddraw_box(&camera->ddraw, app->dataset.octree.point_bounds, 0xffffffff);
+            }
         }
-        sc_camera_control_aerial_update(
-            &app->aerial_control,
-            &(ScCameraControlAerialUpdateInfo) {
-                .common = common_update_info,
-                .world_target = box3f_center(app->octree.point_bounds),
-            },
-            &aerial_camera->camera
-        );
-
-        // Viewports.
-        main_camera->viewport = (SDL_GPUViewport) {
-            .x = 0.0f,
-            .y = 0.0f,
-            .w = screen_width,
-            .h = screen_height,
-            .min_depth = 0.0f,
-            .max_depth = 1.0f,
-        };
-        aerial_camera->viewport = (SDL_GPUViewport) {
-            .x = app->parameters.view_mode == VIEW_MODE_SPLIT ? screen_width : 0.0f,
-            .y = 0.0f,
-            .w = screen_width,
-            .h = screen_height,
-            .min_depth = 0.0f,
-            .max_depth = 1.0f,
-        };
-
-        // Uniforms.
-        main_camera->uniforms = (ScOctreeUniforms) {
-            .clip_from_world = main_camera->camera.clip_from_world,
-            .node_world_scale = app->octree.node_world_scale,
-        };
-        aerial_camera->uniforms = (ScOctreeUniforms) {
-            .clip_from_world = aerial_camera->camera.clip_from_world,
-            .node_world_scale = app->octree.node_world_scale,
-        };
 
         // Debug.
-        ScDebugDraw* main_ddraw = &main_camera->ddraw;
-        const ScFrustum* main_frustum = &main_camera->camera.frustum;
-        const vec3f main_camera_position = main_camera->camera.world_position;
-        sc_ddraw_box(main_ddraw, app->octree.point_bounds, 0xffffffff);
-
-        if (app->parameters.view_mode == VIEW_MODE_SPLIT) {
-            // clang-format off
+        if (view_mode == VIEW_MODE_SPLIT) {
             ScDebugDraw* aerial_ddraw = &aerial_camera->ddraw;
-            sc_ddraw_line(aerial_ddraw, main_camera_position, vec3f_add(main_camera_position, vec3f_scale(main_camera->camera.world_right, 50.0f)), 0xff0000ff);
-            sc_ddraw_line(aerial_ddraw, main_camera_position, vec3f_add(main_camera_position, vec3f_scale(main_camera->camera.world_up, 50.0f)), 0xff00ff00);
-            sc_ddraw_line(aerial_ddraw, main_camera_position, vec3f_add(main_camera_position, vec3f_scale(main_camera->camera.world_forward, 50.0f)), 0xffff0000);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_LBN], main_frustum->corners[SC_FRUSTUM_CORNER_LBF], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_RBN], main_frustum->corners[SC_FRUSTUM_CORNER_RBF], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_LTN], main_frustum->corners[SC_FRUSTUM_CORNER_LTF], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_RTN], main_frustum->corners[SC_FRUSTUM_CORNER_RTF], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_LBN], main_frustum->corners[SC_FRUSTUM_CORNER_RBN], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_LTN], main_frustum->corners[SC_FRUSTUM_CORNER_RTN], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_LBN], main_frustum->corners[SC_FRUSTUM_CORNER_LTN], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_RBN], main_frustum->corners[SC_FRUSTUM_CORNER_RTN], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_LBF], main_frustum->corners[SC_FRUSTUM_CORNER_RBF], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_LTF], main_frustum->corners[SC_FRUSTUM_CORNER_RTF], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_LBF], main_frustum->corners[SC_FRUSTUM_CORNER_LTF], 0xff808080);
-            sc_ddraw_line(aerial_ddraw, main_frustum->corners[SC_FRUSTUM_CORNER_RBF], main_frustum->corners[SC_FRUSTUM_CORNER_RTF], 0xff808080);
-            // clang-format on
+            sc_ddraw_axis(
+                aerial_ddraw,
+                main_camera->camera.world_position,
+                main_camera->camera.world_right,
+                main_camera->camera.world_up,
+                main_camera->camera.world_forward,
+                50.0f
+            );
+            sc_ddraw_frustum(aerial_ddraw, main_camera->camera.world_from_clip, 0xff808080);
         }
     }
 
-    // Octree - traversal.
-    sc_octree_traverse(
-        &app->octree,
-        &(ScOctreeTraverseInfo) {
-            .camera = &main_camera->camera,
-            .lod_bias = app->parameters.lod_bias,
+    // Octree - visible points.
+    uint64_t visible_point_count = 0;
+    for (uint32_t i = 0; i < traversal->node_traverse_count; i++) {
+        const uint32_t node_idx = traversal->node_traverse[i];
+        const ScOctreeNode* node = &app->dataset.octree.nodes[node_idx];
+        visible_point_count += node->point_count;
+    }
+    app->visible_point_count = visible_point_count;
+
+    // Octree - node bounds.
+    if (view_mode == VIEW_MODE_SPLIT) {
+        ScDebugDraw* aerial_ddraw = &aerial_camera->ddraw;
+        for (uint32_t i = 0; i < traversal->node_traverse_count; i++) {
+            const uint32_t node_idx = traversal->node_traverse[i];
+            const box3f node_bounds = sc_octree_node_bounds(&app->dataset.octree, node_idx);
+            sc_ddraw_box(aerial_ddraw, node_bounds, 0xffffffff);
         }
-    );
+    }
+    if (app->parameters.show_all_nodes && app->all_node_bounds == NULL
+        && app->dataset.octree.node_count > 0) {
+        const uint32_t node_count = (uint32_t)app->dataset.octree.node_count;
+        ScDebugDrawInstance* instances =
+            SC_ARENA_ALLOC(frame_arena, ScDebugDrawInstance, node_count);
+        for (uint32_t i = 0; i < node_count; i++) {
+            const box3f node_bounds = sc_octree_node_bounds(&app->dataset.octree, i);
+            instances[i] = sc_ddraw_instance_box(node_bounds, 0xff404040);
+        }
+        app->all_node_bounds = sc_ddraw_persistent_new(
+            &aerial_camera->ddraw,
+            app->device,
+            SC_DDRAW_SHAPE_BOX,
+            instances,
+            node_count
+        );
+    }
+    if (app->all_node_bounds != NULL) {
+        app->all_node_bounds->visible =
+            app->parameters.show_all_nodes && view_mode == VIEW_MODE_SPLIT;
+    }
 
     // Gui - begin.
     sc_gui_frame_begin(&app->gui);
 
+    // Gui.
+    SC_PROFILE_BEGIN("gui");
+    {
+        const float visible_mpoint_count = (float)visible_point_count / 1e6f;
+
+        ImGui_SetNextWindowSize((ImVec2) {240.0f, 300.0f}, ImGuiCond_Once);
+        ImGui_Begin("stormcloud", NULL, 0);
+        ImGui_InputText(
+            "dataset",
+            app->dataset_file_path,
+            sizeof(app->dataset_file_path),
+            ImGuiInputTextFlags_None
+        );
+        if (app->dataset_loader != NULL) {
+            ImGui_Text("loading...");
+        } else if (ImGui_Button("open")) {
+            sc_app_dataset_open(app, app->dataset_file_path);
+        }
+        if (app->live_replay.positions != NULL) {
+            const ScAppLiveReplay* replay = &app->live_replay;
+            ImGui_Text(
+                "live: %.1f%%, %.2f Mpts/s",
+                100.0 * (double)replay->point_offset / (double)replay->point_count,
+                replay->insert_ns > 0 ? 1e3 * (double)replay->insert_point_count
+                                            / (double)replay->insert_ns
+                                      : 0.0
+            );
+        } else if (ImGui_Button("live_replay")) {
+            sc_app_live_replay_begin(app);
+        }
+        ImGui_SliderFloat("live_mpoints_per_s", &app->live_replay.mpoint_rate, 0.1f, 20.0f);
+        ImGui_Text("octree_points: %" PRIu64, app->dataset.octree.point_count);
+        ImGui_Text("octree_nodes: %" PRIu64, app->dataset.octree.node_count);
+        ImGui_Text("traversed_nodes: %u", traversal->node_traverse_count);
+        ImGui_Text(
+            "visible_points: %" PRIu64 " (%.2fM)",
+            visible_point_count,
+            visible_mpoint_count
+        );
+        ImGui_SliderFloat("lod_bias", &app->parameters.lod_bias, 0.0f, 1.0f);
+        sc_lod_controller_gui(&app->lod_controller);
+        ImGui_Checkbox("show_all_nodes", &app->parameters.show_all_nodes);
+        ImGui_Checkbox("pipelined", &app->pipeline.enabled);
+        ImGui_ComboChar(
+            "view_mode",
+            (int32_t*)&app->parameters.view_mode,
+            SC_APP_VIEW_MODE_NAME,
+            SC_COUNTOF(SC_APP_VIEW_MODE_NAME)
+        );
+        if (app->parameters.view_mode == VIEW_MODE_STEREO) {
+            ImGui_SliderFloat("stereo_separation", &app->parameters.stereo_separation, 0.0f, 64.0f);
+        }
+        ImGui_ComboChar(
+            "color_mode",
+            (int32_t*)&app->parameters.color_mode,
+            SC_APP_COLOR_MODE_NAME,
+            SC_COUNTOF(SC_APP_COLOR_MODE_NAME)
+        );
+        ImGui_ComboChar(
+            "camera_control",
+            (int32_t*)&app->parameters.main_camera_control_type,
+            SC_APP_MAIN_CAMERA_CONTROL_TYPE_NAME,
+            SC_COUNTOF(SC_APP_MAIN_CAMERA_CONTROL_TYPE_NAME)
+        );
+        if (ImGui_Button("cpu_snapshot")) {
+            ScRaster raster;
+            sc_raster_new(
+                &raster,
+                &(ScRasterCreateInfo) {
+                    .width = (uint32_t)main_camera->viewport.w,
+                    .height = (uint32_t)main_camera->viewport.h,
+                }
+            );
+            sc_raster_render(
+                &raster,
+                &(ScRasterRenderInfo) {
+                    .octree = &app->dataset.octree,
+                    .traversal = traversal,
+                    .clip_from_world = main_camera->camera.clip_from_world,
+                    .clear_color = (vec4f) {0.025f, 0.025f, 0.025f, 1.0f},
+                }
+            );
+            sc_raster_write_png(&raster, "temp/snapshot_cpu.png");
+            sc_raster_free(&raster);
+        }
+        ImGui_End();
+
+        sc_profile_gui();
+        sc_stats_gui(&app->stats);
+    }
+    SC_PROFILE_END();
+
+    // Frame - prepare the next frame on the worker, overlapping recording and submission.
+    if (app->pipeline.enabled) {
+        const ScAppPrepareInfo prepare_info = sc_app_prepare_info(app, delta_time);
+        sc_app_pipeline_kick(&app->pipeline, &prepare_info);
+    }
+
     // Command buffer.
     SDL_GPUCommandBuffer* cmd = SDL_AcquireGPUCommandBuffer(app->device);
     if (cmd == NULL) {
@@ -822,7 +1850,13 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
 
     // Swapchain.
     SDL_GPUTexture* swapchain = NULL;
-    if (!SDL_AcquireGPUSwapchainTexture(cmd, app->window, &swapchain, NULL, NULL)) {
+    SC_PROFILE_BEGIN("swapchain_acquire");
+    const uint64_t swapchain_begin_ns = SDL_GetTicksNS();
+    const bool swapchain_acquired =
+        SDL_AcquireGPUSwapchainTexture(cmd, app->window, &swapchain, NULL, NULL);
+    app->swapchain_wait_ns = SDL_GetTicksNS() - swapchain_begin_ns;
+    SC_PROFILE_END();
+    if (!swapchain_acquired) {
         SC_LOG_ERROR("SDL_AcquireGPUSwapchainTexture failed: %s", SDL_GetError());
         return -1;
     }
@@ -833,6 +1867,32 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
         return SDL_APP_CONTINUE;
     }
 
+    // Upload, every copy of the frame in one copy pass ahead of the render pass.
+    const uint64_t submit_begin_ns = SDL_GetTicksNS();
+    SC_PROFILE_BEGIN("upload");
+    for (uint32_t i = 0; i < SC_APP_VIEW_MAX_COUNT; i++) {
+        sc_ddraw_upload(
+            &app->cameras[i].ddraw,
+            &(ScDebugUploadInfo) {
+                .device = app->device,
+                .uploader = &app->frame_uploader,
+                .frame_index = app->frame_index,
+            }
+        );
+    }
+    sc_gui_frame_end(
+        &app->gui,
+        &(ScGuiUploadInfo) {
+            .device = app->device,
+            .uploader = &app->frame_uploader,
+        }
+    );
+    if (app->dataset.octree.live != NULL) {
+        sc_app_dataset_live_upload(&app->dataset, app->device, &app->frame_uploader);
+    }
+    sc_gpu_frame_uploader_flush(&app->frame_uploader, cmd);
+    SC_PROFILE_END();
+
     // Render pass - begin.
     SDL_GPURenderPass* render_pass = SDL_BeginGPURenderPass(
         cmd,
@@ -862,181 +1922,90 @@ SDL_AppResult SDL_AppIterate(void* appstate) {
         }
     );
 
-    // Draw view.
-    switch (app->parameters.view_mode) {
-        case VIEW_MODE_FULLSCREEN: {
-            // Points.
-            SDL_BindGPUGraphicsPipeline(render_pass, app->point_pipeline);
-            SDL_BindGPUVertexBuffers(
-                render_pass,
-                0,
-                (SDL_GPUBufferBinding[]) {
-                    {
-                        .buffer = app->point_buffer,
-                        .offset = 0,
-                    },
-                    {
-                        .buffer = app->node_buffer,
-                        .offset = 0,
-                    },
-                },
-                2
-            );
-            SDL_SetGPUViewport(render_pass, &main_camera->viewport);
-            SDL_PushGPUVertexUniformData(cmd, 0, &main_camera->uniforms, sizeof(ScOctreeUniforms));
-            for (uint32_t i = 0; i < app->octree.node_traverse_count; i++) {
-                const uint32_t node_idx = app->octree.node_traverse[i];
-                const ScOctreeNode* node = &app->octree.nodes[node_idx];
-                const uint32_t vertex_count = (uint32_t)node->point_count;
-                const uint32_t vertex_offset = (uint32_t)node->point_offset;
-                SDL_DrawGPUPrimitives(render_pass, vertex_count, 1, vertex_offset, node_idx);
-            }
+    // Draw views.
+    SC_PROFILE_BEGIN("draw");
+    {
+        // Points, the cut is resolved to draws once and replayed with the uniforms of each view.
+        SC_PROFILE_BEGIN("draw_points");
+        uint32_t point_draw_count = 0;
+        const ScAppPointDraw* point_draws =
+            sc_app_point_draws_new(app, traversal, frame_arena, &point_draw_count);
+        for (uint32_t i = 0; i < layout->view_count; i++) {
+            ScAppCamera* camera = &app->cameras[i];
+            SDL_SetGPUViewport(render_pass, &camera->viewport);
+            SDL_PushGPUVertexUniformData(cmd, 0, &camera->uniforms, sizeof(ScOctreeUniforms));
+            sc_app_point_draw(app, point_draws, point_draw_count, render_pass);
+        }
+        SC_PROFILE_END();
 
-            // Debug.
+        // Debug.
+        SC_PROFILE_BEGIN("draw_debug");
+        for (uint32_t i = 0; i < layout->view_count; i++) {
+            ScAppCamera* camera = &app->cameras[i];
             sc_ddraw_render(
-                &main_camera->ddraw,
+                &camera->ddraw,
                 &(ScDebugRenderInfo) {
-                    .device = app->device,
                     .command_buffer = cmd,
                     .render_pass = render_pass,
-                    .viewport = main_camera->viewport,
-                    .clip_from_world = main_camera->camera.clip_from_world,
+                    .viewport = camera->viewport,
+                    .clip_from_world = camera->camera.clip_from_world,
                     .frame_index = app->frame_index,
                 }
             );
-            break;
-        }
-
-        case VIEW_MODE_SPLIT: {
-            // Points.
-            SDL_BindGPUGraphicsPipeline(render_pass, app->point_pipeline);
-            SDL_BindGPUVertexBuffers(
-                render_pass,
-                0,
-                (SDL_GPUBufferBinding[]) {
-                    {
-                        .buffer = app->point_buffer,
-                        .offset = 0,
-                    },
-                    {
-                        .buffer = app->node_buffer,
-                        .offset = 0,
-                    },
-                },
-                2
-            );
-            for (uint32_t i = 0; i < CAMERA_TYPE_COUNT; i++) {
-                ScAppCamera* camera = &app->cameras[i];
-                SDL_SetGPUViewport(render_pass, &camera->viewport);
-                SDL_PushGPUVertexUniformData(cmd, 0, &camera->uniforms, sizeof(ScOctreeUniforms));
-                for (uint32_t j = 0; j < app->octree.node_traverse_count; j++) {
-                    const uint32_t node_idx = app->octree.node_traverse[j];
-                    const ScOctreeNode* node = &app->octree.nodes[node_idx];
-                    const uint32_t vertex_count = (uint32_t)node->point_count;
-                    const uint32_t vertex_offset = (uint32_t)node->point_offset;
-                    SDL_DrawGPUPrimitives(render_pass, vertex_count, 1, vertex_offset, node_idx);
-                }
-            }
-
-            // Nodes.
-            SDL_BindGPUGraphicsPipeline(render_pass, app->bounds_pipeline);
-            SDL_BindGPUVertexBuffers(
-                render_pass,
-                0,
-                (SDL_GPUBufferBinding[]) {
-                    {
-                        .buffer = app->bounds_buffer,
-                        .offset = 0,
-                    },
-                    {
-                        .buffer = app->node_buffer,
-                        .offset = 0,
-                    },
-                },
-                2
-            );
-            SDL_SetGPUViewport(render_pass, &aerial_camera->viewport);
-            SDL_PushGPUVertexUniformData(
-                cmd,
-                0,
-                &aerial_camera->uniforms,
-                sizeof(ScOctreeUniforms)
-            );
-            for (uint32_t i = 0; i < app->octree.node_traverse_count; i++) {
-                const uint32_t node_idx = app->octree.node_traverse[i];
-                SDL_DrawGPUPrimitives(render_pass, app->bounds_vertex_count, 1, 0, node_idx);
-            }
-
-            // Debug.
-            for (uint32_t i = 0; i < CAMERA_TYPE_COUNT; i++) {
-                ScAppCamera* camera = &app->cameras[i];
-                sc_ddraw_render(
-                    &camera->ddraw,
-                    &(ScDebugRenderInfo) {
-                        .device = app->device,
-                        .command_buffer = cmd,
-                        .render_pass = render_pass,
-                        .viewport = camera->viewport,
-                        .clip_from_world = camera->camera.clip_from_world,
-                        .frame_index = app->frame_index,
-                    }
-                );
-            }
-
-            break;
-        }
-
-        default: break;
-    }
-
-    // Gui.
-    {
-        uint64_t visible_point_count = 0;
-        for (uint32_t i = 0; i < app->octree.node_traverse_count; i++) {
-            const uint32_t node_idx = app->octree.node_traverse[i];
-            const ScOctreeNode* node = &app->octree.nodes[node_idx];
-            visible_point_count += node->point_count;
         }
-        const float visible_mpoint_count = (float)visible_point_count / 1e6f;
-
-        ImGui_SetNextWindowSize((ImVec2) {240.0f, 300.0f}, ImGuiCond_Once);
-        ImGui_Begin("stormcloud", NULL, 0);
-        ImGui_Text("octree_points: %u", app->octree.point_count);
-        ImGui_Text("octree_nodes: %u", app->octree.node_count);
-        ImGui_Text("traversed_nodes: %u", app->octree.node_traverse_count);
-        ImGui_Text("visible_points: %u (%.2fM)", visible_point_count, visible_mpoint_count);
-        ImGui_SliderFloat("lod_bias", &app->parameters.lod_bias, 0.0f, 1.0f);
-        ImGui_ComboChar(
-            "view_mode",
-            (int32_t*)&app->parameters.view_mode,
-            SC_APP_VIEW_MODE_NAME,
-            SC_COUNTOF(SC_APP_VIEW_MODE_NAME)
-        );
-        ImGui_ComboChar(
-            "camera_control",
-            (int32_t*)&app->parameters.main_camera_control_type,
-            SC_APP_MAIN_CAMERA_CONTROL_TYPE_NAME,
-            SC_COUNTOF(SC_APP_MAIN_CAMERA_CONTROL_TYPE_NAME)
-        );
-        ImGui_End();
+        SC_PROFILE_END();
     }
+    SC_PROFILE_END();
 
-    // Gui - end.
-    sc_gui_frame_end(
+    // Gui - render.
+    SC_PROFILE_BEGIN("draw_gui");
+    sc_gui_render(
         &app->gui,
         &(ScGuiRenderInfo) {
-            .device = app->device,
             .command_buffer = cmd,
             .render_pass = render_pass,
-            .frame_index = app->frame_index,
         }
     );
+    SC_PROFILE_END();
 
     // Render pass - end.
     SDL_EndGPURenderPass(render_pass);
 
     // Submit.
+    SC_PROFILE_BEGIN("submit");
     SDL_SubmitGPUCommandBuffer(cmd);
+    SC_PROFILE_END();
+    const uint64_t submit_end_ns = SDL_GetTicksNS();
+
+    // Stats.
+    const ScOctreeTraverseStats* traverse_stats = &traversal->traverse_stats;
+    const ScLodController* lod_controller = &app->lod_controller;
+    sc_stats_push(
+        &app->stats,
+        &(ScStatsRecord) {
+            .timers =
+                {
+                    [SC_STATS_TIMER_FRAME] = 1e3f * delta_time,
+                    [SC_STATS_TIMER_BUSY] = SDL_max(busy_ms, 0.0f),
+                    [SC_STATS_TIMER_TRAVERSE] = (float)frame_slot->traverse_ns / 1e6f,
+                    [SC_STATS_TIMER_SUBMIT] = (float)(submit_end_ns - submit_begin_ns) / 1e6f,
+                },
+            .counters =
+                {
+                    [SC_STATS_COUNTER_VISIBLE_POINTS] = visible_point_count,
+                    [SC_STATS_COUNTER_TRAVERSED_NODES] = traversal->node_traverse_count,
+                    [SC_STATS_COUNTER_VISITED_NODES] = traverse_stats->visited_node_count,
+                    [SC_STATS_COUNTER_FRUSTUM_CULLED_NODES] =
+                        traverse_stats->frustum_culled_node_count,
+                    [SC_STATS_COUNTER_LOD_CULLED_NODES] = traverse_stats->lod_culled_node_count,
+                    [SC_STATS_COUNTER_UPLOAD_BYTES] = app->frame_uploader.upload_byte_count,
+                    [SC_STATS_COUNTER_POINT_BUDGET] =
+                        lod_controller->enabled && lod_controller->point_budget != UINT64_MAX
+                            ? lod_controller->point_budget
+                            : 0,
+                },
+        }
+    );
 
     // Frame index.
     app->frame_index = (app->frame_index + 1) % SC_INFLIGHT_FRAME_COUNT;
@@ -1048,23 +2017,39 @@ void SDL_AppQuit(void* appstate, SDL_AppResult result) {
     // Unpack.
     ScApp* app = (ScApp*)appstate;
 
+    // Stop.
+    sc_app_pipeline_free(&app->pipeline);
+
     // Destroy.
     SDL_ReleaseGPUGraphicsPipeline(app->device, app->point_pipeline);
-    SDL_ReleaseGPUGraphicsPipeline(app->device, app->bounds_pipeline);
-    SDL_ReleaseGPUBuffer(app->device, app->point_buffer);
-    SDL_ReleaseGPUBuffer(app->device, app->bounds_buffer);
+    SDL_ReleaseGPUGraphicsPipeline(app->device, app->point_color_pipeline);
+    SDL_ReleaseGPUGraphicsPipeline(app->device, app->point_compact_pipeline);
+    if (app->dataset_loader != NULL) {
+        sc_app_dataset_loader_free(app->dataset_loader, app->device);
+    }
+    if (app->retired_dataset_frame_count > 0) {
+        sc_app_dataset_free(&app->retired_dataset, app->device);
+    }
+    sc_app_dataset_free(&app->dataset, app->device);
+    sc_app_live_replay_end(&app->live_replay);
     SDL_ReleaseGPUTexture(app->device, app->depth_stencil_texture);
-    for (uint32_t i = 0; i < CAMERA_TYPE_COUNT; i++) {
+    for (uint32_t i = 0; i < SC_APP_VIEW_MAX_COUNT; i++) {
         sc_app_camera_free(&app->cameras[i], app->device);
     }
     sc_gui_free(&app->gui, app->device);
+    sc_gpu_frame_uploader_free(&app->frame_uploader);
     SDL_ReleaseWindowFromGPUDevice(app->device, app->window);
     SDL_DestroyWindow(app->window);
     SDL_DestroyGPUDevice(app->device);
 
     // Free.
-    sc_octree_free(&app->octree);
+    for (uint32_t i = 0; i < SC_INFLIGHT_FRAME_COUNT; i++) {
+        sc_arena_free(&app->frame_arenas[i]);
+    }
+    sc_stats_free(&app->stats);
     free(app);
+    sc_job_system_free();
+    sc_profile_free();
 
     // End.
     SC_ASSERT(result == SDL_APP_SUCCESS);
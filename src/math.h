@@ -173,6 +173,22 @@ static SC_INLINE vec3f vec3f_cross(vec3f lhs, vec3f rhs) {
     };
 }
 
+static SC_INLINE vec3f vec3f_min(vec3f lhs, vec3f rhs) {
+    return (vec3f) {
+        SDL_min(lhs.x, rhs.x),
+        SDL_min(lhs.y, rhs.y),
+        SDL_min(lhs.z, rhs.z),
+    };
+}
+
+static SC_INLINE vec3f vec3f_max(vec3f lhs, vec3f rhs) {
+    return (vec3f) {
+        SDL_max(lhs.x, rhs.x),
+        SDL_max(lhs.y, rhs.y),
+        SDL_max(lhs.z, rhs.z),
+    };
+}
+
 static SC_INLINE float vec3f_component_min(vec3f vec) {
     return SDL_min(SDL_min(vec.x, vec.y), vec.z);
 }
@@ -500,6 +516,12 @@ static SC_INLINE bool box3f_contains(box3f box, vec3f point) {
         && point.y <= box.mx.y && point.z <= box.mx.z;
 }
 
+// Touching boxes intersect.
+static SC_INLINE bool box3f_intersects(box3f lhs, box3f rhs) {
+    return lhs.mn.x <= rhs.mx.x && lhs.mn.y <= rhs.mx.y && lhs.mn.z <= rhs.mx.z
+        && rhs.mn.x <= lhs.mx.x && rhs.mn.y <= lhs.mx.y && rhs.mn.z <= lhs.mx.z;
+}
+
 static SC_INLINE sphere3f sphere3f_from_box3f(box3f box) {
     const vec3f origin = box3f_center(box);
     const vec3f extents = box3f_extents(box);
@@ -541,6 +563,606 @@ static SC_INLINE vec4f vec4f_from_plane3f(plane3f plane) {
     };
 }
 
+//
+// Batch
+//
+
+// Notes:
+// - Batch kernels operate on SoA arrays, unaligned, with any count.
+// - Every kernel has a scalar reference, and SSE2/AVX2 paths which evaluate the same
+//   operations in the same order, so all paths produce bitwise identical results.
+// - The unsuffixed function dispatches to the widest path enabled at compile time.
+
+typedef enum plane3f_side {
+    PLANE3F_SIDE_BACK,
+    PLANE3F_SIDE_STRADDLE,
+    PLANE3F_SIDE_FRONT,
+} plane3f_side;
+
+// Transform points (x, y, z, 1) by m into homogeneous (x, y, z, w).
+
+static void mat4f_transform_batch_scalar(
+    mat4f m,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out_x,
+    float* out_y,
+    float* out_z,
+    float* out_w,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        const vec4f p = mat4f_mul_vec4f(m, vec4f_new(x[i], y[i], z[i], 1.0f));
+        out_x[i] = p.x;
+        out_y[i] = p.y;
+        out_z[i] = p.z;
+        out_w[i] = p.w;
+    }
+}
+
+#if defined(SC_SIMD_SSE2)
+static void mat4f_transform_batch_sse2(
+    mat4f m,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out_x,
+    float* out_y,
+    float* out_z,
+    float* out_w,
+    uint32_t count
+) {
+    // clang-format off
+    const __m128 m00 = _mm_set1_ps(m.m00), m01 = _mm_set1_ps(m.m01), m02 = _mm_set1_ps(m.m02), m03 = _mm_set1_ps(m.m03);
+    const __m128 m10 = _mm_set1_ps(m.m10), m11 = _mm_set1_ps(m.m11), m12 = _mm_set1_ps(m.m12), m13 = _mm_set1_ps(m.m13);
+    const __m128 m20 = _mm_set1_ps(m.m20), m21 = _mm_set1_ps(m.m21), m22 = _mm_set1_ps(m.m22), m23 = _mm_set1_ps(m.m23);
+    const __m128 m30 = _mm_set1_ps(m.m30), m31 = _mm_set1_ps(m.m31), m32 = _mm_set1_ps(m.m32), m33 = _mm_set1_ps(m.m33);
+    // clang-format on
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 px = _mm_loadu_ps(x + i);
+        const __m128 py = _mm_loadu_ps(y + i);
+        const __m128 pz = _mm_loadu_ps(z + i);
+        // clang-format off
+        _mm_storeu_ps(out_x + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, px), _mm_mul_ps(m10, py)), _mm_mul_ps(m20, pz)), m30));
+        _mm_storeu_ps(out_y + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, px), _mm_mul_ps(m11, py)), _mm_mul_ps(m21, pz)), m31));
+        _mm_storeu_ps(out_z + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, px), _mm_mul_ps(m12, py)), _mm_mul_ps(m22, pz)), m32));
+        _mm_storeu_ps(out_w + i, _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m03, px), _mm_mul_ps(m13, py)), _mm_mul_ps(m23, pz)), m33));
+        // clang-format on
+    }
+    mat4f_transform_batch_scalar(
+        m,
+        x + i,
+        y + i,
+        z + i,
+        out_x + i,
+        out_y + i,
+        out_z + i,
+        out_w + i,
+        count - i
+    );
+}
+#endif
+
+#if defined(SC_SIMD_AVX2)
+static void mat4f_transform_batch_avx2(
+    mat4f m,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out_x,
+    float* out_y,
+    float* out_z,
+    float* out_w,
+    uint32_t count
+) {
+    // clang-format off
+    const __m256 m00 = _mm256_set1_ps(m.m00), m01 = _mm256_set1_ps(m.m01), m02 = _mm256_set1_ps(m.m02), m03 = _mm256_set1_ps(m.m03);
+    const __m256 m10 = _mm256_set1_ps(m.m10), m11 = _mm256_set1_ps(m.m11), m12 = _mm256_set1_ps(m.m12), m13 = _mm256_set1_ps(m.m13);
+    const __m256 m20 = _mm256_set1_ps(m.m20), m21 = _mm256_set1_ps(m.m21), m22 = _mm256_set1_ps(m.m22), m23 = _mm256_set1_ps(m.m23);
+    const __m256 m30 = _mm256_set1_ps(m.m30), m31 = _mm256_set1_ps(m.m31), m32 = _mm256_set1_ps(m.m32), m33 = _mm256_set1_ps(m.m33);
+    // clang-format on
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        const __m256 pz = _mm256_loadu_ps(z + i);
+        // clang-format off
+        _mm256_storeu_ps(out_x + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, px), _mm256_mul_ps(m10, py)), _mm256_mul_ps(m20, pz)), m30));
+        _mm256_storeu_ps(out_y + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, px), _mm256_mul_ps(m11, py)), _mm256_mul_ps(m21, pz)), m31));
+        _mm256_storeu_ps(out_z + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m02, px), _mm256_mul_ps(m12, py)), _mm256_mul_ps(m22, pz)), m32));
+        _mm256_storeu_ps(out_w + i, _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m03, px), _mm256_mul_ps(m13, py)), _mm256_mul_ps(m23, pz)), m33));
+        // clang-format on
+    }
+    mat4f_transform_batch_scalar(
+        m,
+        x + i,
+        y + i,
+        z + i,
+        out_x + i,
+        out_y + i,
+        out_z + i,
+        out_w + i,
+        count - i
+    );
+}
+#endif
+
+static void mat4f_transform_batch(
+    mat4f m,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out_x,
+    float* out_y,
+    float* out_z,
+    float* out_w,
+    uint32_t count
+) {
+#if defined(SC_SIMD_AVX2)
+    mat4f_transform_batch_avx2(m, x, y, z, out_x, out_y, out_z, out_w, count);
+#elif defined(SC_SIMD_SSE2)
+    mat4f_transform_batch_sse2(m, x, y, z, out_x, out_y, out_z, out_w, count);
+#else
+    mat4f_transform_batch_scalar(m, x, y, z, out_x, out_y, out_z, out_w, count);
+#endif
+}
+
+// Classify boxes against a plane, front is the non-negative half-space. Only the corners
+// furthest along and against the plane normal are evaluated, which gives the same result as
+// testing all eight corners.
+
+typedef struct box3f_batch {
+    const float* mn_x;
+    const float* mn_y;
+    const float* mn_z;
+    const float* mx_x;
+    const float* mx_y;
+    const float* mx_z;
+} box3f_batch;
+
+typedef struct box3f_batch_vertices {
+    const float* p_x;
+    const float* p_y;
+    const float* p_z;
+    const float* n_x;
+    const float* n_y;
+    const float* n_z;
+} box3f_batch_vertices;
+
+static SC_INLINE box3f_batch_vertices box3f_batch_plane_vertices(box3f_batch boxes, plane3f plane) {
+    const bool sx = plane.n.x >= 0.0f;
+    const bool sy = plane.n.y >= 0.0f;
+    const bool sz = plane.n.z >= 0.0f;
+    return (box3f_batch_vertices) {
+        .p_x = sx ? boxes.mx_x : boxes.mn_x,
+        .p_y = sy ? boxes.mx_y : boxes.mn_y,
+        .p_z = sz ? boxes.mx_z : boxes.mn_z,
+        .n_x = sx ? boxes.mn_x : boxes.mx_x,
+        .n_y = sy ? boxes.mn_y : boxes.mx_y,
+        .n_z = sz ? boxes.mn_z : boxes.mx_z,
+    };
+}
+
+static void box3f_classify_plane_batch_scalar(
+    box3f_batch boxes,
+    plane3f plane,
+    uint8_t* out_side,
+    uint32_t count
+) {
+    const box3f_batch_vertices v = box3f_batch_plane_vertices(boxes, plane);
+    const vec4f p = vec4f_from_plane3f(plane);
+    for (uint32_t i = 0; i < count; i++) {
+        const float dp = vec4f_dot(p, vec4f_new(v.p_x[i], v.p_y[i], v.p_z[i], 1.0f));
+        const float dn = vec4f_dot(p, vec4f_new(v.n_x[i], v.n_y[i], v.n_z[i], 1.0f));
+        out_side[i] = (uint8_t)((dp >= 0.0f ? 1 : 0) + (dn >= 0.0f ? 1 : 0));
+    }
+}
+
+#if defined(SC_SIMD_SSE2)
+static void box3f_classify_plane_batch_sse2(
+    box3f_batch boxes,
+    plane3f plane,
+    uint8_t* out_side,
+    uint32_t count
+) {
+    const box3f_batch_vertices v = box3f_batch_plane_vertices(boxes, plane);
+    const __m128 nx = _mm_set1_ps(plane.n.x);
+    const __m128 ny = _mm_set1_ps(plane.n.y);
+    const __m128 nz = _mm_set1_ps(plane.n.z);
+    const __m128 d = _mm_set1_ps(plane.d);
+    const __m128 zero = _mm_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // clang-format off
+        const __m128 dp = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_loadu_ps(v.p_x + i)), _mm_mul_ps(ny, _mm_loadu_ps(v.p_y + i))), _mm_mul_ps(nz, _mm_loadu_ps(v.p_z + i))), d);
+        const __m128 dn = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_loadu_ps(v.n_x + i)), _mm_mul_ps(ny, _mm_loadu_ps(v.n_y + i))), _mm_mul_ps(nz, _mm_loadu_ps(v.n_z + i))), d);
+        // clang-format on
+        // Comparisons are all ones when true, so the negated sum counts the front vertices.
+        const __m128i p_front = _mm_castps_si128(_mm_cmpge_ps(dp, zero));
+        const __m128i n_front = _mm_castps_si128(_mm_cmpge_ps(dn, zero));
+        const __m128i side = _mm_sub_epi32(_mm_setzero_si128(), _mm_add_epi32(p_front, n_front));
+        const __m128i side_u16 = _mm_packs_epi32(side, side);
+        const int32_t side_u8 = _mm_cvtsi128_si32(_mm_packus_epi16(side_u16, side_u16));
+        memcpy(out_side + i, &side_u8, sizeof(side_u8));
+    }
+    box3f_classify_plane_batch_scalar(
+        (box3f_batch) {
+            .mn_x = boxes.mn_x + i,
+            .mn_y = boxes.mn_y + i,
+            .mn_z = boxes.mn_z + i,
+            .mx_x = boxes.mx_x + i,
+            .mx_y = boxes.mx_y + i,
+            .mx_z = boxes.mx_z + i,
+        },
+        plane,
+        out_side + i,
+        count - i
+    );
+}
+#endif
+
+#if defined(SC_SIMD_AVX2)
+static void box3f_classify_plane_batch_avx2(
+    box3f_batch boxes,
+    plane3f plane,
+    uint8_t* out_side,
+    uint32_t count
+) {
+    const box3f_batch_vertices v = box3f_batch_plane_vertices(boxes, plane);
+    const __m256 nx = _mm256_set1_ps(plane.n.x);
+    const __m256 ny = _mm256_set1_ps(plane.n.y);
+    const __m256 nz = _mm256_set1_ps(plane.n.z);
+    const __m256 d = _mm256_set1_ps(plane.d);
+    const __m256 zero = _mm256_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // clang-format off
+        const __m256 dp = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, _mm256_loadu_ps(v.p_x + i)), _mm256_mul_ps(ny, _mm256_loadu_ps(v.p_y + i))), _mm256_mul_ps(nz, _mm256_loadu_ps(v.p_z + i))), d);
+        const __m256 dn = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, _mm256_loadu_ps(v.n_x + i)), _mm256_mul_ps(ny, _mm256_loadu_ps(v.n_y + i))), _mm256_mul_ps(nz, _mm256_loadu_ps(v.n_z + i))), d);
+        // clang-format on
+        // Comparisons are all ones when true, so the negated sum counts the front vertices.
+        const __m256i p_front = _mm256_castps_si256(_mm256_cmp_ps(dp, zero, _CMP_GE_OQ));
+        const __m256i n_front = _mm256_castps_si256(_mm256_cmp_ps(dn, zero, _CMP_GE_OQ));
+        const __m256i side =
+            _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_add_epi32(p_front, n_front));
+        const __m128i side_u16 =
+            _mm_packs_epi32(_mm256_castsi256_si128(side), _mm256_extracti128_si256(side, 1));
+        _mm_storel_epi64((__m128i*)(out_side + i), _mm_packus_epi16(side_u16, side_u16));
+    }
+    box3f_classify_plane_batch_scalar(
+        (box3f_batch) {
+            .mn_x = boxes.mn_x + i,
+            .mn_y = boxes.mn_y + i,
+            .mn_z = boxes.mn_z + i,
+            .mx_x = boxes.mx_x + i,
+            .mx_y = boxes.mx_y + i,
+            .mx_z = boxes.mx_z + i,
+        },
+        plane,
+        out_side + i,
+        count - i
+    );
+}
+#endif
+
+static void
+box3f_classify_plane_batch(box3f_batch boxes, plane3f plane, uint8_t* out_side, uint32_t count) {
+#if defined(SC_SIMD_AVX2)
+    box3f_classify_plane_batch_avx2(boxes, plane, out_side, count);
+#elif defined(SC_SIMD_SSE2)
+    box3f_classify_plane_batch_sse2(boxes, plane, out_side, count);
+#else
+    box3f_classify_plane_batch_scalar(boxes, plane, out_side, count);
+#endif
+}
+
+// Screen projected sphere areas, same formula as sc_screen_projected_sphere_area.
+
+typedef struct sphere3f_project_info {
+    mat4f view_from_world;
+    float focal_length;
+    float screen_area;
+} sphere3f_project_info;
+
+static void sphere3f_project_area_batch_scalar(
+    const sphere3f_project_info* info,
+    const float* o_x,
+    const float* o_y,
+    const float* o_z,
+    const float* r,
+    float* out_area,
+    uint32_t count
+) {
+    const mat4f v = info->view_from_world;
+    const float fl = info->focal_length;
+    const float screen_area = info->screen_area;
+    for (uint32_t i = 0; i < count; i++) {
+        const vec4f p = vec4f_new(o_x[i], o_y[i], o_z[i], 1.0f);
+        const vec3f o = vec3f_from_vec4f(mat4f_mul_vec4f(v, p));
+        const float r2 = r[i] * r[i];
+        const float z2 = o.z * o.z;
+        const float l2 = vec3f_dot(o, o);
+        const float area = -SC_PI * fl * fl * r2 * sqrtf(fabsf((l2 - r2) / (r2 - z2))) / (r2 - z2);
+        out_area[i] = area * screen_area * 0.25f;
+    }
+}
+
+#if defined(SC_SIMD_SSE2)
+static void sphere3f_project_area_batch_sse2(
+    const sphere3f_project_info* info,
+    const float* o_x,
+    const float* o_y,
+    const float* o_z,
+    const float* r,
+    float* out_area,
+    uint32_t count
+) {
+    // Unpack.
+    const mat4f v = info->view_from_world;
+    // clang-format off
+    const __m128 m00 = _mm_set1_ps(v.m00), m10 = _mm_set1_ps(v.m10), m20 = _mm_set1_ps(v.m20);
+    const __m128 m01 = _mm_set1_ps(v.m01), m11 = _mm_set1_ps(v.m11), m21 = _mm_set1_ps(v.m21);
+    const __m128 m02 = _mm_set1_ps(v.m02), m12 = _mm_set1_ps(v.m12), m22 = _mm_set1_ps(v.m22);
+    const __m128 m30 = _mm_set1_ps(v.m30), m31 = _mm_set1_ps(v.m31), m32 = _mm_set1_ps(v.m32);
+    // clang-format on
+    const __m128 k = _mm_set1_ps(-SC_PI * info->focal_length * info->focal_length);
+    const __m128 screen_area = _mm_set1_ps(info->screen_area);
+    const __m128 quarter = _mm_set1_ps(0.25f);
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 px = _mm_loadu_ps(o_x + i);
+        const __m128 py = _mm_loadu_ps(o_y + i);
+        const __m128 pz = _mm_loadu_ps(o_z + i);
+        const __m128 pr = _mm_loadu_ps(r + i);
+        // clang-format off
+        const __m128 ox = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, px), _mm_mul_ps(m10, py)), _mm_mul_ps(m20, pz)), m30);
+        const __m128 oy = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, px), _mm_mul_ps(m11, py)), _mm_mul_ps(m21, pz)), m31);
+        const __m128 oz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, px), _mm_mul_ps(m12, py)), _mm_mul_ps(m22, pz)), m32);
+        const __m128 r2 = _mm_mul_ps(pr, pr);
+        const __m128 z2 = _mm_mul_ps(oz, oz);
+        const __m128 l2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oy, oy)), z2);
+        const __m128 rz = _mm_sub_ps(r2, z2);
+        const __m128 q = _mm_sqrt_ps(_mm_and_ps(_mm_div_ps(_mm_sub_ps(l2, r2), rz), abs_mask));
+        // clang-format on
+        const __m128 area = _mm_div_ps(_mm_mul_ps(_mm_mul_ps(k, r2), q), rz);
+        _mm_storeu_ps(out_area + i, _mm_mul_ps(_mm_mul_ps(area, screen_area), quarter));
+    }
+    sphere3f_project_area_batch_scalar(
+        info,
+        o_x + i,
+        o_y + i,
+        o_z + i,
+        r + i,
+        out_area + i,
+        count - i
+    );
+}
+#endif
+
+#if defined(SC_SIMD_AVX2)
+static void sphere3f_project_area_batch_avx2(
+    const sphere3f_project_info* info,
+    const float* o_x,
+    const float* o_y,
+    const float* o_z,
+    const float* r,
+    float* out_area,
+    uint32_t count
+) {
+    // Unpack.
+    const mat4f v = info->view_from_world;
+    // clang-format off
+    const __m256 m00 = _mm256_set1_ps(v.m00), m10 = _mm256_set1_ps(v.m10), m20 = _mm256_set1_ps(v.m20);
+    const __m256 m01 = _mm256_set1_ps(v.m01), m11 = _mm256_set1_ps(v.m11), m21 = _mm256_set1_ps(v.m21);
+    const __m256 m02 = _mm256_set1_ps(v.m02), m12 = _mm256_set1_ps(v.m12), m22 = _mm256_set1_ps(v.m22);
+    const __m256 m30 = _mm256_set1_ps(v.m30), m31 = _mm256_set1_ps(v.m31), m32 = _mm256_set1_ps(v.m32);
+    // clang-format on
+    const __m256 k = _mm256_set1_ps(-SC_PI * info->focal_length * info->focal_length);
+    const __m256 screen_area = _mm256_set1_ps(info->screen_area);
+    const __m256 quarter = _mm256_set1_ps(0.25f);
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 px = _mm256_loadu_ps(o_x + i);
+        const __m256 py = _mm256_loadu_ps(o_y + i);
+        const __m256 pz = _mm256_loadu_ps(o_z + i);
+        const __m256 pr = _mm256_loadu_ps(r + i);
+        // clang-format off
+        const __m256 ox = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, px), _mm256_mul_ps(m10, py)), _mm256_mul_ps(m20, pz)), m30);
+        const __m256 oy = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, px), _mm256_mul_ps(m11, py)), _mm256_mul_ps(m21, pz)), m31);
+        const __m256 oz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m02, px), _mm256_mul_ps(m12, py)), _mm256_mul_ps(m22, pz)), m32);
+        const __m256 r2 = _mm256_mul_ps(pr, pr);
+        const __m256 z2 = _mm256_mul_ps(oz, oz);
+        const __m256 l2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ox, ox), _mm256_mul_ps(oy, oy)), z2);
+        const __m256 rz = _mm256_sub_ps(r2, z2);
+        const __m256 q = _mm256_sqrt_ps(_mm256_and_ps(_mm256_div_ps(_mm256_sub_ps(l2, r2), rz), abs_mask));
+        // clang-format on
+        const __m256 area = _mm256_div_ps(_mm256_mul_ps(_mm256_mul_ps(k, r2), q), rz);
+        _mm256_storeu_ps(out_area + i, _mm256_mul_ps(_mm256_mul_ps(area, screen_area), quarter));
+    }
+    sphere3f_project_area_batch_scalar(
+        info,
+        o_x + i,
+        o_y + i,
+        o_z + i,
+        r + i,
+        out_area + i,
+        count - i
+    );
+}
+#endif
+
+static void sphere3f_project_area_batch(
+    const sphere3f_project_info* info,
+    const float* o_x,
+    const float* o_y,
+    const float* o_z,
+    const float* r,
+    float* out_area,
+    uint32_t count
+) {
+#if defined(SC_SIMD_AVX2)
+    sphere3f_project_area_batch_avx2(info, o_x, o_y, o_z, r, out_area, count);
+#elif defined(SC_SIMD_SSE2)
+    sphere3f_project_area_batch_sse2(info, o_x, o_y, o_z, r, out_area, count);
+#else
+    sphere3f_project_area_batch_scalar(info, o_x, o_y, o_z, r, out_area, count);
+#endif
+}
+
+// Decode 10/10/10 quantized positions within a box, same formula as point.hlsl.
+
+static void vec3f_decode_unorm10_batch_scalar(
+    const uint32_t* packed,
+    uint32_t stride,
+    vec3f mn,
+    vec3f extent,
+    float* out_x,
+    float* out_y,
+    float* out_z,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t position = packed[(size_t)i * stride];
+        out_x[i] = mn.x + ((float)(position & 0x3ff) / 1023.0f) * extent.x;
+        out_y[i] = mn.y + ((float)((position >> 10) & 0x3ff) / 1023.0f) * extent.y;
+        out_z[i] = mn.z + ((float)((position >> 20) & 0x3ff) / 1023.0f) * extent.z;
+    }
+}
+
+#if defined(SC_SIMD_SSE2)
+static void vec3f_decode_unorm10_batch_sse2(
+    const uint32_t* packed,
+    uint32_t stride,
+    vec3f mn,
+    vec3f extent,
+    float* out_x,
+    float* out_y,
+    float* out_z,
+    uint32_t count
+) {
+    const __m128i mask = _mm_set1_epi32(0x3ff);
+    const __m128 scale = _mm_set1_ps(1023.0f);
+    const __m128 mn_x = _mm_set1_ps(mn.x);
+    const __m128 mn_y = _mm_set1_ps(mn.y);
+    const __m128 mn_z = _mm_set1_ps(mn.z);
+    const __m128 extent_x = _mm_set1_ps(extent.x);
+    const __m128 extent_y = _mm_set1_ps(extent.y);
+    const __m128 extent_z = _mm_set1_ps(extent.z);
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const uint32_t* src = packed + (size_t)i * stride;
+        const __m128i p = stride == 1 ? _mm_loadu_si128((const __m128i*)src)
+                                      : _mm_set_epi32(
+                                            (int32_t)src[3 * stride],
+                                            (int32_t)src[2 * stride],
+                                            (int32_t)src[1 * stride],
+                                            (int32_t)src[0]
+                                        );
+        const __m128 ux = _mm_cvtepi32_ps(_mm_and_si128(p, mask));
+        const __m128 uy = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(p, 10), mask));
+        const __m128 uz = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(p, 20), mask));
+        _mm_storeu_ps(out_x + i, _mm_add_ps(mn_x, _mm_mul_ps(_mm_div_ps(ux, scale), extent_x)));
+        _mm_storeu_ps(out_y + i, _mm_add_ps(mn_y, _mm_mul_ps(_mm_div_ps(uy, scale), extent_y)));
+        _mm_storeu_ps(out_z + i, _mm_add_ps(mn_z, _mm_mul_ps(_mm_div_ps(uz, scale), extent_z)));
+    }
+    vec3f_decode_unorm10_batch_scalar(
+        packed + (size_t)i * stride,
+        stride,
+        mn,
+        extent,
+        out_x + i,
+        out_y + i,
+        out_z + i,
+        count - i
+    );
+}
+#endif
+
+#if defined(SC_SIMD_AVX2)
+static void vec3f_decode_unorm10_batch_avx2(
+    const uint32_t* packed,
+    uint32_t stride,
+    vec3f mn,
+    vec3f extent,
+    float* out_x,
+    float* out_y,
+    float* out_z,
+    uint32_t count
+) {
+    const __m256i mask = _mm256_set1_epi32(0x3ff);
+    const __m256i gather_offsets = _mm256_mullo_epi32(
+        _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+        _mm256_set1_epi32((int32_t)stride)
+    );
+    const __m256 scale = _mm256_set1_ps(1023.0f);
+    const __m256 mn_x = _mm256_set1_ps(mn.x);
+    const __m256 mn_y = _mm256_set1_ps(mn.y);
+    const __m256 mn_z = _mm256_set1_ps(mn.z);
+    const __m256 extent_x = _mm256_set1_ps(extent.x);
+    const __m256 extent_y = _mm256_set1_ps(extent.y);
+    const __m256 extent_z = _mm256_set1_ps(extent.z);
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const uint32_t* src = packed + (size_t)i * stride;
+        __m256i p;
+        if (stride == 1) {
+            p = _mm256_loadu_si256((const __m256i*)src);
+        } else if (stride == 2) {
+            // Deinterleave, cheaper than a gather for ScOctreePoint.
+            const __m256 lo = _mm256_loadu_ps((const float*)src);
+            const __m256 hi = _mm256_loadu_ps((const float*)src + 8);
+            const __m256 even = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+            p = _mm256_permute4x64_epi64(_mm256_castps_si256(even), _MM_SHUFFLE(3, 1, 2, 0));
+        } else {
+            p = _mm256_i32gather_epi32((const int*)src, gather_offsets, 4);
+        }
+        const __m256 ux = _mm256_cvtepi32_ps(_mm256_and_si256(p, mask));
+        const __m256 uy = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(p, 10), mask));
+        const __m256 uz = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(p, 20), mask));
+        // clang-format off
+        _mm256_storeu_ps(out_x + i, _mm256_add_ps(mn_x, _mm256_mul_ps(_mm256_div_ps(ux, scale), extent_x)));
+        _mm256_storeu_ps(out_y + i, _mm256_add_ps(mn_y, _mm256_mul_ps(_mm256_div_ps(uy, scale), extent_y)));
+        _mm256_storeu_ps(out_z + i, _mm256_add_ps(mn_z, _mm256_mul_ps(_mm256_div_ps(uz, scale), extent_z)));
+        // clang-format on
+    }
+    vec3f_decode_unorm10_batch_scalar(
+        packed + (size_t)i * stride,
+        stride,
+        mn,
+        extent,
+        out_x + i,
+        out_y + i,
+        out_z + i,
+        count - i
+    );
+}
+#endif
+
+static void vec3f_decode_unorm10_batch(
+    const uint32_t* packed,
+    uint32_t stride,
+    vec3f mn,
+    vec3f extent,
+    float* out_x,
+    float* out_y,
+    float* out_z,
+    uint32_t count
+) {
+#if defined(SC_SIMD_AVX2)
+    vec3f_decode_unorm10_batch_avx2(packed, stride, mn, extent, out_x, out_y, out_z, count);
+#elif defined(SC_SIMD_SSE2)
+    vec3f_decode_unorm10_batch_sse2(packed, stride, mn, extent, out_x, out_y, out_z, count);
+#else
+    vec3f_decode_unorm10_batch_scalar(packed, stride, mn, extent, out_x, out_y, out_z, count);
+#endif
+}
+
 //
 // Morton codes
 //
@@ -580,3 +1202,627 @@ static SC_INLINE void morton2_decode32(uint16_t* x, uint16_t* y, uint32_t mc) {
     *x = (uint16_t)res;
     *y = (uint16_t)(res >> 32);
 }
+
+//
+// Morton codes (3D)
+//
+
+// Notes:
+// - 30-bit codes interleave 10 bits per axis into a uint32_t, 63-bit codes interleave 21 bits
+//   per axis into a uint64_t. Bit 0 of a triplet is x, bit 1 is y, bit 2 is z.
+// - Input bits above the per-axis width are ignored.
+// - The _bmi2 paths use PDEP/PEXT, the _lut paths work on any CPU. PDEP/PEXT are microcoded
+//   on AMD before Zen 3, where the LUT path is faster.
+// - The batch _avx2 paths use magic bit masks on 8 (30-bit) or 4 (63-bit) lanes. With only
+//   4 lanes the 63-bit batch is slower than PDEP/PEXT, so it prefers the _bmi2 path.
+
+#define MORTON3_MASK30_X 0x09249249u
+#define MORTON3_MASK63_X 0x1249249249249249ull
+
+// Spread the 8 bits of b to every third bit.
+#define MORTON3_SPREAD8(b)                                                              \
+    (((b) & 0x01u) | (((b) & 0x02u) << 2) | (((b) & 0x04u) << 4) | (((b) & 0x08u) << 6) \
+     | (((b) & 0x10u) << 8) | (((b) & 0x20u) << 10) | (((b) & 0x40u) << 12)             \
+     | (((b) & 0x80u) << 14))
+
+// Gather the 9 bits of c from every third bit into x | y << 3 | z << 6.
+#define MORTON3_COMPACT9(c)                                                                 \
+    (((c) & 0x001u) | (((c) & 0x008u) >> 2) | (((c) & 0x040u) >> 4) | (((c) & 0x002u) << 2) \
+     | (((c) & 0x010u) >> 0) | (((c) & 0x080u) >> 2) | (((c) & 0x004u) << 4)                \
+     | (((c) & 0x020u) << 2) | (((c) & 0x100u) >> 0))
+
+#define MORTON3_LUT4(f, n) f(n), f(n + 1), f(n + 2), f(n + 3)
+#define MORTON3_LUT16(f, n)                                                                     \
+    MORTON3_LUT4(f, n), MORTON3_LUT4(f, n + 4), MORTON3_LUT4(f, n + 8), MORTON3_LUT4(f, n + 12)
+#define MORTON3_LUT64(f, n)                                                  \
+    MORTON3_LUT16(f, n), MORTON3_LUT16(f, n + 16), MORTON3_LUT16(f, n + 32), \
+        MORTON3_LUT16(f, n + 48)
+#define MORTON3_LUT256(f, n)                                                  \
+    MORTON3_LUT64(f, n), MORTON3_LUT64(f, n + 64), MORTON3_LUT64(f, n + 128), \
+        MORTON3_LUT64(f, n + 192)
+
+static const uint32_t MORTON3_ENCODE_LUT[256] = {
+    MORTON3_LUT256(MORTON3_SPREAD8, 0u),
+};
+
+static const uint16_t MORTON3_DECODE_LUT[512] = {
+    MORTON3_LUT256(MORTON3_COMPACT9, 0u),
+    MORTON3_LUT256(MORTON3_COMPACT9, 256u),
+};
+
+static SC_INLINE uint32_t morton3_encode30_lut(uint32_t x, uint32_t y, uint32_t z) {
+    const uint32_t ex = MORTON3_ENCODE_LUT[x & 0xff] | MORTON3_ENCODE_LUT[(x >> 8) & 0x3] << 24;
+    const uint32_t ey = MORTON3_ENCODE_LUT[y & 0xff] | MORTON3_ENCODE_LUT[(y >> 8) & 0x3] << 24;
+    const uint32_t ez = MORTON3_ENCODE_LUT[z & 0xff] | MORTON3_ENCODE_LUT[(z >> 8) & 0x3] << 24;
+    return ex | (ey << 1) | (ez << 2);
+}
+
+static SC_INLINE void morton3_decode30_lut(uint32_t* x, uint32_t* y, uint32_t* z, uint32_t mc) {
+    mc &= 0x3fffffff;
+    uint32_t rx = 0, ry = 0, rz = 0;
+    for (uint32_t i = 0; i < 4; i++) {
+        const uint32_t e = MORTON3_DECODE_LUT[(mc >> (9 * i)) & 0x1ff];
+        rx |= (e & 0x7) << (3 * i);
+        ry |= ((e >> 3) & 0x7) << (3 * i);
+        rz |= (e >> 6) << (3 * i);
+    }
+    *x = rx;
+    *y = ry;
+    *z = rz;
+}
+
+static SC_INLINE uint64_t morton3_spread21_lut(uint32_t v) {
+    return (uint64_t)MORTON3_ENCODE_LUT[v & 0xff]
+           | (uint64_t)MORTON3_ENCODE_LUT[(v >> 8) & 0xff] << 24
+           | (uint64_t)MORTON3_ENCODE_LUT[(v >> 16) & 0x1f] << 48;
+}
+
+static SC_INLINE uint64_t morton3_encode63_lut(uint32_t x, uint32_t y, uint32_t z) {
+    const uint64_t ex = morton3_spread21_lut(x);
+    const uint64_t ey = morton3_spread21_lut(y);
+    const uint64_t ez = morton3_spread21_lut(z);
+    return ex | (ey << 1) | (ez << 2);
+}
+
+static SC_INLINE void morton3_decode63_lut(uint32_t* x, uint32_t* y, uint32_t* z, uint64_t mc) {
+    mc &= 0x7fffffffffffffffull;
+    uint32_t rx = 0, ry = 0, rz = 0;
+    for (uint32_t i = 0; i < 7; i++) {
+        const uint32_t e = MORTON3_DECODE_LUT[(mc >> (9 * i)) & 0x1ff];
+        rx |= (e & 0x7) << (3 * i);
+        ry |= ((e >> 3) & 0x7) << (3 * i);
+        rz |= (e >> 6) << (3 * i);
+    }
+    *x = rx;
+    *y = ry;
+    *z = rz;
+}
+
+#if defined(SC_SIMD_BMI2)
+static SC_INLINE uint32_t morton3_encode30_bmi2(uint32_t x, uint32_t y, uint32_t z) {
+    return _pdep_u32(x, MORTON3_MASK30_X) | _pdep_u32(y, MORTON3_MASK30_X << 1)
+           | _pdep_u32(z, MORTON3_MASK30_X << 2);
+}
+
+static SC_INLINE void morton3_decode30_bmi2(uint32_t* x, uint32_t* y, uint32_t* z, uint32_t mc) {
+    *x = _pext_u32(mc, MORTON3_MASK30_X);
+    *y = _pext_u32(mc, MORTON3_MASK30_X << 1);
+    *z = _pext_u32(mc, MORTON3_MASK30_X << 2);
+}
+
+static SC_INLINE uint64_t morton3_encode63_bmi2(uint32_t x, uint32_t y, uint32_t z) {
+    return _pdep_u64(x, MORTON3_MASK63_X) | _pdep_u64(y, MORTON3_MASK63_X << 1)
+           | _pdep_u64(z, MORTON3_MASK63_X << 2);
+}
+
+static SC_INLINE void morton3_decode63_bmi2(uint32_t* x, uint32_t* y, uint32_t* z, uint64_t mc) {
+    *x = (uint32_t)_pext_u64(mc, MORTON3_MASK63_X);
+    *y = (uint32_t)_pext_u64(mc, MORTON3_MASK63_X << 1);
+    *z = (uint32_t)_pext_u64(mc, MORTON3_MASK63_X << 2);
+}
+#endif
+
+static SC_INLINE uint32_t morton3_encode30(uint32_t x, uint32_t y, uint32_t z) {
+#if defined(SC_SIMD_BMI2)
+    return morton3_encode30_bmi2(x, y, z);
+#else
+    return morton3_encode30_lut(x, y, z);
+#endif
+}
+
+static SC_INLINE void morton3_decode30(uint32_t* x, uint32_t* y, uint32_t* z, uint32_t mc) {
+#if defined(SC_SIMD_BMI2)
+    morton3_decode30_bmi2(x, y, z, mc);
+#else
+    morton3_decode30_lut(x, y, z, mc);
+#endif
+}
+
+static SC_INLINE uint64_t morton3_encode63(uint32_t x, uint32_t y, uint32_t z) {
+#if defined(SC_SIMD_BMI2)
+    return morton3_encode63_bmi2(x, y, z);
+#else
+    return morton3_encode63_lut(x, y, z);
+#endif
+}
+
+static SC_INLINE void morton3_decode63(uint32_t* x, uint32_t* y, uint32_t* z, uint64_t mc) {
+#if defined(SC_SIMD_BMI2)
+    morton3_decode63_bmi2(x, y, z, mc);
+#else
+    morton3_decode63_lut(x, y, z, mc);
+#endif
+}
+
+// Batch: encode.
+
+static void morton3_encode30_batch_lut(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint32_t* out_mc,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        out_mc[i] = morton3_encode30_lut(x[i], y[i], z[i]);
+    }
+}
+
+static void morton3_encode63_batch_lut(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint64_t* out_mc,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        out_mc[i] = morton3_encode63_lut(x[i], y[i], z[i]);
+    }
+}
+
+#if defined(SC_SIMD_BMI2)
+static void morton3_encode30_batch_bmi2(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint32_t* out_mc,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        out_mc[i] = morton3_encode30_bmi2(x[i], y[i], z[i]);
+    }
+}
+
+static void morton3_encode63_batch_bmi2(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint64_t* out_mc,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        out_mc[i] = morton3_encode63_bmi2(x[i], y[i], z[i]);
+    }
+}
+#endif
+
+#if defined(SC_SIMD_AVX2)
+static SC_INLINE __m256i morton3_spread10_avx2(__m256i v) {
+    // clang-format off
+    v = _mm256_and_si256(v, _mm256_set1_epi32(0x000003ff));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 16)), _mm256_set1_epi32(0x030000ff));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 8)), _mm256_set1_epi32(0x0300f00f));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 4)), _mm256_set1_epi32(0x030c30c3));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 2)), _mm256_set1_epi32(0x09249249));
+    // clang-format on
+    return v;
+}
+
+static SC_INLINE __m256i morton3_spread21_avx2(__m256i v) {
+    // clang-format off
+    v = _mm256_and_si256(v, _mm256_set1_epi64x(0x00000000001fffffll));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi64(v, 32)), _mm256_set1_epi64x(0x001f00000000ffffll));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi64(v, 16)), _mm256_set1_epi64x(0x001f0000ff0000ffll));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi64(v, 8)), _mm256_set1_epi64x(0x100f00f00f00f00fll));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi64(v, 4)), _mm256_set1_epi64x(0x10c30c30c30c30c3ll));
+    v = _mm256_and_si256(_mm256_or_si256(v, _mm256_slli_epi64(v, 2)), _mm256_set1_epi64x(0x1249249249249249ll));
+    // clang-format on
+    return v;
+}
+
+static void morton3_encode30_batch_avx2(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint32_t* out_mc,
+    uint32_t count
+) {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i ex = morton3_spread10_avx2(_mm256_loadu_si256((const __m256i*)(x + i)));
+        const __m256i ey = morton3_spread10_avx2(_mm256_loadu_si256((const __m256i*)(y + i)));
+        const __m256i ez = morton3_spread10_avx2(_mm256_loadu_si256((const __m256i*)(z + i)));
+        const __m256i mc = _mm256_or_si256(
+            _mm256_or_si256(ex, _mm256_slli_epi32(ey, 1)),
+            _mm256_slli_epi32(ez, 2)
+        );
+        _mm256_storeu_si256((__m256i*)(out_mc + i), mc);
+    }
+    for (; i < count; i++) {
+        out_mc[i] = morton3_encode30(x[i], y[i], z[i]);
+    }
+}
+
+static void morton3_encode63_batch_avx2(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint64_t* out_mc,
+    uint32_t count
+) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i px = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(x + i)));
+        const __m256i py = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(y + i)));
+        const __m256i pz = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i*)(z + i)));
+        const __m256i ex = morton3_spread21_avx2(px);
+        const __m256i ey = morton3_spread21_avx2(py);
+        const __m256i ez = morton3_spread21_avx2(pz);
+        const __m256i mc = _mm256_or_si256(
+            _mm256_or_si256(ex, _mm256_slli_epi64(ey, 1)),
+            _mm256_slli_epi64(ez, 2)
+        );
+        _mm256_storeu_si256((__m256i*)(out_mc + i), mc);
+    }
+    for (; i < count; i++) {
+        out_mc[i] = morton3_encode63(x[i], y[i], z[i]);
+    }
+}
+#endif
+
+static void morton3_encode30_batch(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint32_t* out_mc,
+    uint32_t count
+) {
+#if defined(SC_SIMD_AVX2)
+    morton3_encode30_batch_avx2(x, y, z, out_mc, count);
+#elif defined(SC_SIMD_BMI2)
+    morton3_encode30_batch_bmi2(x, y, z, out_mc, count);
+#else
+    morton3_encode30_batch_lut(x, y, z, out_mc, count);
+#endif
+}
+
+static void morton3_encode63_batch(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint64_t* out_mc,
+    uint32_t count
+) {
+#if defined(SC_SIMD_BMI2)
+    morton3_encode63_batch_bmi2(x, y, z, out_mc, count);
+#elif defined(SC_SIMD_AVX2)
+    morton3_encode63_batch_avx2(x, y, z, out_mc, count);
+#else
+    morton3_encode63_batch_lut(x, y, z, out_mc, count);
+#endif
+}
+
+// Batch: decode.
+
+static void morton3_decode30_batch_lut(
+    const uint32_t* mc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        morton3_decode30_lut(&out_x[i], &out_y[i], &out_z[i], mc[i]);
+    }
+}
+
+static void morton3_decode63_batch_lut(
+    const uint64_t* mc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        morton3_decode63_lut(&out_x[i], &out_y[i], &out_z[i], mc[i]);
+    }
+}
+
+#if defined(SC_SIMD_BMI2)
+static void morton3_decode30_batch_bmi2(
+    const uint32_t* mc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        morton3_decode30_bmi2(&out_x[i], &out_y[i], &out_z[i], mc[i]);
+    }
+}
+
+static void morton3_decode63_batch_bmi2(
+    const uint64_t* mc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        morton3_decode63_bmi2(&out_x[i], &out_y[i], &out_z[i], mc[i]);
+    }
+}
+#endif
+
+#if defined(SC_SIMD_AVX2)
+static SC_INLINE __m256i morton3_compact10_avx2(__m256i v) {
+    // clang-format off
+    v = _mm256_and_si256(v, _mm256_set1_epi32(0x09249249));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi32(v, 2)), _mm256_set1_epi32(0x030c30c3));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi32(v, 4)), _mm256_set1_epi32(0x0300f00f));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi32(v, 8)), _mm256_set1_epi32((int)0xff0000ff));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi32(v, 16)), _mm256_set1_epi32(0x000003ff));
+    // clang-format on
+    return v;
+}
+
+static SC_INLINE __m128i morton3_compact21_avx2(__m256i v) {
+    // clang-format off
+    v = _mm256_and_si256(v, _mm256_set1_epi64x(0x1249249249249249ll));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi64(v, 2)), _mm256_set1_epi64x(0x10c30c30c30c30c3ll));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi64(v, 4)), _mm256_set1_epi64x(0x100f00f00f00f00fll));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi64(v, 8)), _mm256_set1_epi64x(0x001f0000ff0000ffll));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi64(v, 16)), _mm256_set1_epi64x(0x001f00000000ffffll));
+    v = _mm256_and_si256(_mm256_xor_si256(v, _mm256_srli_epi64(v, 32)), _mm256_set1_epi64x(0x00000000001fffffll));
+    // clang-format on
+    v = _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+    return _mm256_castsi256_si128(v);
+}
+
+static void morton3_decode30_batch_avx2(
+    const uint32_t* mc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i m = _mm256_loadu_si256((const __m256i*)(mc + i));
+        const __m256i x = morton3_compact10_avx2(m);
+        const __m256i y = morton3_compact10_avx2(_mm256_srli_epi32(m, 1));
+        const __m256i z = morton3_compact10_avx2(_mm256_srli_epi32(m, 2));
+        _mm256_storeu_si256((__m256i*)(out_x + i), x);
+        _mm256_storeu_si256((__m256i*)(out_y + i), y);
+        _mm256_storeu_si256((__m256i*)(out_z + i), z);
+    }
+    for (; i < count; i++) {
+        morton3_decode30(&out_x[i], &out_y[i], &out_z[i], mc[i]);
+    }
+}
+
+static void morton3_decode63_batch_avx2(
+    const uint64_t* mc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i m = _mm256_loadu_si256((const __m256i*)(mc + i));
+        const __m128i x = morton3_compact21_avx2(m);
+        const __m128i y = morton3_compact21_avx2(_mm256_srli_epi64(m, 1));
+        const __m128i z = morton3_compact21_avx2(_mm256_srli_epi64(m, 2));
+        _mm_storeu_si128((__m128i*)(out_x + i), x);
+        _mm_storeu_si128((__m128i*)(out_y + i), y);
+        _mm_storeu_si128((__m128i*)(out_z + i), z);
+    }
+    for (; i < count; i++) {
+        morton3_decode63(&out_x[i], &out_y[i], &out_z[i], mc[i]);
+    }
+}
+#endif
+
+static void morton3_decode30_batch(
+    const uint32_t* mc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+#if defined(SC_SIMD_AVX2)
+    morton3_decode30_batch_avx2(mc, out_x, out_y, out_z, count);
+#elif defined(SC_SIMD_BMI2)
+    morton3_decode30_batch_bmi2(mc, out_x, out_y, out_z, count);
+#else
+    morton3_decode30_batch_lut(mc, out_x, out_y, out_z, count);
+#endif
+}
+
+static void morton3_decode63_batch(
+    const uint64_t* mc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+#if defined(SC_SIMD_BMI2)
+    morton3_decode63_batch_bmi2(mc, out_x, out_y, out_z, count);
+#elif defined(SC_SIMD_AVX2)
+    morton3_decode63_batch_avx2(mc, out_x, out_y, out_z, count);
+#else
+    morton3_decode63_batch_lut(mc, out_x, out_y, out_z, count);
+#endif
+}
+
+//
+// Hilbert codes (3D)
+//
+
+// Notes:
+// - Same curve as Skilling, "Programming the Hilbert curve" (2004), evaluated as a 24-state
+//   machine which maps the octant of each level, top down, to its rank along the curve.
+// - Octants are read from and written to Morton codes, so the bit interleave uses the
+//   PDEP/PEXT or LUT path of morton3_*.
+// - Consecutive codes always decode to face-adjacent cells.
+
+// Indexed by [state][octant], rank | next_state << 3.
+static const uint8_t HILBERT3_ENCODE_LUT[24][8] = {
+    {24, 143, 123, 12, 41, 94, 2, 5},
+    {32, 17, 107, 10, 135, 182, 4, 13},
+    {0, 9, 87, 190, 59, 18, 36, 21},
+    {16, 155, 33, 26, 183, 44, 134, 29},
+    {40, 95, 25, 142, 75, 20, 34, 37},
+    {8, 171, 191, 28, 1, 42, 86, 45},
+    {50, 57, 99, 72, 53, 166, 92, 119},
+    {174, 49, 47, 88, 61, 58, 76, 19},
+    {66, 147, 73, 56, 69, 84, 118, 167},
+    {126, 7, 65, 80, 77, 60, 74, 35},
+    {68, 187, 175, 48, 85, 82, 46, 89},
+    {52, 127, 139, 64, 93, 6, 90, 81},
+    {98, 105, 101, 150, 51, 120, 140, 71},
+    {158, 97, 109, 106, 31, 136, 124, 11},
+    {114, 163, 117, 132, 121, 104, 70, 151},
+    {78, 39, 125, 108, 113, 128, 122, 3},
+    {116, 179, 133, 130, 159, 96, 30, 137},
+    {100, 79, 141, 38, 91, 112, 138, 129},
+    {146, 149, 153, 102, 67, 188, 168, 55},
+    {110, 157, 145, 154, 15, 172, 184, 27},
+    {162, 165, 115, 180, 169, 54, 152, 103},
+    {62, 173, 23, 156, 161, 170, 176, 43},
+    {164, 181, 131, 178, 111, 14, 144, 185},
+    {148, 189, 63, 22, 83, 186, 160, 177},
+};
+
+// Indexed by [state][rank], octant | next_state << 3.
+static const uint8_t HILBERT3_DECODE_LUT[24][8] = {
+    {24, 44, 6, 122, 11, 7, 93, 137},
+    {32, 17, 11, 106, 6, 15, 181, 132},
+    {0, 9, 21, 60, 38, 23, 187, 82},
+    {16, 34, 27, 153, 45, 31, 134, 180},
+    {40, 26, 38, 76, 21, 39, 139, 89},
+    {8, 4, 45, 169, 27, 47, 86, 186},
+    {75, 57, 48, 98, 94, 52, 165, 119},
+    {91, 49, 61, 23, 78, 60, 168, 42},
+    {59, 74, 64, 145, 85, 68, 118, 167},
+    {83, 66, 78, 39, 61, 76, 120, 1},
+    {51, 95, 85, 185, 64, 84, 46, 170},
+    {67, 87, 94, 138, 48, 92, 5, 121},
+    {125, 105, 96, 52, 142, 98, 147, 71},
+    {141, 97, 107, 15, 126, 106, 152, 28},
+    {109, 124, 112, 161, 131, 114, 70, 151},
+    {133, 116, 126, 7, 107, 122, 72, 33},
+    {101, 143, 131, 177, 112, 130, 30, 156},
+    {117, 135, 142, 92, 96, 138, 35, 73},
+    {174, 154, 144, 68, 189, 145, 99, 55},
+    {190, 146, 155, 31, 173, 153, 104, 12},
+    {158, 172, 160, 114, 179, 161, 53, 103},
+    {182, 164, 173, 47, 155, 169, 56, 18},
+    {150, 191, 179, 130, 160, 177, 13, 108},
+    {166, 183, 189, 84, 144, 185, 19, 58},
+};
+
+static SC_INLINE uint32_t hilbert3_encode30(uint32_t x, uint32_t y, uint32_t z) {
+    const uint32_t mc = morton3_encode30(x, y, z);
+    uint32_t hc = 0;
+    uint32_t state = 0;
+    for (int32_t level = 9; level >= 0; level--) {
+        const uint32_t e = HILBERT3_ENCODE_LUT[state][(mc >> (3 * level)) & 0x7];
+        hc |= (uint32_t)(e & 0x7) << (3 * level);
+        state = e >> 3;
+    }
+    return hc;
+}
+
+static SC_INLINE void hilbert3_decode30(uint32_t* x, uint32_t* y, uint32_t* z, uint32_t hc) {
+    uint32_t mc = 0;
+    uint32_t state = 0;
+    for (int32_t level = 9; level >= 0; level--) {
+        const uint32_t e = HILBERT3_DECODE_LUT[state][(hc >> (3 * level)) & 0x7];
+        mc |= (uint32_t)(e & 0x7) << (3 * level);
+        state = e >> 3;
+    }
+    morton3_decode30(x, y, z, mc);
+}
+
+static SC_INLINE uint64_t hilbert3_encode63(uint32_t x, uint32_t y, uint32_t z) {
+    const uint64_t mc = morton3_encode63(x, y, z);
+    uint64_t hc = 0;
+    uint32_t state = 0;
+    for (int32_t level = 20; level >= 0; level--) {
+        const uint32_t e = HILBERT3_ENCODE_LUT[state][(mc >> (3 * level)) & 0x7];
+        hc |= (uint64_t)(e & 0x7) << (3 * level);
+        state = e >> 3;
+    }
+    return hc;
+}
+
+static SC_INLINE void hilbert3_decode63(uint32_t* x, uint32_t* y, uint32_t* z, uint64_t hc) {
+    uint64_t mc = 0;
+    uint32_t state = 0;
+    for (int32_t level = 20; level >= 0; level--) {
+        const uint32_t e = HILBERT3_DECODE_LUT[state][(hc >> (3 * level)) & 0x7];
+        mc |= (uint64_t)(e & 0x7) << (3 * level);
+        state = e >> 3;
+    }
+    morton3_decode63(x, y, z, mc);
+}
+
+static void hilbert3_encode30_batch(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint32_t* out_hc,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        out_hc[i] = hilbert3_encode30(x[i], y[i], z[i]);
+    }
+}
+
+static void hilbert3_decode30_batch(
+    const uint32_t* hc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        hilbert3_decode30(&out_x[i], &out_y[i], &out_z[i], hc[i]);
+    }
+}
+
+static void hilbert3_encode63_batch(
+    const uint32_t* x,
+    const uint32_t* y,
+    const uint32_t* z,
+    uint64_t* out_hc,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        out_hc[i] = hilbert3_encode63(x[i], y[i], z[i]);
+    }
+}
+
+static void hilbert3_decode63_batch(
+    const uint64_t* hc,
+    uint32_t* out_x,
+    uint32_t* out_y,
+    uint32_t* out_z,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; i++) {
+        hilbert3_decode63(&out_x[i], &out_y[i], &out_z[i], hc[i]);
+    }
+}
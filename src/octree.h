@@ -1,3 +1,37 @@
+typedef enum ScOctreeAttribute {
+    SC_OCTREE_ATTRIBUTE_INTENSITY,
+    SC_OCTREE_ATTRIBUTE_CLASSIFICATION,
+    SC_OCTREE_ATTRIBUTE_RETURN_NUMBER,
+    SC_OCTREE_ATTRIBUTE_GPS_TIME,
+    SC_OCTREE_ATTRIBUTE_COUNT,
+} ScOctreeAttribute;
+
+static const char* SC_OCTREE_ATTRIBUTE_NAME[] = {
+    "intensity",
+    "classification",
+    "return_number",
+    "gps_time",
+};
+
+// Element sizes: uint16_t, uint8_t, uint8_t, double.
+static const uint32_t SC_OCTREE_ATTRIBUTE_STRIDE[] = {
+    sizeof(uint16_t),
+    sizeof(uint8_t),
+    sizeof(uint8_t),
+    sizeof(double),
+};
+
+typedef enum ScOctreePointFormat {
+    SC_OCTREE_POINT_FORMAT_DEFAULT,
+    SC_OCTREE_POINT_FORMAT_COMPACT,
+    SC_OCTREE_POINT_FORMAT_COUNT,
+} ScOctreePointFormat;
+
+static const char* SC_OCTREE_POINT_FORMAT_MAGIC[] = {
+    "TOKYOOCT",
+    "TOKYOOC6",
+};
+
 typedef struct ScOctreeNode {
     int32_t min_x;
     int32_t min_y;
@@ -21,17 +55,49 @@ typedef struct ScOctreeNodeInstance {
     float max_z;
 } ScOctreeNodeInstance;
 
+// Measured from the points of a node, in world units.
+typedef struct ScOctreeNodeGeometry {
+    // Bounds the points, usually much tighter than the node cube.
+    sphere3f sphere;
+    // Mean distance between a point and its nearest neighbour. The geometric error of drawing
+    // the node in place of its children.
+    float spacing;
+} ScOctreeNodeGeometry;
+
 typedef struct ScOctreePoint {
     uint32_t position;
     uint32_t color;
 } ScOctreePoint;
 
+// Bits 0-29: position, same as ScOctreePoint.
+// Bits 30-47: color, RGB666.
+typedef struct ScOctreePointCompact {
+    uint16_t data[3];
+} ScOctreePointCompact;
+
 typedef struct ScOctreeUniforms {
     mat4f clip_from_world;
     float node_world_scale;
-    uint32_t pad[3];
+    uint32_t point_color_stream;
+    uint32_t pad[2];
 } ScOctreeUniforms;
 
+typedef struct ScOctreeTraverseStats {
+    uint32_t visited_node_count;
+    uint32_t frustum_culled_node_count;
+    // Interior nodes drawn in place of their children.
+    uint32_t lod_culled_node_count;
+} ScOctreeTraverseStats;
+
+// Traversal output, node_traverse is allocated from the arena passed to sc_octree_traverse. Kept
+// apart from the octree, so several cuts can be alive at once.
+typedef struct ScOctreeTraversal {
+    uint32_t* node_traverse;
+    uint32_t node_traverse_count;
+    uint32_t node_traverse_capacity;
+    ScOctreeTraverseStats traverse_stats;
+} ScOctreeTraversal;
+
 typedef struct ScOctree {
     float unit_world_scale;
     float node_unit_count;
@@ -39,43 +105,587 @@ typedef struct ScOctree {
 
     ScOctreeNode* nodes;
     ScOctreeNodeInstance* node_instances;
+    ScOctreeNodeGeometry* node_geometry;
     uint64_t node_count;
 
+    // Exactly one of points and compact_points is allocated, depending on point_format.
+    ScOctreePointFormat point_format;
     ScOctreePoint* points;
+    ScOctreePointCompact* compact_points;
     uint64_t point_count;
     box3f point_bounds;
 
-    uint32_t* node_traverse;
-    uint32_t node_traverse_count;
+    // Optional attribute streams, one array per attribute in point order, so the points of a
+    // node are contiguous at node->point_offset. Streams stay on disk until loaded.
+    char* file_path;
+    uint32_t attribute_mask;
+    uint64_t attribute_file_offsets[SC_OCTREE_ATTRIBUTE_COUNT];
+    void* attributes[SC_OCTREE_ATTRIBUTE_COUNT];
+
+    // Insertion state, only for octrees created with sc_octree_live_new.
+    struct ScOctreeLive* live;
 } ScOctree;
 
-static void sc_octree_new(ScOctree* octree, const char* file_path) {
-    // Timing.
-    const uint64_t begin_time_ns = SDL_GetTicksNS();
+static SC_INLINE ScOctreePointCompact sc_octree_point_compact(ScOctreePoint point) {
+    // Round 8-bit channels to 6 bits.
+    const uint64_t r = (((point.color >> 0) & 0xff) * 63 + 127) / 255;
+    const uint64_t g = (((point.color >> 8) & 0xff) * 63 + 127) / 255;
+    const uint64_t b = (((point.color >> 16) & 0xff) * 63 + 127) / 255;
+    const uint64_t bits = (uint64_t)(point.position & 0x3fffffff) | r << 30 | g << 36 | b << 42;
+    return (ScOctreePointCompact) {
+        .data = {(uint16_t)bits, (uint16_t)(bits >> 16), (uint16_t)(bits >> 32)},
+    };
+}
 
-    // Load header.
+static SC_INLINE ScOctreePoint sc_octree_point_expand(ScOctreePointCompact compact) {
+    // Expand 6-bit channels the same way as unorm decoding in point_compact.hlsl.
+    const uint64_t bits = (uint64_t)compact.data[0] | (uint64_t)compact.data[1] << 16
+                          | (uint64_t)compact.data[2] << 32;
+    const uint32_t r = (((uint32_t)(bits >> 30) & 0x3f) * 255 + 31) / 63;
+    const uint32_t g = (((uint32_t)(bits >> 36) & 0x3f) * 255 + 31) / 63;
+    const uint32_t b = (((uint32_t)(bits >> 42) & 0x3f) * 255 + 31) / 63;
+    return (ScOctreePoint) {
+        .position = (uint32_t)bits & 0x3fffffff,
+        .color = 0xff000000 | b << 16 | g << 8 | r,
+    };
+}
+
+static uint32_t sc_octree_point_stride(ScOctreePointFormat point_format) {
+    switch (point_format) {
+        case SC_OCTREE_POINT_FORMAT_DEFAULT: return sizeof(ScOctreePoint);
+        case SC_OCTREE_POINT_FORMAT_COMPACT: return sizeof(ScOctreePointCompact);
+        default: SC_ASSERT(false); return 0;
+    }
+}
+
+static const void* sc_octree_point_data(const ScOctree* octree) {
+    if (octree->point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+        return octree->compact_points;
+    }
+    return octree->points;
+}
+
+// Points are read in chunks of this size, each chunk by any job worker with its own handle.
+#define SC_OCTREE_READ_CHUNK_BYTE_COUNT (32 * 1024 * 1024)
+// Node instances are converted in chunks of at least this many nodes.
+#define SC_OCTREE_NODE_INSTANCE_GRAIN 4096
+
+typedef struct ScOctreeRead {
+    const char* file_path;
+    uint64_t file_offset;
+    uint64_t byte_count;
+    uint8_t* data;
+} ScOctreeRead;
+
+static void sc_octree_read_chunks(void* user_data, uint32_t begin, uint32_t end) {
+    const ScOctreeRead* read = user_data;
+    SDL_IOStream* io = SDL_IOFromFile(read->file_path, "rb");
+    SC_SDL_ASSERT(io != NULL);
+    for (uint32_t chunk = begin; chunk < end; chunk++) {
+        const uint64_t chunk_offset = (uint64_t)chunk * SC_OCTREE_READ_CHUNK_BYTE_COUNT;
+        const uint64_t byte_count =
+            SDL_min(read->byte_count - chunk_offset, SC_OCTREE_READ_CHUNK_BYTE_COUNT);
+        const Sint64 file_offset = (Sint64)(read->file_offset + chunk_offset);
+        SC_SDL_ASSERT(SDL_SeekIO(io, file_offset, SDL_IO_SEEK_SET) == file_offset);
+        SC_SDL_ASSERT(SDL_ReadIO(io, read->data + chunk_offset, byte_count) == byte_count);
+    }
+    SDL_CloseIO(io);
+}
+
+// Grows a buffer to at least byte_count bytes, keeping its contents.
+static void sc_octree_reserve(uint8_t** data, uint64_t* capacity, uint64_t byte_count) {
+    if (byte_count > *capacity) {
+        *capacity = byte_count;
+        *data = realloc(*data, byte_count);
+        SC_ASSERT(*data != NULL);
+    }
+}
+
+// Reads count elements of stride bytes at element offset first of the stream at file_offset,
+// for tools which visit the file node by node instead of loading it.
+static void sc_octree_stream_read(
+    SDL_IOStream* io,
+    uint64_t file_offset,
+    uint32_t stride,
+    uint64_t first,
+    uint32_t count,
+    uint8_t** data,
+    uint64_t* capacity
+) {
+    const uint64_t byte_count = (uint64_t)count * stride;
+    sc_octree_reserve(data, capacity, byte_count);
+    const Sint64 offset = (Sint64)(file_offset + first * stride);
+    SC_SDL_ASSERT(SDL_SeekIO(io, offset, SDL_IO_SEEK_SET) == offset);
+    SC_SDL_ASSERT(SDL_ReadIO(io, *data, byte_count) == byte_count);
+}
+
+static void sc_octree_node_instances_convert(void* user_data, uint32_t begin, uint32_t end) {
+    ScOctree* octree = user_data;
+    for (uint32_t i = begin; i < end; ++i) {
+        const ScOctreeNode* node = &octree->nodes[i];
+        octree->node_instances[i] = (ScOctreeNodeInstance) {
+            .min_x = (float)node->min_x,
+            .min_y = (float)node->min_y,
+            .min_z = (float)node->min_z,
+            .max_x = (float)node->max_x,
+            .max_y = (float)node->max_y,
+            .max_z = (float)node->max_z,
+        };
+    }
+}
+
+// Node geometry of files without a TOKYOGEO table is measured from the points, which is slow, and
+// cached in a sidecar file next to the octree, so later launches read it back instead. Layout:
+// - ScOctreeCacheHeader
+// - node_geometry, node_count elements
+// Notes:
+// - The cache is keyed by a hash of everything node geometry is derived from: the header, every
+//   node and every point. The points are in memory by then and are hashed in parallel chunks,
+//   which costs a small fraction of measuring the geometry. Touching the file keeps the cache,
+//   any change to its contents does not.
+// - Node instances are not cached. They are a per node conversion of the node bounds, which is
+//   cheaper than reading them back.
+// - A cache with another magic, version, key or node count is stale, and is rebuilt and
+//   rewritten transparently. Bump SC_OCTREE_CACHE_VERSION whenever the layout changes.
+// - Failing to write the cache, e.g. next to a read-only octree, is not an error.
+#define SC_OCTREE_CACHE_MAGIC "SCOCACHE"
+#define SC_OCTREE_CACHE_VERSION 2
+#define SC_OCTREE_CACHE_EXTENSION ".cache"
+// Points are hashed in chunks of this size, the chunk hashes are then hashed in order.
+#define SC_OCTREE_CACHE_HASH_CHUNK_BYTE_COUNT (4 * 1024 * 1024)
+
+typedef struct ScOctreeCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t pad;
+    uint64_t content_hash;
+    uint64_t node_count;
+} ScOctreeCacheHeader;
+
+typedef struct ScOctreeCacheHash {
+    const uint8_t* data;
+    uint64_t byte_count;
+    uint64_t* chunk_hashes;
+} ScOctreeCacheHash;
+
+static void sc_octree_cache_hash_chunks(void* user_data, uint32_t begin, uint32_t end) {
+    const ScOctreeCacheHash* cache_hash = user_data;
+    for (uint32_t chunk = begin; chunk < end; chunk++) {
+        const uint64_t chunk_offset = (uint64_t)chunk * SC_OCTREE_CACHE_HASH_CHUNK_BYTE_COUNT;
+        const uint64_t byte_count =
+            SDL_min(cache_hash->byte_count - chunk_offset, SC_OCTREE_CACHE_HASH_CHUNK_BYTE_COUNT);
+        cache_hash->chunk_hashes[chunk] =
+            sc_hash_bytes(SC_HASH_SEED, cache_hash->data + chunk_offset, byte_count);
+    }
+}
+
+// The points must be loaded.
+static uint64_t sc_octree_cache_content_hash(const ScOctree* octree) {
+    // Header.
+    uint64_t hash = SC_HASH_SEED;
+    hash = sc_hash_bytes(hash, &octree->point_format, sizeof(octree->point_format));
+    hash = sc_hash_bytes(hash, &octree->point_count, sizeof(octree->point_count));
+    hash = sc_hash_bytes(hash, &octree->point_bounds, sizeof(octree->point_bounds));
+    hash = sc_hash_bytes(hash, &octree->unit_world_scale, sizeof(octree->unit_world_scale));
+    hash = sc_hash_bytes(hash, &octree->node_unit_count, sizeof(octree->node_unit_count));
+    hash = sc_hash_bytes(hash, &octree->node_world_scale, sizeof(octree->node_world_scale));
+    hash = sc_hash_bytes(hash, &octree->node_count, sizeof(octree->node_count));
+
+    // Nodes.
+    hash = sc_hash_bytes(hash, octree->nodes, octree->node_count * sizeof(ScOctreeNode));
+
+    // Points.
+    const uint64_t point_byte_count =
+        octree->point_count * sc_octree_point_stride(octree->point_format);
+    const uint64_t chunk_count = (point_byte_count + SC_OCTREE_CACHE_HASH_CHUNK_BYTE_COUNT - 1)
+                                 / SC_OCTREE_CACHE_HASH_CHUNK_BYTE_COUNT;
+    uint64_t* chunk_hashes = malloc(SDL_max(chunk_count, 1) * sizeof(uint64_t));
+    sc_job_parallel_for(
+        sc_octree_cache_hash_chunks,
+        &(ScOctreeCacheHash) {
+            .data = sc_octree_point_data(octree),
+            .byte_count = point_byte_count,
+            .chunk_hashes = chunk_hashes,
+        },
+        (uint32_t)chunk_count,
+        1
+    );
+    hash = sc_hash_bytes(hash, chunk_hashes, chunk_count * sizeof(uint64_t));
+    free(chunk_hashes);
+    return hash;
+}
+
+// Reads node_geometry, which is already allocated. Returns false if the cache is missing or
+// stale.
+static bool
+sc_octree_cache_read(ScOctree* octree, const char* cache_path, uint64_t content_hash) {
+    SDL_IOStream* io = SDL_IOFromFile(cache_path, "rb");
+    if (io == NULL) {
+        return false;
+    }
+    ScOctreeCacheHeader header;
+    const size_t geometry_byte_count = octree->node_count * sizeof(ScOctreeNodeGeometry);
+    const bool valid = SDL_ReadIO(io, &header, sizeof(header)) == sizeof(header)
+                       && strncmp(header.magic, SC_OCTREE_CACHE_MAGIC, sizeof(header.magic)) == 0
+                       && header.version == SC_OCTREE_CACHE_VERSION
+                       && header.content_hash == content_hash
+                       && header.node_count == octree->node_count
+                       && SDL_ReadIO(io, octree->node_geometry, geometry_byte_count)
+                              == geometry_byte_count;
+    SDL_CloseIO(io);
+    return valid;
+}
+
+static void
+sc_octree_cache_write(const ScOctree* octree, const char* cache_path, uint64_t content_hash) {
+    SDL_IOStream* io = SDL_IOFromFile(cache_path, "wb");
+    if (io == NULL) {
+        SC_LOG_INFO("Skipping octree cache %s: %s", cache_path, SDL_GetError());
+        return;
+    }
+    ScOctreeCacheHeader header = {
+        .version = SC_OCTREE_CACHE_VERSION,
+        .content_hash = content_hash,
+        .node_count = octree->node_count,
+    };
+    memcpy(header.magic, SC_OCTREE_CACHE_MAGIC, sizeof(header.magic));
+    const size_t geometry_byte_count = octree->node_count * sizeof(ScOctreeNodeGeometry);
+    bool written = SDL_WriteIO(io, &header, sizeof(header)) == sizeof(header);
+    written = written
+              && SDL_WriteIO(io, octree->node_geometry, geometry_byte_count)
+                     == geometry_byte_count;
+    if (!SDL_CloseIO(io) || !written) {
+        // Remove the partial file, it would be rejected as stale anyway.
+        SC_LOG_ERROR("Failed to write octree cache %s: %s", cache_path, SDL_GetError());
+        SDL_RemovePath(cache_path);
+    }
+}
+
+// Nearest neighbours are searched among this many points on either side in Morton order.
+#define SC_OCTREE_SPACING_WINDOW 8
+// Spacing is measured on at most about this many points per node.
+#define SC_OCTREE_SPACING_SAMPLE_COUNT 1024
+
+// Estimate from the node cube alone, for nodes with too few points to measure.
+static ScOctreeNodeGeometry
+sc_octree_node_geometry_from_cube(const ScOctree* octree, uint32_t node_idx) {
+    const ScOctreeNode* node = &octree->nodes[node_idx];
+    const float scale = octree->node_world_scale;
+    const box3f bounds = (box3f) {
+        .mn = {scale * (float)node->min_x, scale * (float)node->min_y, scale * (float)node->min_z},
+        .mx = {scale * (float)node->max_x, scale * (float)node->max_y, scale * (float)node->max_z},
+    };
+    const sphere3f sphere = sphere3f_from_box3f(bounds);
+    return (ScOctreeNodeGeometry) {
+        .sphere = sphere,
+        .spacing = sphere.r / octree->node_unit_count,
+    };
+}
+
+static int sc_octree_code_compare(const void* lhs, const void* rhs) {
+    const uint32_t a = *(const uint32_t*)lhs;
+    const uint32_t b = *(const uint32_t*)rhs;
+    return (a > b) - (a < b);
+}
+
+static SC_INLINE vec3f
+sc_octree_code_position(uint32_t code, vec3f node_min, vec3f quantization_step) {
+    uint32_t x, y, z;
+    morton3_decode30_lut(&x, &y, &z, code);
+    return (vec3f) {
+        node_min.x + quantization_step.x * (float)x,
+        node_min.y + quantization_step.y * (float)y,
+        node_min.z + quantization_step.z * (float)z,
+    };
+}
+
+// Measures node_geometry from the points. Nearest neighbours are approximated by the closest
+// point among Morton order neighbours, which rarely misses by more than a cell.
+static void sc_octree_node_geometry_measure(void* user_data, uint32_t begin, uint32_t end) {
+    ScOctree* octree = user_data;
+    uint32_t* codes = NULL;
+    uint32_t code_capacity = 0;
+    for (uint32_t node_idx = begin; node_idx < end; node_idx++) {
+        // Unpack.
+        const ScOctreeNode* node = &octree->nodes[node_idx];
+        const uint32_t point_count = node->point_count;
+        ScOctreeNodeGeometry* geometry = &octree->node_geometry[node_idx];
+        *geometry = sc_octree_node_geometry_from_cube(octree, node_idx);
+        if (point_count < 2) {
+            continue;
+        }
+
+        // Positions decode as node_min + q * quantization_step.
+        const float scale = octree->node_world_scale;
+        const vec3f node_min =
+            {scale * (float)node->min_x, scale * (float)node->min_y, scale * (float)node->min_z};
+        const vec3f quantization_step = (vec3f) {
+            scale * (float)(node->max_x - node->min_x) / 1023.0f,
+            scale * (float)(node->max_y - node->min_y) / 1023.0f,
+            scale * (float)(node->max_z - node->min_z) / 1023.0f,
+        };
+
+        // Quantized positions in Morton order.
+        if (point_count > code_capacity) {
+            code_capacity = point_count;
+            codes = realloc(codes, code_capacity * sizeof(uint32_t));
+        }
+        uint32_t q_min[3] = {1023, 1023, 1023};
+        uint32_t q_max[3] = {0, 0, 0};
+        for (uint32_t i = 0; i < point_count; i++) {
+            const uint64_t point_idx = node->point_offset + i;
+            const ScOctreePoint point =
+                octree->points != NULL ? octree->points[point_idx]
+                                       : sc_octree_point_expand(octree->compact_points[point_idx]);
+            const uint32_t q[3] = {
+                point.position & 1023,
+                (point.position >> 10) & 1023,
+                (point.position >> 20) & 1023,
+            };
+            for (uint32_t c = 0; c < 3; c++) {
+                q_min[c] = SDL_min(q_min[c], q[c]);
+                q_max[c] = SDL_max(q_max[c], q[c]);
+            }
+            codes[i] = morton3_encode30_lut(q[0], q[1], q[2]);
+        }
+        qsort(codes, point_count, sizeof(uint32_t), sc_octree_code_compare);
+
+        // Sphere around the center of the point bounds.
+        const vec3f center = (vec3f) {
+            node_min.x + quantization_step.x * 0.5f * (float)(q_min[0] + q_max[0]),
+            node_min.y + quantization_step.y * 0.5f * (float)(q_min[1] + q_max[1]),
+            node_min.z + quantization_step.z * 0.5f * (float)(q_min[2] + q_max[2]),
+        };
+        float radius_squared = 0.0f;
+        for (uint32_t i = 0; i < point_count; i++) {
+            const vec3f point = sc_octree_code_position(codes[i], node_min, quantization_step);
+            const vec3f offset = vec3f_sub(point, center);
+            radius_squared = SDL_max(radius_squared, vec3f_dot(offset, offset));
+        }
+        geometry->sphere = (sphere3f) {.o = center, .r = sqrtf(radius_squared)};
+
+        // Spacing. Points quantized to the same position are not neighbours, if all of them
+        // are, the spacing is below the quantization step.
+        const uint32_t sample_stride = SDL_max(point_count / SC_OCTREE_SPACING_SAMPLE_COUNT, 1);
+        double distance_sum = 0.0;
+        uint32_t distance_count = 0;
+        for (uint32_t i = 0; i < point_count; i += sample_stride) {
+            const vec3f point = sc_octree_code_position(codes[i], node_min, quantization_step);
+            const uint32_t window = SC_OCTREE_SPACING_WINDOW;
+            const uint32_t j_begin = SDL_max(i, window) - window;
+            const uint32_t j_end = SDL_min(i + window + 1, point_count);
+            float nearest_squared = FLT_MAX;
+            for (uint32_t j = j_begin; j < j_end; j++) {
+                if (codes[j] == codes[i]) {
+                    continue;
+                }
+                const vec3f neighbour =
+                    sc_octree_code_position(codes[j], node_min, quantization_step);
+                const vec3f offset = vec3f_sub(neighbour, point);
+                nearest_squared = SDL_min(nearest_squared, vec3f_dot(offset, offset));
+            }
+            if (nearest_squared < FLT_MAX) {
+                distance_sum += sqrt((double)nearest_squared);
+                distance_count++;
+            }
+        }
+        const float step_min =
+            SDL_min(SDL_min(quantization_step.x, quantization_step.y), quantization_step.z);
+        geometry->spacing =
+            distance_count > 0 ? (float)(distance_sum / (double)distance_count) : step_min;
+    }
+    free(codes);
+}
+
+// Points follow the header and the nodes.
+static uint64_t sc_octree_point_file_offset(const ScOctree* octree) {
+    return 8 + 2 * sizeof(uint64_t) + sizeof(box3f) + 3 * sizeof(float)
+           + octree->node_count * sizeof(ScOctreeNode);
+}
+
+// Checks that the file opens, starts with a known magic and is large enough for the nodes and
+// the points its header declares, without loading it. Failures are logged.
+static bool sc_octree_probe(const char* file_path) {
+    // Open.
+    SDL_IOStream* io = SDL_IOFromFile(file_path, "rb");
+    if (io == NULL) {
+        SC_LOG_ERROR("Failed to open %s: %s", file_path, SDL_GetError());
+        return false;
+    }
+    const Sint64 file_size = SDL_GetIOSize(io);
+    char magic[8];
+    uint64_t counts[2];
+    const bool header_read = SDL_ReadIO(io, magic, sizeof(magic)) == sizeof(magic)
+                             && SDL_ReadIO(io, counts, sizeof(counts)) == sizeof(counts);
+    SDL_CloseIO(io);
+    if (file_size < 0 || !header_read) {
+        SC_LOG_ERROR("Failed to read the header of %s", file_path);
+        return false;
+    }
+
+    // Magic.
+    ScOctreePointFormat point_format = SC_OCTREE_POINT_FORMAT_COUNT;
+    for (uint32_t i = 0; i < SC_OCTREE_POINT_FORMAT_COUNT; i++) {
+        if (strncmp(magic, SC_OCTREE_POINT_FORMAT_MAGIC[i], sizeof(magic)) == 0) {
+            point_format = (ScOctreePointFormat)i;
+        }
+    }
+    if (point_format == SC_OCTREE_POINT_FORMAT_COUNT) {
+        SC_LOG_ERROR("Unknown magic %.8s in %s", magic, file_path);
+        return false;
+    }
+
+    // Size, each count is bounded by the remaining bytes first so the products can't overflow.
+    const uint64_t node_count = counts[0];
+    const uint64_t point_count = counts[1];
+    const uint64_t header_byte_count = sc_octree_point_file_offset(&(ScOctree) {0});
+    const uint64_t point_stride = sc_octree_point_stride(point_format);
+    uint64_t byte_count = (uint64_t)file_size;
+    bool fits = byte_count >= header_byte_count;
+    byte_count = fits ? byte_count - header_byte_count : 0;
+    fits = fits && node_count != 0 && node_count <= byte_count / sizeof(ScOctreeNode);
+    byte_count = fits ? byte_count - node_count * sizeof(ScOctreeNode) : 0;
+    fits = fits && point_count <= byte_count / point_stride;
+    if (!fits) {
+        SC_LOG_ERROR(
+            "Truncated %s: %" PRIu64 " bytes, header declares %" PRIu64 " nodes and %" PRIu64
+            " points",
+            file_path,
+            (uint64_t)file_size,
+            node_count,
+            point_count
+        );
+        return false;
+    }
+    return true;
+}
+
+// Loads the header and the nodes, the points stay on disk. Untrusted files should pass
+// sc_octree_probe first, failing to read here is fatal. Everything else starts zeroed.
+static void sc_octree_header_load(ScOctree* octree, const char* file_path) {
+    // Open.
+    SDL_zerop(octree);
     FILE* file = fopen(file_path, "rb");
+    if (file == NULL) {
+        SC_LOG_ERROR("Failed to open %s", file_path);
+        abort();
+    }
+
+    // Load header.
     char magic[8];
-    fread(magic, 1, sizeof(magic), file);
-    SC_ASSERT(strncmp(magic, "TOKYOOCT", sizeof(magic)) == 0);
-    fread(&octree->node_count, 1, sizeof(uint64_t), file);
-    fread(&octree->point_count, 1, sizeof(uint64_t), file);
-    fread(&octree->point_bounds, 1, sizeof(box3f), file);
-    fread(&octree->unit_world_scale, 1, sizeof(float), file);
-    fread(&octree->node_unit_count, 1, sizeof(float), file);
-    fread(&octree->node_world_scale, 1, sizeof(float), file);
+    bool read = fread(magic, 1, sizeof(magic), file) == sizeof(magic);
+    octree->point_format = SC_OCTREE_POINT_FORMAT_COUNT;
+    for (uint32_t i = 0; i < SC_OCTREE_POINT_FORMAT_COUNT; i++) {
+        if (strncmp(magic, SC_OCTREE_POINT_FORMAT_MAGIC[i], sizeof(magic)) == 0) {
+            octree->point_format = (ScOctreePointFormat)i;
+        }
+    }
+    read = read && octree->point_format != SC_OCTREE_POINT_FORMAT_COUNT;
+    read = read && fread(&octree->node_count, 1, sizeof(uint64_t), file) == sizeof(uint64_t);
+    read = read && fread(&octree->point_count, 1, sizeof(uint64_t), file) == sizeof(uint64_t);
+    read = read && fread(&octree->point_bounds, 1, sizeof(box3f), file) == sizeof(box3f);
+    read = read && fread(&octree->unit_world_scale, 1, sizeof(float), file) == sizeof(float);
+    read = read && fread(&octree->node_unit_count, 1, sizeof(float), file) == sizeof(float);
+    read = read && fread(&octree->node_world_scale, 1, sizeof(float), file) == sizeof(float);
+    if (!read) {
+        SC_LOG_ERROR("Failed to read the header of %s", file_path);
+        abort();
+    }
 
     // Load nodes.
-    octree->nodes = malloc(octree->node_count * sizeof(ScOctreeNode));
-    fread(octree->nodes, 1, octree->node_count * sizeof(ScOctreeNode), file);
+    const uint64_t node_byte_count = octree->node_count * sizeof(ScOctreeNode);
+    octree->nodes = malloc(node_byte_count);
+    SC_ASSERT(octree->nodes != NULL);
+    if (fread(octree->nodes, 1, node_byte_count, file) != node_byte_count) {
+        SC_LOG_ERROR("Failed to read the nodes of %s", file_path);
+        abort();
+    }
+    fclose(file);
+    octree->file_path = SDL_strdup(file_path);
+}
 
-    // Load points.
-    octree->points = malloc(octree->point_count * sizeof(ScOctreePoint));
-    fread(octree->points, 1, octree->point_count * sizeof(ScOctreePoint), file);
+// Optional tables after the points, each starting with a magic:
+// - "TOKYOATR": uint32_t attribute mask, bit i set if ScOctreeAttribute i is present, then the
+//   present attribute streams in enum order, point_count elements each
+// - "TOKYOGEO": node_geometry, node_count elements
+// Returns whether node_geometry was read.
+static bool sc_octree_tables_load(ScOctree* octree) {
+    const char* file_path = octree->file_path;
+    octree->attribute_mask = 0;
+    memset(octree->attributes, 0, sizeof(octree->attributes));
+    memset(octree->attribute_file_offsets, 0, sizeof(octree->attribute_file_offsets));
+    octree->node_geometry = malloc(octree->node_count * sizeof(ScOctreeNodeGeometry));
+    bool node_geometry_loaded = false;
+    SDL_IOStream* io = SDL_IOFromFile(file_path, "rb");
+    SC_SDL_ASSERT(io != NULL);
+    uint64_t table_offset = sc_octree_point_file_offset(octree)
+                            + octree->point_count * sc_octree_point_stride(octree->point_format);
+    SC_SDL_ASSERT(SDL_SeekIO(io, (Sint64)table_offset, SDL_IO_SEEK_SET) == (Sint64)table_offset);
+    char table_magic[8];
+    while (SDL_ReadIO(io, table_magic, sizeof(table_magic)) == sizeof(table_magic)) {
+        table_offset += sizeof(table_magic);
+        if (strncmp(table_magic, "TOKYOATR", sizeof(table_magic)) == 0) {
+            const size_t mask_size = sizeof(uint32_t);
+            SC_SDL_ASSERT(SDL_ReadIO(io, &octree->attribute_mask, mask_size) == mask_size);
+            table_offset += sizeof(uint32_t);
+            for (uint32_t i = 0; i < SC_OCTREE_ATTRIBUTE_COUNT; i++) {
+                if (octree->attribute_mask & (1u << i)) {
+                    octree->attribute_file_offsets[i] = table_offset;
+                    table_offset += octree->point_count * SC_OCTREE_ATTRIBUTE_STRIDE[i];
+                }
+            }
+        } else if (strncmp(table_magic, "TOKYOGEO", sizeof(table_magic)) == 0) {
+            const uint64_t byte_count = octree->node_count * sizeof(ScOctreeNodeGeometry);
+            SC_SDL_ASSERT(SDL_ReadIO(io, octree->node_geometry, byte_count) == byte_count);
+            table_offset += byte_count;
+            node_geometry_loaded = true;
+        } else {
+            SC_LOG_ERROR("Unknown table %.8s in %s, ignoring the rest", table_magic, file_path);
+            break;
+        }
+        const Sint64 next_offset = (Sint64)table_offset;
+        SC_SDL_ASSERT(SDL_SeekIO(io, next_offset, SDL_IO_SEEK_SET) == next_offset);
+    }
+    SDL_CloseIO(io);
+    return node_geometry_loaded;
+}
+
+static void sc_octree_new(ScOctree* octree, const char* file_path) {
+    // Timing.
+    const uint64_t begin_time_ns = SDL_GetTicksNS();
+
+    // Header and nodes.
+    sc_octree_header_load(octree, file_path);
+
+    // Load points, chunks are read in parallel.
+    const uint64_t point_byte_count =
+        octree->point_count * sc_octree_point_stride(octree->point_format);
+    uint8_t* point_data = malloc(point_byte_count);
+    if (octree->point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+        octree->compact_points = (ScOctreePointCompact*)point_data;
+    } else {
+        octree->points = (ScOctreePoint*)point_data;
+    }
+    const uint64_t chunk_count =
+        (point_byte_count + SC_OCTREE_READ_CHUNK_BYTE_COUNT - 1) / SC_OCTREE_READ_CHUNK_BYTE_COUNT;
+    sc_job_parallel_for(
+        sc_octree_read_chunks,
+        &(ScOctreeRead) {
+            .file_path = file_path,
+            .file_offset = sc_octree_point_file_offset(octree),
+            .byte_count = point_byte_count,
+            .data = point_data,
+        },
+        (uint32_t)chunk_count,
+        1
+    );
+
+    // Tables.
+    const bool node_geometry_loaded = sc_octree_tables_load(octree);
 
     // Debug: morton order visualization.
     const bool debug_morton_order_coloring = false;
-    if (debug_morton_order_coloring) {
+    if (debug_morton_order_coloring && octree->points != NULL) {
         for (uint32_t node_idx = 0; node_idx < octree->node_count; ++node_idx) {
             const ScOctreeNode* node = &octree->nodes[node_idx];
             for (uint32_t point_idx = 0; point_idx < node->point_count; ++point_idx) {
@@ -88,7 +698,7 @@ static void sc_octree_new(ScOctree* octree, const char* file_path) {
 
     // Debug: write points as images.
     const bool debug_write_point_images = false;
-    if (debug_write_point_images) {
+    if (debug_write_point_images && octree->points != NULL) {
         for (uint32_t node_idx = 0; node_idx < octree->node_count; ++node_idx) {
             const ScOctreeNode* node = &octree->nodes[node_idx];
             uint32_t image_size = 1;
@@ -122,27 +732,44 @@ static void sc_octree_new(ScOctree* octree, const char* file_path) {
 
     // Node instances.
     octree->node_instances = malloc(octree->node_count * sizeof(ScOctreeNodeInstance));
-    for (uint64_t i = 0; i < octree->node_count; ++i) {
-        const ScOctreeNode* node = &octree->nodes[i];
-        octree->node_instances[i] = (ScOctreeNodeInstance) {
-            .min_x = (float)node->min_x,
-            .min_y = (float)node->min_y,
-            .min_z = (float)node->min_z,
-            .max_x = (float)node->max_x,
-            .max_y = (float)node->max_y,
-            .max_z = (float)node->max_z,
-        };
-    }
+    sc_job_parallel_for(
+        sc_octree_node_instances_convert,
+        octree,
+        (uint32_t)octree->node_count,
+        SC_OCTREE_NODE_INSTANCE_GRAIN
+    );
 
-    // Node traversal.
-    octree->node_traverse = malloc(octree->node_count * sizeof(uint32_t));
-    octree->node_traverse_count = 0;
+    // Node geometry, for files written without it from the cache if it is up to date, else
+    // measured and cached.
+    if (!node_geometry_loaded) {
+        const uint64_t content_hash = sc_octree_cache_content_hash(octree);
+        char* cache_path = NULL;
+        SDL_asprintf(&cache_path, "%s%s", file_path, SC_OCTREE_CACHE_EXTENSION);
+        if (sc_octree_cache_read(octree, cache_path, content_hash)) {
+            SC_LOG_INFO("Read octree cache %s", cache_path);
+        } else {
+            const uint64_t measure_begin_time_ns = SDL_GetTicksNS();
+            sc_job_parallel_for(
+                sc_octree_node_geometry_measure,
+                octree,
+                (uint32_t)octree->node_count,
+                1
+            );
+            SC_LOG_INFO(
+                "Measured node geometry in %" PRIu64 " ms",
+                (SDL_GetTicksNS() - measure_begin_time_ns) / 1000000
+            );
+            SC_LOG_INFO("Rebuilt octree cache %s", cache_path);
+            sc_octree_cache_write(octree, cache_path, content_hash);
+        }
+        SDL_free(cache_path);
+    }
 
     // Timing.
     const uint64_t end_time_ns = SDL_GetTicksNS();
     const uint64_t elapsed_time_ns = end_time_ns - begin_time_ns;
     SC_LOG_INFO(
-        "Loaded %d points in %" PRIu64 " ms",
+        "Loaded %" PRIu64 " points in %" PRIu64 " ms",
         octree->point_count,
         elapsed_time_ns / 1000000
     );
@@ -151,8 +778,9 @@ static void sc_octree_new(ScOctree* octree, const char* file_path) {
     // clang-format off
     const vec3f point_bounds_extents = box3f_extents(octree->point_bounds);
     const vec3f point_bounds_center = box3f_center(octree->point_bounds);
-    SC_LOG_INFO("Node count: %llu", octree->node_count);
-    SC_LOG_INFO("Point count: %llu", octree->point_count);
+    SC_LOG_INFO("Node count: %" PRIu64, octree->node_count);
+    SC_LOG_INFO("Point count: %" PRIu64, octree->point_count);
+    SC_LOG_INFO("Point format: %s", octree->point_format == SC_OCTREE_POINT_FORMAT_COMPACT ? "compact" : "default");
     SC_LOG_INFO("Point bounds:");
     SC_LOG_INFO("  Min: %f, %f, %f", octree->point_bounds.mn.x, octree->point_bounds.mn.y, octree->point_bounds.mn.z);
     SC_LOG_INFO("  Max: %f, %f, %f", octree->point_bounds.mx.x, octree->point_bounds.mx.y, octree->point_bounds.mx.z);
@@ -162,80 +790,482 @@ static void sc_octree_new(ScOctree* octree, const char* file_path) {
     SC_LOG_INFO("Node unit count: %f", octree->node_unit_count);
     SC_LOG_INFO("Node world scale: %f", octree->node_world_scale);
     // clang-format on
+    for (uint32_t i = 0; i < SC_OCTREE_ATTRIBUTE_COUNT; i++) {
+        if (octree->attribute_mask & (1u << i)) {
+            SC_LOG_INFO("Attribute: %s", SC_OCTREE_ATTRIBUTE_NAME[i]);
+        }
+    }
+}
+
+static void sc_octree_attribute_unload(ScOctree* octree, ScOctreeAttribute attribute) {
+    free(octree->attributes[attribute]);
+    octree->attributes[attribute] = NULL;
 }
 
+static void sc_octree_live_free(struct ScOctreeLive* live, uint64_t node_count);
+
 static void sc_octree_free(ScOctree* octree) {
+    if (octree->live != NULL) {
+        sc_octree_live_free(octree->live, octree->node_count);
+    }
     free(octree->nodes);
     free(octree->node_instances);
+    free(octree->node_geometry);
+    free(octree->points);
+    free(octree->compact_points);
+    for (uint32_t i = 0; i < SC_OCTREE_ATTRIBUTE_COUNT; i++) {
+        sc_octree_attribute_unload(octree, (ScOctreeAttribute)i);
+    }
+    SDL_free(octree->file_path);
+}
+
+static bool sc_octree_attribute_available(const ScOctree* octree, ScOctreeAttribute attribute) {
+    return (octree->attribute_mask & (1u << attribute)) != 0;
+}
+
+// Reads an attribute stream from disk, unless already loaded. Returns NULL if the file has
+// no such attribute.
+static const void* sc_octree_attribute_load(ScOctree* octree, ScOctreeAttribute attribute) {
+    // Validation.
+    if (!sc_octree_attribute_available(octree, attribute)) {
+        return NULL;
+    }
+    if (octree->attributes[attribute] != NULL) {
+        return octree->attributes[attribute];
+    }
+
+    // Timing.
+    const uint64_t begin_time_ns = SDL_GetTicksNS();
+
+    // Load, with 64-bit offsets.
+    const uint64_t byte_count = octree->point_count * SC_OCTREE_ATTRIBUTE_STRIDE[attribute];
+    void* data = malloc(byte_count);
+    SDL_IOStream* io = SDL_IOFromFile(octree->file_path, "rb");
+    SC_SDL_ASSERT(io != NULL);
+    const Sint64 file_offset = (Sint64)octree->attribute_file_offsets[attribute];
+    SC_SDL_ASSERT(SDL_SeekIO(io, file_offset, SDL_IO_SEEK_SET) == file_offset);
+    SC_SDL_ASSERT(SDL_ReadIO(io, data, byte_count) == byte_count);
+    SDL_CloseIO(io);
+    octree->attributes[attribute] = data;
+
+    // Timing.
+    const uint64_t end_time_ns = SDL_GetTicksNS();
+    SC_LOG_INFO(
+        "Loaded attribute %s (%" PRIu64 " MB) in %" PRIu64 " ms",
+        SC_OCTREE_ATTRIBUTE_NAME[attribute],
+        byte_count / (1024 * 1024),
+        (end_time_ns - begin_time_ns) / 1000000
+    );
+    return data;
+}
+
+// Converts points to the compact format in place.
+static void sc_octree_compact(ScOctree* octree) {
+    SC_ASSERT(octree->live == NULL);
+    if (octree->point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+        return;
+    }
+    octree->compact_points = malloc(octree->point_count * sizeof(ScOctreePointCompact));
+    for (uint64_t i = 0; i < octree->point_count; i++) {
+        octree->compact_points[i] = sc_octree_point_compact(octree->points[i]);
+    }
     free(octree->points);
-    free(octree->node_traverse);
+    octree->points = NULL;
+    octree->point_format = SC_OCTREE_POINT_FORMAT_COMPACT;
 }
 
+// Writes the octree in its current point format, including any attribute streams.
+static bool sc_octree_write(ScOctree* octree, const char* file_path) {
+    SC_ASSERT(octree->live == NULL);
+    SDL_IOStream* io = SDL_IOFromFile(file_path, "wb");
+    if (io == NULL) {
+        SC_LOG_ERROR("Failed to open %s: %s", file_path, SDL_GetError());
+        return false;
+    }
+
+    // Header.
+    bool ok = true;
+    ok &= SDL_WriteIO(io, SC_OCTREE_POINT_FORMAT_MAGIC[octree->point_format], 8) == 8;
+    ok &= SDL_WriteIO(io, &octree->node_count, sizeof(uint64_t)) == sizeof(uint64_t);
+    ok &= SDL_WriteIO(io, &octree->point_count, sizeof(uint64_t)) == sizeof(uint64_t);
+    ok &= SDL_WriteIO(io, &octree->point_bounds, sizeof(box3f)) == sizeof(box3f);
+    ok &= SDL_WriteIO(io, &octree->unit_world_scale, sizeof(float)) == sizeof(float);
+    ok &= SDL_WriteIO(io, &octree->node_unit_count, sizeof(float)) == sizeof(float);
+    ok &= SDL_WriteIO(io, &octree->node_world_scale, sizeof(float)) == sizeof(float);
+
+    // Nodes and points.
+    const uint64_t node_byte_count = octree->node_count * sizeof(ScOctreeNode);
+    const uint64_t point_byte_count =
+        octree->point_count * sc_octree_point_stride(octree->point_format);
+    ok &= SDL_WriteIO(io, octree->nodes, node_byte_count) == node_byte_count;
+    ok &= SDL_WriteIO(io, sc_octree_point_data(octree), point_byte_count) == point_byte_count;
+
+    // Attributes, loaded from the source file one at a time.
+    if (octree->attribute_mask != 0) {
+        ok &= SDL_WriteIO(io, "TOKYOATR", 8) == 8;
+        ok &= SDL_WriteIO(io, &octree->attribute_mask, sizeof(uint32_t)) == sizeof(uint32_t);
+        for (uint32_t i = 0; i < SC_OCTREE_ATTRIBUTE_COUNT; i++) {
+            const ScOctreeAttribute attribute = (ScOctreeAttribute)i;
+            if (!sc_octree_attribute_available(octree, attribute)) {
+                continue;
+            }
+            const bool loaded = octree->attributes[attribute] != NULL;
+            const void* data = sc_octree_attribute_load(octree, attribute);
+            const uint64_t byte_count = octree->point_count * SC_OCTREE_ATTRIBUTE_STRIDE[i];
+            ok &= SDL_WriteIO(io, data, byte_count) == byte_count;
+            if (!loaded) {
+                sc_octree_attribute_unload(octree, attribute);
+            }
+        }
+    }
+
+    // Node geometry.
+    const uint64_t geometry_byte_count = octree->node_count * sizeof(ScOctreeNodeGeometry);
+    ok &= SDL_WriteIO(io, "TOKYOGEO", 8) == 8;
+    ok &= SDL_WriteIO(io, octree->node_geometry, geometry_byte_count) == geometry_byte_count;
+
+    ok &= SDL_CloseIO(io);
+    if (!ok) {
+        SC_LOG_ERROR("Failed to write %s: %s", file_path, SDL_GetError());
+    }
+    return ok;
+}
+
+// ASPRS standard point classes.
+static const uint32_t SC_OCTREE_CLASSIFICATION_COLORS[] = {
+    0xff808080, // Created, never classified.
+    0xffb0b0b0, // Unclassified.
+    0xff3a6ea5, // Ground.
+    0xff4cc24c, // Low vegetation.
+    0xff28a028, // Medium vegetation.
+    0xff107010, // High vegetation.
+    0xff2020e0, // Building.
+    0xffff00ff, // Low point (noise).
+    0xff808080, // Reserved.
+    0xffe08020, // Water.
+    0xff206080, // Rail.
+    0xff404040, // Road surface.
+    0xff808080, // Reserved.
+    0xff00e0e0, // Wire - guard.
+    0xff00c0ff, // Wire - conductor.
+    0xff0080ff, // Transmission tower.
+    0xff00a0c0, // Wire - structure connector.
+    0xffa0a0ff, // Bridge deck.
+    0xffff40ff, // High noise.
+};
+
+// Maps a loaded attribute stream to RGBA8 colors, point_count elements.
+static void sc_octree_attribute_colors(
+    const ScOctree* octree,
+    ScOctreeAttribute attribute,
+    uint32_t* colors
+) {
+    // Validation.
+    const void* data = octree->attributes[attribute];
+    SC_ASSERT(data != NULL);
+
+    // Map.
+    const uint64_t point_count = octree->point_count;
+    switch (attribute) {
+        case SC_OCTREE_ATTRIBUTE_INTENSITY: {
+            const uint16_t* intensity = data;
+            for (uint64_t i = 0; i < point_count; i++) {
+                const uint32_t v = intensity[i] >> 8;
+                colors[i] = 0xff000000 | (v << 16) | (v << 8) | v;
+            }
+            break;
+        }
+        case SC_OCTREE_ATTRIBUTE_CLASSIFICATION: {
+            const uint8_t* classification = data;
+            for (uint64_t i = 0; i < point_count; i++) {
+                const uint8_t c = classification[i];
+                colors[i] = c < SC_COUNTOF(SC_OCTREE_CLASSIFICATION_COLORS)
+                                ? SC_OCTREE_CLASSIFICATION_COLORS[c]
+                                : sc_color_from_hsv((float)(c % 16) / 16.0f, 0.5f, 1.0f);
+            }
+            break;
+        }
+        case SC_OCTREE_ATTRIBUTE_RETURN_NUMBER: {
+            const uint8_t* return_number = data;
+            for (uint64_t i = 0; i < point_count; i++) {
+                const float hue = (float)(return_number[i] & 0x7) / 8.0f;
+                colors[i] = sc_color_from_hsv(hue, 0.75f, 1.0f);
+            }
+            break;
+        }
+        case SC_OCTREE_ATTRIBUTE_GPS_TIME: {
+            const double* gps_time = data;
+            double mn = DBL_MAX;
+            double mx = -DBL_MAX;
+            for (uint64_t i = 0; i < point_count; i++) {
+                mn = SDL_min(mn, gps_time[i]);
+                mx = SDL_max(mx, gps_time[i]);
+            }
+            const double scale = mx > mn ? 1.0 / (mx - mn) : 0.0;
+            for (uint64_t i = 0; i < point_count; i++) {
+                const float t = (float)((gps_time[i] - mn) * scale);
+                colors[i] = sc_color_from_hsv(0.75f * t, 0.75f, 1.0f);
+            }
+            break;
+        }
+        default: SC_ASSERT(false); break;
+    }
+}
+
+static box3f sc_octree_node_bounds(const ScOctree* octree, uint32_t node_idx) {
+    const ScOctreeNodeInstance* instance = &octree->node_instances[node_idx];
+    const float scale = octree->node_world_scale;
+    return (box3f) {
+        .mn = {scale * instance->min_x, scale * instance->min_y, scale * instance->min_z},
+        .mx = {scale * instance->max_x, scale * instance->max_y, scale * instance->max_z},
+    };
+}
+
+// Notes:
+// - One traversal serves several views at once, e.g. the panes of a multi-view layout or the eyes
+//   of a stereo pair, so the same cut of nodes is drawn in all of them.
+// - Nodes are culled against the union frustum of the views first. When the views diverge, its
+//   planes are loose and the views are also tested one by one, a node is kept while any of them
+//   may see it. Nearby views, like stereo pairs, are only tested against the union.
+// - A node is drawn in place of its children only once it is small enough in every view which
+//   may see it.
+
+#define SC_OCTREE_TRAVERSE_MAX_VIEW_COUNT 8
+// Views whose frustum planes all agree within this cosine count as nearby.
+#define SC_OCTREE_TRAVERSE_NEARBY_VIEW_COS 0.9999f
+
 typedef struct ScOctreeTraverseInfo {
-    const ScPerspectiveCamera* camera;
+    ScArena* arena;
+    const ScPerspectiveCamera* cameras;
+    uint32_t camera_count;
     float lod_bias;
 } ScOctreeTraverseInfo;
 
-static void sc_octree_traverse(ScOctree* octree, const ScOctreeTraverseInfo* traverse_info) {
+// Derived from the cameras once per traversal.
+typedef struct ScOctreeTraverseViews {
+    ScFrustum union_frustum;
+    bool view_culling;
+    uint32_t view_mask;
+} ScOctreeTraverseViews;
+
+static void sc_octree_traverse_views_new(
+    ScOctreeTraverseViews* views,
+    const ScPerspectiveCamera* cameras,
+    uint32_t camera_count
+) {
+    SC_ASSERT(camera_count > 0 && camera_count <= SC_OCTREE_TRAVERSE_MAX_VIEW_COUNT);
+    views->union_frustum = sc_perspective_camera_union_frustum(cameras, camera_count);
+    views->view_culling = false;
+    views->view_mask = (1u << camera_count) - 1;
+    for (uint32_t i = 1; i < camera_count; i++) {
+        for (uint32_t j = 0; j < SC_FRUSTUM_PLANE_COUNT; j++) {
+            const vec3f n = cameras[i].frustum.planes[j].n;
+            const vec3f n0 = cameras[0].frustum.planes[j].n;
+            views->view_culling |= vec3f_dot(n, n0) < SC_OCTREE_TRAVERSE_NEARBY_VIEW_COS;
+        }
+    }
+}
+
+// Octrees with fewer nodes are traversed on the calling thread only.
+#define SC_OCTREE_TRAVERSE_PARALLEL_NODE_COUNT 4096
+// Nodes this deep that need descending are handed to job workers as separate subtrees.
+#define SC_OCTREE_TRAVERSE_SPLIT_DEPTH 2
+#define SC_OCTREE_TRAVERSE_SPLIT_MAX_COUNT 64
+static_assert(
+    SC_OCTREE_TRAVERSE_SPLIT_MAX_COUNT == 1 << (3 * SC_OCTREE_TRAVERSE_SPLIT_DEPTH),
+    "One subtree per node at the split depth"
+);
+// Subtrees traversed on job workers write their nodes in blocks of this many.
+#define SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT 256
+
+// Scratch shared by the subtree jobs of one traversal, allocated before the fork. Jobs claim
+// blocks with an atomic counter and chain them in order, so no job touches an allocator.
+typedef struct ScOctreeTraverseBlocks {
+    uint32_t* nodes;
+    uint32_t* next_blocks;
+    uint32_t block_capacity;
+    SDL_AtomicInt block_count;
+} ScOctreeTraverseBlocks;
+
+// Where a subtree traversal writes its nodes. On the calling thread they are grown in the arena,
+// or on the heap without one. On job workers they go to a chain of blocks.
+typedef struct ScOctreeTraverseOutput {
+    ScOctreeTraversal* traversal;
+    ScArena* arena;
+    ScOctreeTraverseBlocks* blocks;
+    uint32_t first_block;
+    uint32_t last_block;
+} ScOctreeTraverseOutput;
+
+// Subtree roots collected by the top-level pass.
+typedef struct ScOctreeTraverseRoots {
+    uint32_t nodes[SC_OCTREE_TRAVERSE_SPLIT_MAX_COUNT];
+    uint32_t count;
+} ScOctreeTraverseRoots;
+
+static void sc_octree_traverse_push(ScOctreeTraverseOutput* output, uint32_t node_idx) {
+    // Blocks.
+    ScOctreeTraversal* traversal = output->traversal;
+    ScOctreeTraverseBlocks* blocks = output->blocks;
+    if (blocks != NULL) {
+        const uint32_t block_offset =
+            traversal->node_traverse_count % SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT;
+        if (block_offset == 0) {
+            const uint32_t block = (uint32_t)SDL_AddAtomicInt(&blocks->block_count, 1);
+            SC_ASSERT(block < blocks->block_capacity);
+            blocks->next_blocks[block] = ~0u;
+            if (traversal->node_traverse_count == 0) {
+                output->first_block = block;
+            } else {
+                blocks->next_blocks[output->last_block] = block;
+            }
+            output->last_block = block;
+        }
+        const uint64_t node_offset =
+            (uint64_t)output->last_block * SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT + block_offset;
+        blocks->nodes[node_offset] = node_idx;
+        traversal->node_traverse_count++;
+        return;
+    }
+
+    // Arena, or heap.
+    if (traversal->node_traverse_count == traversal->node_traverse_capacity) {
+        const uint32_t capacity = SDL_max(2 * traversal->node_traverse_capacity, 256);
+        if (output->arena != NULL) {
+            traversal->node_traverse = sc_arena_grow(
+                output->arena,
+                traversal->node_traverse,
+                traversal->node_traverse_capacity * sizeof(uint32_t),
+                capacity * sizeof(uint32_t),
+                _Alignof(uint32_t)
+            );
+        } else {
+            traversal->node_traverse =
+                realloc(traversal->node_traverse, capacity * sizeof(uint32_t));
+        }
+        traversal->node_traverse_capacity = capacity;
+    }
+    traversal->node_traverse[traversal->node_traverse_count++] = node_idx;
+}
+
+// Traverses the subtree below root. Nodes at split_depth that would be descended into are pushed
+// to split instead, if given.
+static void sc_octree_traverse_subtree(
+    const ScOctree* octree,
+    const ScOctreeTraverseInfo* traverse_info,
+    const ScOctreeTraverseViews* views,
+    uint32_t root,
+    ScOctreeTraverseOutput* output,
+    ScOctreeTraverseRoots* split
+) {
     // Unpack.
-    const float node_unit_count = octree->node_unit_count;
+    ScOctreeTraversal* traversal = output->traversal;
     const float node_world_scale = octree->node_world_scale;
-    const ScPerspectiveCamera* camera = traverse_info->camera;
+    const ScPerspectiveCamera* cameras = traverse_info->cameras;
+    const uint32_t camera_count = traverse_info->camera_count;
     const float lod_bias = traverse_info->lod_bias;
 
-    // Reset.
-    octree->node_traverse_count = 0;
-
-    // Traverse state.
+    // Traverse state. Per node, whether it is entirely inside the union frustum, the views which
+    // may see it, and the views it is entirely inside of.
     uint32_t todo[64] = {0};
+    uint32_t todo_depths[64] = {0};
+    bool todo_inside[64] = {0};
+    uint8_t todo_views[64] = {0};
+    uint8_t todo_views_inside[64] = {0};
     uint32_t todo_count = 0;
-    todo[todo_count++] = 0;
+    todo_views[todo_count] = (uint8_t)views->view_mask;
+    todo[todo_count++] = root;
 
     // Traversal.
     while (todo_count) {
         // Unpack.
         const uint32_t curr = todo[--todo_count];
+        const uint32_t curr_depth = todo_depths[todo_count];
+        bool curr_inside = todo_inside[todo_count];
+        uint32_t curr_views = todo_views[todo_count];
+        uint32_t curr_views_inside = todo_views_inside[todo_count];
         const ScOctreeNode* curr_node = &octree->nodes[curr];
+        traversal->traverse_stats.visited_node_count++;
 
-        // Calculate current bounds.
-        const vec3f curr_bounds_mn = (vec3f) {
-            node_world_scale * (float)curr_node->min_x,
-            node_world_scale * (float)curr_node->min_y,
-            node_world_scale * (float)curr_node->min_z,
-        };
-        const vec3f curr_bounds_mx = (vec3f) {
-            node_world_scale * (float)curr_node->max_x,
-            node_world_scale * (float)curr_node->max_y,
-            node_world_scale * (float)curr_node->max_z,
-        };
-        const box3f curr_bounds = (box3f) {
-            .mn = curr_bounds_mn,
-            .mx = curr_bounds_mx,
-        };
+        // Frustum culling, not needed below nodes entirely inside.
+        const uint32_t curr_views_test = views->view_culling ? curr_views & ~curr_views_inside : 0;
+        if (!curr_inside || curr_views_test != 0) {
+            const box3f curr_bounds = (box3f) {
+                .mn = {
+                    node_world_scale * (float)curr_node->min_x,
+                    node_world_scale * (float)curr_node->min_y,
+                    node_world_scale * (float)curr_node->min_z,
+                },
+                .mx = {
+                    node_world_scale * (float)curr_node->max_x,
+                    node_world_scale * (float)curr_node->max_y,
+                    node_world_scale * (float)curr_node->max_z,
+                },
+            };
 
-        // Frustum culling.
-        if (!sc_frustum_intersects_box(&camera->frustum, curr_bounds)) {
-            continue;
+            // Union.
+            if (!curr_inside) {
+                const ScFrustumSide side =
+                    sc_frustum_classify_box(&views->union_frustum, curr_bounds);
+                if (side == SC_FRUSTUM_SIDE_OUTSIDE) {
+                    traversal->traverse_stats.frustum_culled_node_count++;
+                    continue;
+                }
+                curr_inside = side == SC_FRUSTUM_SIDE_INSIDE;
+            }
+
+            // Views.
+            for (uint32_t i = 0; i < camera_count; i++) {
+                if ((curr_views_test & (1u << i)) == 0) {
+                    continue;
+                }
+                const ScFrustumSide side =
+                    sc_frustum_classify_box(&cameras[i].frustum, curr_bounds);
+                if (side == SC_FRUSTUM_SIDE_OUTSIDE) {
+                    curr_views &= ~(1u << i);
+                } else if (side == SC_FRUSTUM_SIDE_INSIDE) {
+                    curr_views_inside |= 1u << i;
+                }
+            }
+            if (curr_views == 0) {
+                traversal->traverse_stats.frustum_culled_node_count++;
+                continue;
+            }
         }
 
         // Special: leaf nodes are always rendered.
         if (curr_node->level == 0) {
-            octree->node_traverse[octree->node_traverse_count++] = curr;
+            sc_octree_traverse_push(output, curr);
             continue;
         }
 
-        // Calculate unit bounding sphere.
-        const sphere3f curr_sphere = sphere3f_from_box3f(curr_bounds);
-        const sphere3f unit_sphere = (sphere3f) {
-            .o = curr_sphere.o,
-            .r = curr_sphere.r / node_unit_count,
+        // Geometric error, as a sphere at the points.
+        const ScOctreeNodeGeometry* curr_geometry = &octree->node_geometry[curr];
+        const sphere3f error_sphere = (sphere3f) {
+            .o = curr_geometry->sphere.o,
+            .r = curr_geometry->spacing,
         };
 
-        // Screen projected sphere area.
+        // Screen projected sphere area, in every view which may see the node.
         // Todo: Can be negative, investigate why.
-        const float sphere_area = sc_screen_projected_sphere_area(camera, unit_sphere);
-        if (sphere_area > 0.0f && sphere_area < lod_bias) {
-            octree->node_traverse[octree->node_traverse_count++] = curr;
+        bool curr_refine = false;
+        for (uint32_t i = 0; i < camera_count && !curr_refine; i++) {
+            if ((curr_views & (1u << i)) == 0) {
+                continue;
+            }
+            const float sphere_area = sc_screen_projected_sphere_area(&cameras[i], error_sphere);
+            curr_refine = !(sphere_area > 0.0f && sphere_area < lod_bias);
+        }
+        if (!curr_refine) {
+            sc_octree_traverse_push(output, curr);
+            traversal->traverse_stats.lod_culled_node_count++;
+            continue;
+        }
+
+        // Split.
+        if (split != NULL && curr_depth == SC_OCTREE_TRAVERSE_SPLIT_DEPTH) {
+            SC_ASSERT(split->count < SC_OCTREE_TRAVERSE_SPLIT_MAX_COUNT);
+            split->nodes[split->count++] = curr;
             continue;
         }
 
@@ -246,7 +1276,1368 @@ static void sc_octree_traverse(ScOctree* octree, const ScOctreeTraverseInfo* tra
                 continue;
             }
             SC_ASSERT(todo_count < SC_COUNTOF(todo));
+            todo_depths[todo_count] = curr_depth + 1;
+            todo_inside[todo_count] = curr_inside;
+            todo_views[todo_count] = (uint8_t)curr_views;
+            todo_views_inside[todo_count] = (uint8_t)curr_views_inside;
             todo[todo_count++] = child;
         }
     }
 }
+
+typedef struct ScOctreeTraverseSplit {
+    const ScOctree* octree;
+    const ScOctreeTraverseInfo* traverse_info;
+    const ScOctreeTraverseViews* views;
+    const uint32_t* roots;
+    ScOctreeTraversal* traversals;
+    ScOctreeTraverseBlocks* blocks;
+    uint32_t* first_blocks;
+} ScOctreeTraverseSplit;
+
+static void sc_octree_traverse_split(void* user_data, uint32_t begin, uint32_t end) {
+    const ScOctreeTraverseSplit* split = user_data;
+    for (uint32_t i = begin; i < end; i++) {
+        ScOctreeTraverseOutput output = {
+            .traversal = &split->traversals[i],
+            .blocks = split->blocks,
+        };
+        sc_octree_traverse_subtree(
+            split->octree,
+            split->traverse_info,
+            split->views,
+            split->roots[i],
+            &output,
+            NULL
+        );
+        split->first_blocks[i] = output.first_block;
+    }
+}
+
+// Only reads the octree, so traversals into different outputs can run concurrently. Large
+// octrees are traversed on job workers, one subtree per job, and the subtrees are appended in
+// order. The scratch for the subtrees comes from the arena as well, without an arena both the
+// output and the scratch are heap-allocated.
+static void sc_octree_traverse(
+    const ScOctree* octree,
+    const ScOctreeTraverseInfo* traverse_info,
+    ScOctreeTraversal* traversal
+) {
+    // Reset.
+    ScArena* arena = traverse_info->arena;
+    *traversal = (ScOctreeTraversal) {0};
+    ScOctreeTraverseOutput output = {.traversal = traversal, .arena = arena};
+
+    // Early out, live octrees start without nodes.
+    if (octree->node_count == 0) {
+        return;
+    }
+
+    // Views.
+    ScOctreeTraverseViews views;
+    sc_octree_traverse_views_new(&views, traverse_info->cameras, traverse_info->camera_count);
+
+    // Serial.
+    if (sc_job_thread_count() == 1 || octree->node_count < SC_OCTREE_TRAVERSE_PARALLEL_NODE_COUNT) {
+        sc_octree_traverse_subtree(octree, traverse_info, &views, 0, &output, NULL);
+        return;
+    }
+
+    // Top levels, collecting the subtrees.
+    ScOctreeTraverseRoots split;
+    split.count = 0;
+    sc_octree_traverse_subtree(octree, traverse_info, &views, 0, &output, &split);
+    if (split.count == 0) {
+        return;
+    }
+
+    // Scratch. The subtrees output at most node_count nodes, and each of them leaves at most one
+    // block partly empty.
+    const uint32_t block_capacity = (uint32_t)((octree->node_count
+                                                + SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT - 1)
+                                               / SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT)
+                                    + split.count;
+    const uint64_t block_node_count =
+        (uint64_t)block_capacity * SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT;
+    ScArena heap_arena = {0};
+    ScArena* scratch_arena = arena;
+    if (scratch_arena == NULL) {
+        sc_arena_new(&heap_arena, (block_node_count + block_capacity) * sizeof(uint32_t));
+        scratch_arena = &heap_arena;
+    }
+    ScOctreeTraverseBlocks blocks = {
+        .nodes = SC_ARENA_ALLOC(scratch_arena, uint32_t, block_node_count),
+        .next_blocks = SC_ARENA_ALLOC(scratch_arena, uint32_t, block_capacity),
+        .block_capacity = block_capacity,
+    };
+
+    // Subtrees.
+    ScOctreeTraversal traversals[SC_OCTREE_TRAVERSE_SPLIT_MAX_COUNT] = {0};
+    uint32_t first_blocks[SC_OCTREE_TRAVERSE_SPLIT_MAX_COUNT];
+    sc_job_parallel_for(
+        sc_octree_traverse_split,
+        &(ScOctreeTraverseSplit) {
+            .octree = octree,
+            .traverse_info = traverse_info,
+            .views = &views,
+            .roots = split.nodes,
+            .traversals = traversals,
+            .blocks = &blocks,
+            .first_blocks = first_blocks,
+        },
+        split.count,
+        1
+    );
+
+    // Merge into a single allocation, subtree roots were visited by both passes.
+    uint32_t node_count = traversal->node_traverse_count;
+    for (uint32_t i = 0; i < split.count; i++) {
+        node_count += traversals[i].node_traverse_count;
+    }
+    uint32_t* node_traverse = arena != NULL ? SC_ARENA_ALLOC(arena, uint32_t, node_count)
+                                            : malloc(node_count * sizeof(uint32_t));
+    uint32_t offset = traversal->node_traverse_count;
+    if (offset > 0) {
+        memcpy(node_traverse, traversal->node_traverse, offset * sizeof(uint32_t));
+    }
+    if (arena == NULL) {
+        free(traversal->node_traverse);
+    }
+    ScOctreeTraverseStats* stats = &traversal->traverse_stats;
+    stats->visited_node_count -= split.count;
+    for (uint32_t i = 0; i < split.count; i++) {
+        const ScOctreeTraversal* subtree = &traversals[i];
+        uint32_t block = first_blocks[i];
+        for (uint32_t j = 0; j < subtree->node_traverse_count;
+             j += SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT) {
+            const uint32_t count =
+                SDL_min(subtree->node_traverse_count - j, SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT);
+            memcpy(
+                &node_traverse[offset],
+                &blocks.nodes[(uint64_t)block * SC_OCTREE_TRAVERSE_BLOCK_NODE_COUNT],
+                count * sizeof(uint32_t)
+            );
+            offset += count;
+            block = blocks.next_blocks[block];
+        }
+        stats->visited_node_count += subtree->traverse_stats.visited_node_count;
+        stats->frustum_culled_node_count += subtree->traverse_stats.frustum_culled_node_count;
+        stats->lod_culled_node_count += subtree->traverse_stats.lod_culled_node_count;
+    }
+    traversal->node_traverse = node_traverse;
+    traversal->node_traverse_count = node_count;
+    traversal->node_traverse_capacity = node_count;
+
+    // Free.
+    if (scratch_arena == &heap_arena) {
+        sc_arena_free(&heap_arena);
+    }
+}
+
+//
+// Octree - live insertion
+//
+
+// Notes:
+// - A live octree starts empty and grows as batches of world-space points are inserted, e.g.
+//   from a scanner. Only the default point format is supported, without attributes.
+// - Every node owns a slot of a power-of-two number of points, from
+//   SC_OCTREE_LIVE_MIN_SLOT_POINT_COUNT up to SC_OCTREE_LIVE_NODE_POINT_COUNT. A full node moves
+//   to a slot twice the size, freed slots are reused by nodes of the same size. With the
+//   positions, slots cost 20 bytes per point, and they are at most twice the points they hold.
+// - Slots never straddle a block of SC_OCTREE_LIVE_BLOCK_POINT_COUNT points, so GPU buffers can
+//   mirror the layout one block per buffer. Only the ranges touched since the last upload are
+//   marked dirty, a node that moved is dirty from its first point.
+// - Node bounds are power-of-two cubes in units, so children split exactly. Unquantized unit
+//   positions are kept next to the points, so a split re-quantizes without losing precision.
+// - Every point ends up in exactly one leaf. A full leaf splits into children. Interior nodes
+//   keep a copy of at most one point per cell of a SC_OCTREE_LIVE_GRID_SIZE^3 grid, which
+//   keeps coarser levels evenly subsampled.
+
+#define SC_OCTREE_LIVE_NODE_POINT_COUNT 16384
+#define SC_OCTREE_LIVE_MIN_SLOT_POINT_COUNT 256
+#define SC_OCTREE_LIVE_SLOT_CLASS_COUNT 7
+#define SC_OCTREE_LIVE_BLOCK_POINT_COUNT (1u << 18)
+#define SC_OCTREE_LIVE_ROOT_UNIT_BITS 20
+#define SC_OCTREE_LIVE_GRID_BITS 5
+#define SC_OCTREE_LIVE_GRID_SIZE (1u << SC_OCTREE_LIVE_GRID_BITS)
+// Leaves this small do not split, further points are dropped.
+#define SC_OCTREE_LIVE_MIN_NODE_UNIT_COUNT (2u * SC_OCTREE_LIVE_GRID_SIZE)
+
+static_assert(
+    SC_OCTREE_LIVE_MIN_SLOT_POINT_COUNT << (SC_OCTREE_LIVE_SLOT_CLASS_COUNT - 1)
+        == SC_OCTREE_LIVE_NODE_POINT_COUNT,
+    "Slot classes must end at the node point count"
+);
+static_assert(
+    SC_OCTREE_LIVE_BLOCK_POINT_COUNT % SC_OCTREE_LIVE_NODE_POINT_COUNT == 0,
+    "Blocks must fit whole slots"
+);
+
+// Position in units, relative to the root minimum.
+typedef struct ScOctreeLivePosition {
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+} ScOctreeLivePosition;
+
+typedef struct ScOctreeLiveNode {
+    uint32_t parent;
+    // Interior nodes, one bit per grid cell. NULL for leaves.
+    uint64_t* grid;
+    // Points in the slot at point_offset, zero until the first point arrives.
+    uint32_t point_capacity;
+    // First point not yet uploaded, UINT32_MAX if clean.
+    uint32_t dirty_point_begin;
+} ScOctreeLiveNode;
+
+typedef struct ScOctreeLive {
+    // Root.
+    vec3f root_world_min;
+    int32_t root_unit_min[3];
+
+    // Nodes.
+    ScOctreeLiveNode* nodes;
+    uint64_t node_capacity;
+
+    // Point slots, allocated up to point_end. Freed slots are listed by size class.
+    ScOctreeLivePosition* positions;
+    uint64_t point_end;
+    uint64_t point_capacity;
+    uint64_t* free_slots[SC_OCTREE_LIVE_SLOT_CLASS_COUNT];
+    uint32_t free_slot_counts[SC_OCTREE_LIVE_SLOT_CLASS_COUNT];
+    uint32_t free_slot_capacities[SC_OCTREE_LIVE_SLOT_CLASS_COUNT];
+
+    // Dirty state, cleared by the consumer after uploading.
+    uint32_t* dirty_nodes;
+    uint32_t dirty_node_count;
+    uint32_t dirty_instance_begin;
+
+    // Statistics.
+    uint64_t inserted_point_count;
+    uint64_t dropped_point_count;
+} ScOctreeLive;
+
+static void sc_octree_live_new(ScOctree* octree, box3f world_bounds) {
+    // Root cube, padded so points on the max faces fall inside.
+    const vec3f world_extents = box3f_extents(world_bounds);
+    const float world_extent =
+        1.001f * SDL_max(SDL_max(world_extents.x, world_extents.y), world_extents.z);
+    const float node_world_scale = world_extent / (float)(1u << SC_OCTREE_LIVE_ROOT_UNIT_BITS);
+    SC_ASSERT(node_world_scale > 0.0f);
+
+    // Octree.
+    SDL_zerop(octree);
+    octree->unit_world_scale = node_world_scale;
+    // Interior nodes are sampled on the grid, so that is the spacing of their points.
+    octree->node_unit_count = (float)SC_OCTREE_LIVE_GRID_SIZE;
+    octree->node_world_scale = node_world_scale;
+    octree->point_format = SC_OCTREE_POINT_FORMAT_DEFAULT;
+    // Stays the requested volume, cameras frame it before any points arrive.
+    octree->point_bounds = world_bounds;
+
+    // Live state.
+    ScOctreeLive* live = calloc(1, sizeof(ScOctreeLive));
+    for (uint32_t i = 0; i < 3; i++) {
+        const float world_min = (&world_bounds.mn.x)[i];
+        const float unit_min = SDL_floorf(world_min / node_world_scale);
+        SC_ASSERT(SDL_fabsf(unit_min) < (float)(1u << 30));
+        live->root_unit_min[i] = (int32_t)unit_min;
+        (&live->root_world_min.x)[i] = unit_min * node_world_scale;
+    }
+    live->dirty_instance_begin = UINT32_MAX;
+    octree->live = live;
+}
+
+static void sc_octree_live_free(ScOctreeLive* live, uint64_t node_count) {
+    for (uint64_t i = 0; i < node_count; i++) {
+        free(live->nodes[i].grid);
+    }
+    free(live->nodes);
+    free(live->positions);
+    for (uint32_t i = 0; i < SC_OCTREE_LIVE_SLOT_CLASS_COUNT; i++) {
+        free(live->free_slots[i]);
+    }
+    free(live->dirty_nodes);
+    free(live);
+}
+
+static void sc_octree_live_dirty(ScOctreeLive* live, uint32_t node_idx, uint32_t point_begin) {
+    ScOctreeLiveNode* live_node = &live->nodes[node_idx];
+    if (live_node->dirty_point_begin == UINT32_MAX) {
+        live->dirty_nodes[live->dirty_node_count++] = node_idx;
+    }
+    live_node->dirty_point_begin = SDL_min(live_node->dirty_point_begin, point_begin);
+}
+
+static uint32_t sc_octree_live_slot_class(uint32_t point_capacity) {
+    return (uint32_t)SDL_MostSignificantBitIndex32(
+        point_capacity / SC_OCTREE_LIVE_MIN_SLOT_POINT_COUNT
+    );
+}
+
+// Returns the point offset of a new slot, reusing a freed one of the same size if possible.
+static uint64_t sc_octree_live_slot_alloc(ScOctree* octree, uint32_t point_capacity) {
+    // Reuse.
+    ScOctreeLive* live = octree->live;
+    const uint32_t slot_class = sc_octree_live_slot_class(point_capacity);
+    if (live->free_slot_counts[slot_class] > 0) {
+        return live->free_slots[slot_class][--live->free_slot_counts[slot_class]];
+    }
+
+    // Append, skipping to the next block instead of straddling it.
+    uint64_t point_offset = live->point_end;
+    if (point_offset % SC_OCTREE_LIVE_BLOCK_POINT_COUNT + point_capacity
+        > SC_OCTREE_LIVE_BLOCK_POINT_COUNT) {
+        point_offset = (point_offset / SC_OCTREE_LIVE_BLOCK_POINT_COUNT + 1)
+                       * SC_OCTREE_LIVE_BLOCK_POINT_COUNT;
+    }
+    live->point_end = point_offset + point_capacity;
+
+    // Grow.
+    if (live->point_end > live->point_capacity) {
+        uint64_t capacity = SDL_max(live->point_capacity, SC_OCTREE_LIVE_BLOCK_POINT_COUNT);
+        while (capacity < live->point_end) {
+            capacity *= 2;
+        }
+        octree->points = realloc(octree->points, capacity * sizeof(ScOctreePoint));
+        live->positions = realloc(live->positions, capacity * sizeof(ScOctreeLivePosition));
+        SC_ASSERT(octree->points != NULL && live->positions != NULL);
+        live->point_capacity = capacity;
+    }
+    return point_offset;
+}
+
+static void
+sc_octree_live_slot_free(ScOctreeLive* live, uint64_t point_offset, uint32_t point_capacity) {
+    const uint32_t slot_class = sc_octree_live_slot_class(point_capacity);
+    if (live->free_slot_counts[slot_class] == live->free_slot_capacities[slot_class]) {
+        const uint32_t capacity = SDL_max(2 * live->free_slot_capacities[slot_class], 64);
+        live->free_slots[slot_class] =
+            realloc(live->free_slots[slot_class], capacity * sizeof(uint64_t));
+        SC_ASSERT(live->free_slots[slot_class] != NULL);
+        live->free_slot_capacities[slot_class] = capacity;
+    }
+    live->free_slots[slot_class][live->free_slot_counts[slot_class]++] = point_offset;
+}
+
+// Moves the points of a full node to a slot twice the size, or gives an empty node its first.
+static void sc_octree_live_node_grow(ScOctree* octree, uint32_t node_idx) {
+    // Allocate.
+    ScOctreeLive* live = octree->live;
+    ScOctreeLiveNode* live_node = &live->nodes[node_idx];
+    const uint32_t point_capacity = live_node->point_capacity == 0
+                                        ? SC_OCTREE_LIVE_MIN_SLOT_POINT_COUNT
+                                        : 2 * live_node->point_capacity;
+    SC_ASSERT(point_capacity <= SC_OCTREE_LIVE_NODE_POINT_COUNT);
+    const uint64_t point_offset = sc_octree_live_slot_alloc(octree, point_capacity);
+
+    // Move.
+    ScOctreeNode* node = &octree->nodes[node_idx];
+    if (live_node->point_capacity > 0) {
+        memcpy(
+            &octree->points[point_offset],
+            &octree->points[node->point_offset],
+            node->point_count * sizeof(ScOctreePoint)
+        );
+        memcpy(
+            &live->positions[point_offset],
+            &live->positions[node->point_offset],
+            node->point_count * sizeof(ScOctreeLivePosition)
+        );
+        sc_octree_live_slot_free(live, node->point_offset, live_node->point_capacity);
+    }
+    node->point_offset = point_offset;
+    live_node->point_capacity = point_capacity;
+    sc_octree_live_dirty(live, node_idx, 0);
+}
+
+// Called after the dirty ranges and node instances have been uploaded.
+static void sc_octree_live_dirty_clear(ScOctree* octree) {
+    ScOctreeLive* live = octree->live;
+    for (uint32_t i = 0; i < live->dirty_node_count; i++) {
+        live->nodes[live->dirty_nodes[i]].dirty_point_begin = UINT32_MAX;
+    }
+    live->dirty_node_count = 0;
+    live->dirty_instance_begin = UINT32_MAX;
+}
+
+static uint32_t sc_octree_live_node_new(
+    ScOctree* octree,
+    uint32_t parent,
+    const int32_t unit_min[3],
+    int32_t unit_size
+) {
+    // Grow.
+    ScOctreeLive* live = octree->live;
+    const uint32_t node_idx = (uint32_t)octree->node_count;
+    if (octree->node_count == live->node_capacity) {
+        const uint64_t capacity = SDL_max(2 * live->node_capacity, 64);
+        octree->nodes = realloc(octree->nodes, capacity * sizeof(ScOctreeNode));
+        octree->node_instances =
+            realloc(octree->node_instances, capacity * sizeof(ScOctreeNodeInstance));
+        octree->node_geometry =
+            realloc(octree->node_geometry, capacity * sizeof(ScOctreeNodeGeometry));
+        live->nodes = realloc(live->nodes, capacity * sizeof(ScOctreeLiveNode));
+        live->dirty_nodes = realloc(live->dirty_nodes, capacity * sizeof(uint32_t));
+        SC_ASSERT(octree->nodes != NULL && octree->node_instances != NULL);
+        SC_ASSERT(octree->node_geometry != NULL);
+        SC_ASSERT(live->nodes != NULL && live->dirty_nodes != NULL);
+        live->node_capacity = capacity;
+    }
+    octree->node_count++;
+
+    // Node.
+    ScOctreeNode* node = &octree->nodes[node_idx];
+    *node = (ScOctreeNode) {
+        .min_x = unit_min[0],
+        .min_y = unit_min[1],
+        .min_z = unit_min[2],
+        .max_x = unit_min[0] + unit_size,
+        .max_y = unit_min[1] + unit_size,
+        .max_z = unit_min[2] + unit_size,
+        .level = 0,
+        .octant_mask = 0,
+        .point_count = 0,
+        .point_offset = 0,
+    };
+    memset(node->octants, 0xff, sizeof(node->octants));
+    octree->node_instances[node_idx] = (ScOctreeNodeInstance) {
+        .min_x = (float)node->min_x,
+        .min_y = (float)node->min_y,
+        .min_z = (float)node->min_z,
+        .max_x = (float)node->max_x,
+        .max_y = (float)node->max_y,
+        .max_z = (float)node->max_z,
+    };
+    // Interior nodes are sampled on the grid, so the cube estimate is their spacing.
+    octree->node_geometry[node_idx] = sc_octree_node_geometry_from_cube(octree, node_idx);
+    live->nodes[node_idx] = (ScOctreeLiveNode) {
+        .parent = parent,
+        .grid = NULL,
+        .point_capacity = 0,
+        .dirty_point_begin = UINT32_MAX,
+    };
+    live->dirty_instance_begin = SDL_min(live->dirty_instance_begin, node_idx);
+    return node_idx;
+}
+
+// Quantizes to 10 bits per axis over the node bounds, decoded as min + q / 1023 * extent.
+static SC_INLINE void sc_octree_live_node_append(
+    ScOctree* octree,
+    uint32_t node_idx,
+    ScOctreeLivePosition position,
+    uint32_t color
+) {
+    ScOctreeLive* live = octree->live;
+    ScOctreeNode* node = &octree->nodes[node_idx];
+    if (node->point_count == live->nodes[node_idx].point_capacity) {
+        sc_octree_live_node_grow(octree, node_idx);
+    }
+    const uint32_t* root_unit_min = (const uint32_t*)live->root_unit_min;
+    const uint64_t size = (uint64_t)(node->max_x - node->min_x);
+    const uint64_t x = position.x - ((uint32_t)node->min_x - root_unit_min[0]);
+    const uint64_t y = position.y - ((uint32_t)node->min_y - root_unit_min[1]);
+    const uint64_t z = position.z - ((uint32_t)node->min_z - root_unit_min[2]);
+    const uint32_t qx = (uint32_t)((x * 1023 + size / 2) / size);
+    const uint32_t qy = (uint32_t)((y * 1023 + size / 2) / size);
+    const uint32_t qz = (uint32_t)((z * 1023 + size / 2) / size);
+    const uint64_t point_idx = node->point_offset + node->point_count;
+    octree->points[point_idx] = (ScOctreePoint) {
+        .position = qx | qy << 10 | qz << 20,
+        .color = color,
+    };
+    live->positions[point_idx] = position;
+    sc_octree_live_dirty(live, node_idx, node->point_count);
+    node->point_count++;
+    octree->point_count++;
+}
+
+static bool sc_octree_live_insert_from(
+    ScOctree* octree,
+    uint32_t node_idx,
+    ScOctreeLivePosition position,
+    uint32_t color
+);
+
+// Turns a full leaf into an interior node and pushes its points down again.
+static void sc_octree_live_node_split(ScOctree* octree, uint32_t node_idx) {
+    // Take the points out.
+    ScOctreeLive* live = octree->live;
+    ScOctreeNode* node = &octree->nodes[node_idx];
+    const uint32_t point_count = node->point_count;
+    ScOctreeLivePosition* positions = malloc(point_count * sizeof(ScOctreeLivePosition));
+    uint32_t* colors = malloc(point_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < point_count; i++) {
+        positions[i] = live->positions[node->point_offset + i];
+        colors[i] = octree->points[node->point_offset + i].color;
+    }
+    octree->point_count -= point_count;
+    node->point_count = 0;
+    sc_octree_live_dirty(live, node_idx, 0);
+
+    // Free the slot, the interior samples start small again.
+    sc_octree_live_slot_free(live, node->point_offset, live->nodes[node_idx].point_capacity);
+    live->nodes[node_idx].point_capacity = 0;
+
+    // Interior, levels count up from the leaves.
+    const uint64_t grid_word_count =
+        (SC_OCTREE_LIVE_GRID_SIZE * SC_OCTREE_LIVE_GRID_SIZE * SC_OCTREE_LIVE_GRID_SIZE) / 64;
+    live->nodes[node_idx].grid = calloc(grid_word_count, sizeof(uint64_t));
+    node->level = 1;
+    for (uint32_t curr = node_idx; curr != 0;) {
+        const uint32_t parent = live->nodes[curr].parent;
+        const uint16_t level = (uint16_t)(octree->nodes[curr].level + 1);
+        if (octree->nodes[parent].level >= level) {
+            break;
+        }
+        octree->nodes[parent].level = level;
+        curr = parent;
+    }
+
+    // Reinsert.
+    for (uint32_t i = 0; i < point_count; i++) {
+        sc_octree_live_insert_from(octree, node_idx, positions[i], colors[i]);
+    }
+    free(positions);
+    free(colors);
+}
+
+static bool sc_octree_live_insert_from(
+    ScOctree* octree,
+    uint32_t node_idx,
+    ScOctreeLivePosition position,
+    uint32_t color
+) {
+    ScOctreeLive* live = octree->live;
+    const uint32_t* root_unit_min = (const uint32_t*)live->root_unit_min;
+    for (;;) {
+        // Unpack.
+        ScOctreeNode* node = &octree->nodes[node_idx];
+        const uint32_t size = (uint32_t)(node->max_x - node->min_x);
+        const uint32_t x = position.x - ((uint32_t)node->min_x - root_unit_min[0]);
+        const uint32_t y = position.y - ((uint32_t)node->min_y - root_unit_min[1]);
+        const uint32_t z = position.z - ((uint32_t)node->min_z - root_unit_min[2]);
+
+        // Leaf.
+        if (node->level == 0) {
+            if (node->point_count < SC_OCTREE_LIVE_NODE_POINT_COUNT) {
+                sc_octree_live_node_append(octree, node_idx, position, color);
+                return true;
+            }
+            if (size < SC_OCTREE_LIVE_MIN_NODE_UNIT_COUNT) {
+                return false;
+            }
+            sc_octree_live_node_split(octree, node_idx);
+            node = &octree->nodes[node_idx];
+        }
+
+        // Interior, keep a copy if the grid cell is empty.
+        const uint32_t size_bits = (uint32_t)SDL_MostSignificantBitIndex32(size);
+        const uint32_t cell_shift = size_bits - SC_OCTREE_LIVE_GRID_BITS;
+        const uint32_t cell = (x >> cell_shift)
+                              | (y >> cell_shift) << SC_OCTREE_LIVE_GRID_BITS
+                              | (z >> cell_shift) << (2 * SC_OCTREE_LIVE_GRID_BITS);
+        uint64_t* grid = live->nodes[node_idx].grid;
+        const uint64_t cell_bit = 1ull << (cell & 63);
+        if ((grid[cell >> 6] & cell_bit) == 0
+            && node->point_count < SC_OCTREE_LIVE_NODE_POINT_COUNT) {
+            grid[cell >> 6] |= cell_bit;
+            sc_octree_live_node_append(octree, node_idx, position, color);
+        }
+
+        // Descend, creating the child on demand.
+        const uint32_t half = size / 2;
+        const uint32_t octant = (uint32_t)(x >= half) | (uint32_t)(y >= half) << 1
+                                | (uint32_t)(z >= half) << 2;
+        uint32_t child = node->octants[octant];
+        if (child == ~0u) {
+            const int32_t child_unit_min[3] = {
+                node->min_x + (int32_t)((octant & 1) * half),
+                node->min_y + (int32_t)(((octant >> 1) & 1) * half),
+                node->min_z + (int32_t)(((octant >> 2) & 1) * half),
+            };
+            child = sc_octree_live_node_new(octree, node_idx, child_unit_min, (int32_t)half);
+            node = &octree->nodes[node_idx];
+            node->octants[octant] = child;
+            node->octant_mask |= (uint16_t)(1u << octant);
+        }
+        node_idx = child;
+    }
+}
+
+// Inserts world-space points with RGBA8 colors, returns the number of points inserted. Points
+// outside the live bounds, or landing in a full leaf that cannot split, are dropped.
+static uint64_t sc_octree_insert(
+    ScOctree* octree,
+    const vec3f* positions,
+    const uint32_t* colors,
+    uint64_t point_count
+) {
+    // Unpack.
+    ScOctreeLive* live = octree->live;
+    SC_ASSERT(live != NULL);
+    const float unit_from_world = 1.0f / octree->node_world_scale;
+    const float unit_max = (float)(1u << SC_OCTREE_LIVE_ROOT_UNIT_BITS);
+
+    // Root.
+    if (octree->node_count == 0) {
+        sc_octree_live_node_new(
+            octree,
+            0,
+            live->root_unit_min,
+            (int32_t)(1u << SC_OCTREE_LIVE_ROOT_UNIT_BITS)
+        );
+    }
+
+    // Insert.
+    uint64_t inserted_point_count = 0;
+    for (uint64_t i = 0; i < point_count; i++) {
+        const float x = (positions[i].x - live->root_world_min.x) * unit_from_world;
+        const float y = (positions[i].y - live->root_world_min.y) * unit_from_world;
+        const float z = (positions[i].z - live->root_world_min.z) * unit_from_world;
+        if (!(x >= 0.0f && y >= 0.0f && z >= 0.0f && x < unit_max && y < unit_max
+              && z < unit_max)) {
+            continue;
+        }
+        const ScOctreeLivePosition position = {(uint32_t)x, (uint32_t)y, (uint32_t)z};
+        inserted_point_count += sc_octree_live_insert_from(octree, 0, position, colors[i]);
+    }
+    live->inserted_point_count += inserted_point_count;
+    live->dropped_point_count += point_count - inserted_point_count;
+    return inserted_point_count;
+}
+
+// Notes:
+// - Resampling rewrites the points of interior nodes from the leaves, which are kept as they
+//   are. Levels are processed bottom-up and every interior node subsamples the new points of
+//   its children, so no level reads more than the points of the level below.
+// - Voxel grid keeps the point closest to the center of every occupied cell of a grid_size^3
+//   grid over the node cube. Poisson disk keeps points at least one cell apart, visited in a
+//   scattered order, which avoids grid patterns at the cost of somewhat fewer points.
+// - The source is not loaded, only its nodes and tables. Leaf points and attributes are read
+//   from disk when their parent is resampled, and again when the output is written front to
+//   back. Memory is bounded by the new interior points plus the children of one node per
+//   worker, not by the size of the file. Unquantized positions are only kept until the parent
+//   level is done.
+// - The nodes of a level run in parallel, each worker with its own file handle.
+// - Points are laid out in node order. Interior points carry the attributes of the leaf points
+//   they were sampled from, packed per point in enum order.
+
+#define SC_OCTREE_RESAMPLE_GRID_SIZE 128
+#define SC_OCTREE_RESAMPLE_MAX_GRID_SIZE 1024
+#define SC_OCTREE_RESAMPLE_EMPTY_CELL UINT64_MAX
+// Poisson disk cells are the radius over sqrt(3), so a cell holds at most one point and
+// neighbours within the radius are at most this many cells away.
+#define SC_OCTREE_RESAMPLE_POISSON_CELL_REACH 2
+
+typedef enum ScOctreeResampleMethod {
+    SC_OCTREE_RESAMPLE_METHOD_VOXEL_GRID,
+    SC_OCTREE_RESAMPLE_METHOD_POISSON_DISK,
+    SC_OCTREE_RESAMPLE_METHOD_COUNT,
+} ScOctreeResampleMethod;
+
+static const char* SC_OCTREE_RESAMPLE_METHOD_NAME[] = {
+    "voxel",
+    "poisson",
+};
+
+typedef struct ScOctreeResampleInfo {
+    ScOctreeResampleMethod method;
+    // Cells per node edge, the Poisson disk radius is one cell.
+    uint32_t grid_size;
+} ScOctreeResampleInfo;
+
+// New points of an interior node.
+typedef struct ScOctreeResampleNode {
+    ScOctreePoint* points;
+    // Unquantized, in units relative to the node minimum.
+    vec3f* positions;
+    // Attributes of the leaf points, attribute_byte_count per point.
+    uint8_t* attributes;
+    uint32_t point_count;
+} ScOctreeResampleNode;
+
+typedef struct ScOctreeResample {
+    // Source, its nodes and tables are loaded but not its points.
+    const ScOctree* source;
+    ScOctreeResampleInfo info;
+    uint32_t attribute_offsets[SC_OCTREE_ATTRIBUTE_COUNT];
+    uint32_t attribute_byte_count;
+
+    // New points, per node.
+    ScOctreeResampleNode* nodes;
+    // Nodes of the level being processed.
+    const uint32_t* level_nodes;
+
+    // Output, the source nodes with the new point counts and offsets. Node geometry is measured
+    // while writing.
+    ScOctreeNode* output_nodes;
+    ScOctreeNodeGeometry* output_node_geometry;
+    uint64_t output_point_count;
+} ScOctreeResample;
+
+// Per worker, grown to the largest node seen.
+typedef struct ScOctreeResampleScratch {
+    // Candidates, the points of the children.
+    vec3f* positions;
+    uint32_t* colors;
+    uint8_t* attributes;
+    uint32_t* selected;
+    uint32_t capacity;
+
+    // Leaf streams, read from disk.
+    SDL_IOStream* io;
+    uint8_t* read_data;
+    uint64_t read_capacity;
+
+    // Occupied cells, open addressing.
+    uint64_t* cell_keys;
+    uint32_t* cell_values;
+    uint32_t cell_mask;
+    uint32_t cell_capacity;
+} ScOctreeResampleScratch;
+
+static void sc_octree_resample_scratch_reserve(
+    ScOctreeResampleScratch* scratch,
+    uint32_t count,
+    uint32_t attribute_byte_count
+) {
+    // Candidates.
+    if (count > scratch->capacity) {
+        scratch->capacity = count;
+        scratch->positions = realloc(scratch->positions, count * sizeof(vec3f));
+        scratch->colors = realloc(scratch->colors, count * sizeof(uint32_t));
+        scratch->attributes =
+            realloc(scratch->attributes, SDL_max((uint64_t)count * attribute_byte_count, 1));
+        scratch->selected = realloc(scratch->selected, count * sizeof(uint32_t));
+        SC_ASSERT(scratch->positions != NULL && scratch->colors != NULL);
+        SC_ASSERT(scratch->attributes != NULL && scratch->selected != NULL);
+    }
+
+    // Cells, at most half full.
+    uint32_t cell_count = 64;
+    while (cell_count < 2 * count) {
+        cell_count *= 2;
+    }
+    if (cell_count > scratch->cell_capacity) {
+        scratch->cell_capacity = cell_count;
+        scratch->cell_keys = realloc(scratch->cell_keys, cell_count * sizeof(uint64_t));
+        scratch->cell_values = realloc(scratch->cell_values, cell_count * sizeof(uint32_t));
+        SC_ASSERT(scratch->cell_keys != NULL && scratch->cell_values != NULL);
+    }
+    scratch->cell_mask = cell_count - 1;
+    memset(scratch->cell_keys, 0xff, cell_count * sizeof(uint64_t));
+}
+
+static void sc_octree_resample_scratch_free(ScOctreeResampleScratch* scratch) {
+    free(scratch->positions);
+    free(scratch->colors);
+    free(scratch->attributes);
+    free(scratch->selected);
+    free(scratch->read_data);
+    free(scratch->cell_keys);
+    free(scratch->cell_values);
+}
+
+// Slot of the key, or of the empty slot where it would go.
+static SC_INLINE uint32_t
+sc_octree_resample_cell_slot(const ScOctreeResampleScratch* scratch, uint64_t key) {
+    uint32_t slot = (uint32_t)((key * 0x9e3779b97f4a7c15ull) >> 32) & scratch->cell_mask;
+    while (scratch->cell_keys[slot] != key
+           && scratch->cell_keys[slot] != SC_OCTREE_RESAMPLE_EMPTY_CELL) {
+        slot = (slot + 1) & scratch->cell_mask;
+    }
+    return slot;
+}
+
+// Gathers the points of the children relative to the node minimum, returns the count. Leaves are
+// read from disk.
+static uint32_t sc_octree_resample_gather(
+    const ScOctreeResample* resample,
+    uint32_t node_idx,
+    ScOctreeResampleScratch* scratch
+) {
+    // Count.
+    const ScOctree* octree = resample->source;
+    const uint32_t attribute_byte_count = resample->attribute_byte_count;
+    const ScOctreeNode* node = &octree->nodes[node_idx];
+    uint64_t count = 0;
+    for (uint32_t octant = 0; octant < 8; octant++) {
+        const uint32_t child_idx = node->octants[octant];
+        if (child_idx == ~0u) {
+            continue;
+        }
+        const ScOctreeNode* child = &octree->nodes[child_idx];
+        count += child->level == 0 ? child->point_count : resample->nodes[child_idx].point_count;
+    }
+    SC_ASSERT(count <= UINT32_MAX / 4);
+    sc_octree_resample_scratch_reserve(scratch, (uint32_t)count, attribute_byte_count);
+
+    // Gather.
+    uint32_t candidate_idx = 0;
+    for (uint32_t octant = 0; octant < 8; octant++) {
+        const uint32_t child_idx = node->octants[octant];
+        if (child_idx == ~0u) {
+            continue;
+        }
+        const ScOctreeNode* child = &octree->nodes[child_idx];
+        const vec3f child_offset = {
+            (float)(child->min_x - node->min_x),
+            (float)(child->min_y - node->min_y),
+            (float)(child->min_z - node->min_z),
+        };
+
+        // Leaves decode as min + q / 1023 * extent.
+        if (child->level == 0) {
+            const vec3f step = {
+                (float)(child->max_x - child->min_x) / 1023.0f,
+                (float)(child->max_y - child->min_y) / 1023.0f,
+                (float)(child->max_z - child->min_z) / 1023.0f,
+            };
+            sc_octree_stream_read(
+                scratch->io,
+                sc_octree_point_file_offset(octree),
+                sc_octree_point_stride(octree->point_format),
+                child->point_offset,
+                child->point_count,
+                &scratch->read_data,
+                &scratch->read_capacity
+            );
+            for (uint32_t i = 0; i < child->point_count; i++) {
+                const ScOctreePoint point =
+                    octree->point_format == SC_OCTREE_POINT_FORMAT_COMPACT
+                        ? sc_octree_point_expand(((ScOctreePointCompact*)scratch->read_data)[i])
+                        : ((ScOctreePoint*)scratch->read_data)[i];
+                scratch->positions[candidate_idx + i] = (vec3f) {
+                    child_offset.x + step.x * (float)(point.position & 1023),
+                    child_offset.y + step.y * (float)((point.position >> 10) & 1023),
+                    child_offset.z + step.z * (float)((point.position >> 20) & 1023),
+                };
+                scratch->colors[candidate_idx + i] = point.color;
+            }
+
+            // Attributes, each stream into its slot of the packed records.
+            for (uint32_t a = 0; a < SC_OCTREE_ATTRIBUTE_COUNT; a++) {
+                if (!sc_octree_attribute_available(octree, (ScOctreeAttribute)a)) {
+                    continue;
+                }
+                const uint32_t stride = SC_OCTREE_ATTRIBUTE_STRIDE[a];
+                sc_octree_stream_read(
+                    scratch->io,
+                    octree->attribute_file_offsets[a],
+                    stride,
+                    child->point_offset,
+                    child->point_count,
+                    &scratch->read_data,
+                    &scratch->read_capacity
+                );
+                uint8_t* dst = scratch->attributes
+                               + (uint64_t)candidate_idx * attribute_byte_count
+                               + resample->attribute_offsets[a];
+                for (uint32_t i = 0; i < child->point_count; i++) {
+                    memcpy(
+                        dst + (uint64_t)i * attribute_byte_count,
+                        scratch->read_data + (uint64_t)i * stride,
+                        stride
+                    );
+                }
+            }
+            candidate_idx += child->point_count;
+            continue;
+        }
+
+        // Interior children were resampled on the previous levels.
+        const ScOctreeResampleNode* resampled = &resample->nodes[child_idx];
+        for (uint32_t i = 0; i < resampled->point_count; i++) {
+            scratch->positions[candidate_idx + i] =
+                vec3f_add(child_offset, resampled->positions[i]);
+            scratch->colors[candidate_idx + i] = resampled->points[i].color;
+        }
+        if (attribute_byte_count > 0) {
+            memcpy(
+                scratch->attributes + (uint64_t)candidate_idx * attribute_byte_count,
+                resampled->attributes,
+                (uint64_t)resampled->point_count * attribute_byte_count
+            );
+        }
+        candidate_idx += resampled->point_count;
+    }
+    return candidate_idx;
+}
+
+// Position in cells, clamped to the grid.
+static SC_INLINE vec3f
+sc_octree_resample_cell_position(vec3f position, vec3f cells_per_unit, float cell_max) {
+    return (vec3f) {
+        SDL_clamp(position.x * cells_per_unit.x, 0.0f, cell_max),
+        SDL_clamp(position.y * cells_per_unit.y, 0.0f, cell_max),
+        SDL_clamp(position.z * cells_per_unit.z, 0.0f, cell_max),
+    };
+}
+
+// Keeps the candidate closest to the center of every occupied cell, returns the count.
+static uint32_t sc_octree_resample_voxel_grid(
+    ScOctreeResampleScratch* scratch,
+    uint32_t candidate_count,
+    vec3f extents,
+    uint32_t grid_size
+) {
+    // Unpack.
+    const float cell_max = (float)(grid_size - 1);
+    const vec3f cells_per_unit = {
+        extents.x > 0.0f ? (float)grid_size / extents.x : 0.0f,
+        extents.y > 0.0f ? (float)grid_size / extents.y : 0.0f,
+        extents.z > 0.0f ? (float)grid_size / extents.z : 0.0f,
+    };
+
+    // Bin, distances are in cells.
+    uint32_t selected_count = 0;
+    for (uint32_t i = 0; i < candidate_count; i++) {
+        const vec3f cell =
+            sc_octree_resample_cell_position(scratch->positions[i], cells_per_unit, cell_max);
+        const uint32_t cx = (uint32_t)cell.x;
+        const uint32_t cy = (uint32_t)cell.y;
+        const uint32_t cz = (uint32_t)cell.z;
+        const uint64_t key = (uint64_t)cx | (uint64_t)cy << 20 | (uint64_t)cz << 40;
+        const uint32_t slot = sc_octree_resample_cell_slot(scratch, key);
+        if (scratch->cell_keys[slot] == SC_OCTREE_RESAMPLE_EMPTY_CELL) {
+            scratch->cell_keys[slot] = key;
+            scratch->cell_values[slot] = selected_count;
+            scratch->selected[selected_count++] = i;
+            continue;
+        }
+
+        // Occupied, keep whichever is closer to the center.
+        const vec3f center = {(float)cx + 0.5f, (float)cy + 0.5f, (float)cz + 0.5f};
+        uint32_t* kept_idx = &scratch->selected[scratch->cell_values[slot]];
+        const vec3f kept_cell = sc_octree_resample_cell_position(
+            scratch->positions[*kept_idx],
+            cells_per_unit,
+            cell_max
+        );
+        const vec3f offset = vec3f_sub(cell, center);
+        const vec3f kept_offset = vec3f_sub(kept_cell, center);
+        if (vec3f_dot(offset, offset) < vec3f_dot(kept_offset, kept_offset)) {
+            *kept_idx = i;
+        }
+    }
+    return selected_count;
+}
+
+static uint32_t sc_octree_resample_gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        const uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// Dart throwing with radius extent / grid_size, returns the count. Candidates are visited with
+// a stride coprime to their count, which scatters the order without any extra memory.
+static uint32_t sc_octree_resample_poisson_disk(
+    ScOctreeResampleScratch* scratch,
+    uint32_t candidate_count,
+    vec3f extents,
+    uint32_t grid_size
+) {
+    // Unpack.
+    const float extent = SDL_max(SDL_max(extents.x, extents.y), extents.z);
+    if (candidate_count == 0) {
+        return 0;
+    }
+    if (extent <= 0.0f) {
+        scratch->selected[0] = 0;
+        return 1;
+    }
+    const float radius = extent / (float)grid_size;
+    const float radius_squared = radius * radius;
+    const float cells_per_unit = sqrtf(3.0f) / radius;
+    const int32_t cell_count = (int32_t)ceilf(extent * cells_per_unit);
+    const int32_t reach = SC_OCTREE_RESAMPLE_POISSON_CELL_REACH;
+
+    // Visiting order.
+    uint32_t stride = (uint32_t)(0.618034 * (double)candidate_count) | 1;
+    while (sc_octree_resample_gcd(stride, candidate_count) != 1) {
+        stride += 2;
+    }
+
+    // Throw.
+    uint32_t selected_count = 0;
+    for (uint32_t n = 0; n < candidate_count; n++) {
+        // Cell.
+        const uint32_t i = (uint32_t)(((uint64_t)n * stride) % candidate_count);
+        const vec3f position = scratch->positions[i];
+        const int32_t cell[3] = {
+            SDL_clamp((int32_t)(position.x * cells_per_unit), 0, cell_count - 1),
+            SDL_clamp((int32_t)(position.y * cells_per_unit), 0, cell_count - 1),
+            SDL_clamp((int32_t)(position.z * cells_per_unit), 0, cell_count - 1),
+        };
+
+        // Reject if any accepted point is within the radius.
+        bool accepted = true;
+        for (int32_t dz = -reach; dz <= reach && accepted; dz++) {
+            for (int32_t dy = -reach; dy <= reach && accepted; dy++) {
+                for (int32_t dx = -reach; dx <= reach && accepted; dx++) {
+                    const int32_t x = cell[0] + dx;
+                    const int32_t y = cell[1] + dy;
+                    const int32_t z = cell[2] + dz;
+                    if (x < 0 || y < 0 || z < 0 || x >= cell_count || y >= cell_count
+                        || z >= cell_count) {
+                        continue;
+                    }
+                    const uint64_t key = (uint64_t)x | (uint64_t)y << 20 | (uint64_t)z << 40;
+                    const uint32_t slot = sc_octree_resample_cell_slot(scratch, key);
+                    if (scratch->cell_keys[slot] == SC_OCTREE_RESAMPLE_EMPTY_CELL) {
+                        continue;
+                    }
+                    const vec3f neighbour = scratch->positions[scratch->cell_values[slot]];
+                    const vec3f offset = vec3f_sub(neighbour, position);
+                    accepted = vec3f_dot(offset, offset) >= radius_squared;
+                }
+            }
+        }
+        if (!accepted) {
+            continue;
+        }
+
+        // Accept.
+        const uint64_t key =
+            (uint64_t)cell[0] | (uint64_t)cell[1] << 20 | (uint64_t)cell[2] << 40;
+        const uint32_t slot = sc_octree_resample_cell_slot(scratch, key);
+        scratch->cell_keys[slot] = key;
+        scratch->cell_values[slot] = i;
+        scratch->selected[selected_count++] = i;
+    }
+    return selected_count;
+}
+
+static void sc_octree_resample_level(void* user_data, uint32_t begin, uint32_t end) {
+    ScOctreeResample* resample = user_data;
+    const ScOctree* octree = resample->source;
+    const ScOctreeResampleInfo* info = &resample->info;
+    const uint32_t attribute_byte_count = resample->attribute_byte_count;
+    ScOctreeResampleScratch scratch = {0};
+    scratch.io = SDL_IOFromFile(octree->file_path, "rb");
+    SC_SDL_ASSERT(scratch.io != NULL);
+    for (uint32_t i = begin; i < end; i++) {
+        // Unpack.
+        const uint32_t node_idx = resample->level_nodes[i];
+        const ScOctreeNode* node = &octree->nodes[node_idx];
+        const vec3f extents = {
+            (float)(node->max_x - node->min_x),
+            (float)(node->max_y - node->min_y),
+            (float)(node->max_z - node->min_z),
+        };
+
+        // Select.
+        const uint32_t candidate_count = sc_octree_resample_gather(resample, node_idx, &scratch);
+        uint32_t count = 0;
+        switch (info->method) {
+            case SC_OCTREE_RESAMPLE_METHOD_VOXEL_GRID:
+                count = sc_octree_resample_voxel_grid(
+                    &scratch,
+                    candidate_count,
+                    extents,
+                    info->grid_size
+                );
+                break;
+            case SC_OCTREE_RESAMPLE_METHOD_POISSON_DISK:
+                count = sc_octree_resample_poisson_disk(
+                    &scratch,
+                    candidate_count,
+                    extents,
+                    info->grid_size
+                );
+                break;
+            default: SC_ASSERT(false); break;
+        }
+
+        // Back in child order, which keeps nearby points together.
+        qsort(scratch.selected, count, sizeof(uint32_t), sc_octree_code_compare);
+
+        // Quantize to 10 bits per axis over the node bounds.
+        ScOctreeResampleNode* resampled = &resample->nodes[node_idx];
+        resampled->points = malloc(count * sizeof(ScOctreePoint));
+        resampled->positions = malloc(count * sizeof(vec3f));
+        resampled->attributes =
+            attribute_byte_count > 0 ? malloc((uint64_t)count * attribute_byte_count) : NULL;
+        resampled->point_count = count;
+        for (uint32_t j = 0; j < count; j++) {
+            const uint32_t candidate_idx = scratch.selected[j];
+            const vec3f position = scratch.positions[candidate_idx];
+            uint32_t q[3] = {0, 0, 0};
+            for (uint32_t c = 0; c < 3; c++) {
+                const float extent = (&extents.x)[c];
+                const float t = extent > 0.0f ? (&position.x)[c] / extent : 0.0f;
+                q[c] = (uint32_t)(SDL_clamp(t, 0.0f, 1.0f) * 1023.0f + 0.5f);
+            }
+            resampled->points[j] = (ScOctreePoint) {
+                .position = q[0] | q[1] << 10 | q[2] << 20,
+                .color = scratch.colors[candidate_idx],
+            };
+            resampled->positions[j] = position;
+            if (attribute_byte_count > 0) {
+                memcpy(
+                    resampled->attributes + (uint64_t)j * attribute_byte_count,
+                    scratch.attributes + (uint64_t)candidate_idx * attribute_byte_count,
+                    attribute_byte_count
+                );
+            }
+        }
+    }
+    sc_octree_resample_scratch_free(&scratch);
+    SDL_CloseIO(scratch.io);
+}
+
+// Rewrites the interior levels of the source from its leaves, see the notes above. The source
+// needs its nodes and tables, sc_octree_header_load and sc_octree_tables_load, and must outlive
+// the resample.
+static void sc_octree_resample(
+    ScOctreeResample* resample,
+    const ScOctree* source,
+    const ScOctreeResampleInfo* info
+) {
+    // Validation.
+    SC_ASSERT(source->live == NULL);
+    SC_ASSERT(info->method < SC_OCTREE_RESAMPLE_METHOD_COUNT);
+    SC_ASSERT(info->grid_size > 0 && info->grid_size <= SC_OCTREE_RESAMPLE_MAX_GRID_SIZE);
+    const uint64_t node_count = source->node_count;
+
+    // Attributes, packed in enum order.
+    *resample = (ScOctreeResample) {
+        .source = source,
+        .info = *info,
+        .nodes = calloc(node_count, sizeof(ScOctreeResampleNode)),
+    };
+    for (uint32_t a = 0; a < SC_OCTREE_ATTRIBUTE_COUNT; a++) {
+        if (sc_octree_attribute_available(source, (ScOctreeAttribute)a)) {
+            resample->attribute_offsets[a] = resample->attribute_byte_count;
+            resample->attribute_byte_count += SC_OCTREE_ATTRIBUTE_STRIDE[a];
+        }
+    }
+
+    // Nodes grouped by level, leaves first.
+    uint32_t level_count = 1;
+    for (uint64_t i = 0; i < node_count; i++) {
+        level_count = SDL_max(level_count, (uint32_t)source->nodes[i].level + 1);
+    }
+    uint64_t* level_offsets = calloc(level_count + 1, sizeof(uint64_t));
+    for (uint64_t i = 0; i < node_count; i++) {
+        level_offsets[source->nodes[i].level + 1]++;
+    }
+    for (uint32_t level = 0; level < level_count; level++) {
+        level_offsets[level + 1] += level_offsets[level];
+    }
+    uint32_t* level_nodes = malloc(node_count * sizeof(uint32_t));
+    uint64_t* level_cursors = malloc(level_count * sizeof(uint64_t));
+    memcpy(level_cursors, level_offsets, level_count * sizeof(uint64_t));
+    for (uint64_t i = 0; i < node_count; i++) {
+        level_nodes[level_cursors[source->nodes[i].level]++] = (uint32_t)i;
+    }
+    free(level_cursors);
+
+    // Resample, bottom-up. Positions of the children are dropped once their parents are done.
+    for (uint32_t level = 1; level < level_count; level++) {
+        resample->level_nodes = level_nodes + level_offsets[level];
+        const uint64_t level_node_count = level_offsets[level + 1] - level_offsets[level];
+        sc_job_parallel_for(sc_octree_resample_level, resample, (uint32_t)level_node_count, 1);
+        for (uint64_t i = 0; i < level_node_count; i++) {
+            const ScOctreeNode* node = &source->nodes[resample->level_nodes[i]];
+            for (uint32_t octant = 0; octant < 8; octant++) {
+                if (node->octants[octant] != ~0u) {
+                    ScOctreeResampleNode* child = &resample->nodes[node->octants[octant]];
+                    free(child->positions);
+                    child->positions = NULL;
+                }
+            }
+        }
+    }
+    resample->level_nodes = NULL;
+    free(level_nodes);
+    free(level_offsets);
+
+    // Layout, in node order.
+    resample->output_nodes = malloc(node_count * sizeof(ScOctreeNode));
+    memcpy(resample->output_nodes, source->nodes, node_count * sizeof(ScOctreeNode));
+    uint64_t point_count = 0;
+    uint64_t leaf_point_count = 0;
+    for (uint64_t i = 0; i < node_count; i++) {
+        ScOctreeNode* node = &resample->output_nodes[i];
+        if (node->level > 0) {
+            node->point_count = resample->nodes[i].point_count;
+        } else {
+            leaf_point_count += node->point_count;
+        }
+        node->point_offset = point_count;
+        point_count += node->point_count;
+    }
+    resample->output_point_count = point_count;
+    SC_LOG_INFO(
+        "Resampled interior points with %s: %" PRIu64 " -> %" PRIu64,
+        SC_OCTREE_RESAMPLE_METHOD_NAME[info->method],
+        source->point_count - leaf_point_count,
+        point_count - leaf_point_count
+    );
+}
+
+// Streams the output front to back, leaves are copied from the source file. Node geometry is
+// copied for leaves if the source has it, and measured otherwise.
+static bool sc_octree_resample_write(
+    ScOctreeResample* resample,
+    bool source_geometry_loaded,
+    const char* file_path
+) {
+    // Unpack.
+    const ScOctree* source = resample->source;
+    const uint64_t node_count = source->node_count;
+    const uint32_t point_stride = sc_octree_point_stride(source->point_format);
+    const uint64_t point_file_offset = sc_octree_point_file_offset(source);
+    const uint32_t attribute_byte_count = resample->attribute_byte_count;
+    resample->output_node_geometry = calloc(node_count, sizeof(ScOctreeNodeGeometry));
+    SDL_IOStream* io = SDL_IOFromFile(file_path, "wb");
+    if (io == NULL) {
+        SC_LOG_ERROR("Failed to open %s: %s", file_path, SDL_GetError());
+        return false;
+    }
+
+    // Header.
+    bool ok = true;
+    ok &= SDL_WriteIO(io, SC_OCTREE_POINT_FORMAT_MAGIC[source->point_format], 8) == 8;
+    ok &= SDL_WriteIO(io, &node_count, sizeof(uint64_t)) == sizeof(uint64_t);
+    ok &= SDL_WriteIO(io, &resample->output_point_count, sizeof(uint64_t)) == sizeof(uint64_t);
+    ok &= SDL_WriteIO(io, &source->point_bounds, sizeof(box3f)) == sizeof(box3f);
+    ok &= SDL_WriteIO(io, &source->unit_world_scale, sizeof(float)) == sizeof(float);
+    ok &= SDL_WriteIO(io, &source->node_unit_count, sizeof(float)) == sizeof(float);
+    ok &= SDL_WriteIO(io, &source->node_world_scale, sizeof(float)) == sizeof(float);
+
+    // Nodes.
+    const uint64_t node_byte_count = node_count * sizeof(ScOctreeNode);
+    ok &= SDL_WriteIO(io, resample->output_nodes, node_byte_count) == node_byte_count;
+
+    // Points, node by node.
+    SDL_IOStream* source_io = SDL_IOFromFile(source->file_path, "rb");
+    SC_SDL_ASSERT(source_io != NULL);
+    uint8_t* data = NULL;
+    uint64_t capacity = 0;
+    for (uint64_t i = 0; i < node_count && ok; i++) {
+        // Leaves are copied.
+        const ScOctreeNode* node = &resample->output_nodes[i];
+        const uint64_t byte_count = (uint64_t)node->point_count * point_stride;
+        if (node->level == 0) {
+            sc_octree_stream_read(
+                source_io,
+                point_file_offset,
+                point_stride,
+                source->nodes[i].point_offset,
+                node->point_count,
+                &data,
+                &capacity
+            );
+            ok &= SDL_WriteIO(io, data, byte_count) == byte_count;
+            if (source_geometry_loaded) {
+                resample->output_node_geometry[i] = source->node_geometry[i];
+                continue;
+            }
+        } else {
+            // Interior points, in the source format.
+            const ScOctreePoint* points = resample->nodes[i].points;
+            sc_octree_reserve(&data, &capacity, byte_count);
+            for (uint32_t j = 0; j < node->point_count; j++) {
+                if (source->point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+                    ((ScOctreePointCompact*)data)[j] = sc_octree_point_compact(points[j]);
+                } else {
+                    ((ScOctreePoint*)data)[j] = points[j];
+                }
+            }
+            ok &= SDL_WriteIO(io, data, byte_count) == byte_count;
+        }
+
+        // Geometry, measured on a view of this node alone.
+        ScOctreeNode view_node = *node;
+        view_node.point_offset = 0;
+        ScOctree view = {
+            .node_unit_count = source->node_unit_count,
+            .node_world_scale = source->node_world_scale,
+            .nodes = &view_node,
+            .node_geometry = &resample->output_node_geometry[i],
+            .node_count = 1,
+            .point_format = source->point_format,
+        };
+        if (source->point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+            view.compact_points = (ScOctreePointCompact*)data;
+        } else {
+            view.points = (ScOctreePoint*)data;
+        }
+        sc_octree_node_geometry_measure(&view, 0, 1);
+    }
+
+    // Attributes, one stream at a time.
+    if (ok && source->attribute_mask != 0) {
+        ok &= SDL_WriteIO(io, "TOKYOATR", 8) == 8;
+        ok &= SDL_WriteIO(io, &source->attribute_mask, sizeof(uint32_t)) == sizeof(uint32_t);
+    }
+    for (uint32_t a = 0; a < SC_OCTREE_ATTRIBUTE_COUNT && ok; a++) {
+        if (!sc_octree_attribute_available(source, (ScOctreeAttribute)a)) {
+            continue;
+        }
+        const uint32_t stride = SC_OCTREE_ATTRIBUTE_STRIDE[a];
+        for (uint64_t i = 0; i < node_count && ok; i++) {
+            const ScOctreeNode* node = &resample->output_nodes[i];
+            const uint64_t byte_count = (uint64_t)node->point_count * stride;
+            if (node->level == 0) {
+                sc_octree_stream_read(
+                    source_io,
+                    source->attribute_file_offsets[a],
+                    stride,
+                    source->nodes[i].point_offset,
+                    node->point_count,
+                    &data,
+                    &capacity
+                );
+            } else {
+                const uint8_t* attributes = resample->nodes[i].attributes;
+                const uint32_t attribute_offset = resample->attribute_offsets[a];
+                sc_octree_reserve(&data, &capacity, byte_count);
+                for (uint32_t j = 0; j < node->point_count; j++) {
+                    memcpy(
+                        data + (uint64_t)j * stride,
+                        attributes + (uint64_t)j * attribute_byte_count + attribute_offset,
+                        stride
+                    );
+                }
+            }
+            ok &= SDL_WriteIO(io, data, byte_count) == byte_count;
+        }
+    }
+    SDL_CloseIO(source_io);
+
+    // Node geometry.
+    if (ok) {
+        const uint64_t geometry_byte_count = node_count * sizeof(ScOctreeNodeGeometry);
+        ok &= SDL_WriteIO(io, "TOKYOGEO", 8) == 8;
+        ok &= SDL_WriteIO(io, resample->output_node_geometry, geometry_byte_count)
+              == geometry_byte_count;
+    }
+    ok &= SDL_CloseIO(io);
+    if (!ok) {
+        SC_LOG_ERROR("Failed to write %s: %s", file_path, SDL_GetError());
+    }
+
+    // Free.
+    free(data);
+    return ok;
+}
+
+static void sc_octree_resample_free(ScOctreeResample* resample) {
+    for (uint64_t i = 0; i < resample->source->node_count; i++) {
+        free(resample->nodes[i].points);
+        free(resample->nodes[i].positions);
+        free(resample->nodes[i].attributes);
+    }
+    free(resample->nodes);
+    free(resample->output_nodes);
+    free(resample->output_node_geometry);
+    SDL_zerop(resample);
+}
@@ -0,0 +1,389 @@
+//
+// Profile - Hierarchical CPU scope timer
+//
+
+// Notes:
+// - Every thread records completed scopes into its own ring, so recording takes no locks. A
+//   ring is registered on the first scope of a thread and can be handed back to the pool
+//   with sc_profile_thread_release when the thread exits.
+// - Recording is latched per frame in sc_profile_frame_begin. Every scope remembers whether its
+//   begin was recorded, in a per-thread bit stack, and its end pops exactly that, so toggling
+//   the profiler mid-scope or nesting deeper than SC_PROFILE_STACK_DEPTH never leaves scopes
+//   unbalanced. While disabled, a scope costs an atomic load and a few thread-local updates;
+//   building with SC_PROFILE_ENABLED=0 removes the scopes entirely.
+// - Scope names must be string literals, only the pointer is stored.
+// - Export follows the Chrome trace event format and can be opened in Perfetto or
+//   chrome://tracing.
+
+#if !defined(SC_PROFILE_ENABLED)
+    #define SC_PROFILE_ENABLED 1
+#endif
+
+#define SC_PROFILE_THREAD_COUNT 64
+#define SC_PROFILE_RING_EVENT_COUNT (1 << 14)
+#define SC_PROFILE_STACK_DEPTH 32
+
+typedef struct ScProfileEvent {
+    const char* name;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+    uint32_t depth;
+} ScProfileEvent;
+
+typedef struct ScProfileThread {
+    // Owner.
+    char name[32];
+    uint32_t id;
+    bool released;
+
+    // Open scopes.
+    const char* stack_names[SC_PROFILE_STACK_DEPTH];
+    uint64_t stack_begin_ns[SC_PROFILE_STACK_DEPTH];
+    uint32_t stack_depth;
+
+    // Completed scopes, in order of their end time.
+    ScProfileEvent* events;
+    SDL_AtomicU32 event_count;
+} ScProfileThread;
+
+typedef struct ScProfiler {
+    // Recording, read by every thread, written by the main thread.
+    SDL_AtomicInt enabled;
+    bool enabled_requested;
+    uint64_t start_ns;
+
+    // Frames.
+    uint64_t frame_begin_ns;
+    uint64_t last_frame_begin_ns;
+    uint64_t last_frame_end_ns;
+    bool paused;
+
+    // Threads.
+    SDL_SpinLock lock;
+    ScProfileThread* threads[SC_PROFILE_THREAD_COUNT];
+    uint32_t thread_count;
+} ScProfiler;
+
+static ScProfiler sc_profiler;
+static SC_THREAD_LOCAL ScProfileThread* sc_profile_thread_current;
+static SC_THREAD_LOCAL const char* sc_profile_thread_current_name;
+// Open scopes of the thread, recorded or not, bit i set if the scope at depth i was recorded.
+static SC_THREAD_LOCAL uint32_t sc_profile_scope_depth;
+static SC_THREAD_LOCAL uint32_t sc_profile_scope_recorded_bits;
+static_assert(SC_PROFILE_STACK_DEPTH <= 32, "Profile recorded bits overflow");
+
+#if SC_PROFILE_ENABLED
+    #define SC_PROFILE_BEGIN(name) sc_profile_scope_begin(name)
+    #define SC_PROFILE_END() sc_profile_scope_end()
+#else
+    #define SC_PROFILE_BEGIN(name) SC_UNUSED(name)
+    #define SC_PROFILE_END()
+#endif
+
+static ScProfileThread* sc_profile_thread_acquire(void) {
+    if (sc_profile_thread_current != NULL) {
+        return sc_profile_thread_current;
+    }
+
+    // Reuse a released ring if possible, otherwise register a new one.
+    ScProfileThread* thread = NULL;
+    SDL_LockSpinlock(&sc_profiler.lock);
+    for (uint32_t i = 0; i < sc_profiler.thread_count; i++) {
+        if (sc_profiler.threads[i]->released) {
+            thread = sc_profiler.threads[i];
+            break;
+        }
+    }
+    if (thread == NULL && sc_profiler.thread_count < SC_PROFILE_THREAD_COUNT) {
+        thread = calloc(1, sizeof(ScProfileThread));
+        thread->events = malloc(SC_PROFILE_RING_EVENT_COUNT * sizeof(ScProfileEvent));
+        sc_profiler.threads[sc_profiler.thread_count++] = thread;
+    }
+    if (thread != NULL) {
+        thread->id = (uint32_t)SDL_GetCurrentThreadID();
+        if (sc_profile_thread_current_name != NULL) {
+            snprintf(thread->name, sizeof(thread->name), "%s", sc_profile_thread_current_name);
+        } else {
+            snprintf(thread->name, sizeof(thread->name), "thread_%u", thread->id);
+        }
+        thread->released = false;
+        thread->stack_depth = 0;
+        SDL_SetAtomicU32(&thread->event_count, 0);
+    }
+    SDL_UnlockSpinlock(&sc_profiler.lock);
+
+    sc_profile_thread_current = thread;
+    return thread;
+}
+
+// Names the calling thread, the ring itself is only acquired on the first recorded scope.
+static void sc_profile_thread_name(const char* name) {
+    sc_profile_thread_current_name = name;
+    ScProfileThread* thread = sc_profile_thread_current;
+    if (thread != NULL) {
+        snprintf(thread->name, sizeof(thread->name), "%s", name);
+    }
+}
+
+static void sc_profile_thread_release(void) {
+    ScProfileThread* thread = sc_profile_thread_current;
+    sc_profile_thread_current_name = NULL;
+    if (thread == NULL) {
+        return;
+    }
+    SDL_LockSpinlock(&sc_profiler.lock);
+    thread->released = true;
+    SDL_UnlockSpinlock(&sc_profiler.lock);
+    sc_profile_thread_current = NULL;
+}
+
+static bool sc_profile_scope_record(const char* name) {
+    ScProfileThread* thread = sc_profile_thread_acquire();
+    if (thread == NULL || thread->stack_depth == SC_PROFILE_STACK_DEPTH) {
+        return false;
+    }
+    thread->stack_names[thread->stack_depth] = name;
+    thread->stack_begin_ns[thread->stack_depth] = SDL_GetTicksNS();
+    thread->stack_depth++;
+    return true;
+}
+
+// Always pushes, scopes which are not recorded push a cleared bit.
+static void sc_profile_scope_begin(const char* name) {
+    const uint32_t depth = sc_profile_scope_depth++;
+    if (depth >= SC_PROFILE_STACK_DEPTH) {
+        return;
+    }
+    const uint32_t bit = 1u << depth;
+    sc_profile_scope_recorded_bits &= ~bit;
+    if (SDL_GetAtomicInt(&sc_profiler.enabled) != 0 && sc_profile_scope_record(name)) {
+        sc_profile_scope_recorded_bits |= bit;
+    }
+}
+
+// Pops what the matching begin pushed.
+static void sc_profile_scope_end(void) {
+    if (sc_profile_scope_depth == 0) {
+        return;
+    }
+    const uint32_t depth = --sc_profile_scope_depth;
+    if (depth >= SC_PROFILE_STACK_DEPTH || (sc_profile_scope_recorded_bits & (1u << depth)) == 0) {
+        return;
+    }
+    ScProfileThread* thread = sc_profile_thread_current;
+    thread->stack_depth--;
+    const uint32_t event_count = SDL_GetAtomicU32(&thread->event_count);
+    thread->events[event_count % SC_PROFILE_RING_EVENT_COUNT] = (ScProfileEvent) {
+        .name = thread->stack_names[thread->stack_depth],
+        .begin_ns = thread->stack_begin_ns[thread->stack_depth],
+        .end_ns = SDL_GetTicksNS(),
+        .depth = thread->stack_depth,
+    };
+    SDL_SetAtomicU32(&thread->event_count, event_count + 1);
+}
+
+static void sc_profile_new(void) {
+    SDL_zero(sc_profiler);
+    sc_profiler.start_ns = SDL_GetTicksNS();
+    sc_profiler.frame_begin_ns = sc_profiler.start_ns;
+}
+
+static void sc_profile_free(void) {
+    for (uint32_t i = 0; i < sc_profiler.thread_count; i++) {
+        free(sc_profiler.threads[i]->events);
+        free(sc_profiler.threads[i]);
+    }
+    SDL_zero(sc_profiler);
+    sc_profile_thread_current = NULL;
+}
+
+// Call on the main thread before any scope of the frame.
+static void sc_profile_frame_begin(void) {
+    const uint64_t now_ns = SDL_GetTicksNS();
+    if (!sc_profiler.paused) {
+        sc_profiler.last_frame_begin_ns = sc_profiler.frame_begin_ns;
+        sc_profiler.last_frame_end_ns = now_ns;
+    }
+    sc_profiler.frame_begin_ns = now_ns;
+    SDL_SetAtomicInt(&sc_profiler.enabled, sc_profiler.enabled_requested ? 1 : 0);
+}
+
+// Returns the oldest event index that is safe to read while the owner keeps writing. The
+// oldest slots are skipped, since the owner may be overwriting them.
+static uint32_t sc_profile_thread_event_begin(uint32_t event_count) {
+    const uint32_t margin = SC_PROFILE_RING_EVENT_COUNT / 8;
+    const uint32_t available = SC_PROFILE_RING_EVENT_COUNT - margin;
+    return event_count > available ? event_count - available : 0;
+}
+
+static bool sc_profile_write_chrome_trace(const char* file_path) {
+    SDL_IOStream* io = SDL_IOFromFile(file_path, "wb");
+    if (io == NULL) {
+        SC_LOG_ERROR("Failed to open %s: %s", file_path, SDL_GetError());
+        return false;
+    }
+
+    // Header.
+    bool ok = true;
+    ok &= SDL_IOprintf(io, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n") > 0;
+
+    // Threads.
+    SDL_LockSpinlock(&sc_profiler.lock);
+    const uint32_t thread_count = sc_profiler.thread_count;
+    SDL_UnlockSpinlock(&sc_profiler.lock);
+    uint64_t written_count = 0;
+    for (uint32_t i = 0; i < thread_count; i++) {
+        ScProfileThread* thread = sc_profiler.threads[i];
+        ok &= SDL_IOprintf(
+                  io,
+                  "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                  "\"args\":{\"name\":\"%s\"}},\n",
+                  i,
+                  thread->name
+              )
+              > 0;
+        const uint32_t event_end = SDL_GetAtomicU32(&thread->event_count);
+        for (uint32_t j = sc_profile_thread_event_begin(event_end); j < event_end; j++) {
+            const ScProfileEvent* event = &thread->events[j % SC_PROFILE_RING_EVENT_COUNT];
+            const double ts_us = (double)(event->begin_ns - sc_profiler.start_ns) / 1e3;
+            const double dur_us = (double)(event->end_ns - event->begin_ns) / 1e3;
+            ok &= SDL_IOprintf(
+                      io,
+                      "{\"name\":\"%s\",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":%.3f,"
+                      "\"dur\":%.3f,\"pid\":1,\"tid\":%u},\n",
+                      event->name,
+                      ts_us,
+                      dur_us,
+                      i
+                  )
+                  > 0;
+            written_count++;
+        }
+    }
+
+    // Footer, the process name doubles as a terminator for the trailing comma.
+    ok &= SDL_IOprintf(
+              io,
+              "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+              "\"args\":{\"name\":\"stormcloud\"}}\n]}\n"
+          )
+          > 0;
+    ok &= SDL_CloseIO(io);
+    if (ok) {
+        SC_LOG_INFO("Wrote %" PRIu64 " profile events to %s", written_count, file_path);
+    } else {
+        SC_LOG_ERROR("Failed to write %s: %s", file_path, SDL_GetError());
+    }
+    return ok;
+}
+
+//
+// Profile - Gui
+//
+
+static const uint32_t SC_PROFILE_GUI_COLORS[] = {
+    0xffb07040,
+    0xff40a0b0,
+    0xff6040c0,
+    0xff50b060,
+    0xffc0a040,
+    0xff9050a0,
+};
+
+static uint32_t sc_profile_gui_color(const char* name) {
+    // FNV-1a, so a scope keeps its color across frames.
+    uint32_t hash = 2166136261u;
+    for (const char* c = name; *c != '\0'; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+    return SC_PROFILE_GUI_COLORS[hash % SC_COUNTOF(SC_PROFILE_GUI_COLORS)];
+}
+
+// Timeline of the last completed frame, one lane per thread and one row per scope depth.
+static void sc_profile_gui(void) {
+    ImGui_SetNextWindowSize((ImVec2) {720.0f, 240.0f}, ImGuiCond_Once);
+    ImGui_Begin("profiler", NULL, 0);
+    ImGui_Checkbox("enabled", &sc_profiler.enabled_requested);
+    ImGui_SameLine();
+    ImGui_Checkbox("paused", &sc_profiler.paused);
+    ImGui_SameLine();
+    if (ImGui_Button("export_trace")) {
+        sc_profile_write_chrome_trace("temp/trace.json");
+    }
+    const uint64_t frame_begin_ns = sc_profiler.last_frame_begin_ns;
+    const uint64_t frame_end_ns = sc_profiler.last_frame_end_ns;
+    const double frame_ms = (double)(frame_end_ns - frame_begin_ns) / 1e6;
+    ImGui_Text("frame: %.3f ms", frame_ms);
+
+    // Layout.
+    const float row_height = 18.0f;
+    const ImVec2 origin = ImGui_GetCursorScreenPos();
+    const float width = SDL_max(ImGui_GetContentRegionAvail().x, 1.0f);
+    const double px_per_ns = frame_end_ns > frame_begin_ns
+                                 ? (double)width / (double)(frame_end_ns - frame_begin_ns)
+                                 : 0.0;
+    ImDrawList* draw_list = ImGui_GetWindowDrawList();
+
+    // Lanes.
+    float lane_y = origin.y;
+    SDL_LockSpinlock(&sc_profiler.lock);
+    const uint32_t thread_count = sc_profiler.thread_count;
+    SDL_UnlockSpinlock(&sc_profiler.lock);
+    for (uint32_t i = 0; i < thread_count; i++) {
+        ScProfileThread* thread = sc_profiler.threads[i];
+        const uint32_t event_end = SDL_GetAtomicU32(&thread->event_count);
+        const uint32_t event_begin = sc_profile_thread_event_begin(event_end);
+
+        // Scan back to the first event of the frame, events are ordered by end time.
+        uint32_t lane_depth = 0;
+        uint32_t j = event_end;
+        while (j > event_begin) {
+            const ScProfileEvent* event = &thread->events[(j - 1) % SC_PROFILE_RING_EVENT_COUNT];
+            if (event->end_ns <= frame_begin_ns) {
+                break;
+            }
+            if (event->end_ns <= frame_end_ns) {
+                lane_depth = SDL_max(lane_depth, event->depth + 1);
+            }
+            j--;
+        }
+        if (lane_depth == 0) {
+            continue;
+        }
+
+        // Scopes.
+        ImDrawList_AddText(draw_list, (ImVec2) {origin.x, lane_y}, 0xffffffff, thread->name);
+        lane_y += row_height;
+        ImDrawList_PushClipRect(
+            draw_list,
+            (ImVec2) {origin.x, lane_y},
+            (ImVec2) {origin.x + width, lane_y + (float)lane_depth * row_height},
+            true
+        );
+        for (; j < event_end; j++) {
+            const ScProfileEvent* event = &thread->events[j % SC_PROFILE_RING_EVENT_COUNT];
+            if (event->end_ns > frame_end_ns) {
+                break;
+            }
+            const uint64_t begin_ns = SDL_max(event->begin_ns, frame_begin_ns);
+            const float x0 = origin.x + (float)((double)(begin_ns - frame_begin_ns) * px_per_ns);
+            const float x1 =
+                origin.x + (float)((double)(event->end_ns - frame_begin_ns) * px_per_ns);
+            const float y0 = lane_y + (float)event->depth * row_height;
+            const ImVec2 p_min = {x0, y0};
+            const ImVec2 p_max = {SDL_max(x1, x0 + 1.0f), y0 + row_height - 1.0f};
+            ImDrawList_AddRectFilled(draw_list, p_min, p_max, sc_profile_gui_color(event->name));
+            if (p_max.x - p_min.x > 32.0f) {
+                ImDrawList_AddText(draw_list, (ImVec2) {x0 + 2.0f, y0}, 0xffffffff, event->name);
+            }
+            if (ImGui_IsMouseHoveringRect(p_min, p_max)) {
+                const double event_ms = (double)(event->end_ns - event->begin_ns) / 1e6;
+                ImGui_SetTooltip("%s: %.3f ms", event->name, event_ms);
+            }
+        }
+        ImDrawList_PopClipRect(draw_list);
+        lane_y += (float)lane_depth * row_height;
+    }
+    ImGui_Dummy((ImVec2) {width, lane_y - origin.y});
+    ImGui_End();
+}
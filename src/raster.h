@@ -0,0 +1,427 @@
+//
+// Raster - CPU point rasterizer
+//
+
+// Notes:
+// - Reference implementation of the point pipeline, decodes positions exactly like point.hlsl.
+// - Depth and color are packed into 64 bits and resolved with atomic min, so the output is
+//   deterministic regardless of how batches are scheduled across workers.
+// - Passes run on the job system, clear and resolve by tiles of rows, splat by batches of points.
+// - https://arxiv.org/abs/2104.07526
+
+#define SC_RASTER_TILE_ROW_COUNT 16
+#define SC_RASTER_BATCH_POINT_COUNT (1 << 14)
+#define SC_RASTER_CLEAR_VALUE UINT64_MAX
+
+typedef enum ScRasterPass {
+    SC_RASTER_PASS_CLEAR,
+    SC_RASTER_PASS_SPLAT,
+    SC_RASTER_PASS_RESOLVE,
+    SC_RASTER_PASS_COUNT,
+} ScRasterPass;
+
+static const char* SC_RASTER_PASS_NAME[] = {
+    "raster_clear",
+    "raster_splat",
+    "raster_resolve",
+};
+
+typedef struct ScRasterBatch {
+    uint32_t node_idx;
+    uint32_t point_count;
+    uint64_t point_offset;
+} ScRasterBatch;
+
+typedef struct ScRasterCreateInfo {
+    uint32_t width;
+    uint32_t height;
+} ScRasterCreateInfo;
+
+typedef struct ScRasterRenderInfo {
+    const ScOctree* octree;
+    const ScOctreeTraversal* traversal;
+    mat4f clip_from_world;
+    vec4f clear_color;
+} ScRasterRenderInfo;
+
+typedef struct ScRaster {
+    // Targets.
+    uint32_t width;
+    uint32_t height;
+    uint32_t tile_count;
+    uint64_t* depth_color;
+    uint32_t* image;
+    uint8_t srgb_from_linear[256];
+
+    // Batches.
+    ScRasterBatch* batches;
+    uint32_t batch_count;
+    uint32_t batch_capacity;
+
+    // Current pass.
+    const ScRasterRenderInfo* render_info;
+    uint32_t clear_color;
+    ScRasterPass pass;
+} ScRaster;
+
+static SC_INLINE void
+sc_raster_splat(ScRaster* raster, uint32_t px, uint32_t py, float depth, uint32_t color) {
+    uint32_t depth_bits;
+    memcpy(&depth_bits, &depth, sizeof(depth_bits));
+    const uint64_t value = ((uint64_t)depth_bits << 32) | (uint64_t)color;
+    sc_atomic_min_u64(&raster->depth_color[py * raster->width + px], value);
+}
+
+static void sc_raster_splat_scalar(
+    ScRaster* raster,
+    const mat4f* m,
+    vec3f mn,
+    vec3f extent,
+    const ScOctreePoint* points,
+    uint32_t point_count
+) {
+    // Unpack.
+    const float width = (float)raster->width;
+    const float height = (float)raster->height;
+
+    for (uint32_t i = 0; i < point_count; i++) {
+        // Decode.
+        const uint32_t position = points[i].position;
+        const uint32_t ix = position & 0x3ff;
+        const uint32_t iy = (position >> 10) & 0x3ff;
+        const uint32_t iz = (position >> 20) & 0x3ff;
+        const float x = mn.x + ((float)ix / 1023.0f) * extent.x;
+        const float y = mn.y + ((float)iy / 1023.0f) * extent.y;
+        const float z = mn.z + ((float)iz / 1023.0f) * extent.z;
+
+        // Transform.
+        const float cx = m->m00 * x + m->m10 * y + m->m20 * z + m->m30;
+        const float cy = m->m01 * x + m->m11 * y + m->m21 * z + m->m31;
+        const float cz = m->m02 * x + m->m12 * y + m->m22 * z + m->m32;
+        const float cw = m->m03 * x + m->m13 * y + m->m23 * z + m->m33;
+        if (!(cw > 0.0f)) {
+            continue;
+        }
+
+        // Clip.
+        const float nx = cx / cw;
+        const float ny = cy / cw;
+        if (!(nx >= -1.0f && nx <= 1.0f && ny >= -1.0f && ny <= 1.0f)) {
+            continue;
+        }
+
+        // Viewport, depth clip is disabled in the point pipeline, so depth clamps.
+        const uint32_t px = (uint32_t)((nx * 0.5f + 0.5f) * width);
+        const uint32_t py = (uint32_t)((0.5f - ny * 0.5f) * height);
+        if (px >= raster->width || py >= raster->height) {
+            continue;
+        }
+        const float depth = SDL_clamp(cz / cw, 0.0f, 1.0f);
+        sc_raster_splat(raster, px, py, depth, points[i].color);
+    }
+}
+
+#if defined(SC_SIMD_AVX2)
+static void sc_raster_splat_avx2(
+    ScRaster* raster,
+    const mat4f* m,
+    vec3f mn,
+    vec3f extent,
+    const ScOctreePoint* points,
+    uint32_t point_count
+) {
+    // Constants.
+    const __m256i mask_10 = _mm256_set1_epi32(0x3ff);
+    const __m256 inv_scale = _mm256_set1_ps(1023.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 neg_one = _mm256_set1_ps(-1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 width = _mm256_set1_ps((float)raster->width);
+    const __m256 height = _mm256_set1_ps((float)raster->height);
+    const __m256i width_i = _mm256_set1_epi32((int32_t)raster->width);
+    const __m256i height_i = _mm256_set1_epi32((int32_t)raster->height);
+    const __m256 mn_x = _mm256_set1_ps(mn.x);
+    const __m256 mn_y = _mm256_set1_ps(mn.y);
+    const __m256 mn_z = _mm256_set1_ps(mn.z);
+    const __m256 extent_x = _mm256_set1_ps(extent.x);
+    const __m256 extent_y = _mm256_set1_ps(extent.y);
+    const __m256 extent_z = _mm256_set1_ps(extent.z);
+    const __m256 m00 = _mm256_set1_ps(m->m00);
+    const __m256 m01 = _mm256_set1_ps(m->m01);
+    const __m256 m02 = _mm256_set1_ps(m->m02);
+    const __m256 m03 = _mm256_set1_ps(m->m03);
+    const __m256 m10 = _mm256_set1_ps(m->m10);
+    const __m256 m11 = _mm256_set1_ps(m->m11);
+    const __m256 m12 = _mm256_set1_ps(m->m12);
+    const __m256 m13 = _mm256_set1_ps(m->m13);
+    const __m256 m20 = _mm256_set1_ps(m->m20);
+    const __m256 m21 = _mm256_set1_ps(m->m21);
+    const __m256 m22 = _mm256_set1_ps(m->m22);
+    const __m256 m23 = _mm256_set1_ps(m->m23);
+    const __m256 m30 = _mm256_set1_ps(m->m30);
+    const __m256 m31 = _mm256_set1_ps(m->m31);
+    const __m256 m32 = _mm256_set1_ps(m->m32);
+    const __m256 m33 = _mm256_set1_ps(m->m33);
+
+    const uint32_t simd_count = point_count & ~7u;
+    for (uint32_t i = 0; i < simd_count; i += 8) {
+        // Deinterleave 8 points into positions and colors.
+        const __m256 p0 = _mm256_loadu_ps((const float*)&points[i + 0]);
+        const __m256 p1 = _mm256_loadu_ps((const float*)&points[i + 4]);
+        const __m256i position = _mm256_permute4x64_epi64(
+            _mm256_castps_si256(_mm256_shuffle_ps(p0, p1, _MM_SHUFFLE(2, 0, 2, 0))),
+            _MM_SHUFFLE(3, 1, 2, 0)
+        );
+        const __m256i color = _mm256_permute4x64_epi64(
+            _mm256_castps_si256(_mm256_shuffle_ps(p0, p1, _MM_SHUFFLE(3, 1, 3, 1))),
+            _MM_SHUFFLE(3, 1, 2, 0)
+        );
+
+        // Decode.
+        const __m256i ix = _mm256_and_si256(position, mask_10);
+        const __m256i iy = _mm256_and_si256(_mm256_srli_epi32(position, 10), mask_10);
+        const __m256i iz = _mm256_and_si256(_mm256_srli_epi32(position, 20), mask_10);
+        const __m256 fx = _mm256_div_ps(_mm256_cvtepi32_ps(ix), inv_scale);
+        const __m256 fy = _mm256_div_ps(_mm256_cvtepi32_ps(iy), inv_scale);
+        const __m256 fz = _mm256_div_ps(_mm256_cvtepi32_ps(iz), inv_scale);
+        const __m256 x = _mm256_add_ps(mn_x, _mm256_mul_ps(fx, extent_x));
+        const __m256 y = _mm256_add_ps(mn_y, _mm256_mul_ps(fy, extent_y));
+        const __m256 z = _mm256_add_ps(mn_z, _mm256_mul_ps(fz, extent_z));
+
+        // Transform.
+        // clang-format off
+        const __m256 cx = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, x), _mm256_mul_ps(m10, y)), _mm256_mul_ps(m20, z)), m30);
+        const __m256 cy = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, x), _mm256_mul_ps(m11, y)), _mm256_mul_ps(m21, z)), m31);
+        const __m256 cz = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m02, x), _mm256_mul_ps(m12, y)), _mm256_mul_ps(m22, z)), m32);
+        const __m256 cw = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m03, x), _mm256_mul_ps(m13, y)), _mm256_mul_ps(m23, z)), m33);
+        // clang-format on
+
+        // Clip.
+        const __m256 nx = _mm256_div_ps(cx, cw);
+        const __m256 ny = _mm256_div_ps(cy, cw);
+        __m256 visible = _mm256_cmp_ps(cw, zero, _CMP_GT_OQ);
+        visible = _mm256_and_ps(visible, _mm256_cmp_ps(nx, neg_one, _CMP_GE_OQ));
+        visible = _mm256_and_ps(visible, _mm256_cmp_ps(nx, one, _CMP_LE_OQ));
+        visible = _mm256_and_ps(visible, _mm256_cmp_ps(ny, neg_one, _CMP_GE_OQ));
+        visible = _mm256_and_ps(visible, _mm256_cmp_ps(ny, one, _CMP_LE_OQ));
+        uint32_t visible_mask = (uint32_t)_mm256_movemask_ps(visible);
+        if (visible_mask == 0) {
+            continue;
+        }
+
+        // Viewport.
+        const __m256 sx = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(nx, half), half), width);
+        const __m256 sy = _mm256_mul_ps(_mm256_sub_ps(half, _mm256_mul_ps(ny, half)), height);
+        const __m256i px = _mm256_cvttps_epi32(sx);
+        const __m256i py = _mm256_cvttps_epi32(sy);
+        const __m256i inside = _mm256_and_si256(
+            _mm256_cmpgt_epi32(width_i, px),
+            _mm256_cmpgt_epi32(height_i, py)
+        );
+        visible_mask &= (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(inside));
+        const __m256 depth = _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(cz, cw), zero), one);
+
+        // Splat.
+        SC_ALIGNAS(32) uint32_t px_lanes[8];
+        SC_ALIGNAS(32) uint32_t py_lanes[8];
+        SC_ALIGNAS(32) float depth_lanes[8];
+        SC_ALIGNAS(32) uint32_t color_lanes[8];
+        _mm256_store_si256((__m256i*)px_lanes, px);
+        _mm256_store_si256((__m256i*)py_lanes, py);
+        _mm256_store_ps(depth_lanes, depth);
+        _mm256_store_si256((__m256i*)color_lanes, color);
+        while (visible_mask) {
+            const uint32_t lane = (uint32_t)_tzcnt_u32(visible_mask);
+            visible_mask &= visible_mask - 1;
+            sc_raster_splat(
+                raster,
+                px_lanes[lane],
+                py_lanes[lane],
+                depth_lanes[lane],
+                color_lanes[lane]
+            );
+        }
+    }
+
+    // Remainder.
+    sc_raster_splat_scalar(raster, m, mn, extent, points + simd_count, point_count - simd_count);
+}
+#endif
+
+static void sc_raster_pass_clear(ScRaster* raster, uint32_t tile) {
+    const uint32_t row_begin = tile * SC_RASTER_TILE_ROW_COUNT;
+    const uint32_t row_end = SDL_min(row_begin + SC_RASTER_TILE_ROW_COUNT, raster->height);
+    uint64_t* dst = &raster->depth_color[row_begin * raster->width];
+    const uint32_t count = (row_end - row_begin) * raster->width;
+    for (uint32_t i = 0; i < count; i++) {
+        dst[i] = SC_RASTER_CLEAR_VALUE;
+    }
+}
+
+static void sc_raster_pass_splat(ScRaster* raster, uint32_t batch_idx) {
+    // Unpack.
+    const ScRasterRenderInfo* render_info = raster->render_info;
+    const ScOctree* octree = render_info->octree;
+    const ScRasterBatch* batch = &raster->batches[batch_idx];
+    const ScOctreeNodeInstance* instance = &octree->node_instances[batch->node_idx];
+    const float node_world_scale = octree->node_world_scale;
+
+    // Node bounds, same as point.hlsl.
+    const vec3f mn = (vec3f) {
+        node_world_scale * instance->min_x,
+        node_world_scale * instance->min_y,
+        node_world_scale * instance->min_z,
+    };
+    const vec3f mx = (vec3f) {
+        node_world_scale * instance->max_x,
+        node_world_scale * instance->max_y,
+        node_world_scale * instance->max_z,
+    };
+    const vec3f extent = vec3f_sub(mx, mn);
+
+    // Splat, expanding compact points in chunks.
+    const mat4f* clip_from_world = &render_info->clip_from_world;
+    ScOctreePoint expanded[256];
+    for (uint32_t begin = 0; begin < batch->point_count;) {
+        const ScOctreePoint* points;
+        uint32_t point_count;
+        if (octree->point_format == SC_OCTREE_POINT_FORMAT_COMPACT) {
+            point_count = SDL_min(batch->point_count - begin, (uint32_t)SC_COUNTOF(expanded));
+            const ScOctreePointCompact* compact = &octree->compact_points[batch->point_offset];
+            for (uint32_t i = 0; i < point_count; i++) {
+                expanded[i] = sc_octree_point_expand(compact[begin + i]);
+            }
+            points = expanded;
+        } else {
+            point_count = batch->point_count - begin;
+            points = &octree->points[batch->point_offset + begin];
+        }
+#if defined(SC_SIMD_AVX2)
+        sc_raster_splat_avx2(raster, clip_from_world, mn, extent, points, point_count);
+#else
+        sc_raster_splat_scalar(raster, clip_from_world, mn, extent, points, point_count);
+#endif
+        begin += point_count;
+    }
+}
+
+static void sc_raster_pass_resolve(ScRaster* raster, uint32_t tile) {
+    const uint32_t row_begin = tile * SC_RASTER_TILE_ROW_COUNT;
+    const uint32_t row_end = SDL_min(row_begin + SC_RASTER_TILE_ROW_COUNT, raster->height);
+    const uint64_t* src = &raster->depth_color[row_begin * raster->width];
+    uint32_t* dst = &raster->image[row_begin * raster->width];
+    const uint32_t count = (row_end - row_begin) * raster->width;
+    const uint8_t* lut = raster->srgb_from_linear;
+    for (uint32_t i = 0; i < count; i++) {
+        const uint64_t value = src[i];
+        if (value == SC_RASTER_CLEAR_VALUE) {
+            dst[i] = raster->clear_color;
+            continue;
+        }
+        const uint32_t color = (uint32_t)value;
+        uint32_t srgb = 0;
+        srgb |= (uint32_t)lut[(color >> 0) & 0xff];
+        srgb |= (uint32_t)lut[(color >> 8) & 0xff] << 8;
+        srgb |= (uint32_t)lut[(color >> 16) & 0xff] << 16;
+        srgb |= 0xff000000;
+        dst[i] = srgb;
+    }
+}
+
+static void sc_raster_pass(void* user_data, uint32_t begin, uint32_t end) {
+    ScRaster* raster = user_data;
+    SC_PROFILE_BEGIN(SC_RASTER_PASS_NAME[raster->pass]);
+    for (uint32_t item = begin; item < end; item++) {
+        switch (raster->pass) {
+            case SC_RASTER_PASS_CLEAR: sc_raster_pass_clear(raster, item); break;
+            case SC_RASTER_PASS_SPLAT: sc_raster_pass_splat(raster, item); break;
+            case SC_RASTER_PASS_RESOLVE: sc_raster_pass_resolve(raster, item); break;
+            default: break;
+        }
+    }
+    SC_PROFILE_END();
+}
+
+static void sc_raster_dispatch(ScRaster* raster, ScRasterPass pass, uint32_t item_count) {
+    raster->pass = pass;
+    sc_job_parallel_for(sc_raster_pass, raster, item_count, 1);
+}
+
+static void sc_raster_new(ScRaster* raster, const ScRasterCreateInfo* create_info) {
+    // Validation.
+    SC_ASSERT(create_info->width > 0);
+    SC_ASSERT(create_info->height > 0);
+
+    // Targets.
+    raster->width = create_info->width;
+    raster->height = create_info->height;
+    raster->tile_count =
+        (raster->height + SC_RASTER_TILE_ROW_COUNT - 1) / SC_RASTER_TILE_ROW_COUNT;
+    raster->depth_color = malloc((size_t)raster->width * raster->height * sizeof(uint64_t));
+    raster->image = malloc((size_t)raster->width * raster->height * sizeof(uint32_t));
+    for (uint32_t i = 0; i < 256; i++) {
+        const float srgb = sc_srgb_from_linear((float)i / 255.0f);
+        raster->srgb_from_linear[i] = (uint8_t)(srgb * 255.0f + 0.5f);
+    }
+
+    // Batches.
+    raster->batch_count = 0;
+    raster->batch_capacity = 1024;
+    raster->batches = malloc(raster->batch_capacity * sizeof(ScRasterBatch));
+}
+
+static void sc_raster_free(ScRaster* raster) {
+    free(raster->batches);
+    free(raster->depth_color);
+    free(raster->image);
+}
+
+static void sc_raster_render(ScRaster* raster, const ScRasterRenderInfo* render_info) {
+    // Unpack.
+    const ScOctree* octree = render_info->octree;
+    const ScOctreeTraversal* traversal = render_info->traversal;
+    const vec4f clear_color = render_info->clear_color;
+
+    // Clear color, same encoding as the sRGB swapchain.
+    raster->render_info = render_info;
+    raster->clear_color = 0;
+    raster->clear_color |= (uint32_t)(sc_srgb_from_linear(clear_color.x) * 255.0f + 0.5f);
+    raster->clear_color |= (uint32_t)(sc_srgb_from_linear(clear_color.y) * 255.0f + 0.5f) << 8;
+    raster->clear_color |= (uint32_t)(sc_srgb_from_linear(clear_color.z) * 255.0f + 0.5f) << 16;
+    raster->clear_color |= (uint32_t)(clear_color.w * 255.0f + 0.5f) << 24;
+
+    // Split the traversal cut into batches.
+    raster->batch_count = 0;
+    for (uint32_t i = 0; i < traversal->node_traverse_count; i++) {
+        const uint32_t node_idx = traversal->node_traverse[i];
+        const ScOctreeNode* node = &octree->nodes[node_idx];
+        for (uint32_t begin = 0; begin < node->point_count;
+             begin += SC_RASTER_BATCH_POINT_COUNT) {
+            if (raster->batch_count == raster->batch_capacity) {
+                raster->batch_capacity *= 2;
+                raster->batches =
+                    realloc(raster->batches, raster->batch_capacity * sizeof(ScRasterBatch));
+            }
+            raster->batches[raster->batch_count++] = (ScRasterBatch) {
+                .node_idx = node_idx,
+                .point_count = SDL_min(node->point_count - begin, SC_RASTER_BATCH_POINT_COUNT),
+                .point_offset = node->point_offset + begin,
+            };
+        }
+    }
+
+    // Passes.
+    SC_PROFILE_BEGIN("raster_render");
+    sc_raster_dispatch(raster, SC_RASTER_PASS_CLEAR, raster->tile_count);
+    sc_raster_dispatch(raster, SC_RASTER_PASS_SPLAT, raster->batch_count);
+    sc_raster_dispatch(raster, SC_RASTER_PASS_RESOLVE, raster->tile_count);
+    SC_PROFILE_END();
+    raster->render_info = NULL;
+}
+
+static bool sc_raster_write_png(const ScRaster* raster, const char* file_path) {
+    const int32_t width = (int32_t)raster->width;
+    const int32_t height = (int32_t)raster->height;
+    return stbi_write_png(file_path, width, height, 4, raster->image, width * 4) != 0;
+}
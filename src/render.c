@@ -0,0 +1,153 @@
+//
+// Stormcloud Render - Includes.
+//
+
+#include "common.h"
+#include "alloc.h"
+#include "profile.h"
+#include "job.h"
+#include "math.h"
+#include "color.h"
+#include "camera.h"
+#include "octree.h"
+#include "raster.h"
+
+//
+// Stormcloud Render - Headless CPU rendering of the traversal cut.
+//
+
+// Usage: stormcloud_render <input.oct> <output.png> [width] [height] [lod_bias]
+
+#define SC_RENDER_DEFAULT_WIDTH 1920
+#define SC_RENDER_DEFAULT_HEIGHT 1200
+#define SC_RENDER_DEFAULT_LOD_BIAS (1.0f / 8.0f)
+
+SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
+    // Arguments.
+    SC_UNUSED(appstate);
+    if (argc < 3) {
+        SC_LOG_ERROR("Usage: %s <input.oct> <output.png> [width] [height] [lod_bias]", argv[0]);
+        return SDL_APP_FAILURE;
+    }
+    const char* input_path = argv[1];
+    const char* output_path = argv[2];
+    const uint32_t width = argc > 3 ? (uint32_t)atoi(argv[3]) : SC_RENDER_DEFAULT_WIDTH;
+    const uint32_t height = argc > 4 ? (uint32_t)atoi(argv[4]) : SC_RENDER_DEFAULT_HEIGHT;
+    const float lod_bias = argc > 5 ? (float)atof(argv[5]) : SC_RENDER_DEFAULT_LOD_BIAS;
+    if (width == 0 || height == 0) {
+        SC_LOG_ERROR("Invalid resolution: %ux%u", width, height);
+        return SDL_APP_FAILURE;
+    }
+
+    // Input, checked before loading.
+    if (!sc_octree_probe(input_path)) {
+        return SDL_APP_FAILURE;
+    }
+
+    // Jobs.
+    sc_job_system_new(&(ScJobSystemCreateInfo) {
+        .worker_count = 0,
+        .pin_workers = false,
+    });
+
+    // Octree.
+    ScOctree octree;
+    sc_octree_new(&octree, input_path);
+
+    // Camera, same initial view as the viewer.
+    ScPerspectiveCamera camera;
+    ScCameraControlOrbit orbit_control =
+        sc_camera_control_orbit_new(&(ScCameraControlOrbitCreateInfo) {
+            .common.scene_bounds = octree.point_bounds,
+        });
+    sc_camera_control_orbit_update(
+        &orbit_control,
+        &(ScCameraControlOrbitUpdateInfo) {
+            .common =
+                {
+                    .screen_width = (float)width,
+                    .screen_height = (float)height,
+                    .field_of_view = rad_from_deg(60.0f),
+                    .clip_distance_near = 16.0f,
+                    .clip_distance_far = 2048.0f,
+                    .delta_time = 0.0f,
+                    .input_captured = true,
+                },
+        },
+        &camera
+    );
+
+    // Traversal.
+    ScArena arena;
+    sc_arena_new(&arena, octree.node_count * sizeof(uint32_t));
+    ScOctreeTraversal traversal;
+    sc_octree_traverse(
+        &octree,
+        &(ScOctreeTraverseInfo) {
+            .arena = &arena,
+            .cameras = &camera,
+            .camera_count = 1,
+            .lod_bias = lod_bias,
+        },
+        &traversal
+    );
+
+    // Render.
+    ScRaster raster;
+    sc_raster_new(
+        &raster,
+        &(ScRasterCreateInfo) {
+            .width = width,
+            .height = height,
+        }
+    );
+    const uint64_t begin_time_ns = SDL_GetTicksNS();
+    sc_raster_render(
+        &raster,
+        &(ScRasterRenderInfo) {
+            .octree = &octree,
+            .traversal = &traversal,
+            .clip_from_world = camera.clip_from_world,
+            .clear_color = (vec4f) {0.025f, 0.025f, 0.025f, 1.0f},
+        }
+    );
+    const uint64_t end_time_ns = SDL_GetTicksNS();
+    SC_LOG_INFO(
+        "Rendered %u nodes on %u threads in %.3f ms",
+        traversal.node_traverse_count,
+        sc_job_thread_count(),
+        (double)(end_time_ns - begin_time_ns) / 1e6
+    );
+
+    // Write.
+    const bool written = sc_raster_write_png(&raster, output_path);
+    if (written) {
+        SC_LOG_INFO("Wrote %s", output_path);
+    } else {
+        SC_LOG_ERROR("Failed to write %s", output_path);
+    }
+
+    // Free.
+    sc_raster_free(&raster);
+    sc_arena_free(&arena);
+    sc_octree_free(&octree);
+    sc_job_system_free();
+
+    return written ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
+
+SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(event);
+    return SDL_APP_CONTINUE;
+}
+
+SDL_AppResult SDL_AppIterate(void* appstate) {
+    SC_UNUSED(appstate);
+    return SDL_APP_SUCCESS;
+}
+
+void SDL_AppQuit(void* appstate, SDL_AppResult result) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(result);
+}
@@ -0,0 +1,201 @@
+//
+// Stormcloud Resample - Includes.
+//
+
+#include "common.h"
+#include "alloc.h"
+#include "job.h"
+#include "math.h"
+#include "color.h"
+#include "camera.h"
+#include "octree.h"
+
+//
+// Stormcloud Resample - Regenerate the interior levels of an octree from its leaves.
+//
+
+// Usage: stormcloud_resample <input.oct> <output.oct> [voxel|poisson] [grid_size]
+
+typedef struct ScResampleLevel {
+    uint64_t node_count;
+    uint64_t point_count;
+    double spacing_sum;
+} ScResampleLevel;
+
+// Per level point counts and mean node spacing, levels count up from the leaves. Spacing is
+// left out without node geometry.
+static void sc_resample_levels(
+    const ScOctreeNode* nodes,
+    const ScOctreeNodeGeometry* node_geometry,
+    uint64_t node_count,
+    ScResampleLevel* levels
+) {
+    for (uint64_t i = 0; i < node_count; i++) {
+        const ScOctreeNode* node = &nodes[i];
+        ScResampleLevel* level = &levels[node->level];
+        level->node_count++;
+        level->point_count += node->point_count;
+        level->spacing_sum += node_geometry != NULL ? (double)node_geometry[i].spacing : 0.0;
+    }
+}
+
+SDL_AppResult SDL_AppInit(void** appstate, int argc, char** argv) {
+    // Arguments.
+    SC_UNUSED(appstate);
+    if (argc < 3) {
+        SC_LOG_ERROR("Usage: %s <input.oct> <output.oct> [voxel|poisson] [grid_size]", argv[0]);
+        return SDL_APP_FAILURE;
+    }
+    const char* input_path = argv[1];
+    const char* output_path = argv[2];
+    if (SDL_strcmp(input_path, output_path) == 0) {
+        SC_LOG_ERROR("Input and output must be different files");
+        return SDL_APP_FAILURE;
+    }
+    ScOctreeResampleInfo resample_info = {
+        .method = SC_OCTREE_RESAMPLE_METHOD_VOXEL_GRID,
+        .grid_size = SC_OCTREE_RESAMPLE_GRID_SIZE,
+    };
+    if (argc > 3) {
+        resample_info.method = SC_OCTREE_RESAMPLE_METHOD_COUNT;
+        for (uint32_t i = 0; i < SC_OCTREE_RESAMPLE_METHOD_COUNT; i++) {
+            if (SDL_strcmp(argv[3], SC_OCTREE_RESAMPLE_METHOD_NAME[i]) == 0) {
+                resample_info.method = (ScOctreeResampleMethod)i;
+            }
+        }
+        if (resample_info.method == SC_OCTREE_RESAMPLE_METHOD_COUNT) {
+            SC_LOG_ERROR("Unknown method %s, expected voxel or poisson", argv[3]);
+            return SDL_APP_FAILURE;
+        }
+    }
+    if (argc > 4) {
+        resample_info.grid_size = (uint32_t)atoi(argv[4]);
+        if (resample_info.grid_size == 0
+            || resample_info.grid_size > SC_OCTREE_RESAMPLE_MAX_GRID_SIZE) {
+            SC_LOG_ERROR("Grid size must be in 1..%d", SC_OCTREE_RESAMPLE_MAX_GRID_SIZE);
+            return SDL_APP_FAILURE;
+        }
+    }
+
+    // Input, checked before loading.
+    if (!sc_octree_probe(input_path)) {
+        return SDL_APP_FAILURE;
+    }
+
+    // Jobs, on all cores.
+    sc_job_system_new(&(ScJobSystemCreateInfo) {
+        .worker_count = 0,
+        .pin_workers = false,
+    });
+
+    // Source, without points.
+    ScOctree source = {0};
+    sc_octree_header_load(&source, input_path);
+    const bool source_geometry_loaded = sc_octree_tables_load(&source);
+    uint32_t level_count = 1;
+    for (uint64_t i = 0; i < source.node_count; i++) {
+        level_count = SDL_max(level_count, (uint32_t)source.nodes[i].level + 1);
+    }
+
+    // Resample.
+    const uint64_t begin_time_ns = SDL_GetTicksNS();
+    ScOctreeResample resample;
+    sc_octree_resample(&resample, &source, &resample_info);
+    const uint64_t end_time_ns = SDL_GetTicksNS();
+    SC_LOG_INFO(
+        "Resampled %u levels with %s, grid %u, on %u threads in %.3f ms",
+        level_count - 1,
+        SC_OCTREE_RESAMPLE_METHOD_NAME[resample_info.method],
+        resample_info.grid_size,
+        sc_job_thread_count(),
+        (double)(end_time_ns - begin_time_ns) / 1e6
+    );
+
+    // Write.
+    const bool written = sc_octree_resample_write(&resample, source_geometry_loaded, output_path);
+    if (written) {
+        SC_LOG_INFO("Wrote %s", output_path);
+    } else {
+        SC_LOG_ERROR("Failed to write %s", output_path);
+    }
+
+    // Levels, before and after.
+    ScResampleLevel* levels_before = calloc(level_count, sizeof(ScResampleLevel));
+    ScResampleLevel* levels_after = calloc(level_count, sizeof(ScResampleLevel));
+    sc_resample_levels(
+        source.nodes,
+        source_geometry_loaded ? source.node_geometry : NULL,
+        source.node_count,
+        levels_before
+    );
+    sc_resample_levels(
+        resample.output_nodes,
+        resample.output_node_geometry,
+        source.node_count,
+        levels_after
+    );
+
+    // Report, from the root down.
+    SC_LOG_INFO("level nodes points_before points_after ratio spacing_before spacing_after");
+    for (uint32_t i = level_count; i-- > 0;) {
+        const ScResampleLevel* before = &levels_before[i];
+        const ScResampleLevel* after = &levels_after[i];
+        if (before->node_count == 0) {
+            continue;
+        }
+        char spacing_before[32] = "-";
+        if (source_geometry_loaded) {
+            snprintf(
+                spacing_before,
+                sizeof(spacing_before),
+                "%.4f",
+                before->spacing_sum / (double)before->node_count
+            );
+        }
+        SC_LOG_INFO(
+            "%5u %5" PRIu64 " %13" PRIu64 " %12" PRIu64 " %5.3f %14s %13.4f",
+            i,
+            before->node_count,
+            before->point_count,
+            after->point_count,
+            before->point_count > 0 ? (double)after->point_count / (double)before->point_count
+                                    : 0.0,
+            spacing_before,
+            after->spacing_sum / (double)after->node_count
+        );
+    }
+    SC_LOG_INFO(
+        "Points: %" PRIu64 " -> %" PRIu64 " (%.1f%% interior)",
+        source.point_count,
+        resample.output_point_count,
+        resample.output_point_count > 0
+            ? 100.0 * (double)(resample.output_point_count - levels_after[0].point_count)
+                  / (double)resample.output_point_count
+            : 0.0
+    );
+
+    // Free.
+    free(levels_before);
+    free(levels_after);
+    sc_octree_resample_free(&resample);
+    sc_octree_free(&source);
+    sc_job_system_free();
+
+    return written ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
+
+SDL_AppResult SDL_AppEvent(void* appstate, SDL_Event* event) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(event);
+    return SDL_APP_CONTINUE;
+}
+
+SDL_AppResult SDL_AppIterate(void* appstate) {
+    SC_UNUSED(appstate);
+    return SDL_APP_SUCCESS;
+}
+
+void SDL_AppQuit(void* appstate, SDL_AppResult result) {
+    SC_UNUSED(appstate);
+    SC_UNUSED(result);
+}
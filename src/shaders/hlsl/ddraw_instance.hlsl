@@ -0,0 +1,42 @@
+cbuffer uniform_buffer: register(b0, space1) {
+    float4x4 clip_from_world;
+}
+
+struct vs_input {
+    float3 position: TEXCOORD0;
+    float4 color: TEXCOORD1;
+    float4 instance_world_from_local_0: TEXCOORD2;
+    float4 instance_world_from_local_1: TEXCOORD3;
+    float4 instance_world_from_local_2: TEXCOORD4;
+    float4 instance_world_from_local_3: TEXCOORD5;
+    float4 instance_color: TEXCOORD6;
+};
+
+struct vs_output {
+    float4 position: SV_Position;
+    float4 color: TEXCOORD0;
+};
+
+vs_output vs_main(vs_input input) {
+    // Columns of the instance transform, which may be projective.
+    const float4 position = input.instance_world_from_local_0 * input.position.x
+                            + input.instance_world_from_local_1 * input.position.y
+                            + input.instance_world_from_local_2 * input.position.z
+                            + input.instance_world_from_local_3;
+    const float3 world_position = position.xyz / position.w;
+
+    vs_output output;
+    output.position = mul(clip_from_world, float4(world_position, 1.0f));
+    output.color = input.color * input.instance_color;
+    return output;
+}
+
+struct fs_output {
+    float4 color: SV_Target0;
+};
+
+fs_output fs_main(vs_output input) {
+    fs_output output;
+    output.color = input.color;
+    return output;
+}
@@ -3,8 +3,8 @@ cbuffer uniform_buffer: register(b0, space1) {
     float2 offset;
 }
 
-Texture2D<float4> font_texture: register(t0, space2);
-SamplerState font_sampler: register(s0, space2);
+[[vk::combinedImageSampler]] Texture2D<float4> font_texture: register(t0, space2);
+[[vk::combinedImageSampler]] SamplerState font_sampler: register(s0, space2);
 
 struct vs_input {
     float2 position: TEXCOORD0;
@@ -16,6 +16,15 @@ struct vs_input {
 struct vs_output {
     float4 position: SV_Position;
     float4 color: TEXCOORD0;
+#if defined(__spirv__)
+    // Vulkan leaves the point size undefined unless the vertex shader writes it.
+    [[vk::builtin("PointSize")]] float point_size: PSIZE;
+#endif
+};
+
+struct fs_input {
+    float4 position: SV_Position;
+    float4 color: TEXCOORD0;
 };
 
 vs_output vs_main(vs_input input) {
@@ -40,6 +49,9 @@ vs_output vs_main(vs_input input) {
     vs_output output;
     output.position = mul(clip_from_world, float4(position, 1.0f));
     output.color = input.color;
+#if defined(__spirv__)
+    output.point_size = 1.0f;
+#endif
     return output;
 }
 
@@ -47,7 +59,7 @@ struct fs_output {
     float4 color: SV_Target0;
 };
 
-fs_output fs_main(vs_output input) {
+fs_output fs_main(fs_input input) {
     fs_output output;
     output.color = input.color;
     return output;
@@ -0,0 +1,94 @@
+cbuffer uniform_buffer: register(b0, space1) {
+    float4x4 clip_from_world;
+    float node_world_scale;
+    uint32_t point_color_stream;
+    uint32_t pad_0;
+    uint32_t pad_1;
+}
+
+// 6-byte points, see ScOctreePointCompact. Bits 0-29: position, bits 30-47: RGB666.
+ByteAddressBuffer points: register(t0, space0);
+// RGBA8 per point, only read if point_color_stream is set.
+ByteAddressBuffer colors: register(t1, space0);
+
+struct vs_input {
+    uint vertex_id: SV_VertexID;
+    float3 instance_min: TEXCOORD0;
+    float3 instance_max: TEXCOORD1;
+};
+
+struct vs_output {
+    float4 position: SV_Position;
+    float4 color: TEXCOORD0;
+#if defined(__spirv__)
+    // Vulkan leaves the point size undefined unless the vertex shader writes it.
+    [[vk::builtin("PointSize")]] float point_size: PSIZE;
+#endif
+};
+
+struct fs_input {
+    float4 position: SV_Position;
+    float4 color: TEXCOORD0;
+};
+
+vs_output vs_main(vs_input input) {
+    const float min_x = node_world_scale * input.instance_min.x;
+    const float min_y = node_world_scale * input.instance_min.y;
+    const float min_z = node_world_scale * input.instance_min.z;
+    const float max_x = node_world_scale * input.instance_max.x;
+    const float max_y = node_world_scale * input.instance_max.y;
+    const float max_z = node_world_scale * input.instance_max.z;
+    const float extent_x = max_x - min_x;
+    const float extent_y = max_y - min_y;
+    const float extent_z = max_z - min_z;
+
+    // Loads must be 4-byte aligned, and a point starts at either 0 or 2 mod 4.
+    const uint byte_offset = 6 * input.vertex_id;
+    const uint2 words = points.Load2(byte_offset & ~3u);
+    const uint shift = 8 * (byte_offset & 3u);
+    const uint lo = shift == 0 ? words.x : (words.x >> 16) | (words.y << 16);
+    const uint hi = shift == 0 ? words.y & 0xffff : words.y >> 16;
+
+    const uint ix = lo & 0x3ff;
+    const uint iy = (lo >> 10) & 0x3ff;
+    const uint iz = (lo >> 20) & 0x3ff;
+    const float x = min_x + ((float)ix / 1023.0f) * extent_x;
+    const float y = min_y + ((float)iy / 1023.0f) * extent_y;
+    const float z = min_z + ((float)iz / 1023.0f) * extent_z;
+    const float3 position = float3(x, y, z);
+
+    const uint rgb = (lo >> 30) | (hi << 2);
+    float4 color = float4(
+        (float)(rgb & 0x3f) / 63.0f,
+        (float)((rgb >> 6) & 0x3f) / 63.0f,
+        (float)((rgb >> 12) & 0x3f) / 63.0f,
+        1.0f
+    );
+    if (point_color_stream != 0) {
+        const uint rgba = colors.Load(4 * input.vertex_id);
+        color = float4(
+            (float)(rgba & 0xff) / 255.0f,
+            (float)((rgba >> 8) & 0xff) / 255.0f,
+            (float)((rgba >> 16) & 0xff) / 255.0f,
+            (float)(rgba >> 24) / 255.0f
+        );
+    }
+
+    vs_output output;
+    output.position = mul(clip_from_world, float4(position, 1.0f));
+    output.color = color;
+#if defined(__spirv__)
+    output.point_size = 1.0f;
+#endif
+    return output;
+}
+
+struct fs_output {
+    float4 color: SV_Target0;
+};
+
+fs_output fs_main(fs_input input) {
+    fs_output output;
+    output.color = input.color;
+    return output;
+}
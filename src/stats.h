@@ -0,0 +1,296 @@
+//
+// Stats - Rolling frame statistics
+//
+
+// Notes:
+// - Keeps the last SC_STATS_FRAME_COUNT frame records and reports percentiles over that
+//   window, since averages hide the spikes we care about.
+// - Records can be streamed to a CSV or JSON lines file, one record per frame.
+// - busy_ms and point_budget are the inputs of the adaptive LOD controller, see lod.h. The
+//   budget is zero while the controller is off or has not measured a frame yet.
+
+#define SC_STATS_FRAME_COUNT 512
+#define SC_STATS_HISTOGRAM_BIN_COUNT 32
+
+typedef enum ScStatsTimer {
+    SC_STATS_TIMER_FRAME,
+    SC_STATS_TIMER_BUSY,
+    SC_STATS_TIMER_TRAVERSE,
+    SC_STATS_TIMER_SUBMIT,
+    SC_STATS_TIMER_COUNT,
+} ScStatsTimer;
+
+static const char* SC_STATS_TIMER_NAME[] = {
+    "frame_ms",
+    "busy_ms",
+    "traverse_ms",
+    "submit_ms",
+};
+
+typedef enum ScStatsCounter {
+    SC_STATS_COUNTER_VISIBLE_POINTS,
+    SC_STATS_COUNTER_TRAVERSED_NODES,
+    SC_STATS_COUNTER_VISITED_NODES,
+    SC_STATS_COUNTER_FRUSTUM_CULLED_NODES,
+    SC_STATS_COUNTER_LOD_CULLED_NODES,
+    SC_STATS_COUNTER_UPLOAD_BYTES,
+    SC_STATS_COUNTER_POINT_BUDGET,
+    SC_STATS_COUNTER_COUNT,
+} ScStatsCounter;
+
+static const char* SC_STATS_COUNTER_NAME[] = {
+    "visible_points",
+    "traversed_nodes",
+    "visited_nodes",
+    "frustum_culled_nodes",
+    "lod_culled_nodes",
+    "upload_bytes",
+    "point_budget",
+};
+
+typedef enum ScStatsExportFormat {
+    SC_STATS_EXPORT_FORMAT_CSV,
+    SC_STATS_EXPORT_FORMAT_JSONL,
+    SC_STATS_EXPORT_FORMAT_COUNT,
+} ScStatsExportFormat;
+
+static const char* SC_STATS_EXPORT_FORMAT_NAME[] = {
+    "csv",
+    "jsonl",
+};
+
+typedef struct ScStatsRecord {
+    uint64_t frame_number;
+    float timers[SC_STATS_TIMER_COUNT];
+    uint64_t counters[SC_STATS_COUNTER_COUNT];
+} ScStatsRecord;
+
+typedef struct ScStatsSummary {
+    float p50;
+    float p95;
+    float p99;
+    float max;
+} ScStatsSummary;
+
+typedef struct ScStats {
+    // Window, oldest record first once full.
+    ScStatsRecord records[SC_STATS_FRAME_COUNT];
+    uint32_t record_count;
+    uint32_t record_next;
+    uint64_t frame_number;
+
+    // Export.
+    SDL_IOStream* export_io;
+    ScStatsExportFormat export_format;
+} ScStats;
+
+static void sc_stats_new(ScStats* stats) {
+    SDL_zerop(stats);
+}
+
+static void sc_stats_export_end(ScStats* stats) {
+    if (stats->export_io == NULL) {
+        return;
+    }
+    if (!SDL_CloseIO(stats->export_io)) {
+        SC_LOG_ERROR("Failed to close stats export: %s", SDL_GetError());
+    }
+    stats->export_io = NULL;
+}
+
+static bool
+sc_stats_export_begin(ScStats* stats, const char* file_path, ScStatsExportFormat export_format) {
+    sc_stats_export_end(stats);
+    stats->export_io = SDL_IOFromFile(file_path, "wb");
+    if (stats->export_io == NULL) {
+        SC_LOG_ERROR("Failed to open %s: %s", file_path, SDL_GetError());
+        return false;
+    }
+    stats->export_format = export_format;
+
+    // Header.
+    if (export_format == SC_STATS_EXPORT_FORMAT_CSV) {
+        SDL_IOprintf(stats->export_io, "frame");
+        for (uint32_t i = 0; i < SC_STATS_TIMER_COUNT; i++) {
+            SDL_IOprintf(stats->export_io, ",%s", SC_STATS_TIMER_NAME[i]);
+        }
+        for (uint32_t i = 0; i < SC_STATS_COUNTER_COUNT; i++) {
+            SDL_IOprintf(stats->export_io, ",%s", SC_STATS_COUNTER_NAME[i]);
+        }
+        SDL_IOprintf(stats->export_io, "\n");
+    }
+    SC_LOG_INFO("Exporting frame stats to %s", file_path);
+    return true;
+}
+
+static void sc_stats_free(ScStats* stats) {
+    sc_stats_export_end(stats);
+}
+
+static void sc_stats_export_record(ScStats* stats, const ScStatsRecord* record) {
+    SDL_IOStream* io = stats->export_io;
+    switch (stats->export_format) {
+        case SC_STATS_EXPORT_FORMAT_CSV: {
+            SDL_IOprintf(io, "%" PRIu64, record->frame_number);
+            for (uint32_t i = 0; i < SC_STATS_TIMER_COUNT; i++) {
+                SDL_IOprintf(io, ",%.4f", (double)record->timers[i]);
+            }
+            for (uint32_t i = 0; i < SC_STATS_COUNTER_COUNT; i++) {
+                SDL_IOprintf(io, ",%" PRIu64, record->counters[i]);
+            }
+            SDL_IOprintf(io, "\n");
+            break;
+        }
+        case SC_STATS_EXPORT_FORMAT_JSONL: {
+            SDL_IOprintf(io, "{\"frame\":%" PRIu64, record->frame_number);
+            for (uint32_t i = 0; i < SC_STATS_TIMER_COUNT; i++) {
+                SDL_IOprintf(io, ",\"%s\":%.4f", SC_STATS_TIMER_NAME[i], (double)record->timers[i]);
+            }
+            for (uint32_t i = 0; i < SC_STATS_COUNTER_COUNT; i++) {
+                SDL_IOprintf(io, ",\"%s\":%" PRIu64, SC_STATS_COUNTER_NAME[i], record->counters[i]);
+            }
+            SDL_IOprintf(io, "}\n");
+            break;
+        }
+        default: break;
+    }
+}
+
+// Appends a record to the window, frame_number is assigned here.
+static void sc_stats_push(ScStats* stats, const ScStatsRecord* record) {
+    ScStatsRecord* dst = &stats->records[stats->record_next];
+    *dst = *record;
+    dst->frame_number = stats->frame_number++;
+    stats->record_next = (stats->record_next + 1) % SC_STATS_FRAME_COUNT;
+    stats->record_count = SDL_min(stats->record_count + 1, SC_STATS_FRAME_COUNT);
+    if (stats->export_io != NULL) {
+        sc_stats_export_record(stats, dst);
+    }
+}
+
+// Copies a timer out of the window in chronological order, returns the value count.
+static uint32_t sc_stats_timer_values(const ScStats* stats, ScStatsTimer timer, float* values) {
+    const uint32_t first = (stats->record_next + SC_STATS_FRAME_COUNT - stats->record_count)
+                           % SC_STATS_FRAME_COUNT;
+    for (uint32_t i = 0; i < stats->record_count; i++) {
+        values[i] = stats->records[(first + i) % SC_STATS_FRAME_COUNT].timers[timer];
+    }
+    return stats->record_count;
+}
+
+static int sc_stats_float_compare(const void* lhs, const void* rhs) {
+    const float a = *(const float*)lhs;
+    const float b = *(const float*)rhs;
+    return (a > b) - (a < b);
+}
+
+// Nearest-rank percentiles over the window.
+static ScStatsSummary sc_stats_summary(const ScStats* stats, ScStatsTimer timer) {
+    float values[SC_STATS_FRAME_COUNT];
+    const uint32_t count = sc_stats_timer_values(stats, timer, values);
+    if (count == 0) {
+        return (ScStatsSummary) {0};
+    }
+    qsort(values, count, sizeof(float), sc_stats_float_compare);
+    const uint32_t p50 = (uint32_t)SDL_ceil(0.50 * count) - 1;
+    const uint32_t p95 = (uint32_t)SDL_ceil(0.95 * count) - 1;
+    const uint32_t p99 = (uint32_t)SDL_ceil(0.99 * count) - 1;
+    return (ScStatsSummary) {
+        .p50 = values[p50],
+        .p95 = values[p95],
+        .p99 = values[p99],
+        .max = values[count - 1],
+    };
+}
+
+static void sc_stats_gui(ScStats* stats) {
+    ImGui_SetNextWindowSize((ImVec2) {360.0f, 520.0f}, ImGuiCond_Once);
+    ImGui_Begin("stats", NULL, 0);
+
+    // Timers.
+    ImGui_Text("window: %u frames", stats->record_count);
+    for (uint32_t i = 0; i < SC_STATS_TIMER_COUNT; i++) {
+        const ScStatsTimer timer = (ScStatsTimer)i;
+        const ScStatsSummary summary = sc_stats_summary(stats, timer);
+        ImGui_Separator();
+        ImGui_Text(
+            "%s p50 %.2f p95 %.2f p99 %.2f max %.2f",
+            SC_STATS_TIMER_NAME[i],
+            (double)summary.p50,
+            (double)summary.p95,
+            (double)summary.p99,
+            (double)summary.max
+        );
+
+        // History.
+        float values[SC_STATS_FRAME_COUNT];
+        const uint32_t count = sc_stats_timer_values(stats, timer, values);
+        ImGui_PushIDInt((int32_t)i);
+        ImGui_PlotLinesEx(
+            "##history",
+            values,
+            (int32_t)count,
+            0,
+            NULL,
+            0.0f,
+            summary.max,
+            (ImVec2) {0.0f, 40.0f},
+            sizeof(float)
+        );
+
+        // Histogram over [0, max].
+        float bins[SC_STATS_HISTOGRAM_BIN_COUNT] = {0};
+        for (uint32_t j = 0; j < count && summary.max > 0.0f; j++) {
+            const float t = values[j] / summary.max;
+            const uint32_t bin = SDL_min(
+                (uint32_t)(t * SC_STATS_HISTOGRAM_BIN_COUNT),
+                SC_STATS_HISTOGRAM_BIN_COUNT - 1
+            );
+            bins[bin] += 1.0f;
+        }
+        ImGui_PlotHistogramEx(
+            "##histogram",
+            bins,
+            SC_STATS_HISTOGRAM_BIN_COUNT,
+            0,
+            NULL,
+            0.0f,
+            FLT_MAX,
+            (ImVec2) {0.0f, 40.0f},
+            sizeof(float)
+        );
+        ImGui_PopID();
+    }
+
+    // Counters, latest frame.
+    ImGui_Separator();
+    if (stats->record_count > 0) {
+        const uint32_t last =
+            (stats->record_next + SC_STATS_FRAME_COUNT - 1) % SC_STATS_FRAME_COUNT;
+        const ScStatsRecord* record = &stats->records[last];
+        for (uint32_t i = 0; i < SC_STATS_COUNTER_COUNT; i++) {
+            ImGui_Text("%s: %" PRIu64, SC_STATS_COUNTER_NAME[i], record->counters[i]);
+        }
+    }
+
+    // Export.
+    ImGui_Separator();
+    if (stats->export_io == NULL) {
+        for (uint32_t i = 0; i < SC_STATS_EXPORT_FORMAT_COUNT; i++) {
+            char label[32];
+            snprintf(label, sizeof(label), "export_%s", SC_STATS_EXPORT_FORMAT_NAME[i]);
+            char file_path[64];
+            snprintf(file_path, sizeof(file_path), "temp/stats.%s", SC_STATS_EXPORT_FORMAT_NAME[i]);
+            if (i > 0) {
+                ImGui_SameLine();
+            }
+            if (ImGui_Button(label)) {
+                sc_stats_export_begin(stats, file_path, (ScStatsExportFormat)i);
+            }
+        }
+    } else if (ImGui_Button("stop_export")) {
+        sc_stats_export_end(stats);
+    }
+
+    ImGui_End();
+}